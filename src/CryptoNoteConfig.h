@@ -77,6 +77,9 @@ const size_t   FUSION_TX_MIN_IN_OUT_COUNT_RATIO              = 4;
 
 const size_t   BLOCKS_IDS_SYNCHRONIZING_DEFAULT_COUNT        =  10000;  //by default, blocks ids count in synchronizing
 const size_t   BLOCKS_SYNCHRONIZING_DEFAULT_COUNT            =  200;    //by default, blocks count in blocks downloading
+const size_t   BLOCKS_SYNCHRONIZING_MAX_RANGES_AHEAD         =  16;     //ranges requested or waiting for commit at once
+const uint32_t BLOCKS_SYNCHRONIZING_MIN_TIMEOUT              =  30;     //seconds, a peer is not considered stalled before that
+const uint32_t BLOCKS_SYNCHRONIZING_TIMEOUT_FACTOR           =  4;      //stalled when a range takes that many times longer than the peer's throughput suggests
 const size_t   COMMAND_RPC_GET_BLOCKS_FAST_MAX_COUNT         =  1000;
 
 // //TODO This port will be used by the daemon to establish connections with p2p network
@@ -218,6 +218,42 @@ std::error_code InProcessNode::doGetTransactionOutsGlobalIndices(const crypto::h
   return std::error_code();
 }
 
+void InProcessNode::getTransactionsOutsGlobalIndices(const std::vector<crypto::hash_t>& transactionHashes,
+    std::vector<std::vector<uint32_t>>& outsGlobalIndices, const Callback& callback)
+{
+  std::unique_lock<std::mutex> lock(mutex);
+  if (state != INITIALIZED) {
+    lock.unlock();
+    callback(make_error_code(cryptonote::error::NOT_INITIALIZED));
+    return;
+  }
+
+  ioService.post(
+    std::bind(&InProcessNode::getTransactionsOutsGlobalIndicesAsync,
+      this,
+      std::cref(transactionHashes),
+      std::ref(outsGlobalIndices),
+      callback
+    )
+  );
+}
+
+void InProcessNode::getTransactionsOutsGlobalIndicesAsync(const std::vector<crypto::hash_t>& transactionHashes,
+    std::vector<std::vector<uint32_t>>& outsGlobalIndices, const Callback& callback)
+{
+  std::vector<std::vector<uint32_t>> indices(transactionHashes.size());
+  std::error_code ec;
+  for (size_t i = 0; i < transactionHashes.size() && !ec; ++i) {
+    ec = doGetTransactionOutsGlobalIndices(transactionHashes[i], indices[i]);
+  }
+
+  if (!ec) {
+    outsGlobalIndices = std::move(indices);
+  }
+
+  callback(ec);
+}
+
 void InProcessNode::getRandomOutsByAmounts(std::vector<uint64_t>&& amounts, uint64_t outsCount,
     std::vector<cryptonote::COMMAND_RPC_GET_RANDOM_OUTPUTS_FOR_AMOUNTS::outs_for_amount>& result, const Callback& callback)
 {
@@ -541,6 +577,40 @@ void InProcessNode::getPoolSymmetricDifferenceAsync(std::vector<crypto::hash_t>&
   callback(ec);
 }
 
+void InProcessNode::getPoolChangesSince(uint64_t& sequence, crypto::hash_t knownBlockId, bool& isBcActual, bool& isFullResync,
+        std::vector<std::unique_ptr<ITransactionReader>>& newTxs, std::vector<crypto::hash_t>& deletedTxIds, const Callback& callback) {
+  std::unique_lock<std::mutex> lock(mutex);
+  if (state != INITIALIZED) {
+    lock.unlock();
+    callback(make_error_code(cryptonote::error::NOT_INITIALIZED));
+    return;
+  }
+
+  ioService.post([this, &sequence, knownBlockId, &isBcActual, &isFullResync, &newTxs, &deletedTxIds, callback] () mutable {
+    this->getPoolChangesSinceAsync(sequence, knownBlockId, isBcActual, isFullResync, newTxs, deletedTxIds, callback);
+  });
+}
+
+void InProcessNode::getPoolChangesSinceAsync(uint64_t& sequence, crypto::hash_t knownBlockId, bool& isBcActual, bool& isFullResync,
+        std::vector<std::unique_ptr<ITransactionReader>>& newTxs, std::vector<crypto::hash_t>& deletedTxIds, const Callback& callback) {
+  std::error_code ec = std::error_code();
+
+  std::vector<transaction_prefix_info_t> added;
+  isBcActual = core.getPoolChangesSince(knownBlockId, sequence, isFullResync, added, deletedTxIds);
+
+  try {
+    for (const auto& tx: added) {
+      newTxs.push_back(createTransactionPrefix(tx.txPrefix, tx.txHash));
+    }
+  } catch (std::system_error& ex) {
+    ec = ex.code();
+  } catch (std::exception&) {
+    ec = make_error_code(std::errc::invalid_argument);
+  }
+
+  callback(ec);
+}
+
 void InProcessNode::getMultisignatureOutputByGlobalIndex(uint64_t amount, uint32_t gindex, multi_signature_output_t& out, const Callback& callback) {
   std::unique_lock<std::mutex> lock(mutex);
   if (state != INITIALIZED) {
@@ -18,9 +18,8 @@
 #include "http/HttpParser.h"
 #include "http/HttpResponse.h"
 
-#include "common/JsonValue.h"
-#include "serialization/JsonInputValueSerializer.h"
-#include "serialization/JsonOutputStreamSerializer.h"
+#include "serialization/JsonOutputStringSerializer.h"
+#include "serialization/JsonTokens.h"
 
 namespace cryptonote {
 
@@ -43,27 +42,23 @@ void JsonRpcServer::processRequest(const cryptonote::HttpRequest& req, cryptonot
     logger(Logging::TRACE) << "HTTP request came: \n" << req;
 
     if (req.getUrl() == "/json_rpc") {
-      std::istringstream jsonInputStream(req.getBody());
-      Common::JsonValue jsonRpcRequest;
-      Common::JsonValue jsonRpcResponse(Common::JsonValue::OBJECT);
+      std::unique_ptr<JsonTokens> jsonRpcRequest;
+      JsonOutputStringSerializer jsonRpcResponse;
 
       try {
-        jsonInputStream >> jsonRpcRequest;
+        jsonRpcRequest.reset(new JsonTokens(req.getBody()));
       } catch (std::runtime_error&) {
         logger(Logging::DEBUGGING) << "Couldn't parse request: \"" << req.getBody() << "\"";
         makeJsonParsingErrorResponse(jsonRpcResponse);
         resp.setStatus(cryptonote::HttpResponse::STATUS_200);
-        resp.setBody(jsonRpcResponse.toString());
+        resp.setBody(std::move(jsonRpcResponse.getString()));
         return;
       }
 
-      processJsonRpcRequest(jsonRpcRequest, jsonRpcResponse);
-
-      std::ostringstream jsonOutputStream;
-      jsonOutputStream << jsonRpcResponse;
+      processJsonRpcRequest(*jsonRpcRequest, jsonRpcResponse);
 
       resp.setStatus(cryptonote::HttpResponse::STATUS_200);
-      resp.setBody(jsonOutputStream.str());
+      resp.setBody(std::move(jsonRpcResponse.getString()));
 
     } else {
       logger(Logging::WARNING) << "Requested url \"" << req.getUrl() << "\" is not found";
@@ -76,46 +71,32 @@ void JsonRpcServer::processRequest(const cryptonote::HttpRequest& req, cryptonot
   }
 }
 
-void JsonRpcServer::prepareJsonResponse(const Common::JsonValue& req, Common::JsonValue& resp) {
-  using Common::JsonValue;
-
-  if (req.contains("id")) {
-    resp.insert("id", req("id"));
+void JsonRpcServer::prepareJsonResponse(const JsonTokens& req, JsonOutputStringSerializer& resp) {
+  size_t id = req.find(0, "id");
+  if (id != JsonTokens::npos) {
+    resp.raw(req.getRaw(id), "id");
   }
-  
-  resp.insert("jsonrpc", "2.0");
-}
-
-void JsonRpcServer::makeErrorResponse(const std::error_code& ec, Common::JsonValue& resp) {
-  using Common::JsonValue;
-
-  JsonValue error(JsonValue::OBJECT);
-
-  JsonValue code;
-  code = static_cast<int64_t>(-32000); //Application specific error code
 
-  JsonValue message;
-  message = ec.message();
-
-  JsonValue data(JsonValue::OBJECT);
-  JsonValue appCode;
-  appCode = static_cast<int64_t>(ec.value());
-  data.insert("application_code", appCode);
-
-  error.insert("code", code);
-  error.insert("message", message);
-  error.insert("data", data);
-
-  resp.insert("error", error);
+  std::string version = "2.0";
+  resp(version, "jsonrpc");
 }
 
-void JsonRpcServer::makeGenericErrorReponse(Common::JsonValue& resp, const char* what, int errorCode) {
-  using Common::JsonValue;
-
-  JsonValue error(JsonValue::OBJECT);
+void JsonRpcServer::makeErrorResponse(const std::error_code& ec, JsonOutputStringSerializer& resp) {
+  int64_t code = -32000; //Application specific error code
+  std::string message = ec.message();
+  int64_t appCode = ec.value();
+
+  resp.beginObject("error");
+  resp(code, "code");
+  resp(message, "message");
+  resp.beginObject("data");
+  resp(appCode, "application_code");
+  resp.endObject();
+  resp.endObject();
+}
 
-  JsonValue code;
-  code = static_cast<int64_t>(errorCode);
+void JsonRpcServer::makeGenericErrorReponse(JsonOutputStringSerializer& resp, const char* what, int errorCode) {
+  int64_t code = errorCode;
 
   std::string msg;
   if (what) {
@@ -124,54 +105,37 @@ void JsonRpcServer::makeGenericErrorReponse(Common::JsonValue& resp, const char*
     msg = "Unknown application error";
   }
 
-  JsonValue message;
-  message = msg;
-
-  error.insert("code", code);
-  error.insert("message", message);
-
-  resp.insert("error", error);
-
+  resp.beginObject("error");
+  resp(code, "code");
+  resp(msg, "message");
+  resp.endObject();
 }
 
-void JsonRpcServer::makeMethodNotFoundResponse(Common::JsonValue& resp) {
-  using Common::JsonValue;
-
-  JsonValue error(JsonValue::OBJECT);
-
-  JsonValue code;
-  code = static_cast<int64_t>(-32601); //ambigous declaration of JsonValue::operator= (between int and JsonValue)
-
-  JsonValue message;
-  message = "Method not found";
-
-  error.insert("code", code);
-  error.insert("message", message);
+void JsonRpcServer::makeMethodNotFoundResponse(JsonOutputStringSerializer& resp) {
+  int64_t code = -32601;
+  std::string message = "Method not found";
 
-  resp.insert("error", error);
+  resp.beginObject("error");
+  resp(code, "code");
+  resp(message, "message");
+  resp.endObject();
 }
 
-void JsonRpcServer::fillJsonResponse(const Common::JsonValue& v, Common::JsonValue& resp) {
-  resp.insert("result", v);
+void JsonRpcServer::fillJsonResponse(const std::string& result, JsonOutputStringSerializer& resp) {
+  resp.raw(result, "result");
 }
 
-void JsonRpcServer::makeJsonParsingErrorResponse(Common::JsonValue& resp) {
-  using Common::JsonValue;
-
-  resp = JsonValue(JsonValue::OBJECT);
-  resp.insert("jsonrpc", "2.0");
-  resp.insert("id", nullptr);
-
-  JsonValue error(JsonValue::OBJECT);
-  JsonValue code;
-  code = static_cast<int64_t>(-32700); //ambigous declaration of JsonValue::operator= (between int and JsonValue)
-
-  JsonValue message = "Parse error";
-
-  error.insert("code", code);
-  error.insert("message", message);
-
-  resp.insert("error", error);
+void JsonRpcServer::makeJsonParsingErrorResponse(JsonOutputStringSerializer& resp) {
+  int64_t code = -32700;
+  std::string message = "Parse error";
+  std::string version = "2.0";
+
+  resp(version, "jsonrpc");
+  resp.raw("null", "id");
+  resp.beginObject("error");
+  resp(code, "code");
+  resp(message, "message");
+  resp.endObject();
 }
 
 }
@@ -16,10 +16,8 @@
 namespace cryptonote {
 class HttpResponse;
 class HttpRequest;
-}
-
-namespace Common {
-class JsonValue;
+class JsonOutputStringSerializer;
+class JsonTokens;
 }
 
 namespace System {
@@ -36,14 +34,15 @@ public:
   virtual void start(const std::string& bindAddress, uint16_t bindPort);
 
 protected:
-  static void makeErrorResponse(const std::error_code& ec, Common::JsonValue& resp);
-  static void makeMethodNotFoundResponse(Common::JsonValue& resp);
-  static void makeGenericErrorReponse(Common::JsonValue& resp, const char* what, int errorCode = -32001);
-  static void fillJsonResponse(const Common::JsonValue& v, Common::JsonValue& resp);
-  static void prepareJsonResponse(const Common::JsonValue& req, Common::JsonValue& resp);
-  static void makeJsonParsingErrorResponse(Common::JsonValue& resp);
-
-  virtual void processJsonRpcRequest(const Common::JsonValue& req, Common::JsonValue& resp) = 0;
+  // The response is written as it is built: prepareJsonResponse comes first, then one error or result
+  static void makeErrorResponse(const std::error_code& ec, JsonOutputStringSerializer& resp);
+  static void makeMethodNotFoundResponse(JsonOutputStringSerializer& resp);
+  static void makeGenericErrorReponse(JsonOutputStringSerializer& resp, const char* what, int errorCode = -32001);
+  static void fillJsonResponse(const std::string& result, JsonOutputStringSerializer& resp);
+  static void prepareJsonResponse(const JsonTokens& req, JsonOutputStringSerializer& resp);
+  static void makeJsonParsingErrorResponse(JsonOutputStringSerializer& resp);
+
+  virtual void processJsonRpcRequest(const JsonTokens& req, JsonOutputStringSerializer& resp) = 0;
 
   // HttpServer
   virtual void processRequest(const cryptonote::HttpRequest& request, cryptonote::HttpResponse& response) override;
@@ -18,7 +18,8 @@ enum NodeErrorCodes {
   NODE_BUSY,
   INTERNAL_NODE_ERROR,
   REQUEST_ERROR,
-  CONNECT_ERROR
+  CONNECT_ERROR,
+  METHOD_NOT_FOUND
 };
 
 // custom category:
@@ -43,6 +44,7 @@ public:
     case INTERNAL_NODE_ERROR: return "Internal node error";
     case REQUEST_ERROR:       return "Error in request parameters";
     case CONNECT_ERROR:       return "Can't connect to daemon";
+    case METHOD_NOT_FOUND:    return "Method is not supported by daemon";
     default:                  return "Unknown error";
     }
   }
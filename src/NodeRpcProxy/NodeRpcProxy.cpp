@@ -72,6 +72,9 @@ void NodeRpcProxy::resetInternalState() {
   m_networkHeight.store(0, std::memory_order_relaxed);
   m_lastKnowHash = cryptonote::NULL_HASH;
   m_knownTxs.clear();
+  m_poolSequence = 0;
+  m_poolChangesSinceSupported = true;
+  m_outsGlobalIndicesBatchSupported = true;
 }
 
 void NodeRpcProxy::init(const INode::Callback& callback) {
@@ -172,22 +175,58 @@ void NodeRpcProxy::updateNodeStatus() {
 }
 
 bool NodeRpcProxy::updatePoolStatus() {
-  std::vector<crypto::hash_t> knownTxs = getKnownTxsVector();
   crypto::hash_t tailBlock = m_lastKnowHash;
 
   bool isBcActual = false;
+  bool isFullResync = false;
+  uint64_t sequence = m_poolSequence;
   std::vector<std::unique_ptr<ITransactionReader>> addedTxs;
   std::vector<crypto::hash_t> deletedTxsIds;
 
-  std::error_code ec = doGetPoolSymmetricDifference(std::move(knownTxs), tailBlock, isBcActual, addedTxs, deletedTxsIds);
-  if (ec) {
-    return true;
+  std::error_code ec;
+  if (m_poolChangesSinceSupported) {
+    ec = doGetPoolChangesSince(sequence, tailBlock, isBcActual, isFullResync, addedTxs, deletedTxsIds);
+    if (ec == make_error_code(error::METHOD_NOT_FOUND)) {
+      // the daemon predates the pool change log
+      m_poolChangesSinceSupported = false;
+    } else if (ec) {
+      return true;
+    }
+  }
+
+  if (!m_poolChangesSinceSupported) {
+    addedTxs.clear();
+    deletedTxsIds.clear();
+    ec = doGetPoolSymmetricDifference(getKnownTxsVector(), tailBlock, isBcActual, addedTxs, deletedTxsIds);
+    if (ec) {
+      return true;
+    }
+
+    isFullResync = false;
   }
 
   if (!isBcActual) {
     return false;
   }
 
+  m_poolSequence = sequence;
+  if (isFullResync) {
+    std::unordered_set<crypto::hash_t> poolTxs;
+    for (const auto& tx : addedTxs) {
+      poolTxs.insert(tx->getTransactionHash());
+    }
+
+    if (poolTxs == m_knownTxs) {
+      return true;
+    }
+
+    for (const auto& hash : m_knownTxs) {
+      if (poolTxs.count(hash) == 0) {
+        deletedTxsIds.push_back(hash);
+      }
+    }
+  }
+
   if (!addedTxs.empty() || !deletedTxsIds.empty()) {
     updatePoolState(addedTxs, deletedTxsIds);
     m_observerManager.notify(&INodeObserver::poolChanged);
@@ -349,6 +388,18 @@ void NodeRpcProxy::getTransactionOutsGlobalIndices(const crypto::hash_t& transac
     std::ref(outsGlobalIndices)), callback);
 }
 
+void NodeRpcProxy::getTransactionsOutsGlobalIndices(const std::vector<crypto::hash_t>& transactionHashes,
+                                                    std::vector<std::vector<uint32_t>>& outsGlobalIndices, const Callback& callback) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (m_state != STATE_INITIALIZED) {
+    callback(make_error_code(error::NOT_INITIALIZED));
+    return;
+  }
+
+  scheduleRequest(std::bind(&NodeRpcProxy::doGetTransactionsOutsGlobalIndices, this, transactionHashes,
+    std::ref(outsGlobalIndices)), callback);
+}
+
 void NodeRpcProxy::queryBlocks(std::vector<crypto::hash_t>&& knownBlockIds, uint64_t timestamp, std::vector<BlockShortEntry>& newBlocks,
   uint32_t& startHeight, const Callback& callback) {
   std::lock_guard<std::mutex> lock(m_mutex);
@@ -373,6 +424,18 @@ void NodeRpcProxy::getPoolSymmetricDifference(std::vector<crypto::hash_t>&& know
     return this->doGetPoolSymmetricDifference(std::move(knownPoolTxIds), knownBlockId, isBcActual, newTxs, deletedTxIds); } , callback);
 }
 
+void NodeRpcProxy::getPoolChangesSince(uint64_t& sequence, crypto::hash_t knownBlockId, bool& isBcActual, bool& isFullResync,
+        std::vector<std::unique_ptr<ITransactionReader>>& newTxs, std::vector<crypto::hash_t>& deletedTxIds, const Callback& callback) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (m_state != STATE_INITIALIZED) {
+    callback(make_error_code(error::NOT_INITIALIZED));
+    return;
+  }
+
+  scheduleRequest([this, &sequence, knownBlockId, &isBcActual, &isFullResync, &newTxs, &deletedTxIds] () -> std::error_code {
+    return this->doGetPoolChangesSince(sequence, knownBlockId, isBcActual, isFullResync, newTxs, deletedTxIds); } , callback);
+}
+
 void NodeRpcProxy::getMultisignatureOutputByGlobalIndex(uint64_t amount, uint32_t gindex, multi_signature_output_t& out, const Callback& callback) {
   std::lock_guard<std::mutex> lock(m_mutex);
   if (m_state != STATE_INITIALIZED) {
@@ -516,6 +579,52 @@ std::error_code NodeRpcProxy::doGetTransactionOutsGlobalIndices(const crypto::ha
   return ec;
 }
 
+std::error_code NodeRpcProxy::doGetTransactionsOutsGlobalIndices(const std::vector<crypto::hash_t>& transactionHashes,
+                                                                 std::vector<std::vector<uint32_t>>& outsGlobalIndices) {
+  outsGlobalIndices.clear();
+  if (transactionHashes.empty()) {
+    return std::error_code();
+  }
+
+  std::error_code ec;
+  if (m_outsGlobalIndicesBatchSupported) {
+    cryptonote::COMMAND_RPC_GET_TXS_GLOBAL_OUTPUTS_INDEXES::request req = AUTO_VAL_INIT(req);
+    cryptonote::COMMAND_RPC_GET_TXS_GLOBAL_OUTPUTS_INDEXES::response rsp = AUTO_VAL_INIT(rsp);
+    req.txids = transactionHashes;
+
+    ec = binaryCommand("/get_o_indexes_batch.bin", req, rsp);
+    if (!ec) {
+      if (rsp.txs.size() != transactionHashes.size()) {
+        return make_error_code(error::INTERNAL_NODE_ERROR);
+      }
+
+      for (auto& tx : rsp.txs) {
+        outsGlobalIndices.push_back(std::move(tx.o_indexes));
+      }
+
+      return ec;
+    }
+
+    if (ec != make_error_code(error::METHOD_NOT_FOUND)) {
+      return ec;
+    }
+
+    // the daemon predates the batch request
+    m_outsGlobalIndicesBatchSupported = false;
+  }
+
+  std::vector<std::vector<uint32_t>> indices(transactionHashes.size());
+  for (size_t i = 0; i < transactionHashes.size(); ++i) {
+    std::error_code txError = doGetTransactionOutsGlobalIndices(transactionHashes[i], indices[i]);
+    if (txError) {
+      return txError;
+    }
+  }
+
+  outsGlobalIndices = std::move(indices);
+  return std::error_code();
+}
+
 std::error_code NodeRpcProxy::doQueryBlocksLite(const std::vector<crypto::hash_t>& knownBlockIds, uint64_t timestamp,
         std::vector<cryptonote::BlockShortEntry>& newBlocks, uint32_t& startHeight) {
   cryptonote::COMMAND_RPC_QUERY_BLOCKS_LITE::request req = AUTO_VAL_INIT(req);
@@ -582,6 +691,33 @@ std::error_code NodeRpcProxy::doGetPoolSymmetricDifference(std::vector<crypto::h
   return ec;
 }
 
+std::error_code NodeRpcProxy::doGetPoolChangesSince(uint64_t& sequence, crypto::hash_t knownBlockId, bool& isBcActual, bool& isFullResync,
+        std::vector<std::unique_ptr<ITransactionReader>>& newTxs, std::vector<crypto::hash_t>& deletedTxIds) {
+  cryptonote::COMMAND_RPC_GET_POOL_CHANGES_SINCE::request req = AUTO_VAL_INIT(req);
+  cryptonote::COMMAND_RPC_GET_POOL_CHANGES_SINCE::response rsp = AUTO_VAL_INIT(rsp);
+
+  req.tailBlockId = knownBlockId;
+  req.sequence = sequence;
+
+  std::error_code ec = binaryCommand("/get_pool_changes_since.bin", req, rsp);
+
+  if (ec) {
+    return ec;
+  }
+
+  isBcActual = rsp.isTailBlockActual;
+  isFullResync = rsp.isFullResync;
+  sequence = rsp.sequence;
+
+  deletedTxIds = std::move(rsp.deletedTxsIds);
+
+  for (const auto& tpi : rsp.addedTxs) {
+    newTxs.push_back(createTransactionPrefix(tpi.txPrefix, tpi.txHash));
+  }
+
+  return ec;
+}
+
 void NodeRpcProxy::scheduleRequest(std::function<std::error_code()>&& procedure, const Callback& callback) {
   // callback is located on stack, so copy it inside binder
   class Wrapper {
@@ -631,6 +767,8 @@ std::error_code NodeRpcProxy::binaryCommand(const std::string& url, const Reques
     ec = interpretResponseStatus(res.status);
   } catch (const ConnectException&) {
     ec = make_error_code(error::CONNECT_ERROR);
+  } catch (const MethodNotFoundException&) {
+    ec = make_error_code(error::METHOD_NOT_FOUND);
   } catch (const std::exception&) {
     ec = make_error_code(error::NETWORK_ERROR);
   }
@@ -648,6 +786,8 @@ std::error_code NodeRpcProxy::jsonCommand(const std::string& url, const Request&
     ec = interpretResponseStatus(res.status);
   } catch (const ConnectException&) {
     ec = make_error_code(error::CONNECT_ERROR);
+  } catch (const MethodNotFoundException&) {
+    ec = make_error_code(error::METHOD_NOT_FOUND);
   } catch (const std::exception&) {
     ec = make_error_code(error::NETWORK_ERROR);
   }
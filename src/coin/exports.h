@@ -21,6 +21,7 @@ struct storage_files_t
   std::string blocksIndexes;
   std::string txPool;
   std::string blockchainIndexes;
+  std::string chainStore;
 };
 
 struct FusionTx
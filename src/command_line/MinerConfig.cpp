@@ -14,6 +14,7 @@ namespace cryptonote
 MinerConfig::MinerConfig()
 {
   miningThreads = 0;
+  miningHashWays = 1;
 }
 
 void MinerConfig::initOptions(boost::program_options::options_description &desc)
@@ -22,6 +23,7 @@ void MinerConfig::initOptions(boost::program_options::options_description &desc)
   add_arg(desc, arg_extra_messages);
   add_arg(desc, arg_start_mining);
   add_arg(desc, arg_mining_threads);
+  add_arg(desc, arg_mining_hash_ways);
 }
 
 void MinerConfig::init(const boost::program_options::variables_map &options)
@@ -40,6 +42,11 @@ void MinerConfig::init(const boost::program_options::variables_map &options)
   {
     miningThreads = get_arg(options, arg_mining_threads);
   }
+
+  if (has_arg(options, arg_mining_hash_ways))
+  {
+    miningHashWays = get_arg(options, arg_mining_hash_ways);
+  }
 }
 
 } //namespace cryptonote
@@ -20,6 +20,8 @@ public:
 
   std::string bindIp;
   uint16_t bindPort;
+  // 0 processes requests on the dispatcher of the p2p server
+  uint32_t threads;
 };
 
 }
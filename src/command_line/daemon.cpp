@@ -95,6 +95,11 @@ void Daemon::init()
   addSetting(arg_console);
   addSetting(arg_testnet_on);
   addSetting(arg_print_genesis_tx);
+  addSetting(arg_db_mmap);
+  addSetting(arg_db_index_flush_interval);
+  addSetting(arg_db_index_cache_size);
+  addSetting(arg_db_rebuild_threads);
+  addSetting(arg_block_cache_size);
 }
 
 bool Daemon::checkVersion()
@@ -15,6 +15,11 @@ const arg_descriptor<bool> arg_os_version = {"os-version", ""};
 // Storage
 const arg_descriptor<std::string> arg_data_dir = {"data-dir", "Specify data directory"};
 arg_descriptor<std::string> arg_config_file;
+const arg_descriptor<bool> arg_db_mmap = {"db-mmap", "Read blocks through a read-only memory mapping of the blocks file instead of file streams"};
+const arg_descriptor<uint32_t> arg_db_index_flush_interval = {"db-index-flush-interval", "Number of appended blocks committed to the block index at once", 100};
+const arg_descriptor<uint32_t> arg_db_index_cache_size = {"db-index-cache-size", "Megabytes of output, key image and transaction index pages kept in memory", 256};
+const arg_descriptor<uint32_t> arg_db_rebuild_threads = {"db-rebuild-threads", "Number of threads decoding blocks when the indices are rebuilt, 0 for one per core", 0};
+const arg_descriptor<uint32_t> arg_block_cache_size = {"block-cache-size", "Megabytes of encoded blocks with their transactions kept in memory for block queries", 64};
 
 // Log info
 const arg_descriptor<std::string> arg_log_file = {"log-file", "", ""};
@@ -34,6 +39,7 @@ const arg_descriptor<std::string> arg_extra_messages =  {"extra-messages-file",
 // Mining
 const arg_descriptor<std::string> arg_start_mining =    {"start-mining", "Specify wallet address to mining for", "", true};
 const arg_descriptor<uint32_t>    arg_mining_threads =  {"mining-threads", "Specify mining threads count", 0, true};
+const arg_descriptor<uint32_t>    arg_mining_hash_ways =  {"mining-hash-ways", "Specify how many nonces each mining thread hashes together (1-4)", 1, true};
 
 
 const std::string DEFAULT_RPC_IP = "127.0.0.1";
@@ -41,6 +47,7 @@ const std::string DEFAULT_RPC_IP = "127.0.0.1";
 // RPC
 const arg_descriptor<std::string> arg_rpc_bind_ip = {"rpc-bind-ip", "", DEFAULT_RPC_IP};
 arg_descriptor<uint16_t> arg_rpc_bind_port;
+const arg_descriptor<uint32_t> arg_rpc_threads = {"rpc-threads", "Number of threads processing RPC requests, 0 to process them on the p2p thread", 0};
 
 
 // P2P
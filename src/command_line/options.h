@@ -13,11 +13,17 @@ extern const arg_descriptor<bool> arg_os_version;
 // Core arguments
 extern const arg_descriptor<std::string> arg_data_dir;
 extern const arg_descriptor<bool> arg_print_genesis_tx;
+extern const arg_descriptor<bool> arg_db_mmap;
+extern const arg_descriptor<uint32_t> arg_db_index_flush_interval;
+extern const arg_descriptor<uint32_t> arg_db_index_cache_size;
+extern const arg_descriptor<uint32_t> arg_db_rebuild_threads;
+extern const arg_descriptor<uint32_t> arg_block_cache_size;
 extern arg_descriptor<std::string> arg_config_file;
 
 // RPC arguments
 extern const arg_descriptor<std::string> arg_rpc_bind_ip;
 extern arg_descriptor<uint16_t> arg_rpc_bind_port;
+extern const arg_descriptor<uint32_t> arg_rpc_threads;
 
 // Log/console arguments
 extern const arg_descriptor<std::string> arg_log_file;
@@ -31,6 +37,7 @@ extern const arg_descriptor<bool> arg_testnet_on;
 extern const arg_descriptor<std::string> arg_extra_messages;
 extern const arg_descriptor<std::string> arg_start_mining;
 extern const arg_descriptor<uint32_t> arg_mining_threads;
+extern const arg_descriptor<uint32_t> arg_mining_hash_ways;
 
 // P2P arguments
 extern const arg_descriptor<std::string> arg_p2p_bind_ip;
@@ -0,0 +1,71 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "MappedFile.h"
+
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+namespace Common {
+
+MappedFile::MappedFile() {
+}
+
+MappedFile::~MappedFile() {
+  close();
+}
+
+bool MappedFile::open(const std::string& filename) {
+  close();
+  m_filename = filename;
+  return remap();
+}
+
+bool MappedFile::remap() {
+  m_region.reset();
+  m_mapping.reset();
+
+  boost::system::error_code ec;
+  uintmax_t fileSize = boost::filesystem::file_size(m_filename, ec);
+  if (ec) {
+    return false;
+  }
+
+  // Empty files can not be mapped, leave the view empty but valid.
+  if (fileSize == 0) {
+    return true;
+  }
+
+  try {
+    m_mapping.reset(new boost::interprocess::file_mapping(m_filename.c_str(), boost::interprocess::read_only));
+    m_region.reset(new boost::interprocess::mapped_region(*m_mapping, boost::interprocess::read_only, 0, static_cast<size_t>(fileSize)));
+  } catch (std::exception&) {
+    m_region.reset();
+    m_mapping.reset();
+    return false;
+  }
+
+  return true;
+}
+
+void MappedFile::close() {
+  m_region.reset();
+  m_mapping.reset();
+  m_filename.clear();
+}
+
+bool MappedFile::isOpen() const {
+  return !m_filename.empty();
+}
+
+const uint8_t* MappedFile::data() const {
+  return m_region ? static_cast<const uint8_t*>(m_region->get_address()) : nullptr;
+}
+
+size_t MappedFile::size() const {
+  return m_region ? m_region->get_size() : 0;
+}
+
+}
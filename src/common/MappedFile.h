@@ -0,0 +1,45 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace boost {
+namespace interprocess {
+class file_mapping;
+class mapped_region;
+}
+}
+
+namespace Common {
+
+// Read-only view of a whole file mapped into memory.
+// The view is a snapshot of the file size at 'open' time; call 'remap' after the file grows.
+class MappedFile {
+public:
+  MappedFile();
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  bool open(const std::string& filename);
+  bool remap();
+  void close();
+
+  bool isOpen() const;
+  const uint8_t* data() const;
+  size_t size() const;
+
+private:
+  std::string m_filename;
+  std::unique_ptr<boost::interprocess::file_mapping> m_mapping;
+  std::unique_ptr<boost::interprocess::mapped_region> m_region;
+};
+
+}
@@ -0,0 +1,549 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "PagedHashFile.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <stdexcept>
+
+#include <boost/filesystem.hpp>
+
+#include "file.h"
+
+namespace Common {
+
+namespace {
+
+const uint64_t MAGIC = 0x3130454c49464850; // "PHFILE01"
+
+}
+
+PagedHashFile::PagedHashFile(size_t keySize, size_t valueSize, size_t cachedPages) :
+  m_keySize(keySize),
+  m_valueSize(valueSize),
+  m_recordSize(keySize + valueSize),
+  m_recordsPerPage((PAGE_SIZE - PAGE_HEADER_SIZE) / (keySize + valueSize)),
+  m_cachedPages(cachedPages) {
+  static_assert(sizeof(header_t) <= PAGE_SIZE, "Header does not fit into a page");
+  assert(keySize > 0 && m_recordsPerPage > 0);
+  resetHeader();
+}
+
+PagedHashFile::~PagedHashFile() {
+  close();
+}
+
+bool PagedHashFile::open(const std::string& filename) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_file.close();
+  m_pages.clear();
+  m_lru.clear();
+  m_filename = filename;
+
+  if (!boost::filesystem::exists(filename)) {
+    m_file.open(filename, std::ios::binary | std::ios::out | std::ios::trunc);
+    m_file.close();
+    m_file.open(filename, std::ios::binary | std::ios::in | std::ios::out);
+    resetHeader();
+    if (!m_file || !writeHeader(m_header)) {
+      m_file.close();
+      return false;
+    }
+
+    return true;
+  }
+
+  m_file.open(filename, std::ios::binary | std::ios::in | std::ios::out);
+  if (!m_file) {
+    return false;
+  }
+
+  std::vector<uint8_t> data(PAGE_SIZE);
+  if (!readPage(0, data.data())) {
+    m_file.close();
+    return false;
+  }
+
+  memcpy(&m_header, data.data(), sizeof m_header);
+  if (m_header.magic != MAGIC || m_header.keySize != m_keySize || m_header.valueSize != m_valueSize ||
+    m_header.clean != 1 || m_header.stateSize > MAX_STATE_SIZE) {
+    m_file.close();
+    resetHeader();
+    return false;
+  }
+
+  return true;
+}
+
+void PagedHashFile::close() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_file.close();
+  m_pages.clear();
+  m_lru.clear();
+}
+
+bool PagedHashFile::isOpen() const {
+  return m_file.is_open();
+}
+
+bool PagedHashFile::find(const void* key, void* value) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  std::vector<uint64_t> chain;
+  uint64_t pageId;
+  size_t slot;
+  bool found = locate(key, chain, pageId, slot);
+  if (found && value != nullptr && m_valueSize != 0) {
+    memcpy(value, record(page(pageId), slot) + m_keySize, m_valueSize);
+  }
+
+  trim();
+  return found;
+}
+
+bool PagedHashFile::insert(const void* key, const void* value) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  std::vector<uint64_t> chain;
+  uint64_t pageId;
+  size_t slot;
+  bool inserted = !locate(key, chain, pageId, slot);
+  if (inserted) {
+    add(key, value);
+  }
+
+  trim();
+  return inserted;
+}
+
+void PagedHashFile::put(const void* key, const void* value) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  std::vector<uint64_t> chain;
+  uint64_t pageId;
+  size_t slot;
+  if (locate(key, chain, pageId, slot)) {
+    page_t& target = page(pageId);
+    if (m_valueSize != 0) {
+      memcpy(record(target, slot) + m_keySize, value, m_valueSize);
+    }
+
+    markDirty(target);
+  } else {
+    add(key, value);
+  }
+
+  trim();
+}
+
+bool PagedHashFile::erase(const void* key) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  std::vector<uint64_t> chain;
+  uint64_t pageId;
+  size_t slot;
+  if (!locate(key, chain, pageId, slot)) {
+    trim();
+    return false;
+  }
+
+  for (uint64_t id = nextPage(page(chain.back())); id != 0; id = nextPage(page(id))) {
+    chain.push_back(id);
+  }
+
+  // the last record of the chain fills the hole, so pages stay densely packed
+  uint64_t lastId = chain.back();
+  page_t& last = page(lastId);
+  page_t& target = page(pageId);
+  uint32_t lastCount = recordCount(last);
+  if (lastId != pageId || slot != lastCount - 1) {
+    memcpy(record(target, slot), record(last, lastCount - 1), m_recordSize);
+  }
+
+  setRecordCount(last, lastCount - 1);
+  markDirty(target);
+  markDirty(last);
+
+  if (lastCount == 1 && chain.size() > 1) {
+    page_t& previous = page(chain[chain.size() - 2]);
+    setNextPage(previous, 0);
+    markDirty(previous);
+    freePage(lastId);
+  }
+
+  --m_header.count;
+  trim();
+  return true;
+}
+
+void PagedHashFile::clear() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_pages.clear();
+  m_lru.clear();
+  m_file.close();
+  m_file.open(m_filename, std::ios::binary | std::ios::out | std::ios::trunc);
+  m_file.close();
+  m_file.open(m_filename, std::ios::binary | std::ios::in | std::ios::out);
+  resetHeader();
+  if (!m_file || !writeHeader(m_header)) {
+    throw std::runtime_error("PagedHashFile::clear");
+  }
+}
+
+uint64_t PagedHashFile::size() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_header.count;
+}
+
+void PagedHashFile::forEach(const std::function<void(const uint8_t* key, const uint8_t* value)>& visitor) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  uint64_t buckets = bucketCount();
+  for (uint64_t bucket = 0; bucket < buckets; ++bucket) {
+    for (uint64_t id = bucketPage(bucket); id != 0;) {
+      page_t& current = page(id);
+      uint32_t count = recordCount(current);
+      for (size_t i = 0; i < count; ++i) {
+        visitor(record(current, i), record(current, i) + m_keySize);
+      }
+
+      id = nextPage(current);
+    }
+
+    trim();
+  }
+}
+
+bool PagedHashFile::commit(const std::string& state) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (state.size() > MAX_STATE_SIZE || !m_file.is_open()) {
+    return false;
+  }
+
+  std::vector<uint64_t> dirty;
+  for (const auto& cached : m_pages) {
+    if (cached.second.dirty) {
+      dirty.push_back(cached.first);
+    }
+  }
+
+  std::sort(dirty.begin(), dirty.end());
+
+  if (!dirty.empty()) {
+    header_t invalid = m_header;
+    invalid.clean = 0;
+    if (!writeHeader(invalid)) {
+      return false;
+    }
+
+    for (uint64_t id : dirty) {
+      if (!writePage(id, m_pages[id].data.data())) {
+        return false;
+      }
+    }
+
+    // the pages must be on disk before the header that declares them valid
+    if (!m_file.flush() || !std::file::sync(m_filename)) {
+      return false;
+    }
+  }
+
+  m_header.clean = 1;
+  m_header.stateSize = static_cast<uint32_t>(state.size());
+  memcpy(m_header.state, state.data(), state.size());
+  if (!writeHeader(m_header)) {
+    return false;
+  }
+
+  for (uint64_t id : dirty) {
+    page_t& written = m_pages[id];
+    written.dirty = false;
+    written.lru = m_lru.insert(m_lru.end(), id);
+  }
+
+  trim();
+  return true;
+}
+
+std::string PagedHashFile::state() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return std::string(reinterpret_cast<const char*>(m_header.state), m_header.stateSize);
+}
+
+uint64_t PagedHashFile::hashKey(const void* key) const {
+  // FNV-1a followed by a finalizer, the low bits select the bucket
+  const uint8_t* bytes = static_cast<const uint8_t*>(key);
+  uint64_t hash = 14695981039346656037ULL;
+  for (size_t i = 0; i < m_keySize; ++i) {
+    hash ^= bytes[i];
+    hash *= 1099511628211ULL;
+  }
+
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ULL;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+uint64_t PagedHashFile::bucketOf(uint64_t hash) const {
+  uint64_t size = INITIAL_BUCKETS << m_header.level;
+  uint64_t bucket = hash & (size - 1);
+  if (bucket < m_header.split) {
+    bucket = hash & (2 * size - 1);
+  }
+
+  return bucket;
+}
+
+uint64_t PagedHashFile::bucketCount() const {
+  return (INITIAL_BUCKETS << m_header.level) + m_header.split;
+}
+
+uint64_t PagedHashFile::bucketPage(uint64_t bucket) const {
+  if (bucket < INITIAL_BUCKETS) {
+    return m_header.segments[0] + bucket;
+  }
+
+  size_t segment = 1;
+  uint64_t start = INITIAL_BUCKETS;
+  while (bucket >= start * 2) {
+    start *= 2;
+    ++segment;
+  }
+
+  return m_header.segments[segment] + bucket - start;
+}
+
+bool PagedHashFile::locate(const void* key, std::vector<uint64_t>& chain, uint64_t& pageId, size_t& slot) {
+  chain.clear();
+  // page 0 holds the header, so it terminates chains
+  for (uint64_t id = bucketPage(bucketOf(hashKey(key))); id != 0;) {
+    chain.push_back(id);
+    page_t& current = page(id);
+    uint32_t count = recordCount(current);
+    for (size_t i = 0; i < count; ++i) {
+      if (memcmp(record(current, i), key, m_keySize) == 0) {
+        pageId = id;
+        slot = i;
+        return true;
+      }
+    }
+
+    id = nextPage(current);
+  }
+
+  return false;
+}
+
+void PagedHashFile::add(const void* key, const void* value) {
+  std::vector<uint8_t> newRecord(m_recordSize);
+  memcpy(newRecord.data(), key, m_keySize);
+  if (m_valueSize != 0) {
+    memcpy(newRecord.data() + m_keySize, value, m_valueSize);
+  }
+
+  append(bucketOf(hashKey(key)), newRecord.data());
+  ++m_header.count;
+
+  // keep buckets three quarters full on average
+  if (m_header.count * 4 > bucketCount() * m_recordsPerPage * 3) {
+    split();
+  }
+}
+
+void PagedHashFile::append(uint64_t bucket, const uint8_t* newRecord) {
+  uint64_t id = bucketPage(bucket);
+  for (uint64_t next = nextPage(page(id)); next != 0; next = nextPage(page(id))) {
+    id = next;
+  }
+
+  page_t* last = &page(id);
+  if (recordCount(*last) == m_recordsPerPage) {
+    uint64_t overflowId = allocatePage();
+    setNextPage(*last, overflowId);
+    markDirty(*last);
+    last = &page(overflowId);
+  }
+
+  uint32_t count = recordCount(*last);
+  memcpy(record(*last, count), newRecord, m_recordSize);
+  setRecordCount(*last, count + 1);
+  markDirty(*last);
+}
+
+void PagedHashFile::split() {
+  uint64_t size = INITIAL_BUCKETS << m_header.level;
+  uint64_t oldBucket = m_header.split;
+  uint64_t newBucket = oldBucket + size;
+  if (oldBucket == 0) {
+    // the first split of a level opens the segment for the buckets it adds
+    size_t segment = m_header.level + 1;
+    if (segment >= SEGMENT_COUNT) {
+      return;
+    }
+
+    m_header.segments[segment] = m_header.pageCount;
+    m_header.pageCount += size;
+  }
+
+  std::vector<uint8_t> records;
+  std::vector<uint64_t> overflow;
+  uint64_t primaryId = bucketPage(oldBucket);
+  for (uint64_t id = primaryId; id != 0;) {
+    page_t& current = page(id);
+    uint32_t count = recordCount(current);
+    records.insert(records.end(), record(current, 0), record(current, 0) + count * m_recordSize);
+    if (id != primaryId) {
+      overflow.push_back(id);
+    }
+
+    id = nextPage(current);
+  }
+
+  page_t& primary = page(primaryId);
+  setRecordCount(primary, 0);
+  setNextPage(primary, 0);
+  markDirty(primary);
+  for (uint64_t id : overflow) {
+    freePage(id);
+  }
+
+  for (size_t offset = 0; offset < records.size(); offset += m_recordSize) {
+    uint64_t bucket = hashKey(records.data() + offset) & (2 * size - 1);
+    assert(bucket == oldBucket || bucket == newBucket);
+    append(bucket, records.data() + offset);
+  }
+
+  if (++m_header.split == size) {
+    m_header.split = 0;
+    ++m_header.level;
+  }
+}
+
+PagedHashFile::page_t& PagedHashFile::page(uint64_t id) {
+  auto it = m_pages.find(id);
+  if (it != m_pages.end()) {
+    if (!it->second.dirty) {
+      m_lru.splice(m_lru.end(), m_lru, it->second.lru);
+    }
+
+    return it->second;
+  }
+
+  std::vector<uint8_t> data(PAGE_SIZE);
+  if (!readPage(id, data.data())) {
+    throw std::runtime_error("PagedHashFile::page");
+  }
+
+  page_t& loaded = m_pages[id];
+  loaded.data.swap(data);
+  loaded.dirty = false;
+  loaded.lru = m_lru.insert(m_lru.end(), id);
+  return loaded;
+}
+
+void PagedHashFile::markDirty(page_t& modified) {
+  if (!modified.dirty) {
+    m_lru.erase(modified.lru);
+    modified.dirty = true;
+  }
+}
+
+uint64_t PagedHashFile::allocatePage() {
+  uint64_t id;
+  if (m_header.freePage != 0) {
+    id = m_header.freePage;
+    m_header.freePage = nextPage(page(id));
+  } else {
+    id = m_header.pageCount++;
+  }
+
+  page_t& allocated = page(id);
+  std::fill(allocated.data.begin(), allocated.data.end(), 0);
+  markDirty(allocated);
+  return id;
+}
+
+void PagedHashFile::freePage(uint64_t id) {
+  page_t& freed = page(id);
+  std::fill(freed.data.begin(), freed.data.end(), 0);
+  setNextPage(freed, m_header.freePage);
+  markDirty(freed);
+  m_header.freePage = id;
+}
+
+// Only called between operations, page references handed out inside an operation stay valid
+void PagedHashFile::trim() {
+  while (m_lru.size() > m_cachedPages) {
+    m_pages.erase(m_lru.front());
+    m_lru.pop_front();
+  }
+}
+
+uint8_t* PagedHashFile::record(page_t& current, size_t slot) {
+  return current.data.data() + PAGE_HEADER_SIZE + slot * m_recordSize;
+}
+
+uint32_t PagedHashFile::recordCount(const page_t& current) {
+  uint32_t count;
+  memcpy(&count, current.data.data(), sizeof count);
+  return count;
+}
+
+void PagedHashFile::setRecordCount(page_t& current, uint32_t count) {
+  memcpy(current.data.data(), &count, sizeof count);
+}
+
+uint64_t PagedHashFile::nextPage(const page_t& current) {
+  uint64_t next;
+  memcpy(&next, current.data.data() + 8, sizeof next);
+  return next;
+}
+
+void PagedHashFile::setNextPage(page_t& current, uint64_t next) {
+  memcpy(current.data.data() + 8, &next, sizeof next);
+}
+
+void PagedHashFile::resetHeader() {
+  memset(&m_header, 0, sizeof m_header);
+  m_header.magic = MAGIC;
+  m_header.keySize = static_cast<uint32_t>(m_keySize);
+  m_header.valueSize = static_cast<uint32_t>(m_valueSize);
+  m_header.clean = 1;
+  m_header.segments[0] = 1;
+  m_header.pageCount = 1 + INITIAL_BUCKETS;
+}
+
+bool PagedHashFile::writeHeader(const header_t& header) {
+  std::vector<uint8_t> data(PAGE_SIZE, 0);
+  memcpy(data.data(), &header, sizeof header);
+  return writePage(0, data.data()) && m_file.flush() && std::file::sync(m_filename);
+}
+
+bool PagedHashFile::readPage(uint64_t id, uint8_t* data) {
+  m_file.clear();
+  if (!m_file.seekg(static_cast<std::streamoff>(id * PAGE_SIZE))) {
+    return false;
+  }
+
+  if (m_file.read(reinterpret_cast<char*>(data), PAGE_SIZE)) {
+    return true;
+  }
+
+  // pages allocated but never written lie past the end of the file and read as empty
+  if (m_file.bad() || !m_file.eof()) {
+    return false;
+  }
+
+  std::fill(data + m_file.gcount(), data + PAGE_SIZE, 0);
+  m_file.clear();
+  return true;
+}
+
+bool PagedHashFile::writePage(uint64_t id, const uint8_t* data) {
+  m_file.clear();
+  m_file.seekp(static_cast<std::streamoff>(id * PAGE_SIZE));
+  return !!m_file.write(reinterpret_cast<const char*>(data), PAGE_SIZE);
+}
+
+}
@@ -0,0 +1,132 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Common {
+
+// Linear hash table of fixed-size records kept in the pages of a single file.
+// Pages are read on demand into a bounded cache. Modified pages stay in memory until 'commit', which writes
+// them behind an invalidated header and syncs them to disk before the valid header, so a file left half-written
+// by a crash or a power loss is refused by 'open'.
+// A page that can not be read from the file makes the operation throw std::runtime_error.
+class PagedHashFile {
+public:
+  static const size_t PAGE_SIZE = 4096;
+  static const size_t MAX_STATE_SIZE = 256;
+
+  PagedHashFile(size_t keySize, size_t valueSize, size_t cachedPages = 256);
+  ~PagedHashFile();
+
+  PagedHashFile(const PagedHashFile&) = delete;
+  PagedHashFile& operator=(const PagedHashFile&) = delete;
+
+  // Creates an empty table if the file does not exist. Fails if the file has another record layout
+  // or was not completely committed.
+  bool open(const std::string& filename);
+  // Uncommitted changes are dropped
+  void close();
+  bool isOpen() const;
+
+  // 'value' may be null when only the presence of the key is needed
+  bool find(const void* key, void* value);
+  // Returns false if the key is already present
+  bool insert(const void* key, const void* value);
+  // Inserts the record or overwrites the value of an existing one
+  void put(const void* key, const void* value);
+  bool erase(const void* key);
+  // Truncates the file, the empty table is committed with an empty state
+  void clear();
+  uint64_t size();
+  void forEach(const std::function<void(const uint8_t* key, const uint8_t* value)>& visitor);
+
+  // Writes all modified pages and records 'state' (at most MAX_STATE_SIZE bytes) along with them
+  bool commit(const std::string& state);
+  // State passed to the last commit
+  std::string state();
+
+  size_t cachedPages() const { return m_cachedPages; }
+  void setCachedPages(size_t count) { m_cachedPages = count; }
+
+private:
+  static const uint64_t INITIAL_BUCKETS = 64;
+  static const size_t SEGMENT_COUNT = 48;
+  static const size_t PAGE_HEADER_SIZE = 16;
+
+  struct header_t {
+    uint64_t magic;
+    uint32_t keySize;
+    uint32_t valueSize;
+    uint32_t clean;
+    uint32_t level;
+    uint64_t split;
+    uint64_t count;
+    uint64_t pageCount;
+    uint64_t freePage;
+    // First page of every group of buckets created together, group 0 holds INITIAL_BUCKETS buckets and
+    // group n > 0 holds INITIAL_BUCKETS << (n - 1)
+    uint64_t segments[SEGMENT_COUNT];
+    uint32_t stateSize;
+    uint8_t state[MAX_STATE_SIZE];
+  };
+
+  struct page_t {
+    std::vector<uint8_t> data;
+    bool dirty;
+    std::list<uint64_t>::iterator lru;
+  };
+
+  uint64_t hashKey(const void* key) const;
+  uint64_t bucketOf(uint64_t hash) const;
+  uint64_t bucketCount() const;
+  uint64_t bucketPage(uint64_t bucket) const;
+  bool locate(const void* key, std::vector<uint64_t>& chain, uint64_t& pageId, size_t& slot);
+  void add(const void* key, const void* value);
+  void append(uint64_t bucket, const uint8_t* record);
+  void split();
+
+  page_t& page(uint64_t id);
+  void markDirty(page_t& page);
+  uint64_t allocatePage();
+  void freePage(uint64_t id);
+  void trim();
+
+  uint8_t* record(page_t& page, size_t slot);
+  static uint32_t recordCount(const page_t& page);
+  static void setRecordCount(page_t& page, uint32_t count);
+  static uint64_t nextPage(const page_t& page);
+  static void setNextPage(page_t& page, uint64_t next);
+
+  void resetHeader();
+  bool writeHeader(const header_t& header);
+  bool readPage(uint64_t id, uint8_t* data);
+  bool writePage(uint64_t id, const uint8_t* data);
+
+  const size_t m_keySize;
+  const size_t m_valueSize;
+  const size_t m_recordSize;
+  const size_t m_recordsPerPage;
+  size_t m_cachedPages;
+
+  std::string m_filename;
+  std::fstream m_file;
+  header_t m_header;
+  std::unordered_map<uint64_t, page_t> m_pages;
+  // Clean pages in least recently used order, dirty pages are not evictable and kept out of it
+  std::list<uint64_t> m_lru;
+  // find is called by concurrent readers, the page cache is shared state
+  std::mutex m_mutex;
+};
+
+}
@@ -0,0 +1,105 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "RecursiveSharedMutex.h"
+
+#include <cassert>
+#include <stdexcept>
+
+namespace Tools {
+
+RecursiveSharedMutex::RecursiveSharedMutex() : m_ownerDepth(0), m_waitingWriters(0) {
+}
+
+void RecursiveSharedMutex::lock() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  std::thread::id self = std::this_thread::get_id();
+  if (m_owner == self) {
+    ++m_ownerDepth;
+    return;
+  }
+
+  // Two readers upgrading at once would wait for each other forever
+  if (m_readers.count(self) != 0) {
+    throw std::logic_error("RecursiveSharedMutex: shared lock can not be upgraded to exclusive");
+  }
+
+  ++m_waitingWriters;
+  m_released.wait(lock, [this] { return m_owner == std::thread::id() && m_readers.empty(); });
+  --m_waitingWriters;
+
+  m_owner = self;
+  m_ownerDepth = 1;
+}
+
+bool RecursiveSharedMutex::try_lock() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  std::thread::id self = std::this_thread::get_id();
+  if (m_owner == self) {
+    ++m_ownerDepth;
+    return true;
+  }
+
+  if (m_owner != std::thread::id() || !m_readers.empty()) {
+    return false;
+  }
+
+  m_owner = self;
+  m_ownerDepth = 1;
+  return true;
+}
+
+void RecursiveSharedMutex::unlock() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  assert(m_owner == std::this_thread::get_id());
+  if (--m_ownerDepth == 0) {
+    m_owner = std::thread::id();
+    lock.unlock();
+    m_released.notify_all();
+  }
+}
+
+void RecursiveSharedMutex::lock_shared() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  std::thread::id self = std::this_thread::get_id();
+  if (m_owner == self) {
+    ++m_ownerDepth;
+    return;
+  }
+
+  auto it = m_readers.find(self);
+  if (it != m_readers.end()) {
+    ++it->second;
+    return;
+  }
+
+  m_released.wait(lock, [this] { return m_owner == std::thread::id() && m_waitingWriters == 0; });
+  m_readers.emplace(self, 1);
+}
+
+void RecursiveSharedMutex::unlock_shared() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  std::thread::id self = std::this_thread::get_id();
+  if (m_owner == self) {
+    if (--m_ownerDepth == 0) {
+      m_owner = std::thread::id();
+      lock.unlock();
+      m_released.notify_all();
+    }
+
+    return;
+  }
+
+  auto it = m_readers.find(self);
+  assert(it != m_readers.end());
+  if (--it->second == 0) {
+    m_readers.erase(it);
+    if (m_readers.empty()) {
+      lock.unlock();
+      m_released.notify_all();
+    }
+  }
+}
+
+}
@@ -0,0 +1,60 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace Tools {
+
+// Reader/writer mutex where both modes are recursive.
+// The exclusive owner may also take shared locks. A thread that already holds a shared lock
+// is never blocked by waiting writers, but it can not request exclusive ownership: lock() throws std::logic_error.
+// Waiting writers block new readers, so block import is not starved by a stream of queries.
+class RecursiveSharedMutex {
+public:
+  RecursiveSharedMutex();
+  RecursiveSharedMutex(const RecursiveSharedMutex&) = delete;
+  RecursiveSharedMutex& operator=(const RecursiveSharedMutex&) = delete;
+
+  void lock();
+  bool try_lock();
+  void unlock();
+
+  void lock_shared();
+  void unlock_shared();
+
+private:
+  std::mutex m_mutex;
+  std::condition_variable m_released;
+  std::thread::id m_owner;
+  size_t m_ownerDepth;
+  size_t m_waitingWriters;
+  std::unordered_map<std::thread::id, size_t> m_readers;
+};
+
+// Shared counterpart of std::lock_guard.
+template<typename Mutex>
+class SharedLockGuard {
+public:
+  explicit SharedLockGuard(Mutex& mutex) : m_mutex(mutex) {
+    m_mutex.lock_shared();
+  }
+
+  ~SharedLockGuard() {
+    m_mutex.unlock_shared();
+  }
+
+  SharedLockGuard(const SharedLockGuard&) = delete;
+  SharedLockGuard& operator=(const SharedLockGuard&) = delete;
+
+private:
+  Mutex& m_mutex;
+};
+
+}
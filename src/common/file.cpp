@@ -3,6 +3,13 @@
 #include <string>
 #include <cstdio>
 
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 namespace std
 {
 namespace file
@@ -82,5 +89,29 @@ bool read(const string &filename, char *data, size_t size, bool forceCreate)
   fs.read(data, size);
   return !!fs;
 }
+
+bool sync(const string &filename)
+{
+#ifdef _WIN32
+  HANDLE handle = CreateFileA(filename.c_str(), GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING,
+    FILE_ATTRIBUTE_NORMAL, NULL);
+  if (handle == INVALID_HANDLE_VALUE)
+  {
+    return false;
+  }
+  bool synced = FlushFileBuffers(handle) != 0;
+  CloseHandle(handle);
+  return synced;
+#else
+  int fd = ::open(filename.c_str(), O_RDWR);
+  if (fd < 0)
+  {
+    return false;
+  }
+  bool synced = fsync(fd) == 0;
+  close(fd);
+  return synced;
+#endif
+}
 } // namespace file
 } // namespace std
\ No newline at end of file
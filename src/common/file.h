@@ -11,5 +11,7 @@ bool create(const string &filename);
 fstream open(const string &filename, bool forceCreate = false);
 bool write(const string &filename, const char *data, size_t size, size_t offset = 0, bool forceCreate = false);
 bool read(const string &filename, char *data, size_t size, bool forceCreate = false);
+// Waits until the written data of the file reached the disk, a flushed stream only hands it to the OS
+bool sync(const string &filename);
 } // namespace file
 } // namespace std
@@ -69,6 +69,7 @@ struct filename_t
   const char *blockIndex;
   const char *blockCache;
   const char *blockChainIndex;
+  const char *chainStore;
   const char *pool;
   const char *p2p;
   const char *miner;
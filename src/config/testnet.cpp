@@ -31,6 +31,7 @@ const char CRYPTONOTE_BLOCKSCACHE_FILENAME[] = "blockscache.dat";
 const char CRYPTONOTE_POOLDATA_FILENAME[] = "poolstate.bin";
 const char P2P_NET_DATA_FILENAME[] = "p2pstate.bin";
 const char CRYPTONOTE_BLOCKCHAIN_INDICES_FILENAME[] = "blockchainindices.dat";
+const char CRYPTONOTE_CHAIN_STORE_DIRNAME[] = "chainstore";
 const char MINER_CONFIG_FILE_NAME[] = "miner_conf.json";
 
 seeds_t seeds = {
@@ -49,13 +50,14 @@ filename_t filenames =
      CRYPTONOTE_BLOCKINDEXES_FILENAME,
      CRYPTONOTE_BLOCKSCACHE_FILENAME,
      CRYPTONOTE_BLOCKCHAIN_INDICES_FILENAME,
+     CRYPTONOTE_CHAIN_STORE_DIRNAME,
      CRYPTONOTE_POOLDATA_FILENAME,
      P2P_NET_DATA_FILENAME,
      MINER_CONFIG_FILE_NAME};
 
 storage_version_t storage = {
     {1, 0, 0},
-    {1, 0, 0}};
+    {2, 0, 0}};
 
 } // namespace
 config_t data = {
@@ -3,13 +3,18 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <alloca.h>
+#include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
+#include <list>
 #include <memory>
 #include <mutex>
+#include <unordered_map>
+#include <vector>
 
 #include "common/varint.h"
 #include "crypto.h"
@@ -41,6 +46,132 @@ namespace crypto {
     sc_reduce32(reinterpret_cast<unsigned char*>(&res));
   }
 
+  static void hash_to_ec(const public_key_t &key, ge_p3 &res);
+
+  /* Decompressed public keys, with the point hash_to_ec gives for them once a ring signature needed it. Split in
+   * shards, each with its own lock and least recently used order, so that verifying threads rarely wait for each
+   * other. The points are computed outside of the lock.
+   */
+  class point_cache {
+  public:
+    point_cache() : shard_capacity(DEFAULT_PUBLIC_KEY_CACHE_SIZE / SHARD_COUNT), hits(0), misses(0) {
+    }
+
+    /* Returns false if 'key' is not a point. 'hash_point' may be null.
+     */
+    bool load(const public_key_t &key, ge_p3 &point, ge_p3 *hash_point) {
+      size_t capacity = shard_capacity.load(std::memory_order_relaxed);
+      if (capacity == 0) {
+        return compute(key, point, hash_point);
+      }
+
+      shard &s = shards[reinterpret_cast<const unsigned char*>(&key)[sizeof(size_t)] % SHARD_COUNT];
+      {
+        lock_guard<mutex> lock(s.lock);
+        auto it = s.index.find(key);
+        if (it != s.index.end() && (hash_point == nullptr || it->second->has_hash_point)) {
+          s.entries.splice(s.entries.begin(), s.entries, it->second);
+          point = it->second->point;
+          if (hash_point != nullptr) {
+            *hash_point = it->second->hash_point;
+          }
+
+          hits.fetch_add(1, std::memory_order_relaxed);
+          return true;
+        }
+      }
+
+      misses.fetch_add(1, std::memory_order_relaxed);
+      if (!compute(key, point, hash_point)) {
+        return false;
+      }
+
+      lock_guard<mutex> lock(s.lock);
+      auto it = s.index.find(key);
+      if (it == s.index.end()) {
+        s.entries.emplace_front();
+        it = s.index.emplace(key, s.entries.begin()).first;
+        it->second->key = key;
+        it->second->has_hash_point = false;
+      } else {
+        s.entries.splice(s.entries.begin(), s.entries, it->second);
+      }
+
+      it->second->point = point;
+      if (hash_point != nullptr) {
+        it->second->hash_point = *hash_point;
+        it->second->has_hash_point = true;
+      }
+
+      trim(s, capacity);
+      return true;
+    }
+
+    void set_size(size_t entries) {
+      size_t capacity = entries == 0 ? 0 : (entries + SHARD_COUNT - 1) / SHARD_COUNT;
+      shard_capacity.store(capacity, std::memory_order_relaxed);
+      for (shard &s : shards) {
+        lock_guard<mutex> lock(s.lock);
+        trim(s, capacity);
+      }
+    }
+
+    void get_stats(uint64_t &hit_count, uint64_t &miss_count) const {
+      hit_count = hits.load(std::memory_order_relaxed);
+      miss_count = misses.load(std::memory_order_relaxed);
+    }
+
+  private:
+    static const size_t SHARD_COUNT = 16;
+
+    struct entry {
+      public_key_t key;
+      ge_p3 point;
+      ge_p3 hash_point;
+      bool has_hash_point;
+    };
+
+    struct shard {
+      mutex lock;
+      std::list<entry> entries;
+      std::unordered_map<public_key_t, std::list<entry>::iterator> index;
+    };
+
+    static bool compute(const public_key_t &key, ge_p3 &point, ge_p3 *hash_point) {
+      if (ge_frombytes_vartime(&point, reinterpret_cast<const unsigned char*>(&key)) != 0) {
+        return false;
+      }
+
+      if (hash_point != nullptr) {
+        hash_to_ec(key, *hash_point);
+      }
+
+      return true;
+    }
+
+    static void trim(shard &s, size_t capacity) {
+      while (s.entries.size() > capacity) {
+        s.index.erase(s.entries.back().key);
+        s.entries.pop_back();
+      }
+    }
+
+    shard shards[SHARD_COUNT];
+    std::atomic<size_t> shard_capacity;
+    std::atomic<uint64_t> hits;
+    std::atomic<uint64_t> misses;
+  };
+
+  static point_cache public_key_cache;
+
+  void set_public_key_cache_size(size_t entries) {
+    public_key_cache.set_size(entries);
+  }
+
+  void get_public_key_cache_stats(uint64_t &hits, uint64_t &misses) {
+    public_key_cache.get_stats(hits, misses);
+  }
+
   void crypto_ops::generate_keys(public_key_t &pub, secret_key_t &sec) {
     lock_guard<mutex> lock(random_lock);
     ge_p3 point;
@@ -69,7 +200,7 @@ namespace crypto {
     ge_p2 point2;
     ge_p1p1 point3;
     assert(sc_check(reinterpret_cast<const unsigned char*>(&key2)) == 0);
-    if (ge_frombytes_vartime(&point, reinterpret_cast<const unsigned char*>(&key1)) != 0) {
+    if (!public_key_cache.load(key1, point, nullptr)) {
       return false;
     }
     ge_scalarmult(&point2, reinterpret_cast<const unsigned char*>(&key2), &point);
@@ -114,7 +245,7 @@ namespace crypto {
     ge_cached point3;
     ge_p1p1 point4;
     ge_p2 point5;
-    if (ge_frombytes_vartime(&point1, reinterpret_cast<const unsigned char*>(&base)) != 0) {
+    if (!public_key_cache.load(base, point1, nullptr)) {
       return false;
     }
     derivation_to_scalar(derivation, output_index, scalar);
@@ -134,7 +265,7 @@ namespace crypto {
     ge_cached point3;
     ge_p1p1 point4;
     ge_p2 point5;
-    if (ge_frombytes_vartime(&point1, reinterpret_cast<const unsigned char*>(&base)) != 0) {
+    if (!public_key_cache.load(base, point1, nullptr)) {
       return false;
     }
     derivation_to_scalar(derivation, output_index, suffix, suffixLength, scalar);
@@ -392,40 +523,80 @@ namespace crypto {
   bool crypto_ops::check_ring_signature(const hash_t &prefix_hash, const key_image_t &image,
     const public_key_t *const *pubs, size_t pubs_count,
     const signature_t *sig) {
-    size_t i;
-    ge_p3 image_unp;
-    ge_dsmp image_pre;
-    elliptic_curve_scalar_t sum, h;
-    rs_comm *const buf = reinterpret_cast<rs_comm *>(alloca(rs_comm_size(pubs_count)));
-#if !defined(NDEBUG)
-    for (i = 0; i < pubs_count; i++) {
-      assert(check_key(*pubs[i]));
+    public_key_t *const keys = reinterpret_cast<public_key_t *>(alloca(pubs_count * sizeof(public_key_t)));
+    for (size_t i = 0; i < pubs_count; i++) {
+      keys[i] = *pubs[i];
     }
-#endif
-    if (ge_frombytes_vartime(&image_unp, reinterpret_cast<const unsigned char*>(&image)) != 0) {
-      return false;
+    ring_signature_batch_item_t item = { &prefix_hash, &image, keys, pubs_count, sig };
+    size_t failed_index;
+    return check_ring_signatures(&item, 1, failed_index);
+  }
+
+  bool crypto_ops::check_ring_signatures(const ring_signature_batch_item_t *items, size_t count, size_t &failed_index) {
+    size_t point_count = 0;
+    size_t comm_size = 0;
+    for (size_t i = 0; i < count; i++) {
+      point_count += 2 * items[i].pubs_count;
+      comm_size = std::max(comm_size, rs_comm_size(items[i].pubs_count));
     }
-    ge_dsm_precomp(image_pre, &image_unp);
-    sc_0(reinterpret_cast<unsigned char*>(&sum));
-    buf->h = prefix_hash;
-    for (i = 0; i < pubs_count; i++) {
-      ge_p2 tmp2;
-      ge_p3 tmp3;
-      if (sc_check(reinterpret_cast<const unsigned char*>(&sig[i])) != 0 || sc_check(reinterpret_cast<const unsigned char*>(&sig[i]) + 32) != 0) {
+
+    // a_i and b_i of every ring member, in the order they are hashed
+    std::vector<ge_p2> points(point_count);
+    std::unique_ptr<fe[]> scratch(new fe[point_count]);
+    std::vector<unsigned char> encoded(32 * point_count);
+    std::vector<elliptic_curve_scalar_t> sums(count);
+    ge_p2 *point = points.data();
+    for (size_t i = 0; i < count; i++) {
+      const ring_signature_batch_item_t &item = items[i];
+      ge_p3 image_unp;
+      ge_dsmp image_pre;
+#if !defined(NDEBUG)
+      for (size_t j = 0; j < item.pubs_count; j++) {
+        assert(check_key(item.pubs[j]));
+      }
+#endif
+      if (ge_frombytes_vartime(&image_unp, reinterpret_cast<const unsigned char*>(item.image)) != 0) {
+        failed_index = i;
         return false;
       }
-      if (ge_frombytes_vartime(&tmp3, reinterpret_cast<const unsigned char*>(&*pubs[i])) != 0) {
-        abort();
+      ge_dsm_precomp(image_pre, &image_unp);
+      sc_0(reinterpret_cast<unsigned char*>(&sums[i]));
+      for (size_t j = 0; j < item.pubs_count; j++) {
+        const unsigned char *sig = reinterpret_cast<const unsigned char*>(&item.sigs[j]);
+        ge_p3 tmp3;
+        ge_p3 hash_point;
+        if (sc_check(sig) != 0 || sc_check(sig + 32) != 0) {
+          failed_index = i;
+          return false;
+        }
+        if (!public_key_cache.load(item.pubs[j], tmp3, &hash_point)) {
+          abort();
+        }
+        ge_double_scalarmult_base_vartime(point++, sig, &tmp3, sig + 32);
+        ge_double_scalarmult_precomp_vartime(point++, sig + 32, &hash_point, sig, image_pre);
+        sc_add(reinterpret_cast<unsigned char*>(&sums[i]), reinterpret_cast<unsigned char*>(&sums[i]), sig);
+      }
+    }
+
+    ge_tobytes_batch(encoded.data(), points.data(), point_count, scratch.get());
+
+    rs_comm *const buf = reinterpret_cast<rs_comm *>(alloca(comm_size));
+    const unsigned char *ring_points = encoded.data();
+    for (size_t i = 0; i < count; i++) {
+      const ring_signature_batch_item_t &item = items[i];
+      elliptic_curve_scalar_t h;
+      buf->h = *item.prefix_hash;
+      memcpy(buf->ab, ring_points, 64 * item.pubs_count);
+      ring_points += 64 * item.pubs_count;
+      hash_to_scalar(buf, rs_comm_size(item.pubs_count), h);
+      sc_sub(reinterpret_cast<unsigned char*>(&h), reinterpret_cast<unsigned char*>(&h), reinterpret_cast<unsigned char*>(&sums[i]));
+      if (sc_isnonzero(reinterpret_cast<unsigned char*>(&h)) != 0) {
+        failed_index = i;
+        return false;
       }
-      ge_double_scalarmult_base_vartime(&tmp2, reinterpret_cast<const unsigned char*>(&sig[i]), &tmp3, reinterpret_cast<const unsigned char*>(&sig[i]) + 32);
-      ge_tobytes(reinterpret_cast<unsigned char*>(&buf->ab[i].a), &tmp2);
-      hash_to_ec(*pubs[i], tmp3);
-      ge_double_scalarmult_precomp_vartime(&tmp2, reinterpret_cast<const unsigned char*>(&sig[i]) + 32, &tmp3, reinterpret_cast<const unsigned char*>(&sig[i]), image_pre);
-      ge_tobytes(reinterpret_cast<unsigned char*>(&buf->ab[i].b), &tmp2);
-      sc_add(reinterpret_cast<unsigned char*>(&sum), reinterpret_cast<unsigned char*>(&sum), reinterpret_cast<const unsigned char*>(&sig[i]));
     }
-    hash_to_scalar(buf, rs_comm_size(pubs_count), h);
-    sc_sub(reinterpret_cast<unsigned char*>(&h), reinterpret_cast<unsigned char*>(&h), reinterpret_cast<unsigned char*>(&sum));
-    return sc_isnonzero(reinterpret_cast<unsigned char*>(&h)) == 0;
+
+    return true;
   }
+
 }
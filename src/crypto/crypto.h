@@ -31,6 +31,16 @@ struct elliptic_curve_scalar_t {
   uint8_t data[32];
 };
 
+  /* One ring signature of a batch, it points to data owned by the caller.
+   */
+  struct ring_signature_batch_item_t {
+    const hash_t *prefix_hash;
+    const key_image_t *image;
+    const public_key_t *pubs;
+    size_t pubs_count;
+    const signature_t *sigs;
+  };
+
   class crypto_ops {
     crypto_ops();
     crypto_ops(const crypto_ops &);
@@ -79,6 +89,8 @@ struct elliptic_curve_scalar_t {
       const public_key_t *const *, size_t, const signature_t *);
     friend bool check_ring_signature(const hash_t &, const key_image_t &,
       const public_key_t *const *, size_t, const signature_t *);
+    static bool check_ring_signatures(const ring_signature_batch_item_t *, size_t, size_t &);
+    friend bool check_ring_signatures(const ring_signature_batch_item_t *, size_t, size_t &);
   };
 
   /* Generate a value filled with random bytes.
@@ -222,6 +234,14 @@ struct elliptic_curve_scalar_t {
     return crypto_ops::check_ring_signature(prefix_hash, image, pubs, pubs_count, sig);
   }
 
+  /* Checks a batch of ring signatures together. The points of all the rings are encoded with a single field
+   * inversion instead of two per ring member, so a batch is cheaper than checking its rings one by one. Each
+   * ring still has its own challenge hash, so on failure 'failed_index' is the ring found invalid first.
+   */
+  inline bool check_ring_signatures(const ring_signature_batch_item_t *items, size_t count, size_t &failed_index) {
+    return crypto_ops::check_ring_signatures(items, count, failed_index);
+  }
+
   /* Variants with vector<const public_key_t *> parameters.
    */
   inline void generate_ring_signature(const hash_t &prefix_hash, const key_image_t &image,
@@ -235,6 +255,17 @@ struct elliptic_curve_scalar_t {
     const signature_t *sig) {
     return check_ring_signature(prefix_hash, image, pubs.data(), pubs.size(), sig);
   }
+  inline bool check_ring_signatures(const std::vector<ring_signature_batch_item_t> &items, size_t &failed_index) {
+    return check_ring_signatures(items.data(), items.size(), failed_index);
+  }
+
+  /* Public keys decompressed by ring signature checks and key derivations are kept in a bounded cache shared by all
+   * threads, as the same outputs are ring members again and again and a wallet derives from the same keys.
+   * 'entries' is the number of keys kept, 0 disables the cache.
+   */
+  const size_t DEFAULT_PUBLIC_KEY_CACHE_SIZE = 16384;
+  void set_public_key_cache_size(size_t entries);
+  void get_public_key_cache_stats(uint64_t &hits, uint64_t &misses);
 
 }
 
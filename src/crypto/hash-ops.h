@@ -54,6 +54,29 @@ void cn_fast_hash(const void *data, size_t length, char *hash);
 
 void cn_slow_hash(const void *data, size_t length, char *hash, int variant, int prehashed);
 
+enum {
+  CN_SLOW_HASH_MAX_WAYS = 4
+};
+
+void cn_slow_hash_multi(const void *const *data, size_t length, char *hash, size_t ways, int variant);
+void slow_hash_free_multi_state(void);
+
+/* Kinds of pages backing a slow hash scratchpad */
+enum {
+  SLOW_HASH_PAGES_NONE,        /* the thread has no scratchpad */
+  SLOW_HASH_PAGES_SMALL,
+  SLOW_HASH_PAGES_TRANSPARENT, /* transparent huge pages were requested, the kernel may still use small ones */
+  SLOW_HASH_PAGES_HUGE
+};
+
+/* Scratchpads are taken from a process-wide pool and go back to it when their thread exits */
+void slow_hash_allocate_state(void);
+void slow_hash_free_state(void);
+/* SLOW_HASH_PAGES_* kind of the scratchpad of the calling thread */
+int slow_hash_state_pages(void);
+/* Scratchpads alive by kind, counts has SLOW_HASH_PAGES_HUGE + 1 entries, and how many of them are pooled */
+void slow_hash_get_scratchpad_counts(size_t *counts, size_t *pooled);
+
 void hash_extra_blake(const void *data, size_t length, char *hash);
 void hash_extra_groestl(const void *data, size_t length, char *hash);
 void hash_extra_jh(const void *data, size_t length, char *hash);
@@ -33,6 +33,21 @@ namespace crypto {
     cn_slow_hash(data, length, reinterpret_cast<char *>(&hash), variant, 0/*prehashed*/);
   }
 
+  // Hashes 'ways' inputs of the same length, interleaving their memory-hard loops in one thread
+  inline void cn_slow_hash_multi(const void *const *data, std::size_t length, hash_t *hashes, size_t ways, int variant = 0) {
+    cn_slow_hash_multi(data, length, reinterpret_cast<char *>(hashes), ways, variant);
+  }
+
+  // Describes a SLOW_HASH_PAGES_* kind for logs
+  inline const char *slow_hash_pages_name(int pages) {
+    switch (pages) {
+    case SLOW_HASH_PAGES_SMALL: return "small pages";
+    case SLOW_HASH_PAGES_TRANSPARENT: return "transparent huge pages";
+    case SLOW_HASH_PAGES_HUGE: return "huge pages";
+    default: return "a scratchpad per hash";
+    }
+  }
+
   inline void tree_hash(const hash_t *hashes, size_t count, hash_t &root_hash) {
     tree_hash(reinterpret_cast<const char (*)[HASH_SIZE]>(hashes), count, reinterpret_cast<char *>(&root_hash));
   }
@@ -243,6 +243,7 @@ extern void aesb_pseudo_round(const uint8_t *in, uint8_t *out, const uint8_t *ex
 #endif
 #else
 #include <wmmintrin.h>
+#include <pthread.h>
 #include <sys/mman.h>
 #define STATIC static
 #define INLINE inline
@@ -332,7 +333,6 @@ union cn_slow_hash_state
 #pragma pack(pop)
 
 THREADV uint8_t *hp_state = NULL;
-THREADV int hp_allocated = 0;
 
 #if defined(_MSC_VER)
 #define cpuid(info,x)    __cpuidex(info,x,0)
@@ -603,69 +603,265 @@ BOOL SetLockPagesPrivilege(HANDLE hProcess, BOOL bEnable)
 }
 #endif
 
+/* A 2MB scratch buffer and the kind of pages backing it */
+struct scratchpad
+{
+    uint8_t *memory;
+    int pages;
+    int mapped;
+};
+
+/*
+ * Scratchpads given back by threads, reused before mapping new ones. Threads that hash
+ * come and go (block import workers, miner threads, RPC handlers), and mapping huge
+ * pages for each of them is slow and may fail once the reserved ones are in use.
+ */
+#define SCRATCHPAD_POOL_SIZE 32
+
+static struct scratchpad scratchpad_pool[SCRATCHPAD_POOL_SIZE];
+static size_t scratchpad_pool_count = 0;
+/* scratchpads alive, pooled ones included, by SLOW_HASH_PAGES_* kind */
+static size_t scratchpad_counts[SLOW_HASH_PAGES_HUGE + 1];
+
+/* hp_pads[0] is hp_state, the others are the additional scratchpads of cn_slow_hash_multi */
+THREADV struct scratchpad hp_pads[CN_SLOW_HASH_MAX_WAYS];
+THREADV int hp_registered = 0;
+
+static void scratchpad_release_all(struct scratchpad *pads, size_t from);
+
+#if defined(_MSC_VER) || defined(__MINGW32__)
+static SRWLOCK scratchpad_lock = SRWLOCK_INIT;
+static INIT_ONCE scratchpad_once = INIT_ONCE_STATIC_INIT;
+static DWORD scratchpad_fls = FLS_OUT_OF_INDEXES;
+
+#define scratchpad_lock_acquire() AcquireSRWLockExclusive(&scratchpad_lock)
+#define scratchpad_lock_release() ReleaseSRWLockExclusive(&scratchpad_lock)
+
+static VOID WINAPI scratchpad_thread_exit(PVOID pads)
+{
+    if(pads != NULL)
+        scratchpad_release_all((struct scratchpad *) pads, 0);
+}
+
+static BOOL CALLBACK scratchpad_create_key(PINIT_ONCE once, PVOID parameter, PVOID *context)
+{
+    scratchpad_fls = FlsAlloc(scratchpad_thread_exit);
+    return TRUE;
+}
+
+static void scratchpad_register_thread(void)
+{
+    InitOnceExecuteOnce(&scratchpad_once, scratchpad_create_key, NULL, NULL);
+    if(scratchpad_fls != FLS_OUT_OF_INDEXES)
+        FlsSetValue(scratchpad_fls, hp_pads);
+}
+#else
+static pthread_mutex_t scratchpad_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t scratchpad_once = PTHREAD_ONCE_INIT;
+static pthread_key_t scratchpad_key;
+
+#define scratchpad_lock_acquire() pthread_mutex_lock(&scratchpad_lock)
+#define scratchpad_lock_release() pthread_mutex_unlock(&scratchpad_lock)
+
+static void scratchpad_thread_exit(void *pads)
+{
+    scratchpad_release_all((struct scratchpad *) pads, 0);
+}
+
+static void scratchpad_create_key(void)
+{
+    pthread_key_create(&scratchpad_key, scratchpad_thread_exit);
+}
+
+static void scratchpad_register_thread(void)
+{
+    pthread_once(&scratchpad_once, scratchpad_create_key);
+    pthread_setspecific(scratchpad_key, hp_pads);
+}
+#endif
+
 /**
- * @brief allocate the 2MB scratch buffer using OS support for huge pages, if available
- *
- * This function tries to allocate the 2MB scratch buffer using a single
- * 2MB "huge page" (instead of the usual 4KB page sizes) to reduce TLB misses
- * during the random accesses to the scratch buffer.  This is one of the
- * important speed optimizations needed to make CryptoNight faster.
+ * @brief maps a 2MB scratch buffer using OS support for huge pages, if available
  *
- * No parameters.  Updates a thread-local pointer, hp_state, to point to
- * the allocated buffer.
+ * The buffer is tried as a single 2MB "huge page" (instead of the usual 4KB page
+ * sizes) to reduce TLB misses during the random accesses to the scratch buffer.
+ * This is one of the important speed optimizations needed to make CryptoNight
+ * faster. Explicit huge pages need to be reserved by the administrator; without
+ * them the buffer is aligned to 2MB and transparent huge pages are requested
+ * where the kernel supports them, and small pages are the last resort.
  */
-
-void slow_hash_allocate_state(void)
+static struct scratchpad scratchpad_map(void)
 {
-    if(hp_state != NULL)
-        return;
+    struct scratchpad pad = { NULL, SLOW_HASH_PAGES_SMALL, 0 };
 
 #if defined(_MSC_VER) || defined(__MINGW32__)
     SetLockPagesPrivilege(GetCurrentProcess(), TRUE);
-    hp_state = (uint8_t *) VirtualAlloc(hp_state, MEMORY, MEM_LARGE_PAGES |
-                                        MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
-#else
-#if defined(__APPLE__) || defined(__FreeBSD__) || defined(__OpenBSD__) || \
+    pad.memory = (uint8_t *) VirtualAlloc(NULL, MEMORY, MEM_LARGE_PAGES |
+                                          MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+    if(pad.memory != NULL)
+    {
+        pad.pages = SLOW_HASH_PAGES_HUGE;
+        pad.mapped = 1;
+        return pad;
+    }
+#elif defined(__APPLE__) || defined(__FreeBSD__) || defined(__OpenBSD__) || \
   defined(__DragonFly__) || defined(__NetBSD__)
-    hp_state = mmap(0, MEMORY, PROT_READ | PROT_WRITE,
-                    MAP_PRIVATE | MAP_ANON, 0, 0);
-#else
-    hp_state = mmap(0, MEMORY, PROT_READ | PROT_WRITE,
-                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, 0, 0);
+    pad.memory = mmap(0, MEMORY, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANON, -1, 0);
+    if(pad.memory != MAP_FAILED)
+    {
+        pad.mapped = 1;
+        return pad;
+    }
+    pad.memory = NULL;
+#elif defined(MAP_HUGETLB)
+    pad.memory = mmap(0, MEMORY, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if(pad.memory != MAP_FAILED)
+    {
+        pad.pages = SLOW_HASH_PAGES_HUGE;
+        pad.mapped = 1;
+        return pad;
+    }
+    pad.memory = NULL;
+
+#if defined(MADV_HUGEPAGE)
+    {
+        /* map twice the size to cut a 2MB aligned range out of it, a huge page can only back such a range */
+        uint8_t *area = mmap(0, 2 * MEMORY, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if(area != MAP_FAILED)
+        {
+            uint8_t *aligned = (uint8_t *) (((uintptr_t) area + MEMORY - 1) & ~((uintptr_t) MEMORY - 1));
+            if(aligned != area)
+                munmap(area, aligned - area);
+            if(aligned + MEMORY != area + 2 * MEMORY)
+                munmap(aligned + MEMORY, area + 2 * MEMORY - (aligned + MEMORY));
+
+            pad.memory = aligned;
+            pad.mapped = 1;
+            if(madvise(aligned, MEMORY, MADV_HUGEPAGE) == 0)
+                pad.pages = SLOW_HASH_PAGES_TRANSPARENT;
+            return pad;
+        }
+    }
 #endif
-    if(hp_state == MAP_FAILED)
-        hp_state = NULL;
 #endif
-    hp_allocated = 1;
-    if(hp_state == NULL)
+
+    pad.memory = (uint8_t *) malloc(MEMORY);
+    return pad;
+}
+
+static void scratchpad_unmap(struct scratchpad *pad)
+{
+    if(!pad->mapped)
+        free(pad->memory);
+    else
+    {
+#if defined(_MSC_VER) || defined(__MINGW32__)
+        VirtualFree(pad->memory, 0, MEM_RELEASE);
+#else
+        munmap(pad->memory, MEMORY);
+#endif
+    }
+}
+
+/* Takes a scratchpad from the pool, or maps a new one, for the calling thread */
+static void scratchpad_acquire(struct scratchpad *pad)
+{
+    if(!hp_registered)
+    {
+        scratchpad_register_thread();
+        hp_registered = 1;
+    }
+
+    scratchpad_lock_acquire();
+    if(scratchpad_pool_count != 0)
+    {
+        *pad = scratchpad_pool[--scratchpad_pool_count];
+        scratchpad_lock_release();
+        return;
+    }
+    scratchpad_lock_release();
+
+    *pad = scratchpad_map();
+    if(pad->memory == NULL)
+        return;
+
+    scratchpad_lock_acquire();
+    ++scratchpad_counts[pad->pages];
+    scratchpad_lock_release();
+}
+
+/* Gives the scratchpads from <from> on back to the pool, unmapping those that do not fit in it */
+static void scratchpad_release_all(struct scratchpad *pads, size_t from)
+{
+    size_t w;
+    for(w = from; w < CN_SLOW_HASH_MAX_WAYS; w++)
     {
-        hp_allocated = 0;
-        hp_state = (uint8_t *) malloc(MEMORY);
+        if(pads[w].memory == NULL)
+            continue;
+
+        scratchpad_lock_acquire();
+        if(scratchpad_pool_count < SCRATCHPAD_POOL_SIZE)
+        {
+            scratchpad_pool[scratchpad_pool_count++] = pads[w];
+            pads[w].memory = NULL;
+        }
+        else
+        {
+            --scratchpad_counts[pads[w].pages];
+        }
+        scratchpad_lock_release();
+
+        if(pads[w].memory != NULL)
+        {
+            scratchpad_unmap(&pads[w]);
+            pads[w].memory = NULL;
+        }
     }
 }
 
 /**
- *@brief frees the state allocated by slow_hash_allocate_state
+ * @brief gives the calling thread its 2MB scratch buffer
+ *
+ * The buffer comes from the pool of buffers released by other threads, or is
+ * mapped with huge pages if possible, see scratchpad_map. It goes back to the
+ * pool when the thread exits or calls slow_hash_free_state.
+ *
+ * No parameters.  Updates a thread-local pointer, hp_state, to point to
+ * the buffer.
  */
 
-void slow_hash_free_state(void)
+void slow_hash_allocate_state(void)
 {
-    if(hp_state == NULL)
+    if(hp_state != NULL)
         return;
 
-    if(!hp_allocated)
-        free(hp_state);
-    else
-    {
-#if defined(_MSC_VER) || defined(__MINGW32__)
-        VirtualFree(hp_state, 0, MEM_RELEASE);
-#else
-        munmap(hp_state, MEMORY);
-#endif
-    }
+    scratchpad_acquire(&hp_pads[0]);
+    hp_state = hp_pads[0].memory;
+}
 
+/**
+ *@brief gives the scratch buffers of the calling thread back to the pool
+ */
+
+void slow_hash_free_state(void)
+{
+    scratchpad_release_all(hp_pads, 0);
     hp_state = NULL;
-    hp_allocated = 0;
+}
+
+int slow_hash_state_pages(void)
+{
+    return hp_state == NULL ? SLOW_HASH_PAGES_NONE : hp_pads[0].pages;
+}
+
+void slow_hash_get_scratchpad_counts(size_t *counts, size_t *pooled)
+{
+    scratchpad_lock_acquire();
+    memcpy(counts, scratchpad_counts, sizeof(scratchpad_counts));
+    *pooled = scratchpad_pool_count;
+    scratchpad_lock_release();
 }
 
 /**
@@ -834,6 +1030,156 @@ void cn_slow_hash(const void *data, size_t length, char *hash, int variant, int
     extra_hashes[state.hs.b[0] & 3](&state, 200, hash);
 }
 
+
+
+void slow_hash_free_multi_state(void)
+{
+    scratchpad_release_all(hp_pads, 1);
+}
+
+/* The state of one of the hashes computed together by cn_slow_hash_multi */
+struct cn_slow_hash_way
+{
+    RDATA_ALIGN16 uint64_t a[2];
+    RDATA_ALIGN16 uint64_t b[4];
+    RDATA_ALIGN16 uint64_t c[2];
+    __m128i _b, _b1;
+    uint64_t tweak1_2;
+    uint64_t division_result;
+    uint64_t sqrt_result;
+    uint8_t *hp_state;
+    union cn_slow_hash_state state;
+};
+
+/* CryptoNight steps 1 and 2 for one way, see cn_slow_hash */
+static void cn_slow_hash_way_init(struct cn_slow_hash_way *way, const void *data, size_t length, int variant)
+{
+    RDATA_ALIGN16 uint8_t expandedKey[240];
+    uint8_t text[INIT_SIZE_BYTE];
+    union cn_slow_hash_state state;
+    uint64_t *b = way->b;
+    size_t i;
+
+    hash_process(&state.hs, data, length);
+    memcpy(text, state.init, INIT_SIZE_BYTE);
+
+    {
+        VARIANT1_INIT64();
+        VARIANT2_INIT64();
+        way->tweak1_2 = tweak1_2;
+        way->division_result = division_result;
+        way->sqrt_result = sqrt_result;
+    }
+
+    aes_expand_key(state.hs.b, expandedKey);
+    for(i = 0; i < MEMORY / INIT_SIZE_BYTE; i++)
+    {
+        aes_pseudo_round(text, text, expandedKey, INIT_SIZE_BLK);
+        memcpy(&way->hp_state[i * INIT_SIZE_BYTE], text, INIT_SIZE_BYTE);
+    }
+
+    U64(way->a)[0] = U64(&state.k[0])[0] ^ U64(&state.k[32])[0];
+    U64(way->a)[1] = U64(&state.k[0])[1] ^ U64(&state.k[32])[1];
+    U64(b)[0] = U64(&state.k[16])[0] ^ U64(&state.k[48])[0];
+    U64(b)[1] = U64(&state.k[16])[1] ^ U64(&state.k[48])[1];
+    way->state = state;
+    way->_b = _mm_load_si128(R128(b));
+    way->_b1 = _mm_load_si128(R128(b) + 1);
+}
+
+/* One iteration of CryptoNight step 3 for one way, the same as in cn_slow_hash */
+static INLINE void cn_slow_hash_way_step(struct cn_slow_hash_way *way, int variant)
+{
+    uint8_t *hp_state = way->hp_state;
+    uint64_t *a = way->a;
+    uint64_t *b = way->b;
+    uint64_t *c = way->c;
+    const uint64_t tweak1_2 = way->tweak1_2;
+    uint64_t division_result = way->division_result;
+    uint64_t sqrt_result = way->sqrt_result;
+    __m128i _a, _b = way->_b, _b1 = way->_b1, _c;
+    uint64_t hi, lo;
+    size_t j;
+    uint64_t *p = NULL;
+
+    pre_aes();
+    _c = _mm_aesenc_si128(_c, _a);
+    post_aes();
+
+    way->_b = _b;
+    way->_b1 = _b1;
+    way->division_result = division_result;
+    way->sqrt_result = sqrt_result;
+}
+
+/* CryptoNight steps 4 and 5 for one way, see cn_slow_hash */
+static void cn_slow_hash_way_final(struct cn_slow_hash_way *way, char *hash)
+{
+    static void (*const extra_hashes[4])(const void *, size_t, char *) =
+    {
+        hash_extra_blake, hash_extra_groestl, hash_extra_jh, hash_extra_skein
+    };
+
+    RDATA_ALIGN16 uint8_t expandedKey[240];
+    uint8_t text[INIT_SIZE_BYTE];
+    size_t i;
+
+    memcpy(text, way->state.init, INIT_SIZE_BYTE);
+    aes_expand_key(&way->state.hs.b[32], expandedKey);
+    for(i = 0; i < MEMORY / INIT_SIZE_BYTE; i++)
+    {
+        aes_pseudo_round_xor(text, text, expandedKey, &way->hp_state[i * INIT_SIZE_BYTE], INIT_SIZE_BLK);
+    }
+
+    memcpy(way->state.init, text, INIT_SIZE_BYTE);
+    hash_permutation(&way->state.hs);
+    extra_hashes[way->state.hs.b[0] & 3](&way->state, 200, hash);
+}
+
+/**
+ * @brief computes the CryptoNight hashes of <ways> inputs of <length> bytes at once
+ *
+ * The memory-hard loops of the inputs are interleaved, one iteration of each per round, so
+ * that the latency of the scratchpad reads, AES and multiplications of one input overlaps
+ * with the work on the others. Each input has its own 2MB scratchpad. The hashes are the
+ * same as cn_slow_hash gives, and are stored one after the other in <hash>. Without AES-NI,
+ * or for more than CN_SLOW_HASH_MAX_WAYS inputs, the inputs are hashed one by one.
+ */
+void cn_slow_hash_multi(const void *const *data, size_t length, char *hash, size_t ways, int variant)
+{
+    struct cn_slow_hash_way way[CN_SLOW_HASH_MAX_WAYS];
+    size_t i, w;
+
+    if(ways <= 1 || ways > CN_SLOW_HASH_MAX_WAYS || force_software_aes() || !check_aes_hw())
+    {
+        for(w = 0; w < ways; w++)
+            cn_slow_hash(data[w], length, hash + w * HASH_SIZE, variant, 0);
+        return;
+    }
+
+    slow_hash_allocate_state();
+    for(w = 1; w < ways; w++)
+    {
+        if(hp_pads[w].memory == NULL)
+            scratchpad_acquire(&hp_pads[w]);
+    }
+
+    for(w = 0; w < ways; w++)
+    {
+        way[w].hp_state = hp_pads[w].memory;
+        cn_slow_hash_way_init(&way[w], data[w], length, variant);
+    }
+
+    for(i = 0; i < ITER / 2; i++)
+    {
+        for(w = 0; w < ways; w++)
+            cn_slow_hash_way_step(&way[w], variant);
+    }
+
+    for(w = 0; w < ways; w++)
+        cn_slow_hash_way_final(&way[w], hash + w * HASH_SIZE);
+}
+
 #elif !defined NO_AES && (defined(__arm__) || defined(__aarch64__))
 void slow_hash_allocate_state(void)
 {
@@ -1578,3 +1924,28 @@ void cn_slow_hash(const void *data, size_t length, char *hash, int variant, int
 }
 
 #endif
+
+#if defined NO_AES || !(defined(__x86_64__) || (defined(_MSC_VER) && defined(_WIN64)))
+void cn_slow_hash_multi(const void *const *data, size_t length, char *hash, size_t ways, int variant)
+{
+    size_t w;
+    for(w = 0; w < ways; w++)
+        cn_slow_hash(data[w], length, hash + w * HASH_SIZE, variant, 0);
+}
+
+void slow_hash_free_multi_state(void)
+{
+}
+
+/* Other platforms hash on a scratchpad of their own per call */
+int slow_hash_state_pages(void)
+{
+    return SLOW_HASH_PAGES_NONE;
+}
+
+void slow_hash_get_scratchpad_counts(size_t *counts, size_t *pooled)
+{
+    memset(counts, 0, (SLOW_HASH_PAGES_HUGE + 1) * sizeof(size_t));
+    *pooled = 0;
+}
+#endif
@@ -0,0 +1,91 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "BlockEntryCache.h"
+
+namespace cryptonote {
+
+BlockEntryCache::BlockEntryCache(size_t maxSize) : m_maxSize(maxSize), m_size(0), m_hits(0), m_misses(0) {
+}
+
+bool BlockEntryCache::get(const crypto::hash_t& blockHash, block_complete_entry_t& entry) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto it = m_index.find(blockHash);
+  if (it == m_index.end()) {
+    ++m_misses;
+    return false;
+  }
+
+  ++m_hits;
+  m_entries.splice(m_entries.begin(), m_entries, it->second);
+  entry = it->second->second;
+  return true;
+}
+
+void BlockEntryCache::put(const crypto::hash_t& blockHash, const block_complete_entry_t& entry) {
+  size_t size = entrySize(entry);
+  if (size > m_maxSize) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (m_index.count(blockHash) != 0) {
+    return;
+  }
+
+  while (m_size + size > m_maxSize) {
+    erase(std::prev(m_entries.end()));
+  }
+
+  m_entries.emplace_front(blockHash, entry);
+  m_index.emplace(blockHash, m_entries.begin());
+  m_size += size;
+}
+
+void BlockEntryCache::remove(const crypto::hash_t& blockHash) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto it = m_index.find(blockHash);
+  if (it != m_index.end()) {
+    erase(it->second);
+  }
+}
+
+void BlockEntryCache::clear() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_entries.clear();
+  m_index.clear();
+  m_size = 0;
+}
+
+uint64_t BlockEntryCache::hits() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_hits;
+}
+
+uint64_t BlockEntryCache::misses() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_misses;
+}
+
+size_t BlockEntryCache::size() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_size;
+}
+
+size_t BlockEntryCache::entrySize(const block_complete_entry_t& entry) {
+  size_t size = entry.block.size();
+  for (const auto& tx : entry.txs) {
+    size += tx.size();
+  }
+
+  return size;
+}
+
+void BlockEntryCache::erase(entries_t::iterator it) {
+  m_size -= entrySize(it->second);
+  m_index.erase(it->first);
+  m_entries.erase(it);
+}
+
+}
@@ -0,0 +1,53 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+#include "crypto/hash.h"
+#include "cryptonote/protocol/definitions.h"
+
+namespace cryptonote {
+
+  // Serialized blocks with their transactions as sent to syncing wallets, keyed by block hash. A block's encoding never
+  // changes, so entries stay valid until the block leaves the main chain. The least recently used entries are evicted
+  // once the encoded size exceeds the limit.
+  class BlockEntryCache {
+  public:
+    explicit BlockEntryCache(size_t maxSize);
+
+    BlockEntryCache(const BlockEntryCache&) = delete;
+    BlockEntryCache& operator=(const BlockEntryCache&) = delete;
+
+    // Counts a hit or a miss
+    bool get(const crypto::hash_t& blockHash, block_complete_entry_t& entry);
+    void put(const crypto::hash_t& blockHash, const block_complete_entry_t& entry);
+    void remove(const crypto::hash_t& blockHash);
+    void clear();
+
+    uint64_t hits() const;
+    uint64_t misses() const;
+    // Encoded bytes held
+    size_t size() const;
+
+  private:
+    typedef std::list<std::pair<crypto::hash_t, block_complete_entry_t>> entries_t;
+
+    static size_t entrySize(const block_complete_entry_t& entry);
+    void erase(entries_t::iterator it);
+
+    mutable std::mutex m_mutex;
+    const size_t m_maxSize;
+    size_t m_size;
+    uint64_t m_hits;
+    uint64_t m_misses;
+    // most recently used first
+    entries_t m_entries;
+    std::unordered_map<crypto::hash_t, entries_t::iterator> m_index;
+  };
+}
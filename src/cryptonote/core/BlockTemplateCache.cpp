@@ -0,0 +1,94 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "BlockTemplateCache.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "TransactionExtra.h"
+
+namespace cryptonote {
+
+BlockTemplateCache::BlockTemplateCache(uint64_t maxPoolChanges, uint64_t maxAge) :
+  m_maxPoolChanges(maxPoolChanges), m_maxAge(maxAge), m_hits(0), m_misses(0), m_valid(false) {
+}
+
+bool BlockTemplateCache::get(const crypto::hash_t& previousBlockHash, uint64_t poolVersion, uint64_t now,
+  const account_public_address_t& address, const binary_array_t& extraNonce, block_t& block, difficulty_t& difficulty, uint32_t& height) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (!isFresh(previousBlockHash, poolVersion, now) || extraNonce.size() != m_extraNonceSize ||
+    memcmp(&address, &m_address, sizeof(address)) != 0) {
+    ++m_misses;
+    return false;
+  }
+
+  ++m_hits;
+  block = m_block;
+  if (!extraNonce.empty()) {
+    memcpy(block.baseTransaction.extra.data() + m_extraNonceOffset, extraNonce.data(), extraNonce.size());
+  }
+
+  difficulty = m_difficulty;
+  height = m_height;
+  return true;
+}
+
+void BlockTemplateCache::put(uint64_t poolVersion, uint64_t now, const account_public_address_t& address,
+  const binary_array_t& extraNonce, const block_t& block, difficulty_t difficulty, uint32_t height) {
+  // the coinbase extra starts with its public key followed by the extra nonce
+  binary_array_t extraPrefix;
+  addTransactionPublicKeyToExtra(extraPrefix, crypto::public_key_t());
+  if (!extraNonce.empty() && !addExtraNonceToTransactionExtra(extraPrefix, extraNonce)) {
+    return;
+  }
+
+  size_t extraNonceOffset = extraPrefix.size() - extraNonce.size();
+  const binary_array_t& extra = block.baseTransaction.extra;
+  if (extra.size() < extraPrefix.size() || !std::equal(extraNonce.begin(), extraNonce.end(), extra.begin() + extraNonceOffset)) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_valid = true;
+  m_poolVersion = poolVersion;
+  m_createdAt = now;
+  m_address = address;
+  m_extraNonceSize = extraNonce.size();
+  m_extraNonceOffset = extraNonceOffset;
+  m_block = block;
+  m_difficulty = difficulty;
+  m_height = height;
+}
+
+void BlockTemplateCache::clear() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_valid = false;
+  m_block = block_t();
+}
+
+uint64_t BlockTemplateCache::hits() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_hits;
+}
+
+uint64_t BlockTemplateCache::misses() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_misses;
+}
+
+bool BlockTemplateCache::isFresh(const crypto::hash_t& previousBlockHash, uint64_t poolVersion, uint64_t now) const {
+  if (!m_valid || m_block.previousBlockHash != previousBlockHash) {
+    return false;
+  }
+
+  uint64_t poolChanges = poolVersion - m_poolVersion;
+  if (poolChanges == 0) {
+    return true;
+  }
+
+  return poolChanges < m_maxPoolChanges && now - m_createdAt < m_maxAge;
+}
+
+}
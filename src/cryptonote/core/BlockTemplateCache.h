@@ -0,0 +1,60 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+
+#include "cryptonote/core/difficulty.h"
+#include "cryptonote/structures/account.h"
+#include "cryptonote/structures/block.h"
+#include "common/binary_array.h"
+
+namespace cryptonote {
+
+  // The last block template built, so that miners and pool servers polling for templates do not have the memory
+  // pool walked and the coinbase built on every request. The template stays valid while the chain tip is the same
+  // and the pool changed less than 'maxPoolChanges' times; past 'maxAge' seconds any pool change invalidates it so
+  // that new transactions get mined. Transactions leaving the pool without a new tip are expired ones, the owner
+  // clears the cache when that happens. Requests for the same address and extra nonce size reuse its coinbase with
+  // their extra nonce patched in.
+  class BlockTemplateCache {
+  public:
+    BlockTemplateCache(uint64_t maxPoolChanges, uint64_t maxAge);
+
+    BlockTemplateCache(const BlockTemplateCache&) = delete;
+    BlockTemplateCache& operator=(const BlockTemplateCache&) = delete;
+
+    // Counts a hit or a miss
+    bool get(const crypto::hash_t& previousBlockHash, uint64_t poolVersion, uint64_t now, const account_public_address_t& address,
+      const binary_array_t& extraNonce, block_t& block, difficulty_t& difficulty, uint32_t& height);
+    void put(uint64_t poolVersion, uint64_t now, const account_public_address_t& address, const binary_array_t& extraNonce,
+      const block_t& block, difficulty_t difficulty, uint32_t height);
+    void clear();
+
+    uint64_t hits() const;
+    uint64_t misses() const;
+
+  private:
+    bool isFresh(const crypto::hash_t& previousBlockHash, uint64_t poolVersion, uint64_t now) const;
+
+    mutable std::mutex m_mutex;
+    const uint64_t m_maxPoolChanges;
+    const uint64_t m_maxAge;
+    uint64_t m_hits;
+    uint64_t m_misses;
+
+    bool m_valid;
+    uint64_t m_poolVersion;
+    uint64_t m_createdAt;
+    account_public_address_t m_address;
+    size_t m_extraNonceSize;
+    // of the extra nonce in the coinbase extra
+    size_t m_extraNonceOffset;
+    block_t m_block;
+    difficulty_t m_difficulty;
+    uint32_t m_height;
+  };
+}
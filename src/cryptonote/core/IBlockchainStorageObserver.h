@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include "crypto/hash.h"
+
 namespace cryptonote {
   class IBlockchainStorageObserver {
   public:
@@ -11,5 +13,7 @@ namespace cryptonote {
     }
 
     virtual void blockchainUpdated() = 0;
+    // The block is no longer part of the main chain
+    virtual void blockPopped(const crypto::hash_t& blockHash) = 0;
   };
 }
@@ -70,6 +70,10 @@ public:
                               std::vector<transaction_t>& addedTxs, std::vector<crypto::hash_t>& deletedTxsIds) = 0;
   virtual bool getPoolChangesLite(const crypto::hash_t& tailBlockId, const std::vector<crypto::hash_t>& knownTxsIds,
                               std::vector<transaction_prefix_info_t>& addedTxs, std::vector<crypto::hash_t>& deletedTxsIds) = 0;
+  // Pool changes after change 'sequence', which becomes the last change. When the pool no longer remembers 'sequence'
+  // 'isFullResync' is set and 'addedTxs' holds the whole pool.
+  virtual bool getPoolChangesSince(const crypto::hash_t& tailBlockId, uint64_t& sequence, bool& isFullResync,
+                              std::vector<transaction_prefix_info_t>& addedTxs, std::vector<crypto::hash_t>& deletedTxsIds) = 0;
   virtual void getPoolChanges(const std::vector<crypto::hash_t>& knownTxsIds, std::vector<transaction_t>& addedTxs,
                               std::vector<crypto::hash_t>& deletedTxsIds) = 0;
   virtual bool queryBlocks(const std::vector<crypto::hash_t>& block_ids, uint64_t timestamp,
@@ -98,6 +102,8 @@ public:
 
   virtual std::unique_ptr<IBlock> getBlock(const crypto::hash_t& blocksId) = 0;
   virtual bool handleIncomingTransaction(const transaction_t& tx, const crypto::hash_t& txHash, size_t blobSize, tx_verification_context_t& tvc, bool keptByBlock) = 0;
+  // Same as handle_incoming_block_blob for an already decoded block whose long hash is known
+  virtual bool handleIncomingBlock(const block_t& block, const crypto::hash_t& proofOfWork, block_verification_context_t& bvc, bool controlMiner, bool relayBlock) = 0;
   virtual std::error_code executeLocked(const std::function<std::error_code()>& func) = 0;
 
   virtual bool addMessageQueue(MessageQueue<BlockchainMessage>& messageQueue) = 0;
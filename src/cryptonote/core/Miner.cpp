@@ -42,6 +42,7 @@ namespace cryptonote
     m_handler(handler),
     m_pausers_count(0),
     m_threads_total(0),
+    m_hash_ways(1),
     m_starter_nonce(0),
     m_last_hr_merge_time(0),
     m_hashes(0),
@@ -133,7 +134,12 @@ namespace cryptonote
       if(m_do_print_hashrate) {
         uint64_t total_hr = std::accumulate(m_last_hash_rates.begin(), m_last_hash_rates.end(), static_cast<uint64_t>(0));
         float hr = static_cast<float>(total_hr)/static_cast<float>(m_last_hash_rates.size());
-        std::cout << "hashrate: " << std::setprecision(4) << std::fixed << hr << ENDL;
+        size_t scratchpads[crypto::SLOW_HASH_PAGES_HUGE + 1];
+        size_t pooled;
+        crypto::slow_hash_get_scratchpad_counts(scratchpads, &pooled);
+        std::cout << "hashrate: " << std::setprecision(4) << std::fixed << hr << ", scratchpads on huge pages: " <<
+          scratchpads[crypto::SLOW_HASH_PAGES_HUGE] << ", transparent huge pages: " << scratchpads[crypto::SLOW_HASH_PAGES_TRANSPARENT] <<
+          ", small pages: " << scratchpads[crypto::SLOW_HASH_PAGES_SMALL] << ENDL;
       }
     }
     
@@ -182,6 +188,13 @@ namespace cryptonote
       }
     }
 
+    if (config.miningHashWays == 0 || config.miningHashWays > crypto::CN_SLOW_HASH_MAX_WAYS) {
+      logger(ERROR) << "Mining hash ways must be 1.." << crypto::CN_SLOW_HASH_MAX_WAYS << ", got " << config.miningHashWays;
+      return false;
+    }
+
+    m_hash_ways = config.miningHashWays;
+
     return true;
   }
   //-----------------------------------------------------------------------------------------------------
@@ -339,7 +352,8 @@ namespace cryptonote
   //-----------------------------------------------------------------------------------------------------
   bool miner::worker_thread(uint32_t th_local_index)
   {
-    logger(INFO) << "Miner thread was started ["<< th_local_index << "]";
+    crypto::slow_hash_allocate_state();
+    logger(INFO) << "Miner thread was started ["<< th_local_index << "], scratchpad on " << crypto::slow_hash_pages_name(crypto::slow_hash_state_pages());
     uint32_t nonce = m_starter_nonce + th_local_index;
     difficulty_t local_diff = 0;
     uint32_t local_template_ver = 0;
@@ -370,16 +384,25 @@ namespace cryptonote
         continue;
       }
 
-      b.nonce = nonce;
-      crypto::hash_t h;
-      if (!m_stop && !Block::getLongHash(b, h)) {
+      uint32_t nonces[crypto::CN_SLOW_HASH_MAX_WAYS];
+      crypto::hash_t h[crypto::CN_SLOW_HASH_MAX_WAYS];
+      for (uint32_t i = 0; i < m_hash_ways; ++i) {
+        nonces[i] = nonce;
+        nonce += m_threads_total;
+      }
+
+      if (!m_stop && !Block::getLongHashes(b, nonces, m_hash_ways, h)) {
         logger(ERROR) << "Failed to get block long hash";
         m_stop = true;
       }
 
-      if (!m_stop && check_hash(h, local_diff))
-      {
+      for (uint32_t i = 0; i < m_hash_ways && !m_stop; ++i) {
+        if (!check_hash(h[i], local_diff)) {
+          continue;
+        }
+
         //we lucky!
+        b.nonce = nonces[i];
         ++m_config.current_extra_message_index;
 
         logger(INFO, GREEN) << "Found block for difficulty: " << local_diff;
@@ -390,11 +413,13 @@ namespace cryptonote
           //success update, lets update config
           stream::save(os::getCoinFile(std::string(config::get().filenames.miner)), storeToJson(m_config));
         }
+
+        break;
       }
 
-      nonce += m_threads_total;
-      ++m_hashes;
+      m_hashes += m_hash_ways;
     }
+    crypto::slow_hash_free_state();
     logger(INFO) << "Miner thread stopped ["<< th_local_index << "]";
     return true;
   }
@@ -66,6 +66,7 @@ namespace cryptonote {
     difficulty_t m_diffic;
 
     std::atomic<uint32_t> m_threads_total;
+    uint32_t m_hash_ways;
     std::atomic<int32_t> m_pausers_count;
     std::mutex m_miners_count_lock;
 
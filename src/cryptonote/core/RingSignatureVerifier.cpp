@@ -0,0 +1,127 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "RingSignatureVerifier.h"
+
+#include <algorithm>
+
+namespace cryptonote {
+
+namespace {
+
+// Most checks handed to crypto::check_ring_signatures at once, small enough to keep the workers balanced
+const size_t BATCH_SIZE = 16;
+
+crypto::ring_signature_batch_item_t toBatchItem(const ring_signature_check_t& check) {
+  return { &check.prefixHash, &check.keyImage, check.outputKeys.data(), check.outputKeys.size(), check.signatures.data() };
+}
+
+bool verifyRange(const ring_signature_check_t* checks, size_t count) {
+  crypto::ring_signature_batch_item_t items[BATCH_SIZE];
+  for (size_t begin = 0; begin < count; begin += BATCH_SIZE) {
+    size_t size = std::min(BATCH_SIZE, count - begin);
+    for (size_t i = 0; i < size; ++i) {
+      items[i] = toBatchItem(checks[begin + i]);
+    }
+
+    size_t failedIndex;
+    if (!crypto::check_ring_signatures(items, size, failedIndex)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+}
+
+bool ring_signature_check_t::verify() const {
+  crypto::ring_signature_batch_item_t item = toBatchItem(*this);
+  size_t failedIndex;
+  return crypto::check_ring_signatures(&item, 1, failedIndex);
+}
+
+RingSignatureVerifier::RingSignatureVerifier(size_t threadCount) :
+  m_checks(nullptr), m_chunkSize(1), m_batchId(0), m_activeWorkers(0), m_stop(false), m_next(0), m_failed(false) {
+  for (size_t i = 1; i < threadCount; ++i) {
+    m_threads.emplace_back(&RingSignatureVerifier::workerThread, this);
+  }
+}
+
+RingSignatureVerifier::~RingSignatureVerifier() {
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+
+  m_batchReady.notify_all();
+  for (auto& thread : m_threads) {
+    thread.join();
+  }
+}
+
+bool RingSignatureVerifier::verify(const std::vector<ring_signature_check_t>& checks) {
+  if (m_threads.empty() || checks.size() <= 1) {
+    return verifyRange(checks.data(), checks.size());
+  }
+
+  // A pool transaction has a few inputs only, so even small batches are spread over all threads
+  size_t threadCount = m_threads.size() + 1;
+  size_t chunkSize = std::min(BATCH_SIZE, (checks.size() + threadCount - 1) / threadCount);
+
+  std::lock_guard<std::mutex> batchLock(m_batchMutex);
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_checks = &checks;
+    m_chunkSize = chunkSize;
+    m_next = 0;
+    m_failed = false;
+    m_activeWorkers = m_threads.size();
+    ++m_batchId;
+  }
+
+  m_batchReady.notify_all();
+  processBatch();
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_batchDone.wait(lock, [this] { return m_activeWorkers == 0; });
+  m_checks = nullptr;
+  return !m_failed;
+}
+
+void RingSignatureVerifier::workerThread() {
+  uint64_t processedBatch = 0;
+  std::unique_lock<std::mutex> lock(m_mutex);
+  for (;;) {
+    m_batchReady.wait(lock, [&] { return m_stop || m_batchId != processedBatch; });
+    if (m_stop) {
+      return;
+    }
+
+    processedBatch = m_batchId;
+    lock.unlock();
+    processBatch();
+    lock.lock();
+
+    if (--m_activeWorkers == 0) {
+      m_batchDone.notify_one();
+    }
+  }
+}
+
+void RingSignatureVerifier::processBatch() {
+  const std::vector<ring_signature_check_t>& checks = *m_checks;
+  while (!m_failed) {
+    size_t index = m_next.fetch_add(m_chunkSize);
+    if (index >= checks.size()) {
+      break;
+    }
+
+    if (!verifyRange(checks.data() + index, std::min(m_chunkSize, checks.size() - index))) {
+      m_failed = true;
+    }
+  }
+}
+
+}
@@ -0,0 +1,62 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "crypto/crypto.h"
+
+namespace cryptonote {
+
+  // Everything needed to check one key input's ring signature without touching the blockchain.
+  // Keys and signatures are copied, so a check stays valid after the blockchain lock is released.
+  struct ring_signature_check_t {
+    crypto::hash_t prefixHash;
+    crypto::key_image_t keyImage;
+    std::vector<crypto::public_key_t> outputKeys;
+    std::vector<crypto::signature_t> signatures;
+
+    bool verify() const;
+  };
+
+  // Checks gathered ring signatures on a fixed set of worker threads, the calling thread takes part too
+  class RingSignatureVerifier {
+  public:
+    explicit RingSignatureVerifier(size_t threadCount = std::thread::hardware_concurrency());
+    ~RingSignatureVerifier();
+
+    RingSignatureVerifier(const RingSignatureVerifier&) = delete;
+    RingSignatureVerifier& operator=(const RingSignatureVerifier&) = delete;
+
+    // Returns false as soon as any signature fails, remaining checks are skipped
+    bool verify(const std::vector<ring_signature_check_t>& checks);
+
+  private:
+    void workerThread();
+    void processBatch();
+
+    std::vector<std::thread> m_threads;
+
+    // Serializes concurrent verify() calls, the workers serve one batch at a time
+    std::mutex m_batchMutex;
+
+    std::mutex m_mutex;
+    std::condition_variable m_batchReady;
+    std::condition_variable m_batchDone;
+    const std::vector<ring_signature_check_t>* m_checks;
+    size_t m_chunkSize;
+    uint64_t m_batchId;
+    size_t m_activeWorkers;
+    bool m_stop;
+
+    std::atomic<size_t> m_next;
+    std::atomic<bool> m_failed;
+  };
+
+}
@@ -17,8 +17,9 @@
 #include "CryptoNoteTools.h"
 #include "cryptonote/structures/array.hpp"
 
-#include "cryptonote/core/blockchain/serializer/block_cache.hpp"
 #include "cryptonote/core/blockchain/serializer/blockchain_indices.hpp"
+#include "cryptonote/core/blockchain/indexing/chain_rebuild.h"
+#include "blockchain_explorer/BlockchainExplorerDataBuilder.h"
 
 using namespace Logging;
 using namespace Common;
@@ -31,33 +32,9 @@ namespace std {
 
 namespace cryptonote {
 
-template<typename K, typename V, typename hash_t>
-bool serialize(google::sparse_hash_map<K, V, hash_t>& value, Common::StringView name, cryptonote::ISerializer& serializer) {
-  return serializeMap(value, name, serializer, [&value](size_t size) { value.resize(size); });
-}
-
-template<typename K, typename hash_t>
-bool serialize(google::sparse_hash_set<K, hash_t>& value, Common::StringView name, cryptonote::ISerializer& serializer) {
-  size_t size = value.size();
-  if (!serializer.beginArray(size, name)) {
-    return false;
-  }
-
-  if (serializer.type() == ISerializer::OUTPUT) {
-    for (auto& key : value) {
-      serializer(const_cast<K&>(key), "");
-    }
-  } else {
-    value.resize(size);
-    while (size--) {
-      K key;
-      serializer(key, "");
-      value.insert(key);
-    }
-  }
-
-  serializer.endArray();
-  return true;
+namespace {
+// Blocks pushed or popped after a snapshot of the blockchain indices before the next one is written
+const size_t INDICES_COMPACTION_INTERVAL = 10000;
 }
 
 Blockchain::Blockchain(const Currency& currency, TxMemoryPool& tx_pool, ILogger& logger) :
@@ -67,11 +44,12 @@ m_tx_pool(tx_pool),
 m_current_block_cumul_sz_limit(0),
 m_is_in_checkpoint_zone(false),
 m_blocks(currency),
+m_chainStore(currency.indexCacheSize()),
+m_uncommittedBlocks(0),
+m_indicesGeneration(0),
+m_indicesLoggedBlocks(0),
+m_indicesCompacting(false),
 m_checkpoints(logger) {
-
-  m_outputs.set_deleted_key(0);
-  crypto::key_image_t nullImage = boost::value_initialized<decltype(nullImage)>();
-  m_spent_keys.set_deleted_key(nullImage);
 }
 
 bool Blockchain::addObserver(IBlockchainStorageObserver* observer) {
@@ -142,17 +120,18 @@ bool Blockchain::checkTransactionSize(size_t blobSize) {
 }
 
 bool Blockchain::haveTransaction(const crypto::hash_t &id) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
-  return m_transactionMap.find(id) != m_transactionMap.end();
+  Tools::SharedLockGuard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  transaction_index_t transactionIndex;
+  return m_chainStore.findTransaction(id, transactionIndex);
 }
 
 bool Blockchain::have_tx_keyimg_as_spent(const crypto::key_image_t &key_im) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
-  return  m_spent_keys.find(key_im) != m_spent_keys.end();
+  Tools::SharedLockGuard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  return m_chainStore.hasKeyImage(key_im);
 }
 
 uint32_t Blockchain::getHeight() {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Tools::SharedLockGuard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
   return static_cast<uint32_t>(m_blocks.size());
 }
 
@@ -163,19 +142,22 @@ bool Blockchain::init(bool load_existing) {
     return false;
   }
 
+  uint32_t storedHeight = 0;
+  crypto::hash_t storedTailId = NULL_HASH;
+  bool storeOpened = m_chainStore.open(m_currency.chainStoreDirName(), storedHeight, storedTailId);
+
   if (load_existing && !m_blocks.empty()) {
     logger(INFO, BRIGHT_WHITE) << "Loading blockchain...";
-    BlockCacheSerializer loader(*this, Block::getHash(m_blocks.back().bl), logger.getLogger());
-    loader.load(m_currency.blocksCacheFileName());
-
-    if (!loader.loaded()) {
-      logger(WARNING, BRIGHT_YELLOW) << "No actual blockchain cache found, rebuilding internal structures...";
+    if (!storeOpened || !loadCache(storedHeight, storedTailId)) {
+      logger(WARNING, BRIGHT_YELLOW) << "No actual chain index store found, rebuilding internal structures...";
       rebuildCache();
     }
 
     loadBlockchainIndices();
   } else {
     m_blocks.clear();
+    m_chainStore.clear();
+    compactIndices();
   }
 
   if (m_blocks.empty()) {
@@ -188,7 +170,7 @@ bool Blockchain::init(bool load_existing) {
       return false;
     }
   } else {
-    crypto::hash_t firstBlockHash = Block::getHash(m_blocks[0].bl);
+    crypto::hash_t firstBlockHash = Block::getHash(m_blocks.get(0)->bl);
     if (!(firstBlockHash == m_currency.genesisBlockHash())) {
       logger(ERROR, BRIGHT_RED) << "Failed to init: genesis block mismatch. "
         "Probably you set --testnet flag with data "
@@ -200,8 +182,9 @@ bool Blockchain::init(bool load_existing) {
 
   update_next_comulative_size_limit();
 
-  uint64_t timestamp_diff = time(NULL) - m_blocks.back().bl.timestamp;
-  if (!m_blocks.back().bl.timestamp) {
+  uint64_t lastTimestamp = m_blocks.getBack()->bl.timestamp;
+  uint64_t timestamp_diff = time(NULL) - lastTimestamp;
+  if (!lastTimestamp) {
     timestamp_diff = time(NULL) - config::get().createTime;
   }
 
@@ -212,69 +195,98 @@ bool Blockchain::init(bool load_existing) {
   return true;
 }
 
+// Opens the store committed at 'height' and applies the blocks appended after that commit
+bool Blockchain::loadCache(uint32_t height, const crypto::hash_t& tailId) {
+  if (height > m_blocks.size() || (height > 0 && Block::getHash(m_blocks.get(height - 1)->bl) != tailId)) {
+    logger(WARNING, BRIGHT_YELLOW) << "Chain index store was committed at height " << height << ", which is not in the blockchain";
+    return false;
+  }
+
+  std::vector<crypto::hash_t> blockIds;
+  if (!m_chainStore.getBlockIds(height, blockIds)) {
+    logger(WARNING, BRIGHT_YELLOW) << "Chain index store misses block ids";
+    return false;
+  }
+
+  m_blockIndex.clear();
+  for (const auto& blockId : blockIds) {
+    m_blockIndex.push(blockId);
+  }
+
+  if (height < m_blocks.size()) {
+    logger(INFO, BRIGHT_WHITE) << "Applying " << m_blocks.size() - height << " blocks appended after the last commit...";
+    replayBlocks(height);
+  }
+
+  return true;
+}
+
 void Blockchain::rebuildCache() {
   std::chrono::steady_clock::time_point timePoint = std::chrono::steady_clock::now();
   m_blockIndex.clear();
-  m_transactionMap.clear();
-  m_spent_keys.clear();
-  m_outputs.clear();
-  m_multisignatureOutputs.clear();
-  for (uint32_t b = 0; b < m_blocks.size(); ++b) {
-    if (b % 1000 == 0) {
-      logger(INFO, BRIGHT_WHITE) << "Height " << b << " of " << m_blocks.size();
+  m_chainStore.clear();
+  replayBlocks(0);
+
+  std::chrono::duration<double> duration = std::chrono::steady_clock::now() - timePoint;
+  logger(INFO, BRIGHT_WHITE) << "Rebuilding internal structures took: " << duration.count();
+}
+
+void Blockchain::replayBlocks(uint32_t startHeight) {
+  uint32_t endHeight = static_cast<uint32_t>(m_blocks.size());
+  ChainIndexRebuilder rebuilder(m_currency.indexRebuildThreads());
+  rebuilder.run(startHeight, endHeight, [this](uint32_t height, block_entry_t& block) {
+    m_blocks.load(height, block);
+  }, [this, endHeight](const indexed_block_t& block) {
+    if (block.height % 1000 == 0) {
+      logger(INFO, BRIGHT_WHITE) << "Height " << block.height << " of " << endHeight;
     }
-    const block_entry_t& block = m_blocks[b];
-    crypto::hash_t blockHash = Block::getHash(block.bl);
-    m_blockIndex.push(blockHash);
-    for (uint16_t t = 0; t < block.transactions.size(); ++t) {
-      const transaction_entry_t& transaction = block.transactions[t];
-      crypto::hash_t transactionHash = BinaryArray::objectHash(transaction.tx);
-      transaction_index_t transactionIndex = { b, t };
-      m_transactionMap.insert(std::make_pair(transactionHash, transactionIndex));
-
-      // process inputs
-      for (auto& i : transaction.tx.inputs) {
-        if (i.type() == typeid(key_input_t)) {
-          m_spent_keys.insert(::boost::get<key_input_t>(i).keyImage);
-        } else if (i.type() == typeid(multi_signature_input_t)) {
-          auto out = ::boost::get<multi_signature_input_t>(i);
-          m_multisignatureOutputs[out.amount][out.outputIndex].isUsed = true;
-        }
-      }
 
-      // process outputs
-      for (uint16_t o = 0; o < transaction.tx.outputs.size(); ++o) {
-        const auto& out = transaction.tx.outputs[o];
-        if (out.target.type() == typeid(key_output_t)) {
-          m_outputs[out.amount].push_back(std::make_pair<>(transactionIndex, o));
-        } else if (out.target.type() == typeid(multi_signature_output_t)) {
-          multisignature_output_usage_t usage = { transactionIndex, o, false };
-          m_multisignatureOutputs[out.amount].push_back(usage);
-        }
-      }
+    m_blockIndex.push(block.hash);
+    ChainIndexRebuilder::apply(m_chainStore, block);
+
+    // Modified pages stay in memory until committed, the blocks being replayed are already on disk
+    if ((block.height + 1) % 1000 == 0) {
+      m_chainStore.commit(block.height + 1, block.hash);
     }
-  }
+  });
 
-  std::chrono::duration<double> duration = std::chrono::steady_clock::now() - timePoint;
-  logger(INFO, BRIGHT_WHITE) << "Rebuilding internal structures took: " << duration.count();
+  commitCache();
 }
 
 bool Blockchain::storeCache() {
   std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
 
   logger(INFO, BRIGHT_WHITE) << "Saving blockchain...";
-  BlockCacheSerializer ser(*this, getTailId(), logger.getLogger());
-  if (!ser.save(m_currency.blocksCacheFileName())) {
-    logger(ERROR, BRIGHT_RED) << "Failed to save blockchain cache";
+  return commitCache();
+}
+
+/**
+* \pre m_blockchain_lock is locked exclusively
+*/
+bool Blockchain::commitCache() {
+  // The store must not describe blocks that did not reach the blocks file yet
+  uint32_t height = static_cast<uint32_t>(m_blocks.size());
+  crypto::hash_t tailId = m_blocks.empty() ? NULL_HASH : m_blockIndex.getTailId();
+  if (!m_blocks.commitIndex() || !m_chainStore.commit(height, tailId)) {
+    logger(ERROR, BRIGHT_RED) << "Failed to commit chain index store";
     return false;
   }
 
+  if (m_indicesLog.isOpen() && !m_indicesLog.flush()) {
+    logger(ERROR, BRIGHT_RED) << "Failed to flush blockchain indices log";
+  }
+
+  m_uncommittedBlocks = 0;
   return true;
 }
 
 bool Blockchain::deinit() {
   storeCache();
-  storeBlockchainIndices();
+  m_indicesLog.close();
+  if (m_indicesCompaction.joinable()) {
+    m_indicesCompaction.join();
+  }
+
   assert(m_messageQueueList.empty());
   return true;
 }
@@ -283,16 +295,16 @@ bool Blockchain::resetAndSetGenesisBlock(const block_t& b) {
   std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
   m_blocks.clear();
   m_blockIndex.clear();
-  m_transactionMap.clear();
+  m_chainStore.clear();
+  m_uncommittedBlocks = 0;
 
-  m_spent_keys.clear();
   m_alternative_chains.clear();
-  m_outputs.clear();
 
   m_paymentIdIndex.clear();
   m_timestampIndex.clear();
   m_generatedTransactionsIndex.clear();
   m_orthanBlocksIndex.clear();
+  compactIndices();
 
   block_verification_context_t bvc = boost::value_initialized<block_verification_context_t>();
   addNewBlock(b, bvc);
@@ -301,24 +313,24 @@ bool Blockchain::resetAndSetGenesisBlock(const block_t& b) {
 
 crypto::hash_t Blockchain::getTailId(uint32_t& height) {
   assert(!m_blocks.empty());
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Tools::SharedLockGuard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
   height = getHeight() - 1;
   return getTailId();
 }
 
 crypto::hash_t Blockchain::getTailId() {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Tools::SharedLockGuard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
   return m_blocks.empty() ? NULL_HASH : m_blockIndex.getTailId();
 }
 
 std::vector<crypto::hash_t> Blockchain::buildSparseChain() {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Tools::SharedLockGuard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
   assert(m_blockIndex.size() != 0);
   return doBuildSparseChain(m_blockIndex.getTailId());
 }
 
 std::vector<crypto::hash_t> Blockchain::buildSparseChain(const crypto::hash_t& startBlockId) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Tools::SharedLockGuard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
   assert(haveBlock(startBlockId));
   return doBuildSparseChain(startBlockId);
 }
@@ -355,18 +367,18 @@ std::vector<crypto::hash_t> Blockchain::doBuildSparseChain(const crypto::hash_t&
 }
 
 crypto::hash_t Blockchain::getBlockIdByHeight(uint32_t height) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Tools::SharedLockGuard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
   assert(height < m_blockIndex.size());
   return m_blockIndex.getBlockId(height);
 }
 
 bool Blockchain::getBlockByHash(const crypto::hash_t& blockHash, block_t& b) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Tools::SharedLockGuard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
 
   uint32_t height = 0;
 
   if (m_blockIndex.getBlockHeight(blockHash, height)) {
-    b = m_blocks[height].bl;
+    b = m_blocks.get(height)->bl;
     return true;
   }
 
@@ -382,12 +394,12 @@ bool Blockchain::getBlockByHash(const crypto::hash_t& blockHash, block_t& b) {
 }
 
 bool Blockchain::getBlockHeight(const crypto::hash_t& blockId, uint32_t& blockHeight) {
-  std::lock_guard<decltype(m_blockchain_lock)> lock(m_blockchain_lock);
+  Tools::SharedLockGuard<decltype(m_blockchain_lock)> lock(m_blockchain_lock);
   return m_blockIndex.getBlockHeight(blockId, blockHeight);
 }
 
 difficulty_t Blockchain::getDifficultyForNextBlock() {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Tools::SharedLockGuard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
   std::vector<uint64_t> timestamps;
   std::vector<difficulty_t> commulative_difficulties;
   size_t offset = m_blocks.size() - std::min(m_blocks.size(), static_cast<uint64_t>(m_currency.difficultyBlocksCount()));
@@ -396,19 +408,19 @@ difficulty_t Blockchain::getDifficultyForNextBlock() {
   }
 
   for (; offset < m_blocks.size(); offset++) {
-    timestamps.push_back(m_blocks[offset].bl.timestamp);
-    commulative_difficulties.push_back(m_blocks[offset].cumulative_difficulty);
+    timestamps.push_back(m_blocks.get(offset)->bl.timestamp);
+    commulative_difficulties.push_back(m_blocks.get(offset)->cumulative_difficulty);
   }
 
   return m_currency.nextDifficulty(timestamps, commulative_difficulties);
 }
 
 uint64_t Blockchain::getCoinsInCirculation() {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Tools::SharedLockGuard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
   if (m_blocks.empty()) {
     return 0;
   } else {
-    return m_blocks.back().already_generated_coins;
+    return m_blocks.getBack()->already_generated_coins;
   }
 }
 
@@ -416,7 +428,7 @@ bool Blockchain::rollback_blockchain_switching(std::list<block_t> &original_chai
   std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
   // remove failed subchain
   for (size_t i = m_blocks.size() - 1; i >= rollback_height; i--) {
-    popBlock(Block::getHash(m_blocks.back().bl));
+    popBlock(Block::getHash(m_blocks.getBack()->bl));
   }
 
   // return back original chain
@@ -453,7 +465,7 @@ bool Blockchain::switch_to_alternative_blockchain(std::list<blocks_ext_by_hash_t
   //disconnecting old chain
   std::list<block_t> disconnected_chain;
   for (size_t i = m_blocks.size() - 1; i >= split_height; i--) {
-    block_t b = m_blocks[i].bl;
+    block_t b = m_blocks.get(i)->bl;
     popBlock(Block::getHash(b));
     //if (!(r)) { logger(ERROR, BRIGHT_RED) << "failed to remove block on chain switching"; return false; }
     disconnected_chain.push_front(b);
@@ -517,7 +529,7 @@ difficulty_t Blockchain::get_next_difficulty_for_alternative_chain(const std::li
   std::vector<uint64_t> timestamps;
   std::vector<difficulty_t> commulative_difficulties;
   if (alt_chain.size() < m_currency.difficultyBlocksCount()) {
-    std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+    Tools::SharedLockGuard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
     size_t main_chain_stop_offset = alt_chain.size() ? alt_chain.front()->second.height : bei.height;
     size_t main_chain_count = m_currency.difficultyBlocksCount() - std::min(m_currency.difficultyBlocksCount(), alt_chain.size());
     main_chain_count = std::min(main_chain_count, main_chain_stop_offset);
@@ -526,8 +538,8 @@ difficulty_t Blockchain::get_next_difficulty_for_alternative_chain(const std::li
     if (!main_chain_start_offset)
       ++main_chain_start_offset; //skip genesis block
     for (; main_chain_start_offset < main_chain_stop_offset; ++main_chain_start_offset) {
-      timestamps.push_back(m_blocks[main_chain_start_offset].bl.timestamp);
-      commulative_difficulties.push_back(m_blocks[main_chain_start_offset].cumulative_difficulty);
+      timestamps.push_back(m_blocks.get(main_chain_start_offset)->bl.timestamp);
+      commulative_difficulties.push_back(m_blocks.get(main_chain_start_offset)->cumulative_difficulty);
     }
 
     if (!((alt_chain.size() + timestamps.size()) <= m_currency.difficultyBlocksCount())) {
@@ -623,7 +635,7 @@ bool Blockchain::validate_miner_transaction(const block_t& b, uint32_t height, s
 }
 
 bool Blockchain::getBackwardBlocksSize(size_t from_height, std::vector<size_t>& sz, size_t count) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Tools::SharedLockGuard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
   if (!(from_height < m_blocks.size())) {
     logger(ERROR, BRIGHT_RED)
       << "Internal error: get_backward_blocks_sizes called with from_height="
@@ -632,14 +644,14 @@ bool Blockchain::getBackwardBlocksSize(size_t from_height, std::vector<size_t>&
   }
   size_t start_offset = (from_height + 1) - std::min((from_height + 1), count);
   for (size_t i = start_offset; i != from_height + 1; i++) {
-    sz.push_back(m_blocks[i].block_cumulative_size);
+    sz.push_back(m_blocks.get(i)->block_cumulative_size);
   }
 
   return true;
 }
 
 bool Blockchain::get_last_n_blocks_sizes(std::vector<size_t>& sz, size_t count) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Tools::SharedLockGuard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
   if (!m_blocks.size()) {
     return true;
   }
@@ -655,12 +667,12 @@ bool Blockchain::complete_timestamps_vector(uint64_t start_top_height, std::vect
   if (timestamps.size() >= m_currency.timestampCheckWindow())
     return true;
 
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Tools::SharedLockGuard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
   size_t need_elements = m_currency.timestampCheckWindow() - timestamps.size();
   if (!(start_top_height < m_blocks.size())) { logger(ERROR, BRIGHT_RED) << "internal error: passed start_height = " << start_top_height << " not less then m_blocks.size()=" << m_blocks.size(); return false; }
   size_t stop_offset = start_top_height > need_elements ? start_top_height - need_elements : 0;
   do {
-    timestamps.push_back(m_blocks[start_top_height].bl.timestamp);
+    timestamps.push_back(m_blocks.get(start_top_height)->bl.timestamp);
     if (start_top_height == 0)
       break;
     --start_top_height;
@@ -720,7 +732,7 @@ bool Blockchain::handle_alternative_block(const block_t& b, const crypto::hash_t
       //make sure that it has right connection to main chain
       if (!(m_blocks.size() > alt_chain.front()->second.height)) { logger(ERROR, BRIGHT_RED) << "main blockchain wrong height"; return false; }
       crypto::hash_t h = NULL_HASH;
-      Block::getHash(m_blocks[alt_chain.front()->second.height - 1].bl, h);
+      Block::getHash(m_blocks.get(alt_chain.front()->second.height - 1)->bl, h);
       if (!(h == alt_chain.front()->second.bl.previousBlockHash)) { logger(ERROR, BRIGHT_RED) << "alternative chain have wrong connection to main chain"; return false; }
       complete_timestamps_vector(alt_chain.front()->second.height - 1, timestamps);
     } else {
@@ -771,7 +783,7 @@ bool Blockchain::handle_alternative_block(const block_t& b, const crypto::hash_t
       return false;
     }
 
-    bei.cumulative_difficulty = alt_chain.size() ? it_prev->second.cumulative_difficulty : m_blocks[mainPrevHeight].cumulative_difficulty;
+    bei.cumulative_difficulty = alt_chain.size() ? it_prev->second.cumulative_difficulty : m_blocks.get(mainPrevHeight)->cumulative_difficulty;
     bei.cumulative_difficulty += current_diff;
 
 #ifdef _DEBUG
@@ -799,11 +811,11 @@ bool Blockchain::handle_alternative_block(const block_t& b, const crypto::hash_t
         bvc.m_verifivation_failed = true;
       }
       return r;
-    } else if (m_blocks.back().cumulative_difficulty < bei.cumulative_difficulty) //check if difficulty bigger then in main chain
+    } else if (m_blocks.getBack()->cumulative_difficulty < bei.cumulative_difficulty) //check if difficulty bigger then in main chain
     {
       //do reorganize!
       logger(INFO, BRIGHT_GREEN) <<
-        "###### REORGANIZE on height: " << alt_chain.front()->second.height << " of " << m_blocks.size() - 1 << " with cum_difficulty " << m_blocks.back().cumulative_difficulty
+        "###### REORGANIZE on height: " << alt_chain.front()->second.height << " of " << m_blocks.size() - 1 << " with cum_difficulty " << m_blocks.getBack()->cumulative_difficulty
         << ENDL << " alternative blockchain size: " << alt_chain.size() << " with cum_difficulty " << bei.cumulative_difficulty;
       bool r = switch_to_alternative_blockchain(alt_chain, false);
       if (r) {
@@ -835,13 +847,13 @@ bool Blockchain::handle_alternative_block(const block_t& b, const crypto::hash_t
 }
 
 bool Blockchain::getBlocks(uint32_t start_offset, uint32_t count, std::list<block_t>& blocks, std::list<transaction_t>& txs) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Tools::SharedLockGuard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
   if (start_offset >= m_blocks.size())
     return false;
   for (size_t i = start_offset; i < start_offset + count && i < m_blocks.size(); i++) {
-    blocks.push_back(m_blocks[i].bl);
+    blocks.push_back(m_blocks.get(i)->bl);
     std::list<crypto::hash_t> missed_ids;
-    getTransactions(m_blocks[i].bl.transactionHashes, txs, missed_ids);
+    getTransactions(m_blocks.get(i)->bl.transactionHashes, txs, missed_ids);
     if (!(!missed_ids.size())) { logger(ERROR, BRIGHT_RED) << "have missed transactions in own block in main blockchain"; return false; }
   }
 
@@ -849,20 +861,20 @@ bool Blockchain::getBlocks(uint32_t start_offset, uint32_t count, std::list<bloc
 }
 
 bool Blockchain::getBlocks(uint32_t start_offset, uint32_t count, std::list<block_t>& blocks) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Tools::SharedLockGuard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
   if (start_offset >= m_blocks.size()) {
     return false;
   }
 
   for (uint32_t i = start_offset; i < start_offset + count && i < m_blocks.size(); i++) {
-    blocks.push_back(m_blocks[i].bl);
+    blocks.push_back(m_blocks.get(i)->bl);
   }
 
   return true;
 }
 
 bool Blockchain::handleGetObjects(NOTIFY_REQUEST_GET_OBJECTS::request& arg, NOTIFY_RESPONSE_GET_OBJECTS::request& rsp) { //Deprecated. Should be removed with CryptoNoteProtocolHandler.
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Tools::SharedLockGuard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
   rsp.current_blockchain_height = getHeight();
   std::list<block_t> blocks;
   getBlocks(arg.blocks, blocks, rsp.missed_ids);
@@ -894,7 +906,7 @@ bool Blockchain::handleGetObjects(NOTIFY_REQUEST_GET_OBJECTS::request& arg, NOTI
 }
 
 bool Blockchain::getAlternativeBlocks(std::list<block_t>& blocks) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Tools::SharedLockGuard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
   for (auto& alt_bl : m_alternative_chains) {
     blocks.push_back(alt_bl.second.bl);
   }
@@ -903,18 +915,19 @@ bool Blockchain::getAlternativeBlocks(std::list<block_t>& blocks) {
 }
 
 uint32_t Blockchain::getAlternativeBlocksCount() {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Tools::SharedLockGuard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
   return static_cast<uint32_t>(m_alternative_chains.size());
 }
 
-bool Blockchain::add_out_to_get_random_outs(std::vector<std::pair<transaction_index_t, uint16_t>>& amount_outs, COMMAND_RPC_GET_RANDOM_OUTPUTS_FOR_AMOUNTS::outs_for_amount& result_outs, uint64_t amount, size_t i) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
-  const transaction_t& tx = transactionByIndex(amount_outs[i].first).tx;
-  if (!(tx.outputs.size() > amount_outs[i].second)) {
+bool Blockchain::add_out_to_get_random_outs(const ChainIndexStore::output_t& amount_out, COMMAND_RPC_GET_RANDOM_OUTPUTS_FOR_AMOUNTS::outs_for_amount& result_outs, uint64_t amount, size_t i) {
+  Tools::SharedLockGuard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  std::shared_ptr<const transaction_entry_t> entry = transactionByIndex(amount_out.first);
+  const transaction_t& tx = entry->tx;
+  if (!(tx.outputs.size() > amount_out.second)) {
     logger(ERROR, BRIGHT_RED) << "internal error: in global outs index, transaction out index="
-      << amount_outs[i].second << " more than transaction outputs = " << tx.outputs.size() << ", for tx id = " << BinaryArray::objectHash(tx); return false;
+      << amount_out.second << " more than transaction outputs = " << tx.outputs.size() << ", for tx id = " << BinaryArray::objectHash(tx); return false;
   }
-  if (!(tx.outputs[amount_outs[i].second].target.type() == typeid(key_output_t))) { logger(ERROR, BRIGHT_RED) << "unknown tx out type"; return false; }
+  if (!(tx.outputs[amount_out.second].target.type() == typeid(key_output_t))) { logger(ERROR, BRIGHT_RED) << "unknown tx out type"; return false; }
 
   //check if transaction is unlocked
   if (!is_tx_spendtime_unlocked(tx.unlockTime))
@@ -922,20 +935,21 @@ bool Blockchain::add_out_to_get_random_outs(std::vector<std::pair<transaction_in
 
   COMMAND_RPC_GET_RANDOM_OUTPUTS_FOR_AMOUNTS::out_entry& oen = *result_outs.outs.insert(result_outs.outs.end(), COMMAND_RPC_GET_RANDOM_OUTPUTS_FOR_AMOUNTS::out_entry());
   oen.global_amount_index = static_cast<uint32_t>(i);
-  oen.out_key = boost::get<key_output_t>(tx.outputs[amount_outs[i].second].target).key;
+  oen.out_key = boost::get<key_output_t>(tx.outputs[amount_out.second].target).key;
   return true;
 }
 
-size_t Blockchain::find_end_of_allowed_index(const std::vector<std::pair<transaction_index_t, uint16_t>>& amount_outs) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
-  if (amount_outs.empty()) {
+size_t Blockchain::find_end_of_allowed_index(uint64_t amount, uint32_t count) {
+  Tools::SharedLockGuard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  if (count == 0) {
     return 0;
   }
 
-  size_t i = amount_outs.size();
+  uint32_t i = count;
   do {
     --i;
-    if (amount_outs[i].first.block + m_currency.minedMoneyUnlockWindow() <= getHeight()) {
+    ChainIndexStore::output_t amount_out;
+    if (m_chainStore.getOutput(amount, i, amount_out) && amount_out.first.block + m_currency.minedMoneyUnlockWindow() <= getHeight()) {
       return i + 1;
     }
   } while (i != 0);
@@ -944,28 +958,31 @@ size_t Blockchain::find_end_of_allowed_index(const std::vector<std::pair<transac
 }
 
 bool Blockchain::getRandomOutsByAmount(const COMMAND_RPC_GET_RANDOM_OUTPUTS_FOR_AMOUNTS::request& req, COMMAND_RPC_GET_RANDOM_OUTPUTS_FOR_AMOUNTS::response& res) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Tools::SharedLockGuard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
 
   for (uint64_t amount : req.amounts) {
     COMMAND_RPC_GET_RANDOM_OUTPUTS_FOR_AMOUNTS::outs_for_amount& result_outs = *res.outs.insert(res.outs.end(), COMMAND_RPC_GET_RANDOM_OUTPUTS_FOR_AMOUNTS::outs_for_amount());
     result_outs.amount = amount;
-    auto it = m_outputs.find(amount);
-    if (it == m_outputs.end()) {
+    uint32_t outputCount = m_chainStore.outputCount(amount);
+    if (outputCount == 0) {
       logger(ERROR, BRIGHT_RED) <<
         "COMMAND_RPC_GET_RANDOM_OUTPUTS_FOR_AMOUNTS: not outs for amount " << amount << ", wallet should use some real outs when it lookup for some mix, so, at least one out for this amount should exist";
       continue;//actually this is strange situation, wallet should use some real outs when it lookup for some mix, so, at least one out for this amount should exist
     }
 
-    std::vector<std::pair<transaction_index_t, uint16_t>>& amount_outs = it->second;
     //it is not good idea to use top fresh outs, because it increases possibility of transaction canceling on split
     //lets find upper bound of not fresh outs
-    size_t up_index_limit = find_end_of_allowed_index(amount_outs);
-    if (!(up_index_limit <= amount_outs.size())) { logger(ERROR, BRIGHT_RED) << "internal error: find_end_of_allowed_index returned wrong index=" << up_index_limit << ", with amount_outs.size = " << amount_outs.size(); return false; }
+    size_t up_index_limit = find_end_of_allowed_index(amount, outputCount);
+    if (!(up_index_limit <= outputCount)) { logger(ERROR, BRIGHT_RED) << "internal error: find_end_of_allowed_index returned wrong index=" << up_index_limit << ", with amount_outs.size = " << outputCount; return false; }
 
     if (up_index_limit > 0) {
       ShuffleGenerator<size_t, crypto::random_engine<size_t>> generator(up_index_limit);
       for (uint64_t j = 0; j < up_index_limit && result_outs.outs.size() < req.outs_count; ++j) {
-        add_out_to_get_random_outs(amount_outs, result_outs, amount, generator());
+        size_t i = generator();
+        ChainIndexStore::output_t amount_out;
+        if (m_chainStore.getOutput(amount, static_cast<uint32_t>(i), amount_out)) {
+          add_out_to_get_random_outs(amount_out, result_outs, amount, i);
+        }
       }
     }
   }
@@ -976,7 +993,7 @@ uint32_t Blockchain::findBlockchainSupplement(const std::vector<crypto::hash_t>&
   assert(!qblock_ids.empty());
   assert(qblock_ids.back() == m_blockIndex.getBlockId(0));
 
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Tools::SharedLockGuard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
   uint32_t blockIndex;
   // assert above guarantees that method returns true
   m_blockIndex.findSupplement(qblock_ids, blockIndex);
@@ -984,17 +1001,17 @@ uint32_t Blockchain::findBlockchainSupplement(const std::vector<crypto::hash_t>&
 }
 
 uint64_t Blockchain::blockDifficulty(size_t i) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Tools::SharedLockGuard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
   if (!(i < m_blocks.size())) { logger(ERROR, BRIGHT_RED) << "wrong block index i = " << i << " at Blockchain::block_difficulty()"; return false; }
   if (i == 0)
-    return m_blocks[i].cumulative_difficulty;
+    return m_blocks.get(i)->cumulative_difficulty;
 
-  return m_blocks[i].cumulative_difficulty - m_blocks[i - 1].cumulative_difficulty;
+  return m_blocks.get(i)->cumulative_difficulty - m_blocks.get(i - 1)->cumulative_difficulty;
 }
 
 void Blockchain::print_blockchain(uint64_t start_index, uint64_t end_index) {
   std::stringstream ss;
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Tools::SharedLockGuard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
   if (start_index >= m_blocks.size()) {
     logger(INFO, BRIGHT_WHITE) <<
       "Wrong starter index set: " << start_index << ", expected max index " << m_blocks.size() - 1;
@@ -1002,7 +1019,7 @@ void Blockchain::print_blockchain(uint64_t start_index, uint64_t end_index) {
   }
 
   for (size_t i = start_index; i != m_blocks.size() && i != end_index; i++) {
-    ss << Block::toString(m_blocks[i]);
+    ss << Block::toString(*m_blocks.get(i));
     ss << "Difficulty: " << blockDifficulty(i) << std::endl;
   }
   logger(DEBUGGING) <<
@@ -1013,7 +1030,7 @@ void Blockchain::print_blockchain(uint64_t start_index, uint64_t end_index) {
 
 void Blockchain::print_blockchain_index() {
   std::stringstream ss;
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Tools::SharedLockGuard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
 
   std::vector<crypto::hash_t> blockIds = m_blockIndex.getBlockIds(0, std::numeric_limits<uint32_t>::max());
   logger(INFO, BRIGHT_WHITE) << "Current blockchain index:";
@@ -1027,13 +1044,16 @@ void Blockchain::print_blockchain_index() {
 
 void Blockchain::print_blockchain_outs(const std::string& file) {
   std::stringstream ss;
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
-  for (const outputs_container_t::value_type& v : m_outputs) {
-    const std::vector<std::pair<transaction_index_t, uint16_t>>& vals = v.second;
-    if (!vals.empty()) {
-      ss << "amount: " << v.first << ENDL;
-      for (size_t i = 0; i != vals.size(); i++) {
-        ss << "\t" << BinaryArray::objectHash(transactionByIndex(vals[i].first).tx) << ": " << vals[i].second << ENDL;
+  Tools::SharedLockGuard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  for (uint64_t amount : m_chainStore.outputAmounts()) {
+    uint32_t count = m_chainStore.outputCount(amount);
+    if (count != 0) {
+      ss << "amount: " << amount << ENDL;
+      for (uint32_t i = 0; i != count; i++) {
+        ChainIndexStore::output_t out;
+        if (m_chainStore.getOutput(amount, i, out)) {
+          ss << "\t" << BinaryArray::objectHash(transactionByIndex(out.first)->tx) << ": " << out.second << ENDL;
+        }
       }
     }
   }
@@ -1053,7 +1073,7 @@ std::vector<crypto::hash_t> Blockchain::findBlockchainSupplement(const std::vect
   assert(!remoteBlockIds.empty());
   assert(remoteBlockIds.back() == m_blockIndex.getBlockId(0));
 
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Tools::SharedLockGuard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
   totalBlockCount = getHeight();
   startBlockIndex = findBlockchainSupplement(remoteBlockIds);
 
@@ -1061,7 +1081,7 @@ std::vector<crypto::hash_t> Blockchain::findBlockchainSupplement(const std::vect
 }
 
 bool Blockchain::haveBlock(const crypto::hash_t& id) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Tools::SharedLockGuard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
   if (m_blockIndex.hasBlock(id))
     return true;
 
@@ -1072,41 +1092,41 @@ bool Blockchain::haveBlock(const crypto::hash_t& id) {
 }
 
 size_t Blockchain::getTotalTransactions() {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
-  return m_transactionMap.size();
+  Tools::SharedLockGuard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  return m_chainStore.transactionCount();
 }
 
 bool Blockchain::getTransactionOutputGlobalIndexes(const crypto::hash_t& tx_id, std::vector<uint32_t>& indexs) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
-  auto it = m_transactionMap.find(tx_id);
-  if (it == m_transactionMap.end()) {
+  Tools::SharedLockGuard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  transaction_index_t transactionIndex;
+  if (!m_chainStore.findTransaction(tx_id, transactionIndex)) {
     logger(WARNING, YELLOW) << "warning: get_tx_outputs_gindexs failed to find transaction with id = " << tx_id;
     return false;
   }
 
-  const transaction_entry_t& tx = transactionByIndex(it->second);
-  if (!(tx.m_global_output_indexes.size())) { logger(ERROR, BRIGHT_RED) << "internal error: global indexes for transaction " << tx_id << " is empty"; return false; }
-  indexs.resize(tx.m_global_output_indexes.size());
-  for (size_t i = 0; i < tx.m_global_output_indexes.size(); ++i) {
-    indexs[i] = tx.m_global_output_indexes[i];
+  std::shared_ptr<const transaction_entry_t> tx = transactionByIndex(transactionIndex);
+  if (!(tx->m_global_output_indexes.size())) { logger(ERROR, BRIGHT_RED) << "internal error: global indexes for transaction " << tx_id << " is empty"; return false; }
+  indexs.resize(tx->m_global_output_indexes.size());
+  for (size_t i = 0; i < tx->m_global_output_indexes.size(); ++i) {
+    indexs[i] = tx->m_global_output_indexes[i];
   }
 
   return true;
 }
 
 bool Blockchain::get_out_by_msig_gindex(uint64_t amount, uint64_t gindex, multi_signature_output_t& out) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
-  auto it = m_multisignatureOutputs.find(amount);
-  if (it == m_multisignatureOutputs.end()) {
+  Tools::SharedLockGuard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  if (m_chainStore.multisignatureOutputCount(amount) <= gindex) {
     return false;
   }
 
-  if (it->second.size() <= gindex) {
+  multisignature_output_usage_t msigUsage;
+  if (!m_chainStore.getMultisignatureOutput(amount, static_cast<uint32_t>(gindex), msigUsage)) {
     return false;
   }
 
-  auto msigUsage = it->second[gindex];
-  auto& targetOut = transactionByIndex(msigUsage.transactionIndex).tx.outputs[msigUsage.outputIndex].target;
+  std::shared_ptr<const transaction_entry_t> tx = transactionByIndex(msigUsage.transactionIndex);
+  auto& targetOut = tx->tx.outputs[msigUsage.outputIndex].target;
   if (targetOut.type() != typeid(multi_signature_output_t)) {
     return false;
   }
@@ -1118,15 +1138,27 @@ bool Blockchain::get_out_by_msig_gindex(uint64_t amount, uint64_t gindex, multi_
 
 
 bool Blockchain::checkTransactionInputs(const transaction_t& tx, uint32_t& max_used_block_height, crypto::hash_t& max_used_block_id, block_info_t* tail) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  std::vector<ring_signature_check_t> ringSignatureChecks;
+  {
+    Tools::SharedLockGuard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+
+    if (tail)
+      tail->id = getTailId(tail->height);
+
+    crypto::hash_t tx_prefix_hash = BinaryArray::objectHash(*static_cast<const transaction_prefix_t*>(&tx));
+    bool res = collectTransactionInputs(tx, tx_prefix_hash, ringSignatureChecks, &max_used_block_height);
+    if (!res) return false;
+    if (!(max_used_block_height < m_blocks.size())) { logger(ERROR, BRIGHT_RED) << "internal error: max used block index=" << max_used_block_height << " is not less then blockchain size = " << m_blocks.size(); return false; }
+    Block::getHash(m_blocks.get(max_used_block_height)->bl, max_used_block_id);
+  }
 
-  if (tail)
-    tail->id = getTailId(tail->height);
+  // Ring signatures only depend on the gathered keys, so they are checked without holding the lock
+  if (!m_ringSignatureVerifier.verify(ringSignatureChecks)) {
+    logger(INFO, BRIGHT_WHITE) <<
+      "Failed to check ring signature for tx " << BinaryArray::objectHash(tx);
+    return false;
+  }
 
-  bool res = checkTransactionInputs(tx, &max_used_block_height);
-  if (!res) return false;
-  if (!(max_used_block_height < m_blocks.size())) { logger(ERROR, BRIGHT_RED) << "internal error: max used block index=" << max_used_block_height << " is not less then blockchain size = " << m_blocks.size(); return false; }
-  Block::getHash(m_blocks[max_used_block_height].bl, max_used_block_id);
   return true;
 }
 
@@ -1142,12 +1174,11 @@ bool Blockchain::haveTransactionKeyImagesAsSpent(const transaction_t &tx) {
   return false;
 }
 
-bool Blockchain::checkTransactionInputs(const transaction_t& tx, uint32_t* pmax_used_block_height) {
-  crypto::hash_t tx_prefix_hash = BinaryArray::objectHash(*static_cast<const transaction_prefix_t*>(&tx));
-  return checkTransactionInputs(tx, tx_prefix_hash, pmax_used_block_height);
-}
-
-bool Blockchain::checkTransactionInputs(const transaction_t& tx, const crypto::hash_t& tx_prefix_hash, uint32_t* pmax_used_block_height) {
+/**
+* \pre m_blockchain_lock is locked
+* Checks everything but ring signatures, those are appended to ringSignatureChecks for RingSignatureVerifier
+*/
+bool Blockchain::collectTransactionInputs(const transaction_t& tx, const crypto::hash_t& tx_prefix_hash, std::vector<ring_signature_check_t>& ringSignatureChecks, uint32_t* pmax_used_block_height) {
   size_t inputIndex = 0;
   if (pmax_used_block_height) {
     *pmax_used_block_height = 0;
@@ -1166,9 +1197,9 @@ bool Blockchain::checkTransactionInputs(const transaction_t& tx, const crypto::h
         return false;
       }
 
-      if (!check_tx_input(in_to_key, tx_prefix_hash, tx.signatures[inputIndex], pmax_used_block_height)) {
+      if (!check_tx_input(in_to_key, tx_prefix_hash, tx.signatures[inputIndex], ringSignatureChecks, pmax_used_block_height)) {
         logger(INFO, BRIGHT_WHITE) <<
-          "Failed to check ring signature for tx " << transactionHash;
+          "Failed to check inputs for tx " << transactionHash;
         return false;
       }
 
@@ -1208,14 +1239,14 @@ bool Blockchain::is_tx_spendtime_unlocked(uint64_t unlock_time) {
   return false;
 }
 
-bool Blockchain::check_tx_input(const key_input_t& txin, const crypto::hash_t& tx_prefix_hash, const std::vector<crypto::signature_t>& sig, uint32_t* pmax_related_block_height) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+bool Blockchain::check_tx_input(const key_input_t& txin, const crypto::hash_t& tx_prefix_hash, const std::vector<crypto::signature_t>& sig, std::vector<ring_signature_check_t>& ringSignatureChecks, uint32_t* pmax_related_block_height) {
+  Tools::SharedLockGuard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
 
   struct outputs_visitor {
-    std::vector<const crypto::public_key_t *>& m_results_collector;
+    std::vector<crypto::public_key_t>& m_results_collector;
     Blockchain& m_bch;
     LoggerRef logger;
-    outputs_visitor(std::vector<const crypto::public_key_t *>& results_collector, Blockchain& bch, ILogger& logger) :m_results_collector(results_collector), m_bch(bch), logger(logger, "outputs_visitor") {
+    outputs_visitor(std::vector<crypto::public_key_t>& results_collector, Blockchain& bch, ILogger& logger) :m_results_collector(results_collector), m_bch(bch), logger(logger, "outputs_visitor") {
     }
 
     bool handle_output(const transaction_t& tx, const transaction_output_t& out, size_t transactionOutputIndex) {
@@ -1232,13 +1263,13 @@ bool Blockchain::check_tx_input(const key_input_t& txin, const crypto::hash_t& t
         return false;
       }
 
-      m_results_collector.push_back(&boost::get<key_output_t>(out.target).key);
+      m_results_collector.push_back(boost::get<key_output_t>(out.target).key);
       return true;
     }
   };
 
   //check ring signature
-  std::vector<const crypto::public_key_t *> output_keys;
+  std::vector<crypto::public_key_t> output_keys;
   outputs_visitor vi(output_keys, *this, logger.getLogger());
   if (!scanOutputKeysForIndexes(txin, vi, pmax_related_block_height)) {
     logger(INFO, BRIGHT_WHITE) <<
@@ -1258,7 +1289,13 @@ bool Blockchain::check_tx_input(const key_input_t& txin, const crypto::hash_t& t
     return true;
   }
 
-  return crypto::check_ring_signature(tx_prefix_hash, txin.keyImage, output_keys, sig.data());
+  ringSignatureChecks.emplace_back();
+  ring_signature_check_t& check = ringSignatureChecks.back();
+  check.prefixHash = tx_prefix_hash;
+  check.keyImage = txin.keyImage;
+  check.outputKeys = std::move(output_keys);
+  check.signatures = sig;
+  return true;
 }
 
 uint64_t Blockchain::get_adjusted_time() {
@@ -1276,7 +1313,7 @@ bool Blockchain::check_block_timestamp_main(const block_t& b) {
   std::vector<uint64_t> timestamps;
   size_t offset = m_blocks.size() <= m_currency.timestampCheckWindow() ? 0 : m_blocks.size() - m_currency.timestampCheckWindow();
   for (; offset != m_blocks.size(); ++offset) {
-    timestamps.push_back(m_blocks[offset].bl.timestamp);
+    timestamps.push_back(m_blocks.get(offset)->bl.timestamp);
   }
 
   return check_block_timestamp(std::move(timestamps), b);
@@ -1339,7 +1376,7 @@ bool Blockchain::update_next_comulative_size_limit() {
   return true;
 }
 
-bool Blockchain::addNewBlock(const block_t& bl_, block_verification_context_t& bvc) {
+bool Blockchain::addNewBlock(const block_t& bl_, block_verification_context_t& bvc, const crypto::hash_t* proofOfWork) {
   //copy block here to let modify block.target
   block_t bl = bl_;
   crypto::hash_t id;
@@ -1368,7 +1405,7 @@ bool Blockchain::addNewBlock(const block_t& bl_, block_verification_context_t& b
       bvc.m_added_to_main_chain = false;
       add_result = handle_alternative_block(bl, id, bvc);
     } else {
-      add_result = pushBlock(bl, bvc);
+      add_result = pushBlock(bl, bvc, proofOfWork);
       if (add_result) {
         sendMessage(BlockchainMessage(NewBlockMessage(id)));
       }
@@ -1382,18 +1419,19 @@ bool Blockchain::addNewBlock(const block_t& bl_, block_verification_context_t& b
   return add_result;
 }
 
-const transaction_entry_t& Blockchain::transactionByIndex(transaction_index_t index) {
-  return m_blocks[index.block].transactions[index.transaction];
+std::shared_ptr<const transaction_entry_t> Blockchain::transactionByIndex(transaction_index_t index) {
+  std::shared_ptr<const block_entry_t> block = m_blocks.get(index.block);
+  return std::shared_ptr<const transaction_entry_t>(block, &block->transactions[index.transaction]);
 }
 
-bool Blockchain::pushBlock(const block_t& blockData, block_verification_context_t& bvc) {
+bool Blockchain::pushBlock(const block_t& blockData, block_verification_context_t& bvc, const crypto::hash_t* proofOfWork) {
   std::vector<transaction_t> transactions;
   if (!loadTransactions(blockData, transactions)) {
     bvc.m_verifivation_failed = true;
     return false;
   }
 
-  if (!pushBlock(blockData, transactions, bvc)) {
+  if (!pushBlock(blockData, transactions, bvc, proofOfWork)) {
     saveTransactions(transactions);
     return false;
   }
@@ -1401,7 +1439,7 @@ bool Blockchain::pushBlock(const block_t& blockData, block_verification_context_
   return true;
 }
 
-bool Blockchain::pushBlock(const block_t& blockData, const std::vector<transaction_t>& transactions, block_verification_context_t& bvc) {
+bool Blockchain::pushBlock(const block_t& blockData, const std::vector<transaction_t>& transactions, block_verification_context_t& bvc, const crypto::hash_t* proofOfWork) {
   std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
 
   auto blockProcessingStart = std::chrono::steady_clock::now();
@@ -1449,7 +1487,16 @@ bool Blockchain::pushBlock(const block_t& blockData, const std::vector<transacti
       return false;
     }
   } else {
-    if (!Block::checkProofOfWork(blockData, currentDifficulty, proof_of_work)) {
+    // The long hash may have been computed ahead by the block import pipeline
+    bool powValid;
+    if (proofOfWork != NULL) {
+      proof_of_work = *proofOfWork;
+      powValid = check_hash(proof_of_work, currentDifficulty);
+    } else {
+      powValid = Block::checkProofOfWork(blockData, currentDifficulty, proof_of_work);
+    }
+
+    if (!powValid) {
       logger(INFO, BRIGHT_WHITE) <<
         "Block " << blockHash << ", has too weak proof of work: " << proof_of_work << ", expected difficulty: " << currentDifficulty;
       bvc.m_verifivation_failed = true;
@@ -1478,6 +1525,7 @@ bool Blockchain::pushBlock(const block_t& blockData, const std::vector<transacti
   size_t coinbase_blob_size = BinaryArray::size(blockData.baseTransaction);
   size_t cumulative_block_size = coinbase_blob_size;
   uint64_t fee_summary = 0;
+  std::vector<ring_signature_check_t> ringSignatureChecks;
   for (size_t i = 0; i < transactions.size(); ++i) {
     const crypto::hash_t& tx_id = blockData.transactionHashes[i];
     block.transactions.resize(block.transactions.size() + 1);
@@ -1487,7 +1535,8 @@ bool Blockchain::pushBlock(const block_t& blockData, const std::vector<transacti
 
     blob_size = BinaryArray::to(block.transactions.back().tx).size();
     fee = getInputAmount(block.transactions.back().tx) - getOutputAmount(block.transactions.back().tx);
-    if (!checkTransactionInputs(block.transactions.back().tx)) {
+    crypto::hash_t tx_prefix_hash = BinaryArray::objectHash(*static_cast<const transaction_prefix_t*>(&block.transactions.back().tx));
+    if (!collectTransactionInputs(block.transactions.back().tx, tx_prefix_hash, ringSignatureChecks)) {
       logger(INFO, BRIGHT_WHITE) <<
         "Block " << blockHash << " has at least one transaction with wrong inputs: " << tx_id;
       bvc.m_verifivation_failed = true;
@@ -1511,7 +1560,7 @@ bool Blockchain::pushBlock(const block_t& blockData, const std::vector<transacti
 
   int64_t emissionChange = 0;
   uint64_t reward = 0;
-  uint64_t already_generated_coins = m_blocks.empty() ? 0 : m_blocks.back().already_generated_coins;
+  uint64_t already_generated_coins = m_blocks.empty() ? 0 : m_blocks.getBack()->already_generated_coins;
   if (!validate_miner_transaction(blockData, static_cast<uint32_t>(m_blocks.size()), cumulative_block_size, already_generated_coins, fee_summary, reward, emissionChange)) {
     logger(INFO, BRIGHT_WHITE) << "Block " << blockHash << " has invalid miner transaction";
     bvc.m_verifivation_failed = true;
@@ -1519,12 +1568,21 @@ bool Blockchain::pushBlock(const block_t& blockData, const std::vector<transacti
     return false;
   }
 
+  // Signatures of all block transactions are verified at once to spread them over all cores
+  if (!m_ringSignatureVerifier.verify(ringSignatureChecks)) {
+    logger(INFO, BRIGHT_WHITE) <<
+      "Block " << blockHash << " has at least one transaction with invalid ring signature";
+    bvc.m_verifivation_failed = true;
+    popTransactions(block, minerTransactionHash);
+    return false;
+  }
+
   block.height = static_cast<uint32_t>(m_blocks.size());
   block.block_cumulative_size = cumulative_block_size;
   block.cumulative_difficulty = currentDifficulty;
   block.already_generated_coins = already_generated_coins + emissionChange;
   if (m_blocks.size() > 0) {
-    block.cumulative_difficulty += m_blocks.back().cumulative_difficulty;
+    block.cumulative_difficulty += m_blocks.getBack()->cumulative_difficulty;
   }
 
   pushBlock(block);
@@ -1551,12 +1609,19 @@ bool Blockchain::pushBlock(block_entry_t& block) {
 
   m_blocks.push_back(block);
   m_blockIndex.push(blockHash);
+  m_chainStore.pushBlock(static_cast<uint32_t>(m_blocks.size() - 1), blockHash);
 
   m_timestampIndex.add(block.bl.timestamp, blockHash);
   m_generatedTransactionsIndex.add(block.bl);
+  logIndicesDelta(makeIndicesDelta(block, blockHash, true));
 
   assert(m_blockIndex.size() == m_blocks.size());
 
+  if (++m_uncommittedBlocks >= m_currency.blockIndexFlushInterval()) {
+    commitCache();
+  }
+
+  m_tx_pool.on_blockchain_inc(m_blocks.size(), blockHash);
   return true;
 }
 
@@ -1567,27 +1632,34 @@ void Blockchain::popBlock(const crypto::hash_t& blockHash) {
     return;
   }
 
-  std::vector<transaction_t> transactions(m_blocks.back().transactions.size() - 1);
-  for (size_t i = 0; i < m_blocks.back().transactions.size() - 1; ++i) {
-    transactions[i] = m_blocks.back().transactions[1 + i].tx;
+  std::shared_ptr<const block_entry_t> block = m_blocks.getBack();
+  std::vector<transaction_t> transactions(block->transactions.size() - 1);
+  for (size_t i = 0; i < block->transactions.size() - 1; ++i) {
+    transactions[i] = block->transactions[1 + i].tx;
   }
 
   saveTransactions(transactions);
 
-  popTransactions(m_blocks.back(), BinaryArray::objectHash(m_blocks.back().bl.baseTransaction));
+  popTransactions(*block, BinaryArray::objectHash(block->bl.baseTransaction));
 
-  m_timestampIndex.remove(m_blocks.back().bl.timestamp, blockHash);
-  m_generatedTransactionsIndex.remove(m_blocks.back().bl);
+  m_timestampIndex.remove(block->bl.timestamp, blockHash);
+  m_generatedTransactionsIndex.remove(block->bl);
+  logIndicesDelta(makeIndicesDelta(*block, blockHash, false));
 
   m_blocks.pop_back();
   m_blockIndex.pop();
+  m_chainStore.popBlock(static_cast<uint32_t>(m_blocks.size()));
 
   assert(m_blockIndex.size() == m_blocks.size());
+
+  // The blocks file drops the popped block at once, the store has to follow
+  commitCache();
+  m_tx_pool.on_blockchain_dec(m_blocks.size(), m_blocks.empty() ? NULL_HASH : m_blockIndex.getTailId());
+  m_observerManager.notify(&IBlockchainStorageObserver::blockPopped, blockHash);
 }
 
 bool Blockchain::pushTransaction(block_entry_t& block, const crypto::hash_t& transactionHash, transaction_index_t transactionIndex) {
-  auto result = m_transactionMap.insert(std::make_pair(transactionHash, transactionIndex));
-  if (!result.second) {
+  if (!m_chainStore.addTransaction(transactionHash, transactionIndex)) {
     logger(ERROR, BRIGHT_RED) <<
       "Duplicate transaction was pushed to blockchain.";
     return false;
@@ -1598,21 +1670,22 @@ bool Blockchain::pushTransaction(block_entry_t& block, const crypto::hash_t& tra
   if (!checkMultisignatureInputsDiff(transaction.tx)) {
     logger(ERROR, BRIGHT_RED) <<
       "Double spending transaction was pushed to blockchain.";
-    m_transactionMap.erase(transactionHash);
+    m_chainStore.removeTransaction(transactionHash);
     return false;
   }
 
   for (size_t i = 0; i < transaction.tx.inputs.size(); ++i) {
     if (transaction.tx.inputs[i].type() == typeid(key_input_t)) {
-      auto result = m_spent_keys.insert(::boost::get<key_input_t>(transaction.tx.inputs[i]).keyImage);
-      if (!result.second) {
+      if (!m_chainStore.addKeyImage(::boost::get<key_input_t>(transaction.tx.inputs[i]).keyImage)) {
         logger(ERROR, BRIGHT_RED) <<
           "Double spending transaction was pushed to blockchain.";
         for (size_t j = 0; j < i; ++j) {
-          m_spent_keys.erase(::boost::get<key_input_t>(transaction.tx.inputs[i - 1 - j]).keyImage);
+          if (transaction.tx.inputs[i - 1 - j].type() == typeid(key_input_t)) {
+            m_chainStore.removeKeyImage(::boost::get<key_input_t>(transaction.tx.inputs[i - 1 - j]).keyImage);
+          }
         }
 
-        m_transactionMap.erase(transactionHash);
+        m_chainStore.removeTransaction(transactionHash);
         return false;
       }
     }
@@ -1621,22 +1694,17 @@ bool Blockchain::pushTransaction(block_entry_t& block, const crypto::hash_t& tra
   for (const auto& inv : transaction.tx.inputs) {
     if (inv.type() == typeid(multi_signature_input_t)) {
       const multi_signature_input_t& in = ::boost::get<multi_signature_input_t>(inv);
-      auto& amountOutputs = m_multisignatureOutputs[in.amount];
-      amountOutputs[in.outputIndex].isUsed = true;
+      m_chainStore.setMultisignatureOutputUsed(in.amount, in.outputIndex, true);
     }
   }
 
   transaction.m_global_output_indexes.resize(transaction.tx.outputs.size());
   for (uint16_t output = 0; output < transaction.tx.outputs.size(); ++output) {
     if (transaction.tx.outputs[output].target.type() == typeid(key_output_t)) {
-      auto& amountOutputs = m_outputs[transaction.tx.outputs[output].amount];
-      transaction.m_global_output_indexes[output] = static_cast<uint32_t>(amountOutputs.size());
-      amountOutputs.push_back(std::make_pair<>(transactionIndex, output));
+      transaction.m_global_output_indexes[output] = m_chainStore.pushOutput(transaction.tx.outputs[output].amount, std::make_pair<>(transactionIndex, output));
     } else if (transaction.tx.outputs[output].target.type() == typeid(multi_signature_output_t)) {
-      auto& amountOutputs = m_multisignatureOutputs[transaction.tx.outputs[output].amount];
-      transaction.m_global_output_indexes[output] = static_cast<uint32_t>(amountOutputs.size());
       multisignature_output_usage_t outputUsage = { transactionIndex, output, false };
-      amountOutputs.push_back(outputUsage);
+      transaction.m_global_output_indexes[output] = m_chainStore.pushMultisignatureOutput(transaction.tx.outputs[output].amount, outputUsage);
     }
   }
 
@@ -1646,104 +1714,101 @@ bool Blockchain::pushTransaction(block_entry_t& block, const crypto::hash_t& tra
 }
 
 void Blockchain::popTransaction(const transaction_t& transaction, const crypto::hash_t& transactionHash) {
-  transaction_index_t transactionIndex = m_transactionMap.at(transactionHash);
+  transaction_index_t transactionIndex;
+  if (!m_chainStore.findTransaction(transactionHash, transactionIndex)) {
+    logger(ERROR, BRIGHT_RED) <<
+      "Blockchain consistency broken - cannot find transaction by hash.";
+    return;
+  }
+
   for (size_t outputIndex = 0; outputIndex < transaction.outputs.size(); ++outputIndex) {
     const transaction_output_t& output = transaction.outputs[transaction.outputs.size() - 1 - outputIndex];
     if (output.target.type() == typeid(key_output_t)) {
-      auto amountOutputs = m_outputs.find(output.amount);
-      if (amountOutputs == m_outputs.end()) {
+      uint32_t count = m_chainStore.outputCount(output.amount);
+      if (count == 0) {
         logger(ERROR, BRIGHT_RED) <<
           "Blockchain consistency broken - cannot find specific amount in outputs map.";
         continue;
       }
 
-      if (amountOutputs->second.empty()) {
+      ChainIndexStore::output_t last;
+      if (!m_chainStore.getOutput(output.amount, count - 1, last)) {
         logger(ERROR, BRIGHT_RED) <<
           "Blockchain consistency broken - output array for specific amount is empty.";
         continue;
       }
 
-      if (amountOutputs->second.back().first.block != transactionIndex.block || amountOutputs->second.back().first.transaction != transactionIndex.transaction) {
+      if (last.first.block != transactionIndex.block || last.first.transaction != transactionIndex.transaction) {
         logger(ERROR, BRIGHT_RED) <<
           "Blockchain consistency broken - invalid transaction index.";
         continue;
       }
 
-      if (amountOutputs->second.back().second != transaction.outputs.size() - 1 - outputIndex) {
+      if (last.second != transaction.outputs.size() - 1 - outputIndex) {
         logger(ERROR, BRIGHT_RED) <<
           "Blockchain consistency broken - invalid output index.";
         continue;
       }
 
-      amountOutputs->second.pop_back();
-      if (amountOutputs->second.empty()) {
-        m_outputs.erase(amountOutputs);
-      }
+      m_chainStore.popOutput(output.amount);
     } else if (output.target.type() == typeid(multi_signature_output_t)) {
-      auto amountOutputs = m_multisignatureOutputs.find(output.amount);
-      if (amountOutputs == m_multisignatureOutputs.end()) {
+      uint32_t count = m_chainStore.multisignatureOutputCount(output.amount);
+      if (count == 0) {
         logger(ERROR, BRIGHT_RED) <<
           "Blockchain consistency broken - cannot find specific amount in outputs map.";
         continue;
       }
 
-      if (amountOutputs->second.empty()) {
+      multisignature_output_usage_t last;
+      if (!m_chainStore.getMultisignatureOutput(output.amount, count - 1, last)) {
         logger(ERROR, BRIGHT_RED) <<
           "Blockchain consistency broken - output array for specific amount is empty.";
         continue;
       }
 
-      if (amountOutputs->second.back().isUsed) {
+      if (last.isUsed) {
         logger(ERROR, BRIGHT_RED) <<
           "Blockchain consistency broken - attempting to remove used output.";
         continue;
       }
 
-      if (amountOutputs->second.back().transactionIndex.block != transactionIndex.block || amountOutputs->second.back().transactionIndex.transaction != transactionIndex.transaction) {
+      if (last.transactionIndex.block != transactionIndex.block || last.transactionIndex.transaction != transactionIndex.transaction) {
         logger(ERROR, BRIGHT_RED) <<
           "Blockchain consistency broken - invalid transaction index.";
         continue;
       }
 
-      if (amountOutputs->second.back().outputIndex != transaction.outputs.size() - 1 - outputIndex) {
+      if (last.outputIndex != transaction.outputs.size() - 1 - outputIndex) {
         logger(ERROR, BRIGHT_RED) <<
           "Blockchain consistency broken - invalid output index.";
         continue;
       }
 
-      amountOutputs->second.pop_back();
-      if (amountOutputs->second.empty()) {
-        m_multisignatureOutputs.erase(amountOutputs);
-      }
+      m_chainStore.popMultisignatureOutput(output.amount);
     }
   }
 
   for (auto& input : transaction.inputs) {
     if (input.type() == typeid(key_input_t)) {
-      size_t count = m_spent_keys.erase(::boost::get<key_input_t>(input).keyImage);
-      if (count != 1) {
+      if (!m_chainStore.removeKeyImage(::boost::get<key_input_t>(input).keyImage)) {
         logger(ERROR, BRIGHT_RED) <<
           "Blockchain consistency broken - cannot find spent key.";
       }
     } else if (input.type() == typeid(multi_signature_input_t)) {
       const multi_signature_input_t& in = ::boost::get<multi_signature_input_t>(input);
-      auto& amountOutputs = m_multisignatureOutputs[in.amount];
-      if (!amountOutputs[in.outputIndex].isUsed) {
+      multisignature_output_usage_t usage;
+      if (!m_chainStore.getMultisignatureOutput(in.amount, in.outputIndex, usage) || !usage.isUsed) {
         logger(ERROR, BRIGHT_RED) <<
           "Blockchain consistency broken - multisignature output not marked as used.";
       }
 
-      amountOutputs[in.outputIndex].isUsed = false;
+      m_chainStore.setMultisignatureOutputUsed(in.amount, in.outputIndex, false);
     }
   }
 
   m_paymentIdIndex.remove(transaction);
 
-  size_t count = m_transactionMap.erase(transactionHash);
-  if (count != 1) {
-    logger(ERROR, BRIGHT_RED) <<
-      "Blockchain consistency broken - cannot find transaction by hash.";
-  }
+  m_chainStore.removeTransaction(transactionHash);
 }
 
 void Blockchain::popTransactions(const block_entry_t& block, const crypto::hash_t& minerTransactionHash) {
@@ -1756,27 +1821,28 @@ void Blockchain::popTransactions(const block_entry_t& block, const crypto::hash_
 
 bool Blockchain::validateInput(const multi_signature_input_t& input, const crypto::hash_t& transactionHash, const crypto::hash_t& transactionPrefixHash, const std::vector<crypto::signature_t>& transactionSignatures) {
   assert(input.signatureCount == transactionSignatures.size());
-  multisignature_outputs_container_t::const_iterator amountOutputs = m_multisignatureOutputs.find(input.amount);
-  if (amountOutputs == m_multisignatureOutputs.end()) {
+  uint32_t outputCount = m_chainStore.multisignatureOutputCount(input.amount);
+  if (outputCount == 0) {
     logger(DEBUGGING) <<
       "transaction_t << " << transactionHash << " contains multisignature input with invalid amount.";
     return false;
   }
 
-  if (input.outputIndex >= amountOutputs->second.size()) {
+  multisignature_output_usage_t outputIndex;
+  if (input.outputIndex >= outputCount || !m_chainStore.getMultisignatureOutput(input.amount, input.outputIndex, outputIndex)) {
     logger(DEBUGGING) <<
       "transaction_t << " << transactionHash << " contains multisignature input with invalid outputIndex.";
     return false;
   }
 
-  const multisignature_output_usage_t& outputIndex = amountOutputs->second[input.outputIndex];
   if (outputIndex.isUsed) {
     logger(DEBUGGING) <<
       "transaction_t << " << transactionHash << " contains double spending multisignature input.";
     return false;
   }
 
-  const transaction_t& outputTransaction = m_blocks[outputIndex.transactionIndex.block].transactions[outputIndex.transactionIndex.transaction].tx;
+  std::shared_ptr<const transaction_entry_t> outputEntry = transactionByIndex(outputIndex.transactionIndex);
+  const transaction_t& outputTransaction = outputEntry->tx;
   if (!is_tx_spendtime_unlocked(outputTransaction.unlockTime)) {
     logger(DEBUGGING) <<
       "transaction_t << " << transactionHash << " contains multisignature input which points to a locked transaction.";
@@ -1812,45 +1878,56 @@ bool Blockchain::validateInput(const multi_signature_input_t& input, const crypt
 }
 
 bool Blockchain::getLowerBound(uint64_t timestamp, uint64_t startOffset, uint32_t& height) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Tools::SharedLockGuard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
 
   assert(startOffset < m_blocks.size());
 
-  auto bound = std::lower_bound(m_blocks.begin() + startOffset, m_blocks.end(), timestamp - m_currency.blockFutureTimeLimit(),
-    [](const block_entry_t& b, uint64_t timestamp) { return b.bl.timestamp < timestamp; });
+  // binary search by hand, the accessor iterators hand out references the cache may drop under the shared lock
+  uint64_t limit = timestamp - m_currency.blockFutureTimeLimit();
+  uint64_t first = startOffset;
+  uint64_t count = m_blocks.size() - startOffset;
+  while (count > 0) {
+    uint64_t step = count / 2;
+    if (m_blocks.get(first + step)->bl.timestamp < limit) {
+      first += step + 1;
+      count -= step + 1;
+    } else {
+      count = step;
+    }
+  }
 
-  if (bound == m_blocks.end()) {
+  if (first == m_blocks.size()) {
     return false;
   }
 
-  height = static_cast<uint32_t>(std::distance(m_blocks.begin(), bound));
+  height = static_cast<uint32_t>(first);
   return true;
 }
 
 std::vector<crypto::hash_t> Blockchain::getBlockIds(uint32_t startHeight, uint32_t maxCount) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Tools::SharedLockGuard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
   return m_blockIndex.getBlockIds(startHeight, maxCount);
 }
 
 bool Blockchain::getBlockContainingTransaction(const crypto::hash_t& txId, crypto::hash_t& blockId, uint32_t& blockHeight) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
-  auto it = m_transactionMap.find(txId);
-  if (it == m_transactionMap.end()) {
+  Tools::SharedLockGuard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  transaction_index_t transactionIndex;
+  if (!m_chainStore.findTransaction(txId, transactionIndex)) {
     return false;
   } else {
-    blockHeight = m_blocks[it->second.block].height;
+    blockHeight = m_blocks.get(transactionIndex.block)->height;
     blockId = getBlockIdByHeight(blockHeight);
     return true;
   }
 }
 
 bool Blockchain::getAlreadyGeneratedCoins(const crypto::hash_t& hash, uint64_t& generatedCoins) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Tools::SharedLockGuard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
 
   // try to find block in main chain
   uint32_t height = 0;
   if (m_blockIndex.getBlockHeight(hash, height)) {
-    generatedCoins = m_blocks[height].already_generated_coins;
+    generatedCoins = m_blocks.get(height)->already_generated_coins;
     return true;
   }
 
@@ -1866,12 +1943,12 @@ bool Blockchain::getAlreadyGeneratedCoins(const crypto::hash_t& hash, uint64_t&
 }
 
 bool Blockchain::getBlockSize(const crypto::hash_t& hash, size_t& size) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Tools::SharedLockGuard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
 
   // try to find block in main chain
   uint32_t height = 0;
   if (m_blockIndex.getBlockHeight(hash, height)) {
-    size = m_blocks[height].block_cumulative_size;
+    size = m_blocks.get(height)->block_cumulative_size;
     return true;
   }
 
@@ -1887,89 +1964,217 @@ bool Blockchain::getBlockSize(const crypto::hash_t& hash, size_t& size) {
 }
 
 bool Blockchain::getMultisigOutputReference(const multi_signature_input_t& txInMultisig, std::pair<crypto::hash_t, size_t>& outputReference) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
-  multisignature_outputs_container_t::const_iterator amountIter = m_multisignatureOutputs.find(txInMultisig.amount);
-  if (amountIter == m_multisignatureOutputs.end()) {
+  Tools::SharedLockGuard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  uint32_t outputCount = m_chainStore.multisignatureOutputCount(txInMultisig.amount);
+  if (outputCount == 0) {
     logger(DEBUGGING) << "transaction_t contains multisignature input with invalid amount.";
     return false;
   }
-  if (amountIter->second.size() <= txInMultisig.outputIndex) {
+  multisignature_output_usage_t outputIndex;
+  if (outputCount <= txInMultisig.outputIndex || !m_chainStore.getMultisignatureOutput(txInMultisig.amount, txInMultisig.outputIndex, outputIndex)) {
     logger(DEBUGGING) << "transaction_t contains multisignature input with invalid outputIndex.";
     return false;
   }
-  const multisignature_output_usage_t& outputIndex = amountIter->second[txInMultisig.outputIndex];
-  const transaction_t& outputTransaction = m_blocks[outputIndex.transactionIndex.block].transactions[outputIndex.transactionIndex.transaction].tx;
+  std::shared_ptr<const transaction_entry_t> outputEntry = transactionByIndex(outputIndex.transactionIndex);
+  const transaction_t& outputTransaction = outputEntry->tx;
   outputReference.first = BinaryArray::objectHash(outputTransaction);
   outputReference.second = outputIndex.outputIndex;
   return true;
 }
 
-bool Blockchain::storeBlockchainIndices() {
+bool Blockchain::loadBlockchainIndices() {
   std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
 
-  logger(INFO, BRIGHT_WHITE) << "Saving blockchain indices...";
-  BlockchainIndicesSerializer ser(*this, getTailId(), logger.getLogger());
-
-  if (!storeToBinaryFile(ser, m_currency.blockchainIndexesFileName())) {
-    logger(ERROR, BRIGHT_RED) << "Failed to save blockchain indices";
-    return false;
-  }
+  logger(INFO, BRIGHT_WHITE) << "Loading blockchain indices for BlockchainExplorer...";
+  BlockchainIndicesSerializer loader(m_paymentIdIndex, m_timestampIndex, m_generatedTransactionsIndex, 0, 0, NULL_HASH, logger.getLogger());
+  loadFromBinaryFile(loader, m_currency.blockchainIndexesFileName());
 
-  return true;
-}
+  uint32_t height = 0;
+  crypto::hash_t tailId = NULL_HASH;
+  m_indicesGeneration = loader.generation();
+  m_indicesLoggedBlocks = 0;
+  uint64_t nextGeneration = m_indicesGeneration;
+  bool loaded = loader.loaded();
+  if (loaded) {
+    height = loader.height();
+    tailId = loader.lastBlockHash();
+
+    // Every log continues the state the previous one ended at, a log left over from another state ends the chain
+    for (uint64_t generation = loader.generation();; ++generation) {
+      uint32_t logHeight;
+      crypto::hash_t logTailId;
+      std::vector<indices_delta_t> deltas;
+      if (!IndicesDeltaLog::read(IndicesDeltaLog::filename(m_currency.blockchainIndexesFileName(), generation), logHeight, logTailId, deltas) ||
+          logHeight != height || logTailId != tailId) {
+        break;
+      }
 
-bool Blockchain::loadBlockchainIndices() {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+      for (const auto& delta : deltas) {
+        applyIndicesDelta(delta);
+        height = delta.pushed ? delta.height + 1 : delta.height;
+        tailId = delta.pushed ? delta.blockHash : delta.previousBlockHash;
+      }
 
-  logger(INFO, BRIGHT_WHITE) << "Loading blockchain indices for BlockchainExplorer...";
-  BlockchainIndicesSerializer loader(*this, Block::getHash(m_blocks.back().bl), logger.getLogger());
+      nextGeneration = generation + 1;
+      m_indicesLoggedBlocks += deltas.size();
+    }
 
-  loadFromBinaryFile(loader, m_currency.blockchainIndexesFileName());
+    loaded = height <= m_blocks.size() && (height == 0 || Block::getHash(m_blocks.get(height - 1)->bl) == tailId);
+  }
 
-  if (!loader.loaded()) {
+  if (!loaded) {
     logger(WARNING, BRIGHT_YELLOW) << "No actual blockchain indices for BlockchainExplorer found, rebuilding...";
-    std::chrono::steady_clock::time_point timePoint = std::chrono::steady_clock::now();
-
     m_paymentIdIndex.clear();
     m_timestampIndex.clear();
     m_generatedTransactionsIndex.clear();
+    height = 0;
+  }
 
-    for (uint32_t b = 0; b < m_blocks.size(); ++b) {
-      if (b % 1000 == 0) {
-        logger(INFO, BRIGHT_WHITE) << "Height " << b << " of " << m_blocks.size();
-      }
-      const block_entry_t& block = m_blocks[b];
-      m_timestampIndex.add(block.bl.timestamp, Block::getHash(block.bl));
-      m_generatedTransactionsIndex.add(block.bl);
-      for (uint16_t t = 0; t < block.transactions.size(); ++t) {
-        const transaction_entry_t& transaction = block.transactions[t];
-        m_paymentIdIndex.add(transaction.tx);
-      }
+  // A short tail goes to a new log on top of the loaded state, a long one is folded into a new snapshot
+  std::chrono::steady_clock::time_point timePoint = std::chrono::steady_clock::now();
+  bool logTail = loaded && m_blocks.size() - height < INDICES_COMPACTION_INTERVAL;
+  if (logTail) {
+    m_indicesGeneration = nextGeneration;
+    if (!m_indicesLog.create(IndicesDeltaLog::filename(m_currency.blockchainIndexesFileName(), m_indicesGeneration), height, tailId)) {
+      logger(ERROR, BRIGHT_RED) << "Failed to create blockchain indices log";
+    }
+  }
+
+  for (uint32_t b = height; b < m_blocks.size(); ++b) {
+    if (b % 1000 == 0) {
+      logger(INFO, BRIGHT_WHITE) << "Height " << b << " of " << m_blocks.size();
     }
+    std::shared_ptr<const block_entry_t> block = m_blocks.get(b);
+    indices_delta_t delta = makeIndicesDelta(*block, m_blockIndex.getBlockId(b), true);
+    applyIndicesDelta(delta);
+    if (logTail) {
+      logIndicesDelta(delta);
+    }
+  }
 
+  if (!logTail) {
+    compactIndices();
     std::chrono::duration<double> duration = std::chrono::steady_clock::now() - timePoint;
     logger(INFO, BRIGHT_WHITE) << "Rebuilding blockchain indices took: " << duration.count();
   }
+
+  m_indicesLog.flush();
   return true;
 }
 
+indices_delta_t Blockchain::makeIndicesDelta(const block_entry_t& block, const crypto::hash_t& blockHash, bool pushed) {
+  indices_delta_t delta;
+  delta.pushed = pushed;
+  delta.height = block.height;
+  delta.blockHash = blockHash;
+  delta.previousBlockHash = block.bl.previousBlockHash;
+  delta.timestamp = block.bl.timestamp;
+  delta.transactionCount = static_cast<uint32_t>(block.bl.transactionHashes.size() + 1);
+  for (size_t t = 0; t < block.transactions.size(); ++t) {
+    crypto::hash_t paymentId;
+    if (BlockchainExplorerDataBuilder::getPaymentId(block.transactions[t].tx, paymentId)) {
+      crypto::hash_t transactionHash = t == 0 ? BinaryArray::objectHash(block.bl.baseTransaction) : block.bl.transactionHashes[t - 1];
+      delta.paymentIds.emplace_back(paymentId, transactionHash);
+    }
+  }
+
+  return delta;
+}
+
+void Blockchain::applyIndicesDelta(const indices_delta_t& delta) {
+  if (delta.pushed) {
+    m_timestampIndex.add(delta.timestamp, delta.blockHash);
+    m_generatedTransactionsIndex.add(delta.height, delta.transactionCount);
+    for (const auto& paymentId : delta.paymentIds) {
+      m_paymentIdIndex.add(paymentId.first, paymentId.second);
+    }
+  } else {
+    m_timestampIndex.remove(delta.timestamp, delta.blockHash);
+    m_generatedTransactionsIndex.remove(delta.height);
+    for (const auto& paymentId : delta.paymentIds) {
+      m_paymentIdIndex.remove(paymentId.first, paymentId.second);
+    }
+  }
+}
+
+/**
+* \pre m_blockchain_lock is locked exclusively
+*/
+void Blockchain::logIndicesDelta(const indices_delta_t& delta) {
+  // Until init loaded the indices there is no log, the deltas are covered by replaying the blocks
+  if (!m_indicesLog.isOpen()) {
+    return;
+  }
+
+  if (!m_indicesLog.append(delta)) {
+    logger(ERROR, BRIGHT_RED) << "Failed to append to blockchain indices log";
+  }
+
+  // A snapshot still being written is not waited for, the next delta tries again
+  if (++m_indicesLoggedBlocks >= INDICES_COMPACTION_INTERVAL && !m_indicesCompacting) {
+    compactIndices();
+  }
+}
+
+/**
+* \pre m_blockchain_lock is locked exclusively
+*/
+void Blockchain::compactIndices() {
+  if (m_indicesCompaction.joinable()) {
+    m_indicesCompaction.join();
+  }
+
+  // Deltas from now on go to the log of the next generation, which starts from the state being saved
+  uint64_t generation = m_indicesGeneration + 1;
+  uint32_t height = static_cast<uint32_t>(m_blocks.size());
+  crypto::hash_t tailId = m_blocks.empty() ? NULL_HASH : m_blockIndex.getTailId();
+  std::string snapshotFilename = m_currency.blockchainIndexesFileName();
+  if (!m_indicesLog.create(IndicesDeltaLog::filename(snapshotFilename, generation), height, tailId)) {
+    logger(ERROR, BRIGHT_RED) << "Failed to create blockchain indices log";
+  }
+
+  m_indicesGeneration = generation;
+  m_indicesLoggedBlocks = 0;
+  m_indicesCompacting = true;
+
+  auto paymentIdIndex = std::make_shared<PaymentIdIndex>(m_paymentIdIndex);
+  auto timestampIndex = std::make_shared<TimestampBlocksIndex>(m_timestampIndex);
+  auto generatedTransactionsIndex = std::make_shared<GeneratedTransactionsIndex>(m_generatedTransactionsIndex);
+  m_indicesCompaction = std::thread([this, paymentIdIndex, timestampIndex, generatedTransactionsIndex, generation, height, tailId, snapshotFilename] {
+    BlockchainIndicesSerializer ser(*paymentIdIndex, *timestampIndex, *generatedTransactionsIndex, generation, height, tailId, logger.getLogger());
+    std::string temporaryFilename = snapshotFilename + ".tmp";
+    boost::system::error_code ec;
+    if (!storeToBinaryFile(ser, temporaryFilename)) {
+      logger(ERROR, BRIGHT_RED) << "Failed to save blockchain indices";
+    } else if (boost::filesystem::rename(temporaryFilename, snapshotFilename, ec), ec) {
+      logger(ERROR, BRIGHT_RED) << "Failed to replace blockchain indices: " << ec.message();
+    } else {
+      // The logs of the previous generations are folded into the new snapshot
+      for (uint64_t obsolete = generation - 1; obsolete > 0 && boost::filesystem::remove(IndicesDeltaLog::filename(snapshotFilename, obsolete), ec); --obsolete) {
+      }
+    }
+
+    m_indicesCompacting = false;
+  });
+}
+
 bool Blockchain::getGeneratedTransactionsNumber(uint32_t height, uint64_t& generatedTransactions) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Tools::SharedLockGuard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
   return m_generatedTransactionsIndex.find(height, generatedTransactions);
 }
 
 bool Blockchain::getOrphanBlockIdsByHeight(uint32_t height, std::vector<crypto::hash_t>& blockHashes) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Tools::SharedLockGuard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
   return m_orthanBlocksIndex.find(height, blockHashes);
 }
 
 bool Blockchain::getBlockIdsByTimestamp(uint64_t timestampBegin, uint64_t timestampEnd, uint32_t blocksNumberLimit, std::vector<crypto::hash_t>& hashes, uint32_t& blocksNumberWithinTimestamps) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Tools::SharedLockGuard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
   return m_timestampIndex.find(timestampBegin, timestampEnd, blocksNumberLimit, hashes, blocksNumberWithinTimestamps);
 }
 
 bool Blockchain::getTransactionIdsByPaymentId(const crypto::hash_t& paymentId, std::vector<crypto::hash_t>& transactionHashes) {
-  std::lock_guard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+  Tools::SharedLockGuard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
   return m_paymentIdIndex.find(paymentId, transactionHashes);
 }
 
@@ -5,21 +5,23 @@
 #pragma once
 
 #include <atomic>
-
-#include "google/sparse_hash_set"
-#include "google/sparse_hash_map"
+#include <thread>
 
 #include "common/ObserverManager.h"
+#include "common/RecursiveSharedMutex.h"
 #include "cryptonote/core/blockchain/serializer/block_index.h"
 #include "cryptonote/core/checkpoints.h"
 #include "cryptonote/core/currency.h"
 #include "cryptonote/core/blockchain/serializer/exports.h"
 #include "cryptonote/core/IBlockchainStorageObserver.h"
 #include "cryptonote/core/ITransactionValidator.h"
+#include "cryptonote/core/RingSignatureVerifier.h"
 #include "cryptonote/core/blockchain/block.hpp"
 #include "cryptonote/core/CryptoNoteFormatUtils.h"
 #include "cryptonote/core/tx_memory_pool.h"
 #include "cryptonote/core/blockchain/indexing/exports.h"
+#include "cryptonote/core/blockchain/indexing/chain_store.h"
+#include "cryptonote/core/blockchain/serializer/indices_delta.h"
 
 #include "cryptonote/core/template/MessageQueue.h"
 #include "cryptonote/core/BlockchainMessages.h"
@@ -78,7 +80,7 @@ namespace cryptonote {
     crypto::hash_t getTailId(uint32_t& height);
     difficulty_t getDifficultyForNextBlock();
     uint64_t getCoinsInCirculation();
-    bool addNewBlock(const block_t& bl_, block_verification_context_t& bvc);
+    bool addNewBlock(const block_t& bl_, block_verification_context_t& bvc, const crypto::hash_t* proofOfWork = NULL);
     bool resetAndSetGenesisBlock(const block_t& b);
     bool haveBlock(const crypto::hash_t& id);
     size_t getTotalTransactions();
@@ -112,7 +114,7 @@ namespace cryptonote {
 
     template<class t_ids_container, class t_blocks_container, class t_missed_container>
     bool getBlocks(const t_ids_container& block_ids, t_blocks_container& blocks, t_missed_container& missed_bs) {
-      std::lock_guard<std::recursive_mutex> lk(m_blockchain_lock);
+      Tools::SharedLockGuard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
 
       for (const auto& bl_id : block_ids) {
         uint32_t height = 0;
@@ -121,7 +123,7 @@ namespace cryptonote {
         } else {
           if (!(height < m_blocks.size())) { logger(Logging::ERROR, Logging::BRIGHT_RED) << "Internal error: bl_id=" << hex::podToString(bl_id)
             << " have index record with offset=" << height << ", bigger then m_blocks.size()=" << m_blocks.size(); return false; }
-            blocks.push_back(m_blocks[height].bl);
+            blocks.push_back(m_blocks.get(height)->bl);
         }
       }
 
@@ -130,14 +132,14 @@ namespace cryptonote {
 
     template<class t_ids_container, class t_tx_container, class t_missed_container>
     void getBlockchainTransactions(const t_ids_container& txs_ids, t_tx_container& txs, t_missed_container& missed_txs) {
-      std::lock_guard<decltype(m_blockchain_lock)> bcLock(m_blockchain_lock);
+      Tools::SharedLockGuard<decltype(m_blockchain_lock)> bcLock(m_blockchain_lock);
 
       for (const auto& tx_id : txs_ids) {
-        auto it = m_transactionMap.find(tx_id);
-        if (it == m_transactionMap.end()) {
+        transaction_index_t transactionIndex;
+        if (!m_chainStore.findTransaction(tx_id, transactionIndex)) {
           missed_txs.push_back(tx_id);
         } else {
-          txs.push_back(transactionByIndex(it->second).tx);
+          txs.push_back(transactionByIndex(transactionIndex)->tx);
         }
       }
     }
@@ -163,52 +165,57 @@ namespace cryptonote {
     void print_blockchain_index();
     void print_blockchain_outs(const std::string& file);
 
-    std::recursive_mutex & getMutex() {
+    Tools::RecursiveSharedMutex& getMutex() {
       return m_blockchain_lock;
     }
 
   private:
-    typedef google::sparse_hash_set<crypto::key_image_t> key_images_container_t;
     typedef std::unordered_map<crypto::hash_t, block_entry_t> blocks_ext_by_hash_t;
-    typedef google::sparse_hash_map<uint64_t, std::vector<std::pair<transaction_index_t, uint16_t>>> outputs_container_t; //crypto::hash_t - tx hash, size_t - index of out in transaction
-    typedef google::sparse_hash_map<uint64_t, std::vector<multisignature_output_usage_t>> multisignature_outputs_container_t;
 
     const Currency& m_currency;
     TxMemoryPool& m_tx_pool;
-    std::recursive_mutex m_blockchain_lock; // TODO: add here reader/writer lock
+    // Queries take it shared; pushBlock, popBlock and chain switching take it exclusively
+    Tools::RecursiveSharedMutex m_blockchain_lock;
     Tools::ObserverManager<IBlockchainStorageObserver> m_observerManager;
 
-    key_images_container_t m_spent_keys;
     size_t m_current_block_cumul_sz_limit;
     blocks_ext_by_hash_t m_alternative_chains; // crypto::hash_t -> block_extended_info
-    outputs_container_t m_outputs;
 
     Checkpoints m_checkpoints;
     std::atomic<bool> m_is_in_checkpoint_zone;
+    RingSignatureVerifier m_ringSignatureVerifier;
 
     typedef BlockAccessor<block_entry_t> blocks_t;
     typedef std::unordered_map<crypto::hash_t, uint32_t> block_map_t;
-    typedef std::unordered_map<crypto::hash_t, transaction_index_t> transaction_map_t;
-
-    friend class BlockCacheSerializer;
-    friend class BlockchainIndicesSerializer;
 
     blocks_t m_blocks;
     cryptonote::BlockIndex m_blockIndex;
-    transaction_map_t m_transactionMap;
-    multisignature_outputs_container_t m_multisignatureOutputs;
+    // Key images, transactions and outputs of the main chain, committed together with the block index
+    ChainIndexStore m_chainStore;
+    size_t m_uncommittedBlocks;
 
     PaymentIdIndex m_paymentIdIndex;
     TimestampBlocksIndex m_timestampIndex;
     GeneratedTransactionsIndex m_generatedTransactionsIndex;
     OrphanBlocksIndex m_orthanBlocksIndex;
 
+    // The three indices above are stored as a snapshot plus the deltas of the blocks pushed and popped after it,
+    // a new snapshot is written in the background once the log grows long
+    IndicesDeltaLog m_indicesLog;
+    uint64_t m_indicesGeneration;
+    size_t m_indicesLoggedBlocks;
+    std::thread m_indicesCompaction;
+    std::atomic<bool> m_indicesCompacting;
+
     IntrusiveLinkedList<MessageQueue<BlockchainMessage>> m_messageQueueList;
 
     Logging::LoggerRef logger;
 
+    bool loadCache(uint32_t height, const crypto::hash_t& tailId);
     void rebuildCache();
+    void replayBlocks(uint32_t startHeight);
     bool storeCache();
+    bool commitCache();
     bool switch_to_alternative_blockchain(std::list<blocks_ext_by_hash_t::iterator>& alt_chain, bool discard_disconnected_chain);
     bool handle_alternative_block(const block_t& b, const crypto::hash_t& id, block_verification_context_t& bvc, bool sendNewAlternativeBlockMessage = true);
     difficulty_t get_next_difficulty_for_alternative_chain(const std::list<blocks_ext_by_hash_t::iterator>& alt_chain, block_entry_t& bei);
@@ -216,9 +223,9 @@ namespace cryptonote {
     bool validate_miner_transaction(const block_t& b, uint32_t height, size_t cumulativeBlockSize, uint64_t alreadyGeneratedCoins, uint64_t fee, uint64_t& reward, int64_t& emissionChange);
     bool rollback_blockchain_switching(std::list<block_t>& original_chain, size_t rollback_height);
     bool get_last_n_blocks_sizes(std::vector<size_t>& sz, size_t count);
-    bool add_out_to_get_random_outs(std::vector<std::pair<transaction_index_t, uint16_t>>& amount_outs, COMMAND_RPC_GET_RANDOM_OUTPUTS_FOR_AMOUNTS_outs_for_amount& result_outs, uint64_t amount, size_t i);
+    bool add_out_to_get_random_outs(const ChainIndexStore::output_t& amount_out, COMMAND_RPC_GET_RANDOM_OUTPUTS_FOR_AMOUNTS_outs_for_amount& result_outs, uint64_t amount, size_t i);
     bool is_tx_spendtime_unlocked(uint64_t unlock_time);
-    size_t find_end_of_allowed_index(const std::vector<std::pair<transaction_index_t, uint16_t>>& amount_outs);
+    size_t find_end_of_allowed_index(uint64_t amount, uint32_t count);
     bool check_block_timestamp_main(const block_t& b);
     bool check_block_timestamp(std::vector<uint64_t> timestamps, const block_t& b);
     uint64_t get_adjusted_time();
@@ -227,13 +234,13 @@ namespace cryptonote {
     std::vector<crypto::hash_t> doBuildSparseChain(const crypto::hash_t& startBlockId) const;
     bool getBlockCumulativeSize(const block_t& block, size_t& cumulativeSize);
     bool update_next_comulative_size_limit();
-    bool check_tx_input(const key_input_t& txin, const crypto::hash_t& tx_prefix_hash, const std::vector<crypto::signature_t>& sig, uint32_t* pmax_related_block_height = NULL);
-    bool checkTransactionInputs(const transaction_t& tx, const crypto::hash_t& tx_prefix_hash, uint32_t* pmax_used_block_height = NULL);
-    bool checkTransactionInputs(const transaction_t& tx, uint32_t* pmax_used_block_height = NULL);
+    bool check_tx_input(const key_input_t& txin, const crypto::hash_t& tx_prefix_hash, const std::vector<crypto::signature_t>& sig, std::vector<ring_signature_check_t>& ringSignatureChecks, uint32_t* pmax_related_block_height = NULL);
+    bool collectTransactionInputs(const transaction_t& tx, const crypto::hash_t& tx_prefix_hash, std::vector<ring_signature_check_t>& ringSignatureChecks, uint32_t* pmax_used_block_height = NULL);
     bool have_tx_keyimg_as_spent(const crypto::key_image_t &key_im);
-    const transaction_entry_t& transactionByIndex(transaction_index_t index);
-    bool pushBlock(const block_t& blockData, block_verification_context_t& bvc);
-    bool pushBlock(const block_t& blockData, const std::vector<transaction_t>& transactions, block_verification_context_t& bvc);
+    // Keeps the block holding the transaction alive, the accessor cache may drop it under the shared lock
+    std::shared_ptr<const transaction_entry_t> transactionByIndex(transaction_index_t index);
+    bool pushBlock(const block_t& blockData, block_verification_context_t& bvc, const crypto::hash_t* proofOfWork = NULL);
+    bool pushBlock(const block_t& blockData, const std::vector<transaction_t>& transactions, block_verification_context_t& bvc, const crypto::hash_t* proofOfWork = NULL);
     bool pushBlock(block_entry_t& block);
     void popBlock(const crypto::hash_t& blockHash);
     bool pushTransaction(block_entry_t& block, const crypto::hash_t& transactionHash, transaction_index_t transactionIndex);
@@ -241,8 +248,11 @@ namespace cryptonote {
     void popTransactions(const block_entry_t& block, const crypto::hash_t& minerTransactionHash);
     bool validateInput(const multi_signature_input_t& input, const crypto::hash_t& transactionHash, const crypto::hash_t& transactionPrefixHash, const std::vector<crypto::signature_t>& transactionSignatures);
 
-    bool storeBlockchainIndices();
     bool loadBlockchainIndices();
+    indices_delta_t makeIndicesDelta(const block_entry_t& block, const crypto::hash_t& blockHash, bool pushed);
+    void applyIndicesDelta(const indices_delta_t& delta);
+    void logIndicesDelta(const indices_delta_t& delta);
+    void compactIndices();
 
     bool loadTransactions(const block_t& block, std::vector<transaction_t>& transactions);
     void saveTransactions(const std::vector<transaction_t>& transactions);
@@ -251,41 +261,40 @@ namespace cryptonote {
   };
 
   template<class visitor_t> bool Blockchain::scanOutputKeysForIndexes(const key_input_t& tx_in_to_key, visitor_t& vis, uint32_t* pmax_related_block_height) {
-    std::lock_guard<std::recursive_mutex> lk(m_blockchain_lock);
-    auto it = m_outputs.find(tx_in_to_key.amount);
-    if (it == m_outputs.end() || !tx_in_to_key.outputIndexes.size())
+    Tools::SharedLockGuard<decltype(m_blockchain_lock)> lk(m_blockchain_lock);
+    uint32_t outputCount = m_chainStore.outputCount(tx_in_to_key.amount);
+    if (outputCount == 0 || !tx_in_to_key.outputIndexes.size())
       return false;
 
     std::vector<uint32_t> absolute_offsets = relative_output_offsets_to_absolute(tx_in_to_key.outputIndexes);
-    std::vector<std::pair<transaction_index_t, uint16_t>>& amount_outs_vec = it->second;
     size_t count = 0;
     for (uint64_t i : absolute_offsets) {
-      if(i >= amount_outs_vec.size() ) {
-        logger(Logging::INFO) << "Wrong index in transaction inputs: " << i << ", expected maximum " << amount_outs_vec.size() - 1;
+      ChainIndexStore::output_t amount_out;
+      if(i >= outputCount || !m_chainStore.getOutput(tx_in_to_key.amount, static_cast<uint32_t>(i), amount_out)) {
+        logger(Logging::INFO) << "Wrong index in transaction inputs: " << i << ", expected maximum " << outputCount - 1;
         return false;
       }
 
-      //auto tx_it = m_transactionMap.find(amount_outs_vec[i].first);
-      //if (!(tx_it != m_transactionMap.end())) { logger(ERROR, BRIGHT_RED) << "Wrong transaction id in output indexes: " << hex::podToString(amount_outs_vec[i].first); return false; }
+      // Held by pointer, the visitor may look up more blocks than operator[] keeps alive
+      std::shared_ptr<const block_entry_t> block = m_blocks.get(amount_out.first.block);
+      const transaction_entry_t& tx = block->transactions[amount_out.first.transaction];
 
-      const transaction_entry_t& tx = transactionByIndex(amount_outs_vec[i].first);
-
-      if (!(amount_outs_vec[i].second < tx.tx.outputs.size())) {
+      if (!(amount_out.second < tx.tx.outputs.size())) {
         logger(Logging::ERROR, Logging::BRIGHT_RED)
             << "Wrong index in transaction outputs: "
-            << amount_outs_vec[i].second << ", expected less then "
+            << amount_out.second << ", expected less then "
             << tx.tx.outputs.size();
         return false;
       }
 
-      if (!vis.handle_output(tx.tx, tx.tx.outputs[amount_outs_vec[i].second], amount_outs_vec[i].second)) {
+      if (!vis.handle_output(tx.tx, tx.tx.outputs[amount_out.second], amount_out.second)) {
         logger(Logging::INFO) << "Failed to handle_output for output no = " << count << ", with absolute offset " << i;
         return false;
       }
 
       if(count++ == absolute_offsets.size()-1 && pmax_related_block_height) {
-        if (*pmax_related_block_height < amount_outs_vec[i].first.block) {
-          *pmax_related_block_height = amount_outs_vec[i].first.block;
+        if (*pmax_related_block_height < amount_out.first.block) {
+          *pmax_related_block_height = amount_out.first.block;
         }
       }
     }
@@ -293,4 +302,3 @@ namespace cryptonote {
     return true;
   }
 }
-
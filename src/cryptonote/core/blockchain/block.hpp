@@ -4,17 +4,23 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
 #include <cstddef>
+#include <cstring>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <list>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 #include "common/file.h"
+#include "common/MappedFile.h"
 
+#include "stream/MemoryInputStream.h"
 #include "stream/StdInputStream.h"
 #include "stream/StdOutputStream.h"
 #include "serialization/BinaryInputStreamSerializer.h"
@@ -146,16 +152,27 @@ public:
   uint64_t size() const;
   const_iterator begin();
   const_iterator end();
+  // The reference points into the cache and is dropped with the item once it is evicted, so it is only safe while
+  // no other thread reads through the accessor. Readers under the shared blockchain lock use get().
   const T& operator[](uint64_t index);
+  // Keeps the item alive for as long as the pointer is held, whatever happens to the cache meanwhile
+  std::shared_ptr<const T> get(uint64_t index);
+  std::shared_ptr<const T> getBack();
+  // Decodes a copy of the item without going through the cache. Only the raw bytes are read under the lock,
+  // so concurrent callers decode in parallel.
+  void load(uint64_t index, T& item);
   const T& front();
   const T& back();
   void clear();
   void pop_back();
   void push_back(const T& item);
   bool readItems(std::fstream &fs, uint64_t&count);
+  bool readMappedIndex(const std::string &filename);
   bool readHeight(std::fstream &fs, uint64_t&count);
   bool writeHeight(std::fstream &fs, uint64_t&count);
   void writeIndex(const char *data, size_t size, size_t offset, std::string message);
+  bool commitIndex();
+  bool recoverIndex();
 
 private:
   struct item_entry_t;
@@ -163,7 +180,7 @@ private:
 
   struct item_entry_t {
   public:
-    T item;
+    std::shared_ptr<T> item;
     typename std::list<cache_entry_t>::iterator cacheIter;
   };
 
@@ -173,6 +190,13 @@ private:
   };
 
   std::fstream m_itemsFile;
+  // Kept open for the accessor lifetime; the count header is only rewritten on commit
+  std::fstream m_indexFile;
+  size_t m_indexFlushInterval;
+  size_t m_pendingIndexWrites;
+  // Read-only view of the blocks file, used instead of seekg/read when the currency enables memory mapping
+  Common::MappedFile m_mappedItems;
+  bool m_memoryMapped;
   size_t m_poolSize;
   std::vector<uint64_t> m_offsets;
   const Currency &m_currency;
@@ -181,14 +205,20 @@ private:
   std::list<cache_entry_t> m_cache;
   uint64_t m_cacheHits;
   uint64_t m_cacheMisses;
+  // Guards the cache and the files, operator[] is called by concurrent readers of Blockchain
+  std::mutex m_lock;
 
-  T* prepare(uint64_t index);
+  std::shared_ptr<T>& prepare(uint64_t index);
+  void readItem(uint64_t index, T& item);
 };
 
 template <class T>
 BlockAccessor<T>::BlockAccessor(const Currency &currency) : m_currency(currency)
 {
   m_poolSize = currency.getPoolSize();
+  m_memoryMapped = currency.isBlocksMemoryMapped();
+  m_indexFlushInterval = std::max<size_t>(currency.blockIndexFlushInterval(), 1);
+  m_pendingIndexWrites = 0;
 }
 
 template<class T> BlockAccessor<T>::~BlockAccessor() {
@@ -196,14 +226,54 @@ template<class T> BlockAccessor<T>::~BlockAccessor() {
 }
 
 template<class T>
-
 void BlockAccessor<T>::writeIndex(const char *data, size_t size, size_t offset, std::string message) {
-  std::string file = m_currency.blockIndexesFileName();
-  if(!std::file::write(file, data, size, offset)) {
+  m_indexFile.seekp(offset);
+  if (!m_indexFile.write(data, size)) {
     throw std::runtime_error(message);
   }
 }
 
+// Group commit: block bytes and size slots are synced to disk before the count header that makes them visible,
+// so the header never references data that did not survive a crash or a power loss.
+template<class T>
+bool BlockAccessor<T>::commitIndex() {
+  std::string blocksFilename = m_currency.blocksFileName();
+  std::string indexFilename = m_currency.blockIndexesFileName();
+  if (!m_itemsFile.flush() || !m_indexFile.flush() || !std::file::sync(blocksFilename) || !std::file::sync(indexFilename)) {
+    return false;
+  }
+
+  uint64_t count = m_offsets.size();
+  m_indexFile.seekp(0);
+  if (!m_indexFile.write(reinterpret_cast<char*>(&count), sizeof count) || !m_indexFile.flush() ||
+    !std::file::sync(indexFilename)) {
+    return false;
+  }
+
+  m_pendingIndexWrites = 0;
+  return true;
+}
+
+// Drops trailing items whose bytes did not fully reach the blocks file before a crash.
+template<class T>
+bool BlockAccessor<T>::recoverIndex() {
+  m_itemsFile.seekg(0, std::ios::end);
+  uint64_t blocksFileSize = static_cast<uint64_t>(m_itemsFile.tellg());
+  uint64_t count = m_offsets.size();
+
+  while (!m_offsets.empty() && m_itemsFileSize > blocksFileSize) {
+    m_itemsFileSize = m_offsets.back();
+    m_offsets.pop_back();
+  }
+
+  if (count == m_offsets.size()) {
+    return true;
+  }
+
+  std::cout << "Block index truncated from " << count << " to " << m_offsets.size() << " items" << std::endl;
+  return commitIndex();
+}
+
 template<class T>
 bool BlockAccessor<T>::readHeight(std::fstream &fs, uint64_t&count) {
   std::string blockIndexesFilename = m_currency.blockIndexesFileName();  
@@ -243,11 +313,50 @@ bool BlockAccessor<T>::readItems(std::fstream &fs, uint64_t&count) {
   return true;
 }
 
+template<class T>
+bool BlockAccessor<T>::readMappedIndex(const std::string &filename) {
+  Common::MappedFile index;
+  if (!index.open(filename) || index.size() < sizeof(uint64_t)) {
+    return false;
+  }
+
+  uint64_t count;
+  memcpy(&count, index.data(), sizeof count);
+  // a corrupt count must not overflow the size check
+  if (count > (index.size() - sizeof count) / sizeof(uint32_t)) {
+    return false;
+  }
+
+  std::vector<uint64_t> offsets;
+  offsets.reserve(count);
+  uint64_t itemsFileSize = 0;
+  const uint8_t* sizes = index.data() + sizeof count;
+  for (uint64_t i = 0; i < count; ++i) {
+    uint32_t itemSize;
+    memcpy(&itemSize, sizes + sizeof itemSize * i, sizeof itemSize);
+    offsets.emplace_back(itemsFileSize);
+    itemsFileSize += itemSize;
+  }
+
+  m_offsets.swap(offsets);
+  m_itemsFileSize = itemsFileSize;
+  return true;
+}
+
 template<class T>
 bool BlockAccessor<T>::initIndex() {
   std::string blockIndexesFilename = m_currency.blockIndexesFileName();
   std::fstream fs;
 
+  if (m_memoryMapped && std::file::exists(blockIndexesFilename)) {
+    if (!readMappedIndex(blockIndexesFilename)) {
+      std::cout << "Fail to read mapped block index!" << std::endl;
+      return false;
+    }
+
+    return true;
+  }
+
   // fs.open(blockIndexesFilename, std::ios::in | std::ios::out | std::ios::binary);
 
   fs = std::file::open(blockIndexesFilename);
@@ -287,6 +396,23 @@ bool BlockAccessor<T>::init()
   }
   std::string blockFilename = m_currency.blocksFileName();
   m_itemsFile = std::file::open(blockFilename, true);
+  m_indexFile = std::file::open(m_currency.blockIndexesFileName());
+  m_pendingIndexWrites = 0;
+
+  if (!m_itemsFile || !m_indexFile) {
+    std::cout << "Fail to open block files!" << std::endl;
+    return false;
+  }
+
+  if (!recoverIndex()) {
+    std::cout << "Fail to recover block index!" << std::endl;
+    return false;
+  }
+
+  if (m_memoryMapped && !m_mappedItems.open(blockFilename)) {
+    std::cout << "Fail to map blocks file!" << std::endl;
+    return false;
+  }
 
   m_items.clear();
   m_cache.clear();
@@ -296,6 +422,11 @@ bool BlockAccessor<T>::init()
 }
 
 template<class T> void BlockAccessor<T>::close() {
+  if (m_pendingIndexWrites > 0 && !commitIndex()) {
+    std::cout << "Fail to commit block index!" << std::endl;
+  }
+
+  m_mappedItems.close();
   std::cout << "BlockAccessor cache hits: " << m_cacheHits << ", misses: " << m_cacheMisses << " (" << std::fixed << std::setprecision(2) << static_cast<double>(m_cacheMisses) / (m_cacheHits + m_cacheMisses) * 100 << "%)" << std::endl;
 }
 
@@ -316,6 +447,11 @@ template<class T> typename BlockAccessor<T>::const_iterator BlockAccessor<T>::en
 }
 
 template<class T> const T& BlockAccessor<T>::operator[](uint64_t index) {
+  return *get(index);
+}
+
+template<class T> std::shared_ptr<const T> BlockAccessor<T>::get(uint64_t index) {
+  std::lock_guard<std::mutex> lock(m_lock);
   auto itemIter = m_items.find(index);
   if (itemIter != m_items.end()) {
     if (itemIter->second.cacheIter != --m_cache.end()) {
@@ -327,24 +463,53 @@ template<class T> const T& BlockAccessor<T>::operator[](uint64_t index) {
   }
 
   if (index >= m_offsets.size()) {
-    throw std::runtime_error("BlockAccessor::operator[]");
+    throw std::runtime_error("BlockAccessor::get");
   }
 
-  if (!m_itemsFile) {
-    throw std::runtime_error("BlockAccessor::operator[]");
+  std::shared_ptr<T> item = std::make_shared<T>();
+  readItem(index, *item);
+  prepare(index) = item;
+  ++m_cacheMisses;
+  return item;
+}
+
+template<class T> void BlockAccessor<T>::load(uint64_t index, T& item) {
+  std::vector<uint8_t> data;
+
+  {
+    std::lock_guard<std::mutex> lock(m_lock);
+    if (index >= m_offsets.size()) {
+      throw std::runtime_error("BlockAccessor::load");
+    }
+
+    uint64_t begin = m_offsets[index];
+    uint64_t end = index + 1 < m_offsets.size() ? m_offsets[index + 1] : m_itemsFileSize;
+    data.resize(static_cast<size_t>(end - begin));
+    if (m_memoryMapped) {
+      if (end > m_mappedItems.size() && !m_mappedItems.remap()) {
+        throw std::runtime_error("BlockAccessor::load");
+      }
+
+      if (end > m_mappedItems.size()) {
+        throw std::runtime_error("BlockAccessor::load");
+      }
+
+      memcpy(data.data(), m_mappedItems.data() + begin, data.size());
+    } else {
+      m_itemsFile.seekg(begin);
+      if (!m_itemsFile.read(reinterpret_cast<char*>(data.data()), data.size())) {
+        throw std::runtime_error("BlockAccessor::load");
+      }
+    }
   }
 
-  m_itemsFile.seekg(m_offsets[index]);
-  T tempItem;
-  
-  Common::StdInputStream stream(m_itemsFile);
+  Common::MemoryInputStream stream(data.data(), data.size());
   cryptonote::BinaryInputStreamSerializer archive(stream);
-  serialize(tempItem, archive);
+  serialize(item, archive);
+}
 
-  T* item = prepare(index);
-  std::swap(tempItem, *item);
-  ++m_cacheMisses;
-  return *item;
+template<class T> std::shared_ptr<const T> BlockAccessor<T>::getBack() {
+  return get(m_offsets.size() - 1);
 }
 
 template<class T> const T& BlockAccessor<T>::front() {
@@ -356,18 +521,18 @@ template<class T> const T& BlockAccessor<T>::back() {
 }
 
 template<class T> void BlockAccessor<T>::clear() {
-  uint64_t count = 0;
-  writeIndex(reinterpret_cast<char*>(&count), sizeof count, 0, "BlockAccessor::clear");
+  std::lock_guard<std::mutex> lock(m_lock);
   m_offsets.clear();
   m_itemsFileSize = 0;
   m_items.clear();
   m_cache.clear();
+  if (!commitIndex()) {
+    throw std::runtime_error("BlockAccessor::clear");
+  }
 }
 
 template<class T> void BlockAccessor<T>::pop_back() {
-  uint64_t count = m_offsets.size() - 1;
-  writeIndex(reinterpret_cast<char*>(&count), sizeof count, 0, "BlockAccessor::pop_back");
-
+  std::lock_guard<std::mutex> lock(m_lock);
   m_itemsFileSize = m_offsets.back();
   m_offsets.pop_back();
   auto itemIter = m_items.find(m_offsets.size());
@@ -375,9 +540,15 @@ template<class T> void BlockAccessor<T>::pop_back() {
     m_cache.erase(itemIter->second.cacheIter);
     m_items.erase(itemIter);
   }
+
+  // Later pushes overwrite the popped slots, so the shrunk count must be durable before that happens
+  if (!commitIndex()) {
+    throw std::runtime_error("BlockAccessor::pop_back");
+  }
 }
 
 template<class T> void BlockAccessor<T>::push_back(const T& item) {
+  std::lock_guard<std::mutex> lock(m_lock);
   uint64_t itemsFileSize;
 
   {
@@ -392,24 +563,58 @@ template<class T> void BlockAccessor<T>::push_back(const T& item) {
     serialize(const_cast<T&>(item), archive);
 
     itemsFileSize = m_itemsFile.tellp();
+
+    // Buffered bytes are invisible through the mapping until flushed
+    if (m_memoryMapped) {
+      m_itemsFile.flush();
+    }
   }
 
   {
     uint32_t itemSize = static_cast<uint32_t>(itemsFileSize - m_itemsFileSize);
     size_t offset = sizeof(uint64_t) + sizeof(uint32_t) * m_offsets.size();
     writeIndex(reinterpret_cast<char*>(&itemSize), sizeof itemSize, offset, "BlockAccessor::push_back");
-    uint64_t count = m_offsets.size() + 1;
-    writeIndex(reinterpret_cast<char*>(&count), sizeof count, 0, "BlockAccessor::push_back");
   }
 
   m_offsets.push_back(m_itemsFileSize);
   m_itemsFileSize = itemsFileSize;
 
-  T* newItem = prepare(m_offsets.size() - 1);
-  *newItem = item;
+  if (++m_pendingIndexWrites >= m_indexFlushInterval && !commitIndex()) {
+    throw std::runtime_error("BlockAccessor::push_back");
+  }
+
+  prepare(m_offsets.size() - 1) = std::make_shared<T>(item);
+}
+
+template<class T> void BlockAccessor<T>::readItem(uint64_t index, T& item) {
+  if (!m_memoryMapped) {
+    if (!m_itemsFile) {
+      throw std::runtime_error("BlockAccessor::operator[]");
+    }
+
+    m_itemsFile.seekg(m_offsets[index]);
+    Common::StdInputStream stream(m_itemsFile);
+    cryptonote::BinaryInputStreamSerializer archive(stream);
+    serialize(item, archive);
+    return;
+  }
+
+  uint64_t begin = m_offsets[index];
+  uint64_t end = index + 1 < m_offsets.size() ? m_offsets[index + 1] : m_itemsFileSize;
+  if (end > m_mappedItems.size() && !m_mappedItems.remap()) {
+    throw std::runtime_error("BlockAccessor::operator[]");
+  }
+
+  if (end > m_mappedItems.size()) {
+    throw std::runtime_error("BlockAccessor::operator[]");
+  }
+
+  Common::MemoryInputStream stream(m_mappedItems.data() + begin, static_cast<size_t>(end - begin));
+  cryptonote::BinaryInputStreamSerializer archive(stream);
+  serialize(item, archive);
 }
 
-template<class T> T* BlockAccessor<T>::prepare(uint64_t index) {
+template<class T> std::shared_ptr<T>& BlockAccessor<T>::prepare(uint64_t index) {
   if (m_items.size() == m_poolSize) {
     auto cacheIter = m_cache.begin();
     m_items.erase(cacheIter->itemIter);
@@ -420,5 +625,5 @@ template<class T> T* BlockAccessor<T>::prepare(uint64_t index) {
   cache_entry_t cacheEntry = { itemIter.first };
   auto cacheIter = m_cache.insert(m_cache.end(), cacheEntry);
   itemIter.first->second.cacheIter = cacheIter;
-  return &itemIter.first->second.item;
+  return itemIter.first->second.item;
 }
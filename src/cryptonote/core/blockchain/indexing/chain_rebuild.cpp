@@ -0,0 +1,244 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "chain_rebuild.h"
+
+#include <algorithm>
+#include <thread>
+#include "cryptonote/structures/array.hpp"
+
+namespace cryptonote
+{
+
+namespace
+{
+
+// Shards in flight per worker, bounds the memory held by indexed blocks waiting for the merge
+const size_t SHARDS_PER_THREAD = 4;
+
+} // namespace
+
+ChainIndexRebuilder::ChainIndexRebuilder(size_t threadCount) :
+  m_threadCount(std::max<size_t>(1, threadCount)),
+  m_nextShard(0),
+  m_mergedShards(0),
+  m_stop(false)
+{
+}
+
+void ChainIndexRebuilder::run(uint32_t startHeight, uint32_t endHeight, const loader_t &load, const merger_t &merge)
+{
+  if (startHeight >= endHeight)
+  {
+    return;
+  }
+
+  uint32_t shardCount = (endHeight - startHeight + SHARD_SIZE - 1) / SHARD_SIZE;
+  size_t threadCount = std::min<size_t>(m_threadCount, shardCount);
+  if (threadCount == 1)
+  {
+    for (uint32_t height = startHeight; height < endHeight; ++height)
+    {
+      block_entry_t block;
+      load(height, block);
+      indexed_block_t indexed;
+      index(height, block, indexed);
+      merge(indexed);
+    }
+
+    return;
+  }
+
+  m_shards.assign(threadCount * SHARDS_PER_THREAD, shard_t());
+  for (auto &shard : m_shards)
+  {
+    shard.ready = false;
+  }
+
+  m_nextShard = 0;
+  m_mergedShards = 0;
+  m_stop = false;
+
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < threadCount; ++i)
+  {
+    threads.emplace_back(&ChainIndexRebuilder::workerThread, this, startHeight, endHeight, std::cref(load));
+  }
+
+  std::exception_ptr error;
+  for (uint32_t shardIndex = 0; shardIndex < shardCount; ++shardIndex)
+  {
+    std::vector<indexed_block_t> blocks;
+
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      shard_t &shard = m_shards[shardIndex % m_shards.size()];
+      m_shardReady.wait(lock, [&shard] { return shard.ready; });
+      error = shard.error;
+      blocks.swap(shard.blocks);
+      shard.error = nullptr;
+      shard.ready = false;
+      ++m_mergedShards;
+      m_shardMerged.notify_all();
+    }
+
+    if (error)
+    {
+      break;
+    }
+
+    try
+    {
+      for (const auto &block : blocks)
+      {
+        merge(block);
+      }
+    }
+    catch (...)
+    {
+      error = std::current_exception();
+      break;
+    }
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_stop = true;
+    m_shardMerged.notify_all();
+  }
+
+  for (auto &thread : threads)
+  {
+    thread.join();
+  }
+
+  m_shards.clear();
+  if (error)
+  {
+    std::rethrow_exception(error);
+  }
+}
+
+void ChainIndexRebuilder::workerThread(uint32_t startHeight, uint32_t endHeight, const loader_t &load)
+{
+  uint32_t shardCount = (endHeight - startHeight + SHARD_SIZE - 1) / SHARD_SIZE;
+  for (;;)
+  {
+    uint32_t shardIndex;
+
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_shardMerged.wait(lock, [this] { return m_stop || m_nextShard < m_mergedShards + m_shards.size(); });
+      if (m_stop || m_nextShard == shardCount)
+      {
+        return;
+      }
+
+      shardIndex = m_nextShard++;
+    }
+
+    uint32_t begin = startHeight + shardIndex * SHARD_SIZE;
+    uint32_t end = std::min(endHeight, begin + SHARD_SIZE);
+    std::vector<indexed_block_t> blocks(end - begin);
+    std::exception_ptr error;
+    try
+    {
+      block_entry_t block;
+      for (uint32_t height = begin; height < end; ++height)
+      {
+        load(height, block);
+        index(height, block, blocks[height - begin]);
+      }
+    }
+    catch (...)
+    {
+      error = std::current_exception();
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    shard_t &shard = m_shards[shardIndex % m_shards.size()];
+    shard.blocks.swap(blocks);
+    shard.error = error;
+    shard.ready = true;
+    m_shardReady.notify_all();
+  }
+}
+
+void ChainIndexRebuilder::index(uint32_t height, const block_entry_t &block, indexed_block_t &indexed)
+{
+  indexed.height = height;
+  indexed.hash = Block::getHash(block.bl);
+  indexed.transactions.resize(block.transactions.size());
+  for (size_t t = 0; t < block.transactions.size(); ++t)
+  {
+    const transaction_t &transaction = block.transactions[t].tx;
+    indexed_transaction_t &indexedTransaction = indexed.transactions[t];
+    indexedTransaction.hash = BinaryArray::objectHash(transaction);
+
+    for (const auto &input : transaction.inputs)
+    {
+      if (input.type() == typeid(key_input_t))
+      {
+        indexedTransaction.keyImages.push_back(::boost::get<key_input_t>(input).keyImage);
+      }
+      else if (input.type() == typeid(multi_signature_input_t))
+      {
+        const multi_signature_input_t &in = ::boost::get<multi_signature_input_t>(input);
+        indexedTransaction.multisignatureInputs.emplace_back(in.amount, in.outputIndex);
+      }
+    }
+
+    for (const auto &output : transaction.outputs)
+    {
+      indexed_transaction_t::output_kind_t kind = indexed_transaction_t::OTHER_OUTPUT;
+      if (output.target.type() == typeid(key_output_t))
+      {
+        kind = indexed_transaction_t::KEY_OUTPUT;
+      }
+      else if (output.target.type() == typeid(multi_signature_output_t))
+      {
+        kind = indexed_transaction_t::MULTISIGNATURE_OUTPUT;
+      }
+
+      indexedTransaction.outputs.emplace_back(output.amount, kind);
+    }
+  }
+}
+
+void ChainIndexRebuilder::apply(ChainIndexStore &store, const indexed_block_t &indexed)
+{
+  store.pushBlock(indexed.height, indexed.hash);
+  for (uint16_t t = 0; t < indexed.transactions.size(); ++t)
+  {
+    const indexed_transaction_t &transaction = indexed.transactions[t];
+    transaction_index_t transactionIndex = {indexed.height, t};
+    store.addTransaction(transaction.hash, transactionIndex);
+
+    for (const auto &keyImage : transaction.keyImages)
+    {
+      store.addKeyImage(keyImage);
+    }
+
+    for (const auto &input : transaction.multisignatureInputs)
+    {
+      store.setMultisignatureOutputUsed(input.first, input.second, true);
+    }
+
+    for (uint16_t o = 0; o < transaction.outputs.size(); ++o)
+    {
+      const auto &output = transaction.outputs[o];
+      if (output.second == indexed_transaction_t::KEY_OUTPUT)
+      {
+        store.pushOutput(output.first, std::make_pair(transactionIndex, o));
+      }
+      else if (output.second == indexed_transaction_t::MULTISIGNATURE_OUTPUT)
+      {
+        multisignature_output_usage_t usage = {transactionIndex, o, false};
+        store.pushMultisignatureOutput(output.first, usage);
+      }
+    }
+  }
+}
+
+} // namespace cryptonote
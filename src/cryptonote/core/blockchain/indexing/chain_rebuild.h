@@ -0,0 +1,86 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <vector>
+#include "cryptonote/core/blockchain/indexing/chain_store.h"
+#include "cryptonote/structures/block_entry.h"
+
+namespace cryptonote
+{
+
+// What a main chain transaction contributes to the chain index store, in the order the store receives it
+struct indexed_transaction_t
+{
+  enum output_kind_t : uint8_t
+  {
+    KEY_OUTPUT,
+    MULTISIGNATURE_OUTPUT,
+    OTHER_OUTPUT
+  };
+
+  crypto::hash_t hash;
+  std::vector<crypto::key_image_t> keyImages;
+  // amount and global index of every multisignature output spent
+  std::vector<std::pair<uint64_t, uint32_t>> multisignatureInputs;
+  std::vector<std::pair<uint64_t, output_kind_t>> outputs;
+};
+
+struct indexed_block_t
+{
+  uint32_t height;
+  crypto::hash_t hash;
+  std::vector<indexed_transaction_t> transactions;
+};
+
+// Rebuilds the chain index store from stored blocks. Worker threads decode and hash consecutive block ranges
+// (shards) into partial indices, the calling thread merges the shards in height order, so global output indices
+// and the store files come out the same as with a single thread.
+class ChainIndexRebuilder
+{
+  public:
+    typedef std::function<void(uint32_t height, block_entry_t &block)> loader_t;
+    typedef std::function<void(const indexed_block_t &block)> merger_t;
+
+    static const uint32_t SHARD_SIZE = 128;
+
+    // A single thread indexes and merges every block in turn on the calling thread
+    ChainIndexRebuilder(size_t threadCount);
+
+    // 'load' is called concurrently from the workers, 'merge' on the calling thread for every height in
+    // [startHeight, endHeight) in order. An exception thrown by 'load' or 'merge' stops the workers and is rethrown.
+    void run(uint32_t startHeight, uint32_t endHeight, const loader_t &load, const merger_t &merge);
+
+    static void index(uint32_t height, const block_entry_t &block, indexed_block_t &indexed);
+    static void apply(ChainIndexStore &store, const indexed_block_t &indexed);
+
+  private:
+    struct shard_t
+    {
+      std::vector<indexed_block_t> blocks;
+      std::exception_ptr error;
+      bool ready;
+    };
+
+    void workerThread(uint32_t startHeight, uint32_t endHeight, const loader_t &load);
+
+    const size_t m_threadCount;
+
+    std::mutex m_mutex;
+    std::condition_variable m_shardReady;
+    std::condition_variable m_shardMerged;
+    // Workers run at most m_shards.size() shards ahead of the merge
+    std::vector<shard_t> m_shards;
+    uint32_t m_nextShard;
+    uint32_t m_mergedShards;
+    bool m_stop;
+};
+
+} // namespace cryptonote
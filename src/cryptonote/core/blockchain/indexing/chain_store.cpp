@@ -0,0 +1,388 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "chain_store.h"
+
+#include <algorithm>
+#include <cstring>
+#include <boost/filesystem.hpp>
+
+namespace cryptonote
+{
+
+namespace
+{
+
+const size_t AMOUNT_INDEX_SIZE = sizeof(uint64_t) + sizeof(uint32_t);
+const size_t TRANSACTION_INDEX_SIZE = sizeof(uint32_t) + sizeof(uint16_t);
+const size_t OUTPUT_SIZE = TRANSACTION_INDEX_SIZE + sizeof(uint16_t);
+const size_t MULTISIGNATURE_OUTPUT_SIZE = OUTPUT_SIZE + sizeof(uint8_t);
+
+// Share of the page cache given to every file, in twelfths
+const size_t KEY_IMAGES_SHARE = 3;
+const size_t TRANSACTIONS_SHARE = 2;
+const size_t OUTPUTS_SHARE = 3;
+const size_t OTHER_SHARE = 1;
+
+size_t cachedPages(size_t cacheSize, size_t share)
+{
+  return std::max<size_t>(16, cacheSize / Common::PagedHashFile::PAGE_SIZE * share / 12);
+}
+
+void writeAmountIndex(uint8_t *data, uint64_t amount, uint32_t index)
+{
+  memcpy(data, &amount, sizeof amount);
+  memcpy(data + sizeof amount, &index, sizeof index);
+}
+
+void writeTransactionIndex(uint8_t *data, const transaction_index_t &transactionIndex)
+{
+  memcpy(data, &transactionIndex.block, sizeof transactionIndex.block);
+  memcpy(data + sizeof transactionIndex.block, &transactionIndex.transaction, sizeof transactionIndex.transaction);
+}
+
+void readTransactionIndex(const uint8_t *data, transaction_index_t &transactionIndex)
+{
+  memcpy(&transactionIndex.block, data, sizeof transactionIndex.block);
+  memcpy(&transactionIndex.transaction, data + sizeof transactionIndex.block, sizeof transactionIndex.transaction);
+}
+
+void writeMultisignatureOutput(uint8_t *data, const multisignature_output_usage_t &usage)
+{
+  writeTransactionIndex(data, usage.transactionIndex);
+  memcpy(data + TRANSACTION_INDEX_SIZE, &usage.outputIndex, sizeof usage.outputIndex);
+  data[OUTPUT_SIZE] = usage.isUsed ? 1 : 0;
+}
+
+void readMultisignatureOutput(const uint8_t *data, multisignature_output_usage_t &usage)
+{
+  readTransactionIndex(data, usage.transactionIndex);
+  memcpy(&usage.outputIndex, data + TRANSACTION_INDEX_SIZE, sizeof usage.outputIndex);
+  usage.isUsed = data[OUTPUT_SIZE] != 0;
+}
+
+std::string makeState(uint32_t height, const crypto::hash_t &tailId)
+{
+  std::string state(sizeof height + sizeof tailId, '\0');
+  memcpy(&state[0], &height, sizeof height);
+  memcpy(&state[sizeof height], &tailId, sizeof tailId);
+  return state;
+}
+
+} // namespace
+
+ChainIndexStore::ChainIndexStore(size_t cacheSize) :
+  m_blocks(sizeof(uint32_t), sizeof(crypto::hash_t), cachedPages(cacheSize, OTHER_SHARE)),
+  m_keyImages(sizeof(crypto::key_image_t), 0, cachedPages(cacheSize, KEY_IMAGES_SHARE)),
+  m_transactions(sizeof(crypto::hash_t), TRANSACTION_INDEX_SIZE, cachedPages(cacheSize, TRANSACTIONS_SHARE)),
+  m_outputs(AMOUNT_INDEX_SIZE, OUTPUT_SIZE, cachedPages(cacheSize, OUTPUTS_SHARE)),
+  m_outputCounts(sizeof(uint64_t), sizeof(uint32_t), cachedPages(cacheSize, OTHER_SHARE)),
+  m_multisignatureOutputs(AMOUNT_INDEX_SIZE, MULTISIGNATURE_OUTPUT_SIZE, cachedPages(cacheSize, OTHER_SHARE)),
+  m_multisignatureOutputCounts(sizeof(uint64_t), sizeof(uint32_t), cachedPages(cacheSize, OTHER_SHARE))
+{
+}
+
+std::vector<std::pair<Common::PagedHashFile *, const char *>> ChainIndexStore::files()
+{
+  return {
+    {&m_blocks, "blocks.dat"},
+    {&m_keyImages, "keyimages.dat"},
+    {&m_transactions, "transactions.dat"},
+    {&m_outputs, "outputs.dat"},
+    {&m_outputCounts, "outputcounts.dat"},
+    {&m_multisignatureOutputs, "msigoutputs.dat"},
+    {&m_multisignatureOutputCounts, "msigoutputcounts.dat"}};
+}
+
+bool ChainIndexStore::open(const std::string &directory, uint32_t &height, crypto::hash_t &tailId)
+{
+  boost::system::error_code ec;
+  boost::filesystem::create_directories(directory, ec);
+
+  bool opened = true;
+  for (auto &file : files())
+  {
+    opened = file.first->open((boost::filesystem::path(directory) / file.second).string()) && opened;
+  }
+
+  if (!opened)
+  {
+    return false;
+  }
+
+  std::string state = m_blocks.state();
+  for (auto &file : files())
+  {
+    if (file.first->state() != state)
+    {
+      return false;
+    }
+  }
+
+  if (state.empty())
+  {
+    height = 0;
+    tailId = NULL_HASH;
+    return true;
+  }
+
+  if (state.size() != sizeof height + sizeof tailId)
+  {
+    return false;
+  }
+
+  memcpy(&height, state.data(), sizeof height);
+  memcpy(&tailId, state.data() + sizeof height, sizeof tailId);
+  return true;
+}
+
+void ChainIndexStore::close()
+{
+  for (auto &file : files())
+  {
+    file.first->close();
+  }
+}
+
+void ChainIndexStore::clear()
+{
+  for (auto &file : files())
+  {
+    file.first->clear();
+  }
+}
+
+bool ChainIndexStore::commit(uint32_t height, const crypto::hash_t &tailId)
+{
+  std::string state = makeState(height, tailId);
+  bool committed = true;
+  for (auto &file : files())
+  {
+    committed = file.first->commit(state) && committed;
+  }
+
+  return committed;
+}
+
+void ChainIndexStore::pushBlock(uint32_t height, const crypto::hash_t &blockHash)
+{
+  m_blocks.put(&height, &blockHash);
+}
+
+void ChainIndexStore::popBlock(uint32_t height)
+{
+  m_blocks.erase(&height);
+}
+
+bool ChainIndexStore::getBlockIds(uint32_t height, std::vector<crypto::hash_t> &blockIds)
+{
+  // a single pass over the file instead of a lookup per height
+  blockIds.assign(height, NULL_HASH);
+  uint32_t found = 0;
+  m_blocks.forEach([&](const uint8_t *key, const uint8_t *value) {
+    uint32_t blockHeight;
+    memcpy(&blockHeight, key, sizeof blockHeight);
+    if (blockHeight < height)
+    {
+      memcpy(&blockIds[blockHeight], value, sizeof(crypto::hash_t));
+      ++found;
+    }
+  });
+
+  return found == height;
+}
+
+bool ChainIndexStore::hasKeyImage(const crypto::key_image_t &keyImage)
+{
+  return m_keyImages.find(&keyImage, nullptr);
+}
+
+bool ChainIndexStore::addKeyImage(const crypto::key_image_t &keyImage)
+{
+  return m_keyImages.insert(&keyImage, nullptr);
+}
+
+bool ChainIndexStore::removeKeyImage(const crypto::key_image_t &keyImage)
+{
+  return m_keyImages.erase(&keyImage);
+}
+
+bool ChainIndexStore::findTransaction(const crypto::hash_t &transactionHash, transaction_index_t &transactionIndex)
+{
+  uint8_t value[TRANSACTION_INDEX_SIZE];
+  if (!m_transactions.find(&transactionHash, value))
+  {
+    return false;
+  }
+
+  readTransactionIndex(value, transactionIndex);
+  return true;
+}
+
+bool ChainIndexStore::addTransaction(const crypto::hash_t &transactionHash, const transaction_index_t &transactionIndex)
+{
+  uint8_t value[TRANSACTION_INDEX_SIZE];
+  writeTransactionIndex(value, transactionIndex);
+  return m_transactions.insert(&transactionHash, value);
+}
+
+bool ChainIndexStore::removeTransaction(const crypto::hash_t &transactionHash)
+{
+  return m_transactions.erase(&transactionHash);
+}
+
+uint64_t ChainIndexStore::transactionCount()
+{
+  return m_transactions.size();
+}
+
+uint32_t ChainIndexStore::outputCount(uint64_t amount)
+{
+  uint32_t count = 0;
+  m_outputCounts.find(&amount, &count);
+  return count;
+}
+
+bool ChainIndexStore::getOutput(uint64_t amount, uint32_t index, output_t &output)
+{
+  uint8_t key[AMOUNT_INDEX_SIZE];
+  uint8_t value[OUTPUT_SIZE];
+  writeAmountIndex(key, amount, index);
+  if (!m_outputs.find(key, value))
+  {
+    return false;
+  }
+
+  readTransactionIndex(value, output.first);
+  memcpy(&output.second, value + TRANSACTION_INDEX_SIZE, sizeof output.second);
+  return true;
+}
+
+uint32_t ChainIndexStore::pushOutput(uint64_t amount, const output_t &output)
+{
+  uint32_t index = outputCount(amount);
+  uint8_t key[AMOUNT_INDEX_SIZE];
+  uint8_t value[OUTPUT_SIZE];
+  writeAmountIndex(key, amount, index);
+  writeTransactionIndex(value, output.first);
+  memcpy(value + TRANSACTION_INDEX_SIZE, &output.second, sizeof output.second);
+  m_outputs.put(key, value);
+
+  uint32_t count = index + 1;
+  m_outputCounts.put(&amount, &count);
+  return index;
+}
+
+bool ChainIndexStore::popOutput(uint64_t amount)
+{
+  uint32_t count = outputCount(amount);
+  if (count == 0)
+  {
+    return false;
+  }
+
+  uint8_t key[AMOUNT_INDEX_SIZE];
+  writeAmountIndex(key, amount, --count);
+  m_outputs.erase(key);
+  if (count == 0)
+  {
+    m_outputCounts.erase(&amount);
+  }
+  else
+  {
+    m_outputCounts.put(&amount, &count);
+  }
+
+  return true;
+}
+
+std::vector<uint64_t> ChainIndexStore::outputAmounts()
+{
+  std::vector<uint64_t> amounts;
+  m_outputCounts.forEach([&amounts](const uint8_t *key, const uint8_t *) {
+    uint64_t amount;
+    memcpy(&amount, key, sizeof amount);
+    amounts.push_back(amount);
+  });
+
+  std::sort(amounts.begin(), amounts.end());
+  return amounts;
+}
+
+uint32_t ChainIndexStore::multisignatureOutputCount(uint64_t amount)
+{
+  uint32_t count = 0;
+  m_multisignatureOutputCounts.find(&amount, &count);
+  return count;
+}
+
+bool ChainIndexStore::getMultisignatureOutput(uint64_t amount, uint32_t index, multisignature_output_usage_t &usage)
+{
+  uint8_t key[AMOUNT_INDEX_SIZE];
+  uint8_t value[MULTISIGNATURE_OUTPUT_SIZE];
+  writeAmountIndex(key, amount, index);
+  if (!m_multisignatureOutputs.find(key, value))
+  {
+    return false;
+  }
+
+  readMultisignatureOutput(value, usage);
+  return true;
+}
+
+uint32_t ChainIndexStore::pushMultisignatureOutput(uint64_t amount, const multisignature_output_usage_t &usage)
+{
+  uint32_t index = multisignatureOutputCount(amount);
+  uint8_t key[AMOUNT_INDEX_SIZE];
+  uint8_t value[MULTISIGNATURE_OUTPUT_SIZE];
+  writeAmountIndex(key, amount, index);
+  writeMultisignatureOutput(value, usage);
+  m_multisignatureOutputs.put(key, value);
+
+  uint32_t count = index + 1;
+  m_multisignatureOutputCounts.put(&amount, &count);
+  return index;
+}
+
+bool ChainIndexStore::popMultisignatureOutput(uint64_t amount)
+{
+  uint32_t count = multisignatureOutputCount(amount);
+  if (count == 0)
+  {
+    return false;
+  }
+
+  uint8_t key[AMOUNT_INDEX_SIZE];
+  writeAmountIndex(key, amount, --count);
+  m_multisignatureOutputs.erase(key);
+  if (count == 0)
+  {
+    m_multisignatureOutputCounts.erase(&amount);
+  }
+  else
+  {
+    m_multisignatureOutputCounts.put(&amount, &count);
+  }
+
+  return true;
+}
+
+bool ChainIndexStore::setMultisignatureOutputUsed(uint64_t amount, uint32_t index, bool used)
+{
+  multisignature_output_usage_t usage;
+  if (!getMultisignatureOutput(amount, index, usage))
+  {
+    return false;
+  }
+
+  usage.isUsed = used;
+  uint8_t key[AMOUNT_INDEX_SIZE];
+  uint8_t value[MULTISIGNATURE_OUTPUT_SIZE];
+  writeAmountIndex(key, amount, index);
+  writeMultisignatureOutput(value, usage);
+  m_multisignatureOutputs.put(key, value);
+  return true;
+}
+
+} // namespace cryptonote
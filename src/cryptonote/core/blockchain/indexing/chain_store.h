@@ -0,0 +1,75 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+#include "common/PagedHashFile.h"
+#include "cryptonote/core/key.h"
+#include "cryptonote/core/blockchain/serializer/multisignature_output_usage.hpp"
+
+namespace cryptonote
+{
+
+// Main chain block ids, spent key images, transaction locations and global output indices kept in paged hash
+// files, so they are neither rebuilt on startup nor held in memory as a whole. Changes become durable together
+// on 'commit', which records the height and top block they describe.
+class ChainIndexStore
+{
+  public:
+    typedef std::pair<transaction_index_t, uint16_t> output_t;
+
+    // 'cacheSize' bytes of pages are kept in memory, split among the files
+    ChainIndexStore(size_t cacheSize);
+
+    // Fails if a file can not be opened or the files were not committed at the same height
+    bool open(const std::string &directory, uint32_t &height, crypto::hash_t &tailId);
+    void close();
+    void clear();
+    bool commit(uint32_t height, const crypto::hash_t &tailId);
+
+    void pushBlock(uint32_t height, const crypto::hash_t &blockHash);
+    void popBlock(uint32_t height);
+    // Ids of the blocks below 'height', false if one of them is missing
+    bool getBlockIds(uint32_t height, std::vector<crypto::hash_t> &blockIds);
+
+    bool hasKeyImage(const crypto::key_image_t &keyImage);
+    // false if the key image is already spent
+    bool addKeyImage(const crypto::key_image_t &keyImage);
+    bool removeKeyImage(const crypto::key_image_t &keyImage);
+
+    bool findTransaction(const crypto::hash_t &transactionHash, transaction_index_t &transactionIndex);
+    // false if the transaction is already in the chain
+    bool addTransaction(const crypto::hash_t &transactionHash, const transaction_index_t &transactionIndex);
+    bool removeTransaction(const crypto::hash_t &transactionHash);
+    uint64_t transactionCount();
+
+    uint32_t outputCount(uint64_t amount);
+    bool getOutput(uint64_t amount, uint32_t index, output_t &output);
+    // Returns the global index of the output
+    uint32_t pushOutput(uint64_t amount, const output_t &output);
+    bool popOutput(uint64_t amount);
+    std::vector<uint64_t> outputAmounts();
+
+    uint32_t multisignatureOutputCount(uint64_t amount);
+    bool getMultisignatureOutput(uint64_t amount, uint32_t index, multisignature_output_usage_t &usage);
+    uint32_t pushMultisignatureOutput(uint64_t amount, const multisignature_output_usage_t &usage);
+    bool popMultisignatureOutput(uint64_t amount);
+    bool setMultisignatureOutputUsed(uint64_t amount, uint32_t index, bool used);
+
+  private:
+    std::vector<std::pair<Common::PagedHashFile *, const char *>> files();
+
+    Common::PagedHashFile m_blocks;
+    Common::PagedHashFile m_keyImages;
+    Common::PagedHashFile m_transactions;
+    Common::PagedHashFile m_outputs;
+    Common::PagedHashFile m_outputCounts;
+    Common::PagedHashFile m_multisignatureOutputs;
+    Common::PagedHashFile m_multisignatureOutputCounts;
+};
+
+} // namespace cryptonote
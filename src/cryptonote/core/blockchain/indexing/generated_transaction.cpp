@@ -13,24 +13,32 @@ GeneratedTransactionsIndex::GeneratedTransactionsIndex() : lastGeneratedTxNumber
 bool GeneratedTransactionsIndex::add(const block_t&block)
 {
   uint32_t blockHeight = boost::get<base_input_t>(block.baseTransaction.inputs.front()).blockIndex;
+  return add(blockHeight, block.transactionHashes.size() + 1); //Plus miner tx
+}
+
+bool GeneratedTransactionsIndex::remove(const block_t&block)
+{
+  uint32_t blockHeight = boost::get<base_input_t>(block.baseTransaction.inputs.front()).blockIndex;
+  return remove(blockHeight);
+}
 
+bool GeneratedTransactionsIndex::add(uint32_t blockHeight, uint64_t transactionCount)
+{
   if (index.size() != blockHeight)
   {
     return false;
   }
 
-  bool status = index.emplace(blockHeight, lastGeneratedTxNumber + block.transactionHashes.size() + 1).second; //Plus miner tx
+  bool status = index.emplace(blockHeight, lastGeneratedTxNumber + transactionCount).second;
   if (status)
   {
-    lastGeneratedTxNumber += block.transactionHashes.size() + 1;
+    lastGeneratedTxNumber += transactionCount;
   }
   return status;
 }
 
-bool GeneratedTransactionsIndex::remove(const block_t&block)
+bool GeneratedTransactionsIndex::remove(uint32_t blockHeight)
 {
-  uint32_t blockHeight = boost::get<base_input_t>(block.baseTransaction.inputs.front()).blockIndex;
-
   if (blockHeight != index.size() - 1)
   {
     return false;
@@ -15,6 +15,9 @@ class GeneratedTransactionsIndex
 
     bool add(const block_t&block);
     bool remove(const block_t&block);
+    // 'transactionCount' includes the miner transaction
+    bool add(uint32_t blockHeight, uint64_t transactionCount);
+    bool remove(uint32_t blockHeight);
     bool find(uint32_t height, uint64_t &generatedTransactions);
     void clear();
 
@@ -10,7 +10,7 @@ bool PaymentIdIndex::add(const transaction_t& transaction) {
     return false;
   }
 
-  index.emplace(paymentId, transactionHash);
+  add(paymentId, transactionHash);
 
   return true;
 }
@@ -22,6 +22,14 @@ bool PaymentIdIndex::remove(const transaction_t& transaction) {
     return false;
   }
 
+  return remove(paymentId, transactionHash);
+}
+
+void PaymentIdIndex::add(const crypto::hash_t& paymentId, const crypto::hash_t& transactionHash) {
+  index.emplace(paymentId, transactionHash);
+}
+
+bool PaymentIdIndex::remove(const crypto::hash_t& paymentId, const crypto::hash_t& transactionHash) {
   auto range = index.equal_range(paymentId);
   for (auto iter = range.first; iter != range.second; ++iter){
     if (iter->second == transactionHash) {
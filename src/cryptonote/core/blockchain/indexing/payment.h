@@ -16,6 +16,8 @@ class PaymentIdIndex
 
     bool add(const transaction_t &transaction);
     bool remove(const transaction_t &transaction);
+    void add(const crypto::hash_t &paymentId, const crypto::hash_t &transactionHash);
+    bool remove(const crypto::hash_t &paymentId, const crypto::hash_t &transactionHash);
     bool find(const crypto::hash_t &paymentId, std::vector<crypto::hash_t> &transactionHashes);
     void clear();
 
@@ -9,7 +9,8 @@
 #include <serialization/BinaryOutputStreamSerializer.h>
 #include <fstream>
 #include <chrono>
-#include <cryptonote/core/blockchain.h>
+#include "cryptonote/core/blockchain/indexing/exports.h"
+#include "config/common.h"
 
 using namespace Logging;
 using namespace Common;
@@ -17,13 +18,16 @@ using namespace Common;
 namespace cryptonote
 {
 
-class Blockchain;
-
+// Snapshot of the payment id, timestamp and generated transactions indices at 'height'. Deltas logged after it
+// are kept in the IndicesDeltaLog files of the following generations.
 class BlockchainIndicesSerializer
 {
 
   public:
-    BlockchainIndicesSerializer(Blockchain &bs, const crypto::hash_t lastBlockHash, ILogger &logger) : m_bs(bs), m_lastBlockHash(lastBlockHash), m_loaded(false), logger(logger, "BlockchainIndicesSerializer")
+    BlockchainIndicesSerializer(PaymentIdIndex &paymentIdIndex, TimestampBlocksIndex &timestampIndex, GeneratedTransactionsIndex &generatedTransactionsIndex,
+                                uint64_t generation, uint32_t height, const crypto::hash_t lastBlockHash, ILogger &logger) :
+      m_paymentIdIndex(paymentIdIndex), m_timestampIndex(timestampIndex), m_generatedTransactionsIndex(generatedTransactionsIndex),
+      m_generation(generation), m_height(height), m_lastBlockHash(lastBlockHash), m_loaded(false), logger(logger, "BlockchainIndicesSerializer")
     {
     }
 
@@ -31,7 +35,7 @@ class BlockchainIndicesSerializer
     {
 
         config::config_t &data = config::get();
-        uint8_t version = data.storageVersions.blockcache_archive.major;
+        uint8_t version = data.storageVersions.blockcache_indices_archive.major;
 
         KV_MEMBER(version);
 
@@ -41,32 +45,19 @@ class BlockchainIndicesSerializer
 
         std::string operation;
 
-        if (s.type() == ISerializer::INPUT)
-        {
-            operation = "- loading ";
-
-            crypto::hash_t blockHash;
-            s(blockHash, "blockHash");
-
-            if (blockHash != m_lastBlockHash)
-            {
-                return;
-            }
-        }
-        else
-        {
-            operation = "- saving ";
-            s(m_lastBlockHash, "blockHash");
-        }
+        operation = s.type() == ISerializer::INPUT ? "- loading " : "- saving ";
+        s(m_generation, "generation");
+        s(m_height, "height");
+        s(m_lastBlockHash, "blockHash");
 
         logger(INFO) << operation << "paymentID index...";
-        s(m_bs.m_paymentIdIndex, "paymentIdIndex");
+        s(m_paymentIdIndex, "paymentIdIndex");
 
         logger(INFO) << operation << "timestamp index...";
-        s(m_bs.m_timestampIndex, "timestampIndex");
+        s(m_timestampIndex, "timestampIndex");
 
         logger(INFO) << operation << "generated transactions index...";
-        s(m_bs.m_generatedTransactionsIndex, "generatedTransactionsIndex");
+        s(m_generatedTransactionsIndex, "generatedTransactionsIndex");
 
         m_loaded = true;
     }
@@ -83,32 +74,19 @@ class BlockchainIndicesSerializer
         if (version < ver)
             return;
 
-        std::string operation;
-        if (Archive::is_loading::value)
-        {
-            operation = "- loading ";
-            crypto::hash_t blockHash;
-            ar &blockHash;
-
-            if (blockHash != m_lastBlockHash)
-            {
-                return;
-            }
-        }
-        else
-        {
-            operation = "- saving ";
-            ar &m_lastBlockHash;
-        }
+        std::string operation = Archive::is_loading::value ? "- loading " : "- saving ";
+        ar &m_generation;
+        ar &m_height;
+        ar &m_lastBlockHash;
 
         logger(INFO) << operation << "paymentID index...";
-        ar &m_bs.m_paymentIdIndex;
+        ar &m_paymentIdIndex;
 
         logger(INFO) << operation << "timestamp index...";
-        ar &m_bs.m_timestampIndex;
+        ar &m_timestampIndex;
 
         logger(INFO) << operation << "generated transactions index...";
-        ar &m_bs.m_generatedTransactionsIndex;
+        ar &m_generatedTransactionsIndex;
 
         m_loaded = true;
     }
@@ -118,10 +96,29 @@ class BlockchainIndicesSerializer
         return m_loaded;
     }
 
+    uint64_t generation() const
+    {
+        return m_generation;
+    }
+
+    uint32_t height() const
+    {
+        return m_height;
+    }
+
+    const crypto::hash_t &lastBlockHash() const
+    {
+        return m_lastBlockHash;
+    }
+
   private:
-    LoggerRef logger;
-    bool m_loaded;
-    Blockchain &m_bs;
+    PaymentIdIndex &m_paymentIdIndex;
+    TimestampBlocksIndex &m_timestampIndex;
+    GeneratedTransactionsIndex &m_generatedTransactionsIndex;
+    uint64_t m_generation;
+    uint32_t m_height;
     crypto::hash_t m_lastBlockHash;
+    bool m_loaded;
+    LoggerRef logger;
 };
 } // namespace cryptonote
\ No newline at end of file
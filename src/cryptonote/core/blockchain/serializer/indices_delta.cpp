@@ -0,0 +1,85 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "indices_delta.h"
+
+#include "cryptonote/core/blockchain/serializer/basics.h"
+#include "cryptonote/structures/array.hpp"
+#include "serialization/SerializationOverloads.h"
+
+namespace cryptonote {
+  namespace {
+    // a larger size can only come from a torn write
+    const uint32_t MAX_RECORD_SIZE = 16 * 1024 * 1024;
+  }
+
+  void indices_delta_t::serialize(ISerializer& s) {
+    s(pushed, "pushed");
+    s(height, "height");
+    s(blockHash, "blockHash");
+    s(previousBlockHash, "previousBlockHash");
+    s(timestamp, "timestamp");
+    s(transactionCount, "transactionCount");
+    s(paymentIds, "paymentIds");
+  }
+
+  std::string IndicesDeltaLog::filename(const std::string& snapshotFilename, uint64_t generation) {
+    return snapshotFilename + "." + std::to_string(generation) + ".log";
+  }
+
+  bool IndicesDeltaLog::read(const std::string& filename, uint32_t& height, crypto::hash_t& tailId, std::vector<indices_delta_t>& deltas) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.read(reinterpret_cast<char*>(&height), sizeof height) || !file.read(reinterpret_cast<char*>(&tailId), sizeof tailId)) {
+      return false;
+    }
+
+    deltas.clear();
+    for (;;) {
+      uint32_t size;
+      if (!file.read(reinterpret_cast<char*>(&size), sizeof size) || size > MAX_RECORD_SIZE) {
+        break;
+      }
+
+      binary_array_t record(size);
+      indices_delta_t delta;
+      if (!file.read(reinterpret_cast<char*>(record.data()), size) || !BinaryArray::from(delta, record)) {
+        break;
+      }
+
+      deltas.push_back(std::move(delta));
+    }
+
+    return true;
+  }
+
+  bool IndicesDeltaLog::create(const std::string& filename, uint32_t height, const crypto::hash_t& tailId) {
+    close();
+    m_file.open(filename, std::ios::binary | std::ios::out | std::ios::trunc);
+    m_file.write(reinterpret_cast<const char*>(&height), sizeof height);
+    m_file.write(reinterpret_cast<const char*>(&tailId), sizeof tailId);
+    m_size = 0;
+    return flush();
+  }
+
+  void IndicesDeltaLog::close() {
+    if (m_file.is_open()) {
+      m_file.close();
+    }
+
+    m_file.clear();
+  }
+
+  bool IndicesDeltaLog::append(const indices_delta_t& delta) {
+    binary_array_t record = BinaryArray::to(delta);
+    uint32_t size = static_cast<uint32_t>(record.size());
+    m_file.write(reinterpret_cast<const char*>(&size), sizeof size);
+    m_file.write(reinterpret_cast<const char*>(record.data()), record.size());
+    ++m_size;
+    return static_cast<bool>(m_file);
+  }
+
+  bool IndicesDeltaLog::flush() {
+    return m_file.is_open() && m_file.flush();
+  }
+}
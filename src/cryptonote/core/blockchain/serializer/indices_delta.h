@@ -0,0 +1,57 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "crypto/hash.h"
+
+namespace cryptonote
+{
+  class ISerializer;
+
+  // What pushing or popping a main chain block changes in the payment id, timestamp and generated
+  // transactions indices
+  struct indices_delta_t {
+    bool pushed;
+    uint32_t height;
+    crypto::hash_t blockHash;
+    crypto::hash_t previousBlockHash;
+    uint64_t timestamp;
+    // miner transaction included
+    uint32_t transactionCount;
+    // payment id and hash of every transaction carrying one
+    std::vector<std::pair<crypto::hash_t, crypto::hash_t>> paymentIds;
+
+    void serialize(ISerializer& s);
+  };
+
+  // Append-only file of the deltas recorded after a snapshot of the indices. The header holds the height and
+  // top block the first delta applies to, so a log is only replayed on top of the state it was started from.
+  class IndicesDeltaLog {
+  public:
+    IndicesDeltaLog() : m_size(0) {}
+
+    static std::string filename(const std::string& snapshotFilename, uint64_t generation);
+    // False if the file is missing or has no header. Stops at the first record a crash left incomplete.
+    static bool read(const std::string& filename, uint32_t& height, crypto::hash_t& tailId, std::vector<indices_delta_t>& deltas);
+
+    // Replaces the file with an empty log starting at 'height'
+    bool create(const std::string& filename, uint32_t height, const crypto::hash_t& tailId);
+    void close();
+    bool isOpen() const { return m_file.is_open(); }
+    bool append(const indices_delta_t& delta);
+    bool flush();
+    // Deltas appended since create
+    size_t size() const { return m_size; }
+
+  private:
+    std::ofstream m_file;
+    size_t m_size;
+  };
+}
@@ -59,7 +59,9 @@ logger(logger, "core"),
 m_mempool(currency, m_blockchain, m_timeProvider, logger),
 m_blockchain(currency, m_mempool, logger),
 m_miner(new miner(currency, *this, logger)),
-m_starter_message_showed(false) {
+m_starter_message_showed(false),
+m_blockEntryCache(currency.blockEntryCacheSize()),
+m_blockTemplateCache(currency.blockTemplatePoolChanges(), currency.blockTemplateMaxAge()) {
   set_cryptonote_protocol(pprotocol);
   m_blockchain.addObserver(this);
     m_mempool.addObserver(this);
@@ -112,6 +114,16 @@ bool core::init(const MinerConfig& minerConfig, bool load_existing) {
   bool r = m_mempool.init();
   if (!(r)) { logger(ERROR, BRIGHT_RED) << "Failed to initialize memory pool"; return false; }
 
+  // the scratchpad goes to the pool shared by the threads checking proofs of work
+  crypto::slow_hash_allocate_state();
+  int pages = crypto::slow_hash_state_pages();
+  crypto::slow_hash_free_state();
+  if (pages == crypto::SLOW_HASH_PAGES_HUGE) {
+    logger(INFO) << "Proof of work scratchpads use huge pages";
+  } else if (pages != crypto::SLOW_HASH_PAGES_NONE) {
+    logger(WARNING) << "Proof of work scratchpads use " << crypto::slow_hash_pages_name(pages) << ", reserve huge pages to check blocks faster";
+  }
+
   r = m_blockchain.init(load_existing);
   if (!(r)) { logger(ERROR, BRIGHT_RED) << "Failed to initialize blockchain storage"; return false; }
 
@@ -276,6 +288,20 @@ size_t core::get_blockchain_total_transactions() {
 //}
 
 bool core::add_new_tx(const transaction_t& tx, const crypto::hash_t& tx_hash, size_t blob_size, tx_verification_context_t& tvc, bool keeped_by_block) {
+  if (m_blockchain.haveTransaction(tx_hash) || m_mempool.have_tx(tx_hash)) {
+    logger(TRACE) << "tx " << tx_hash << " is already in blockchain or transaction pool";
+    return true;
+  }
+
+  // Ring signatures of relayed transactions are verified before the locks below are taken, the pool only
+  // checks them again if the block they were checked against left the main chain in the meantime.
+  // Transactions kept by a block are left to the pool, which checks them once.
+  block_info_t maxUsedBlock;
+  bool preChecked = !keeped_by_block;
+  if (preChecked && !m_blockchain.checkTransactionInputs(tx, maxUsedBlock)) {
+    maxUsedBlock.clear();
+  }
+
   //Locking on m_mempool and m_blockchain closes possibility to add tx to memory pool which is already in blockchain 
   std::lock_guard<decltype(m_mempool)> lk(m_mempool);
   Locker lbs(m_blockchain.getMutex());;
@@ -290,10 +316,17 @@ bool core::add_new_tx(const transaction_t& tx, const crypto::hash_t& tx_hash, si
     return true;
   }
 
-  return m_mempool.add_tx(tx, tx_hash, blob_size, tvc, keeped_by_block);
+  return m_mempool.add_tx(tx, tx_hash, blob_size, tvc, keeped_by_block, preChecked ? &maxUsedBlock : nullptr);
 }
 
 bool core::get_block_template(block_t& b, const account_public_address_t& adr, difficulty_t& diffic, uint32_t& height, const binary_array_t& ex_nonce) {
+  uint64_t poolVersion = m_mempool.getVersion();
+  uint64_t now = m_timeProvider.now();
+  if (m_blockTemplateCache.get(get_tail_id(), poolVersion, now, adr, ex_nonce, b, diffic, height)) {
+    b.timestamp = time(NULL);
+    return true;
+  }
+
   size_t median_size;
   uint64_t already_generated_coins;
   config::config_t conf = config::get();
@@ -367,6 +400,7 @@ bool core::get_block_template(block_t& b, const account_public_address_t& adr, d
       }
     }
     if (!(cumulative_size == txs_size + BinaryArray::size(b.baseTransaction))) { logger(ERROR, BRIGHT_RED) << "unexpected case: cumulative_size=" << cumulative_size << " is not equal txs_cumulative_size=" << txs_size << " + get_object_blobsize(b.baseTransaction)=" << BinaryArray::size(b.baseTransaction); return false; }
+    m_blockTemplateCache.put(poolVersion, now, adr, ex_nonce, b, diffic, height);
     return true;
   }
 
@@ -440,18 +474,49 @@ bool core::getPoolChanges(const crypto::hash_t& tailBlockId, const std::vector<c
 
 bool core::getPoolChangesLite(const crypto::hash_t& tailBlockId, const std::vector<crypto::hash_t>& knownTxsIds,
         std::vector<transaction_prefix_info_t>& addedTxs, std::vector<crypto::hash_t>& deletedTxsIds) {
+  std::vector<crypto::hash_t> addedTxsIds;
   std::vector<transaction_t> added;
-  bool returnStatus = getPoolChanges(tailBlockId, knownTxsIds, added, deletedTxsIds);
+  {
+    auto guard = m_mempool.obtainGuard();
+    m_mempool.get_difference(knownTxsIds, addedTxsIds, deletedTxsIds);
+    std::vector<crypto::hash_t> misses;
+    m_mempool.getTransactions(addedTxsIds, added, misses);
+    assert(misses.empty());
+  }
 
-  for (const auto& tx: added) {
+  // the pool knows the hashes already
+  for (size_t i = 0; i < added.size(); ++i) {
     transaction_prefix_info_t tpi;
-    tpi.txPrefix = tx;
-    tpi.txHash = BinaryArray::objectHash(tx);
+    tpi.txPrefix = added[i];
+    tpi.txHash = addedTxsIds[i];
 
     addedTxs.push_back(std::move(tpi));
   }
 
-  return returnStatus;
+  return tailBlockId == m_blockchain.getTailId();
+}
+
+bool core::getPoolChangesSince(const crypto::hash_t& tailBlockId, uint64_t& sequence, bool& isFullResync,
+        std::vector<transaction_prefix_info_t>& addedTxs, std::vector<crypto::hash_t>& deletedTxsIds) {
+  std::vector<crypto::hash_t> addedTxsIds;
+  std::vector<transaction_t> added;
+  {
+    auto guard = m_mempool.obtainGuard();
+    isFullResync = !m_mempool.getChangesSince(sequence, addedTxsIds, deletedTxsIds);
+    std::vector<crypto::hash_t> misses;
+    m_mempool.getTransactions(addedTxsIds, added, misses);
+    assert(misses.empty());
+  }
+
+  for (size_t i = 0; i < added.size(); ++i) {
+    transaction_prefix_info_t tpi;
+    tpi.txPrefix = added[i];
+    tpi.txHash = addedTxsIds[i];
+
+    addedTxs.push_back(std::move(tpi));
+  }
+
+  return tailBlockId == m_blockchain.getTailId();
 }
 
 void core::getPoolChanges(const std::vector<crypto::hash_t>& knownTxsIds, std::vector<transaction_t>& addedTxs,
@@ -481,12 +546,16 @@ bool core::handle_incoming_block_blob(const binary_array_t& block_blob, block_ve
   return handle_incoming_block(b, bvc, control_miner, relay_block);
 }
 
-bool core::handle_incoming_block(const block_t& b, block_verification_context_t& bvc, bool control_miner, bool relay_block) {
+bool core::handleIncomingBlock(const block_t& block, const crypto::hash_t& proofOfWork, block_verification_context_t& bvc, bool controlMiner, bool relayBlock) {
+  return handle_incoming_block(block, bvc, controlMiner, relayBlock, &proofOfWork);
+}
+
+bool core::handle_incoming_block(const block_t& b, block_verification_context_t& bvc, bool control_miner, bool relay_block, const crypto::hash_t* proofOfWork) {
   if (control_miner) {
     pause_mining();
   }
 
-  m_blockchain.addNewBlock(b, bvc);
+  m_blockchain.addNewBlock(b, bvc, proofOfWork);
 
   if (control_miner) {
     update_block_template_and_resume_mining();
@@ -621,7 +690,13 @@ void core::blockchainUpdated() {
   m_observerManager.notify(&ICoreObserver::blockchainUpdated);
 }
 
+void core::blockPopped(const crypto::hash_t& blockHash) {
+  m_blockEntryCache.remove(blockHash);
+}
+
 void core::txDeletedFromPool() {
+  // the cached template may hold the deleted transactions, a block with them would be rejected
+  m_blockTemplateCache.clear();
   poolUpdated();
 }
 
@@ -668,18 +743,20 @@ bool core::queryBlocks(const std::vector<crypto::hash_t>& knownBlockIds, uint64_
 
     item.block_id = Block::getHash(b);
 
-    if (b.timestamp >= timestamp) {
+    block_complete_entry_t& completeEntry = item;
+    if (b.timestamp >= timestamp && !m_blockEntryCache.get(item.block_id, completeEntry)) {
       // query transactions
       std::list<transaction_t> txs;
       std::list<crypto::hash_t> missedTxs;
       m_blockchain.getTransactions(b.transactionHashes, txs, missedTxs);
 
       // fill data
-      block_complete_entry_t& completeEntry = item;
       completeEntry.block = BinaryArray::toString(BinaryArray::to(b));
       for (auto& tx : txs) {
         completeEntry.txs.push_back(BinaryArray::toString(BinaryArray::to(tx)));
       }
+
+      m_blockEntryCache.put(item.block_id, completeEntry);
     }
 
     entries.push_back(std::move(item));
@@ -968,6 +1045,34 @@ std::unique_ptr<IBlock> core::getBlock(const crypto::hash_t& blockId) {
   return std::move(blockPtr);
 }
 
+bool core::getBlockEntry(const crypto::hash_t& blockId, block_complete_entry_t& entry) {
+  if (m_blockEntryCache.get(blockId, entry)) {
+    return true;
+  }
+
+  Locker lbs(m_blockchain.getMutex());
+  // popping a block is what drops it from the cache, so only main chain blocks are served
+  if (!m_blockchain.isBlockInMainChain(blockId)) {
+    return false;
+  }
+
+  block_t block;
+  m_blockchain.getBlockByHash(blockId, block);
+  std::list<transaction_t> txs;
+  std::list<crypto::hash_t> missedTxs;
+  m_blockchain.getTransactions(block.transactionHashes, txs, missedTxs);
+
+  entry.block = BinaryArray::toString(BinaryArray::to(block));
+  entry.txs.clear();
+  entry.txs.reserve(txs.size());
+  for (auto& tx : txs) {
+    entry.txs.push_back(BinaryArray::toString(BinaryArray::to(tx)));
+  }
+
+  m_blockEntryCache.put(blockId, entry);
+  return true;
+}
+
 bool core::addMessageQueue(MessageQueue<BlockchainMessage>& messageQueue) {
   return m_blockchain.addMessageQueue(messageQueue);
 }
@@ -8,6 +8,8 @@
 #include "currency.h"
 #include "tx_memory_pool.h"
 #include "blockchain.h"
+#include "BlockEntryCache.h"
+#include "BlockTemplateCache.h"
 #include "cryptonote/core/IMinerHandler.h"
 #include "command_line/MinerConfig.h"
 #include "ICore.h"
@@ -69,6 +71,7 @@ namespace cryptonote {
      virtual bool getOutByMSigGIndex(uint64_t amount, uint64_t gindex, multi_signature_output_t& out) override;
      virtual std::unique_ptr<IBlock> getBlock(const crypto::hash_t& blocksId) override;
      virtual bool handleIncomingTransaction(const transaction_t& tx, const crypto::hash_t& txHash, size_t blobSize, tx_verification_context_t& tvc, bool keptByBlock) override;
+     virtual bool handleIncomingBlock(const block_t& block, const crypto::hash_t& proofOfWork, block_verification_context_t& bvc, bool controlMiner, bool relayBlock) override;
      virtual std::error_code executeLocked(const std::function<std::error_code()>& func) override;
      
      virtual bool addMessageQueue(MessageQueue<BlockchainMessage>& messageQueue) override;
@@ -95,6 +98,10 @@ namespace cryptonote {
     virtual crypto::hash_t getBlockIdByHeight(uint32_t height) override;
     void getTransactions(const std::vector<crypto::hash_t>& txs_ids, std::list<transaction_t>& txs, std::list<crypto::hash_t>& missed_txs, bool checkTxPool = false) override;
     virtual bool getBlockByHash(const crypto::hash_t &h, block_t &blk) override;
+    // The encoded main chain block with its transactions, served from the cache when present
+    bool getBlockEntry(const crypto::hash_t& blockId, block_complete_entry_t& entry);
+    uint64_t getBlockEntryCacheHits() const { return m_blockEntryCache.hits(); }
+    uint64_t getBlockEntryCacheMisses() const { return m_blockEntryCache.misses(); }
 
      bool get_alternative_blocks(std::list<block_t>& blocks);
      size_t get_alternative_blocks_count();
@@ -125,6 +132,8 @@ namespace cryptonote {
                                  std::vector<transaction_t>& addedTxs, std::vector<crypto::hash_t>& deletedTxsIds) override;
      virtual bool getPoolChangesLite(const crypto::hash_t& tailBlockId, const std::vector<crypto::hash_t>& knownTxsIds,
                                   std::vector<transaction_prefix_info_t>& addedTxs, std::vector<crypto::hash_t>& deletedTxsIds) override;
+     virtual bool getPoolChangesSince(const crypto::hash_t& tailBlockId, uint64_t& sequence, bool& isFullResync,
+                                  std::vector<transaction_prefix_info_t>& addedTxs, std::vector<crypto::hash_t>& deletedTxsIds) override;
      virtual void getPoolChanges(const std::vector<crypto::hash_t>& knownTxsIds, std::vector<transaction_t>& addedTxs,
                                  std::vector<crypto::hash_t>& deletedTxsIds) override;
 
@@ -135,7 +144,7 @@ namespace cryptonote {
      bool add_new_tx(const transaction_t& tx, const crypto::hash_t& tx_hash, size_t blob_size, tx_verification_context_t& tvc, bool keeped_by_block);
      bool load_state_data();
      bool parse_tx_from_blob(transaction_t& tx, crypto::hash_t& tx_hash, crypto::hash_t& tx_prefix_hash, const binary_array_t& blob);
-     bool handle_incoming_block(const block_t& b, block_verification_context_t& bvc, bool control_miner, bool relay_block);
+     bool handle_incoming_block(const block_t& b, block_verification_context_t& bvc, bool control_miner, bool relay_block, const crypto::hash_t* proofOfWork = NULL);
 
      bool check_tx_syntax(const transaction_t& tx);
      //check correct values, amounts and all lightweight checks not related with database
@@ -150,6 +159,7 @@ namespace cryptonote {
      bool on_update_blocktemplate_interval();
      bool check_tx_inputs_keyimages_diff(const transaction_t& tx);
      virtual void blockchainUpdated() override;
+     virtual void blockPopped(const crypto::hash_t& blockHash) override;
      virtual void txDeletedFromPool() override;
      void poolUpdated();
 
@@ -168,5 +178,7 @@ namespace cryptonote {
      friend class tx_validate_inputs;
      std::atomic<bool> m_starter_message_showed;
      Tools::ObserverManager<ICoreObserver> m_observerManager;
+     BlockEntryCache m_blockEntryCache;
+     BlockTemplateCache m_blockTemplateCache;
    };
 }
@@ -559,6 +559,7 @@ CurrencyBuilder::CurrencyBuilder(const std::string &path, config::config_t& conf
   files.blocksIndexes = config.filenames.blockIndex;
   files.txPool = config.filenames.pool;
   files.blockchainIndexes = config.filenames.blockChainIndex;
+  files.chainStore = config.filenames.chainStore;
   m_currency.setFiles(files);
 }
 
@@ -28,6 +28,14 @@ class Currency {
 public:
   uint64_t maxBlockHeight() const { return m_maxBlockHeight; }
   size_t getPoolSize() const { return m_poolSize; }
+  bool isBlocksMemoryMapped() const { return m_blocksMemoryMapped; }
+  size_t blockIndexFlushInterval() const { return m_blockIndexFlushInterval; }
+  size_t indexCacheSize() const { return m_indexCacheSize; }
+  size_t indexRebuildThreads() const { return m_indexRebuildThreads; }
+  size_t blockEntryCacheSize() const { return m_blockEntryCacheSize; }
+  uint64_t blockTemplatePoolChanges() const { return m_blockTemplatePoolChanges; }
+  uint64_t blockTemplateMaxAge() const { return m_blockTemplateMaxAge; }
+  size_t poolChangeLogSize() const { return m_poolChangeLogSize; }
   size_t maxBlockBlobSize() const { return m_maxBlockBlobSize; }
   size_t maxTxSize() const { return m_maxTxSize; }
   uint64_t publicAddressBase58Prefix() const { return m_publicAddressBase58Prefix; }
@@ -102,6 +110,9 @@ public:
   const std::string blockchainIndexesFileName(bool withoutPath = false) const { 
     return getFiles(m_files.blockchainIndexes, withoutPath);
   }
+  const std::string chainStoreDirName(bool withoutPath = false) const {
+    return getFiles(m_files.chainStore, withoutPath);
+  }
 
   // bool isTestnet() const { return m_testnet; }
 
@@ -197,6 +208,14 @@ private:
   crypto::hash_t m_genesisBlockHash;
 
   size_t m_poolSize = 1024;
+  bool m_blocksMemoryMapped = false;
+  size_t m_blockIndexFlushInterval = 1;
+  size_t m_indexCacheSize = 16 * 1024 * 1024;
+  size_t m_indexRebuildThreads = 1;
+  size_t m_blockEntryCacheSize = 16 * 1024 * 1024;
+  uint64_t m_blockTemplatePoolChanges = 16;
+  uint64_t m_blockTemplateMaxAge = 10;
+  size_t m_poolChangeLogSize = 4096;
 
   Logging::LoggerRef logger;
 
@@ -216,6 +235,14 @@ public:
 
   transaction_t generateGenesisTransaction();
 
+  CurrencyBuilder& blocksMemoryMapped(bool val) { m_currency.m_blocksMemoryMapped = val; return *this; }
+  CurrencyBuilder& blockIndexFlushInterval(size_t val) { m_currency.m_blockIndexFlushInterval = val; return *this; }
+  CurrencyBuilder& indexCacheSize(size_t val) { m_currency.m_indexCacheSize = val; return *this; }
+  CurrencyBuilder& indexRebuildThreads(size_t val) { m_currency.m_indexRebuildThreads = val; return *this; }
+  CurrencyBuilder& blockEntryCacheSize(size_t val) { m_currency.m_blockEntryCacheSize = val; return *this; }
+  CurrencyBuilder& blockTemplatePoolChanges(uint64_t val) { m_currency.m_blockTemplatePoolChanges = val; return *this; }
+  CurrencyBuilder& blockTemplateMaxAge(uint64_t val) { m_currency.m_blockTemplateMaxAge = val; return *this; }
+  CurrencyBuilder& poolChangeLogSize(size_t val) { m_currency.m_poolChangeLogSize = val; return *this; }
   CurrencyBuilder& maxBlockNumber(uint64_t val) { m_currency.m_maxBlockHeight = val; return *this; }
   CurrencyBuilder& maxBlockBlobSize(size_t val) { m_currency.m_maxBlockBlobSize = val; return *this; }
   CurrencyBuilder& maxTxSize(size_t val) { m_currency.m_maxTxSize = val; return *this; }
@@ -7,12 +7,13 @@ namespace cryptonote
 
 class Blockchain;
 
+// Shared ownership of the blockchain lock, core only runs queries under it
 class Locker : boost::noncopyable
 {
   public:
-    Locker(std::recursive_mutex& mutex)
+    Locker(Tools::RecursiveSharedMutex& mutex)
         : m_lock(mutex) {}
   private:
-    std::lock_guard<std::recursive_mutex> m_lock;
+    Tools::SharedLockGuard<Tools::RecursiveSharedMutex> m_lock;
 };
 } // namespace cryptonote
\ No newline at end of file
@@ -96,6 +96,9 @@ namespace cryptonote {
     m_timeProvider(timeProvider), 
     m_txCheckInterval(60, timeProvider),
     m_fee_index(boost::get<1>(m_transactions)),
+    m_version(0),
+    m_readyTransactionsStale(true),
+    m_changeSequence(static_cast<uint64_t>(crypto::rand<uint32_t>()) << 32),
     logger(log, "txpool") {
   }
 
@@ -103,7 +106,8 @@ namespace cryptonote {
     deinit();
   }
   //---------------------------------------------------------------------------------
-  bool TxMemoryPool::add_tx(const transaction_t &tx, /*const crypto::hash_t& tx_prefix_hash,*/ const crypto::hash_t &id, size_t blobSize, tx_verification_context_t& tvc, bool keptByBlock) {
+  bool TxMemoryPool::add_tx(const transaction_t &tx, /*const crypto::hash_t& tx_prefix_hash,*/ const crypto::hash_t &id, size_t blobSize, tx_verification_context_t& tvc, bool keptByBlock,
+    const block_info_t* checkedMaxUsedBlock) {
     if (!check_inputs_types_supported(tx)) {
       tvc.m_verifivation_failed = true;
       return false;
@@ -147,7 +151,17 @@ namespace cryptonote {
     block_info_t maxUsedBlock;
 
     // check inputs
-    bool inputsValid = m_validator.checkTransactionInputs(tx, maxUsedBlock);
+    bool inputsValid;
+    if (checkedMaxUsedBlock == nullptr) {
+      inputsValid = m_validator.checkTransactionInputs(tx, maxUsedBlock);
+    } else if (checkedMaxUsedBlock->empty()) {
+      inputsValid = false;
+    } else {
+      // signatures are only verified again on a chain switch, key images may have been spent by a block since
+      maxUsedBlock = *checkedMaxUsedBlock;
+      block_info_t lastFailed;
+      inputsValid = m_validator.checkTransactionInputs(tx, maxUsedBlock, lastFailed) && !m_validator.haveSpentKeyImages(tx);
+    }
 
     if (!inputsValid) {
       if (!keptByBlock) {
@@ -160,6 +174,9 @@ namespace cryptonote {
       tvc.m_verifivation_impossible = true;
     }
 
+    // the inputs were just checked against the chain tail, what is left of is_transaction_ready_to_go
+    bool ready = inputsValid && !m_validator.haveSpentKeyImages(tx);
+
     if (!keptByBlock) {
       bool sizeValid = m_validator.checkTransactionSize(blobSize);
       if (!sizeValid) {
@@ -200,6 +217,11 @@ namespace cryptonote {
       }
       m_paymentIdIndex.add(txd.tx);
       m_timestampIndex.add(txd.receiveTime, txd.id);
+      ++m_version;
+      if (ready) {
+        m_readyTransactions.insert(id);
+        logChange(id, true);
+      }
 
     }
 
@@ -245,6 +267,11 @@ namespace cryptonote {
     return m_transactions.size();
   }
   //---------------------------------------------------------------------------------
+  uint64_t TxMemoryPool::getVersion() const {
+    std::lock_guard<std::recursive_mutex> lock(m_transactions_lock);
+    return m_version;
+  }
+  //---------------------------------------------------------------------------------
   void TxMemoryPool::get_transactions(std::list<transaction_t>& txs) const {
     std::lock_guard<std::recursive_mutex> lock(m_transactions_lock);
     for (const auto& tx_vt : m_transactions) {
@@ -252,15 +279,10 @@ namespace cryptonote {
     }
   }
   //---------------------------------------------------------------------------------
-  void TxMemoryPool::get_difference(const std::vector<crypto::hash_t>& known_tx_ids, std::vector<crypto::hash_t>& new_tx_ids, std::vector<crypto::hash_t>& deleted_tx_ids) const {
+  void TxMemoryPool::get_difference(const std::vector<crypto::hash_t>& known_tx_ids, std::vector<crypto::hash_t>& new_tx_ids, std::vector<crypto::hash_t>& deleted_tx_ids) {
     std::lock_guard<std::recursive_mutex> lock(m_transactions_lock);
-    std::unordered_set<crypto::hash_t> ready_tx_ids;
-    for (const auto& tx : m_transactions) {
-      transaction::transaction_check_info_t checkInfo(tx);
-      if (is_transaction_ready_to_go(tx.tx, checkInfo)) {
-        ready_tx_ids.insert(tx.id);
-      }
-    }
+    updateReadyTransactions();
+    std::unordered_set<crypto::hash_t> ready_tx_ids(m_readyTransactions);
 
     std::unordered_set<crypto::hash_t> known_set(known_tx_ids.begin(), known_tx_ids.end());
     for (auto it = ready_tx_ids.begin(), e = ready_tx_ids.end(); it != e;) {
@@ -278,11 +300,46 @@ namespace cryptonote {
     deleted_tx_ids.assign(known_set.begin(), known_set.end());
   }
   //---------------------------------------------------------------------------------
+  bool TxMemoryPool::getChangesSince(uint64_t& sequence, std::vector<crypto::hash_t>& new_tx_ids, std::vector<crypto::hash_t>& deleted_tx_ids) {
+    std::lock_guard<std::recursive_mutex> lock(m_transactions_lock);
+    updateReadyTransactions();
+
+    uint64_t known = sequence;
+    sequence = m_changeSequence;
+    if (known == m_changeSequence) {
+      return true;
+    }
+
+    if (known > m_changeSequence || m_changes.empty() || m_changes.front().sequence > known + 1) {
+      new_tx_ids.assign(m_readyTransactions.begin(), m_readyTransactions.end());
+      return false;
+    }
+
+    // only the last change of each transaction matters
+    std::unordered_map<crypto::hash_t, bool> changes;
+    auto it = std::lower_bound(m_changes.begin(), m_changes.end(), known + 1, [](const PoolChange& change, uint64_t value) {
+      return change.sequence < value;
+    });
+
+    for (; it != m_changes.end(); ++it) {
+      changes[it->id] = it->added;
+    }
+
+    for (const auto& change : changes) {
+      (change.second ? new_tx_ids : deleted_tx_ids).push_back(change.first);
+    }
+
+    return true;
+  }
+  //---------------------------------------------------------------------------------
   bool TxMemoryPool::on_blockchain_inc(uint64_t new_block_height, const crypto::hash_t& top_block_id) {
+    // not locking the pool, the blockchain lock is taken before it
+    m_readyTransactionsStale = true;
     return true;
   }
   //---------------------------------------------------------------------------------
   bool TxMemoryPool::on_blockchain_dec(uint64_t new_block_height, const crypto::hash_t& top_block_id) {
+    m_readyTransactionsStale = true;
     return true;
   }
   //---------------------------------------------------------------------------------
@@ -320,6 +377,41 @@ namespace cryptonote {
     return true;
   }
   //---------------------------------------------------------------------------------
+  void TxMemoryPool::updateReadyTransactions() {
+    if (!m_readyTransactionsStale.exchange(false)) {
+      return;
+    }
+
+    std::unordered_set<crypto::hash_t> wasReady;
+    wasReady.swap(m_readyTransactions);
+    for (auto it = m_transactions.begin(); it != m_transactions.end(); ++it) {
+      // the check info saved from the last check lets unchanged inputs skip the ring signatures
+      transaction::transaction_check_info_t checkInfo(*it);
+      bool ready = is_transaction_ready_to_go(it->tx, checkInfo);
+      m_transactions.modify(it, [&checkInfo](transaction::transaction_details_t& item) {
+        static_cast<transaction::transaction_check_info_t&>(item) = checkInfo;
+      });
+
+      if (ready) {
+        m_readyTransactions.insert(it->id);
+        if (wasReady.erase(it->id) == 0) {
+          logChange(it->id, true);
+        }
+      }
+    }
+
+    for (const auto& id : wasReady) {
+      logChange(id, false);
+    }
+  }
+  //---------------------------------------------------------------------------------
+  void TxMemoryPool::logChange(const crypto::hash_t& id, bool added) {
+    m_changes.push_back({++m_changeSequence, id, added});
+    while (m_changes.size() > m_currency.poolChangeLogSize()) {
+      m_changes.pop_front();
+    }
+  }
+  //---------------------------------------------------------------------------------
   std::string TxMemoryPool::print_pool(bool short_format) const {
     std::stringstream ss;
     std::lock_guard<std::recursive_mutex> lock(m_transactions_lock);
@@ -346,6 +438,7 @@ namespace cryptonote {
   bool TxMemoryPool::fill_block_template(block_t& bl, size_t median_size, size_t maxCumulativeSize,
                                            uint64_t already_generated_coins, size_t& total_size, uint64_t& fee) {
     std::lock_guard<std::recursive_mutex> lock(m_transactions_lock);
+    updateReadyTransactions();
 
     total_size = 0;
     fee = 0;
@@ -362,8 +455,7 @@ namespace cryptonote {
         continue;
       }
 
-      transaction::transaction_check_info_t checkInfo(txd);
-      if (is_transaction_ready_to_go(txd.tx, checkInfo) && blockTemplate.addTransaction(txd.id, txd.tx)) {
+      if (m_readyTransactions.count(txd.id) != 0 && blockTemplate.addTransaction(txd.id, txd.tx)) {
         total_size += txd.blobSize;
       }
     }
@@ -376,15 +468,7 @@ namespace cryptonote {
         continue;
       }
 
-      transaction::transaction_check_info_t checkInfo(txd);
-      bool ready = is_transaction_ready_to_go(txd.tx, checkInfo);
-
-      // update item state
-      m_fee_index.modify(i, [&checkInfo](transaction::transaction_check_info_t& item) {
-        item = checkInfo;
-      });
-
-      if (ready && blockTemplate.addTransaction(txd.id, txd.tx)) {
+      if (m_readyTransactions.count(txd.id) != 0 && blockTemplate.addTransaction(txd.id, txd.tx)) {
         total_size += txd.blobSize;
         fee += txd.fee;
       }
@@ -410,6 +494,8 @@ namespace cryptonote {
       buildIndices();
     }
 
+    m_readyTransactions.clear();
+    m_readyTransactionsStale = true;
     removeExpiredTransactions();
 
     // Ignore deserialization error
@@ -521,6 +607,10 @@ namespace cryptonote {
     removeTransactionInputs(i->id, i->tx, i->keptByBlock);
     m_paymentIdIndex.remove(i->tx);
     m_timestampIndex.remove(i->receiveTime, i->id);
+    if (m_readyTransactions.erase(i->id) != 0) {
+      logChange(i->id, false);
+    }
+    ++m_version;
     return m_transactions.erase(i);
   }
 
@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <atomic>
+#include <deque>
 #include <set>
 #include <unordered_map>
 #include <unordered_set>
@@ -61,11 +63,15 @@ namespace cryptonote {
     bool deinit();
 
     bool have_tx(const crypto::hash_t &id) const;
-    bool add_tx(const transaction_t &tx, const crypto::hash_t &id, size_t blobSize, tx_verification_context_t& tvc, bool keeped_by_block);
+    // 'checkedMaxUsedBlock' is the result of checkTransactionInputs(tx, maxUsedBlock) run by the caller before taking
+    // the pool and blockchain locks, empty if that check failed. Without it the inputs are checked here.
+    bool add_tx(const transaction_t &tx, const crypto::hash_t &id, size_t blobSize, tx_verification_context_t& tvc, bool keeped_by_block,
+      const block_info_t* checkedMaxUsedBlock = nullptr);
     bool add_tx(const transaction_t &tx, tx_verification_context_t& tvc, bool keeped_by_block);
     //gets tx and remove it from pool
     bool take_tx(const crypto::hash_t &id, transaction_t &tx, size_t& blobSize, uint64_t& fee);
 
+    // Called by the blockchain with its lock held, the ready transactions are checked again on the next read
     bool on_blockchain_inc(uint64_t new_block_height, const crypto::hash_t& top_block_id);
     bool on_blockchain_dec(uint64_t new_block_height, const crypto::hash_t& top_block_id);
 
@@ -76,8 +82,14 @@ namespace cryptonote {
     bool fill_block_template(block_t &bl, size_t median_size, size_t maxCumulativeSize, uint64_t already_generated_coins, size_t &total_size, uint64_t &fee);
 
     void get_transactions(std::list<transaction_t>& txs) const;
-    void get_difference(const std::vector<crypto::hash_t>& known_tx_ids, std::vector<crypto::hash_t>& new_tx_ids, std::vector<crypto::hash_t>& deleted_tx_ids) const;
+    // Ready transactions missing from 'known_tx_ids', and known ones that are no longer ready
+    void get_difference(const std::vector<crypto::hash_t>& known_tx_ids, std::vector<crypto::hash_t>& new_tx_ids, std::vector<crypto::hash_t>& deleted_tx_ids);
+    // Ready transactions added and removed after change 'sequence', 'sequence' becomes the last change. Returns false
+    // with every ready transaction in 'new_tx_ids' when the change log no longer reaches back to 'sequence'.
+    bool getChangesSince(uint64_t& sequence, std::vector<crypto::hash_t>& new_tx_ids, std::vector<crypto::hash_t>& deleted_tx_ids);
     size_t get_transactions_count() const;
+    // Incremented each time a transaction is added or removed
+    uint64_t getVersion() const;
     std::string print_pool(bool short_format) const;
     void on_idle();
 
@@ -122,6 +134,8 @@ namespace cryptonote {
     tx_container_t::iterator removeTransaction(tx_container_t::iterator i);
     bool removeExpiredTransactions();
     bool is_transaction_ready_to_go(const transaction_t& tx, transaction::transaction_check_info_t& txd) const;
+    void updateReadyTransactions();
+    void logChange(const crypto::hash_t& id, bool added);
 
     void buildIndices();
 
@@ -139,6 +153,22 @@ namespace cryptonote {
     tx_container_t m_transactions;  
     tx_container_t::nth_index<1>::type& m_fee_index;
     std::unordered_map<crypto::hash_t, uint64_t> m_recentlyDeletedTransactions;
+    uint64_t m_version;
+    // Transactions that can go into a block on top of the chain. A transaction is classified when it is added, and
+    // all of them again after the chain changed, instead of on every read.
+    std::unordered_set<crypto::hash_t> m_readyTransactions;
+    std::atomic<bool> m_readyTransactionsStale;
+
+    struct PoolChange {
+      uint64_t sequence;
+      crypto::hash_t id;
+      bool added;
+    };
+
+    // Changes of the ready set, the last Currency::poolChangeLogSize() of them. Sequences start at a random value,
+    // so that a client of a restarted daemon does not read a log it has not seen.
+    std::deque<PoolChange> m_changes;
+    uint64_t m_changeSequence;
 
     Logging::LoggerRef logger;
 
@@ -0,0 +1,158 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "BlockImportPipeline.h"
+
+#include "cryptonote/core/CryptoNoteFormatUtils.h"
+#include "cryptonote/structures/array.hpp"
+#include "cryptonote/structures/block_entry.h"
+
+namespace cryptonote
+{
+
+BlockImportPipeline::BlockImportPipeline(const Currency& currency, const KnownBlockPredicate& isKnown,
+  const PreparedCallback& onPrepared, size_t threadCount) :
+  m_currency(currency),
+  m_isKnown(isKnown),
+  m_onPrepared(onPrepared),
+  m_blocks(nullptr),
+  m_batchId(0),
+  m_activeWorkers(0),
+  m_stop(false),
+  m_next(0),
+  m_cancel(false) {
+  threadCount = std::max<size_t>(1, threadCount);
+  for (size_t i = 0; i < threadCount; ++i) {
+    m_threads.emplace_back(&BlockImportPipeline::workerThread, this);
+  }
+}
+
+BlockImportPipeline::~BlockImportPipeline() {
+  finish();
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+
+  m_batchReady.notify_all();
+  for (auto& thread : m_threads) {
+    thread.join();
+  }
+}
+
+void BlockImportPipeline::start(const std::vector<block_complete_entry_t>& blocks) {
+  finish();
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_blocks = &blocks;
+    m_prepared.assign(blocks.size(), prepared_block_t());
+    m_ready.assign(blocks.size(), false);
+    m_next = 0;
+    m_cancel = false;
+    m_activeWorkers = m_threads.size();
+    ++m_batchId;
+  }
+
+  m_batchReady.notify_all();
+}
+
+void BlockImportPipeline::finish() {
+  m_cancel = true;
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_batchDone.wait(lock, [this] { return m_activeWorkers == 0; });
+  m_blocks = nullptr;
+}
+
+bool BlockImportPipeline::isReady(size_t index) {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  return m_ready[index];
+}
+
+prepared_block_t& BlockImportPipeline::get(size_t index) {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_preparedEvent.wait(lock, [this, index] { return m_ready[index]; });
+  return m_prepared[index];
+}
+
+void BlockImportPipeline::workerThread() {
+  uint64_t processedBatch = 0;
+  std::unique_lock<std::mutex> lock(m_mutex);
+  for (;;) {
+    m_batchReady.wait(lock, [&] { return m_stop || m_batchId != processedBatch; });
+    if (m_stop) {
+      return;
+    }
+
+    processedBatch = m_batchId;
+    lock.unlock();
+    prepareBatch();
+    lock.lock();
+
+    if (--m_activeWorkers == 0) {
+      m_batchDone.notify_all();
+    }
+  }
+}
+
+void BlockImportPipeline::prepareBatch() {
+  // Entries are taken in order, so the block the caller commits next is always the first one prepared
+  const std::vector<block_complete_entry_t>& blocks = *m_blocks;
+  for (size_t index = m_next++; !m_cancel && index < blocks.size(); index = m_next++) {
+    prepare(blocks[index], m_prepared[index]);
+
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_ready[index] = true;
+      m_preparedEvent.notify_all();
+    }
+
+    if (m_onPrepared) {
+      m_onPrepared();
+    }
+  }
+}
+
+void BlockImportPipeline::prepare(const block_complete_entry_t& entry, prepared_block_t& prepared) {
+  // decode and hash
+  binary_array_t blockBlob = array::fromString(entry.block);
+  if (blockBlob.size() > m_currency.maxBlockBlobSize()) {
+    prepared.error = "block blob is too big";
+    return;
+  }
+
+  if (!BinaryArray::from(prepared.block, blockBlob) || !Block::getHash(prepared.block, prepared.hash)) {
+    prepared.error = "failed to parse block";
+    return;
+  }
+
+  prepared.known = m_isKnown && m_isKnown(prepared.hash);
+  if (prepared.known) {
+    return;
+  }
+
+  prepared.transactions.resize(entry.txs.size());
+  prepared.transactionHashes.resize(entry.txs.size());
+  prepared.transactionSizes.resize(entry.txs.size());
+  for (size_t i = 0; i < entry.txs.size(); ++i) {
+    binary_array_t txBlob = array::fromString(entry.txs[i]);
+    prepared.transactionSizes[i] = txBlob.size();
+    if (txBlob.size() > m_currency.maxTxSize()) {
+      prepared.error = "transaction blob is too big";
+      return;
+    }
+
+    crypto::hash_t prefixHash;
+    if (!parseAndValidateTransactionFromBinaryArray(txBlob, prepared.transactions[i], prepared.transactionHashes[i], prefixHash)) {
+      prepared.error = "failed to parse transaction";
+      return;
+    }
+  }
+
+  // proof of work, checked against the difficulty on commit
+  if (!Block::getLongHash(prepared.block, prepared.proofOfWork)) {
+    prepared.error = "failed to compute proof of work";
+  }
+}
+
+}
@@ -0,0 +1,87 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cryptonote/core/currency.h"
+#include "cryptonote/protocol/definitions.h"
+
+namespace cryptonote
+{
+  struct prepared_block_t
+  {
+    block_t block;
+    crypto::hash_t hash;
+    crypto::hash_t proofOfWork;
+    std::vector<transaction_t> transactions;
+    std::vector<crypto::hash_t> transactionHashes;
+    std::vector<size_t> transactionSizes;
+    // The block is already in the chain, only 'block' and 'hash' are set
+    bool known;
+    // Empty when the entry decoded and passed the stateless checks
+    std::string error;
+  };
+
+  // Runs the stateless part of block import ahead of the commit: worker threads decode and hash the
+  // block and its transactions, check sizes and compute the proof of work. The caller commits the
+  // prepared blocks in order while the workers keep going on the following ones. The workers live as
+  // long as the pipeline and serve one batch of entries at a time.
+  class BlockImportPipeline
+  {
+  public:
+    typedef std::function<bool(const crypto::hash_t&)> KnownBlockPredicate;
+    typedef std::function<void()> PreparedCallback;
+
+    // 'isKnown' is called from the workers once a block is hashed, known blocks are not prepared further.
+    // 'onPrepared' is called from the workers after each block that became ready.
+    BlockImportPipeline(const Currency& currency, const KnownBlockPredicate& isKnown = KnownBlockPredicate(),
+      const PreparedCallback& onPrepared = PreparedCallback(), size_t threadCount = std::thread::hardware_concurrency());
+    ~BlockImportPipeline();
+
+    BlockImportPipeline(const BlockImportPipeline&) = delete;
+    BlockImportPipeline& operator=(const BlockImportPipeline&) = delete;
+
+    // Starts preparing 'blocks', the batch being prepared before is finished first
+    void start(const std::vector<block_complete_entry_t>& blocks);
+    // Stops preparing and waits for the workers to leave the batch, the entries vector may be released afterwards
+    void finish();
+
+    size_t size() const { return m_prepared.size(); }
+    bool isReady(size_t index);
+    // Blocks until the entry is prepared
+    prepared_block_t& get(size_t index);
+
+  private:
+    void workerThread();
+    void prepareBatch();
+    void prepare(const block_complete_entry_t& entry, prepared_block_t& prepared);
+
+    const Currency& m_currency;
+    KnownBlockPredicate m_isKnown;
+    PreparedCallback m_onPrepared;
+    const std::vector<block_complete_entry_t>* m_blocks;
+    std::vector<prepared_block_t> m_prepared;
+    std::vector<bool> m_ready;
+
+    std::mutex m_mutex;
+    std::condition_variable m_batchReady;
+    std::condition_variable m_batchDone;
+    std::condition_variable m_preparedEvent;
+    uint64_t m_batchId;
+    size_t m_activeWorkers;
+    bool m_stop;
+
+    std::atomic<size_t> m_next;
+    std::atomic<bool> m_cancel;
+    std::vector<std::thread> m_threads;
+  };
+}
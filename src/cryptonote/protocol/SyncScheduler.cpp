@@ -0,0 +1,225 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "SyncScheduler.h"
+
+#include <algorithm>
+
+namespace cryptonote
+{
+
+SyncScheduler::SyncScheduler(size_t rangeSize, size_t maxRangesAhead) :
+  m_rangeSize(std::max<size_t>(rangeSize, 1)),
+  m_maxRangesAhead(std::max<size_t>(maxRangesAhead, 1)),
+  m_topHeight(0),
+  m_topId(NULL_HASH) {
+}
+
+size_t SyncScheduler::addBlockIds(uint32_t startHeight, const crypto::hash_t& previousId, const std::vector<crypto::hash_t>& ids,
+  const peer_id_t& peer) {
+  size_t added = 0;
+  crypto::hash_t previous = previousId;
+  for (size_t i = 0; i < ids.size(); previous = ids[i], ++i) {
+    uint32_t height = startHeight + static_cast<uint32_t>(i);
+    if (m_scheduled.count(ids[i]) != 0) {
+      announce(startHeight, ids, peer, height);
+      continue;
+    }
+
+    if (!m_ranges.empty() && (height != m_topHeight + 1 || previous != m_topId)) {
+      // the peer is on another branch, its ids are picked up again once the scheduled ones are committed
+      break;
+    }
+
+    // a range is extended only with ids of the peer that announced all of it
+    auto last = m_ranges.empty() ? m_ranges.end() : std::prev(m_ranges.end());
+    if (last == m_ranges.end() || last->second.requested || last->second.delivered || last->second.ids.size() >= m_rangeSize ||
+      last->second.announcedBy.size() != 1 || last->second.announcedBy.count(peer) == 0) {
+      last = m_ranges.emplace(height, range_t()).first;
+      last->second.announcedBy.insert(peer);
+    }
+
+    last->second.ids.push_back(ids[i]);
+    m_scheduled.insert(ids[i]);
+    m_topHeight = height;
+    m_topId = ids[i];
+    ++added;
+  }
+
+  return added;
+}
+
+bool SyncScheduler::assign(const peer_id_t& peer, uint32_t peerHeight, clock::time_point now, std::vector<crypto::hash_t>& blockIds) {
+  peer_stats_t& stats = m_peers[peer];
+  if (stats.busy) {
+    return false;
+  }
+
+  // limit how far ahead of the commit point the reorder buffer may grow
+  size_t index = 0;
+  for (auto it = m_ranges.begin(); it != m_ranges.end() && index < m_maxRangesAhead; ++it, ++index) {
+    range_t& range = it->second;
+    if (range.requested || range.delivered || it->first + range.ids.size() > peerHeight || range.announcedBy.count(peer) == 0) {
+      continue;
+    }
+
+    range.requested = true;
+    range.peer = peer;
+    range.requestedAt = now;
+    stats.busy = true;
+    stats.assignedHeight = it->first;
+    blockIds = range.ids;
+    return true;
+  }
+
+  return false;
+}
+
+bool SyncScheduler::deliver(const peer_id_t& peer, std::vector<block_complete_entry_t>&& blocks, clock::time_point now) {
+  auto statsIt = m_peers.find(peer);
+  if (statsIt == m_peers.end() || !statsIt->second.busy) {
+    return false;
+  }
+
+  peer_stats_t& stats = statsIt->second;
+  stats.busy = false;
+
+  auto it = m_ranges.find(stats.assignedHeight);
+  if (it == m_ranges.end() || !it->second.requested || it->second.peer != peer) {
+    return false;
+  }
+
+  range_t& range = it->second;
+  double seconds = std::max(std::chrono::duration<double>(now - range.requestedAt).count(), 0.001);
+  double measured = static_cast<double>(blocks.size()) / seconds;
+  stats.throughput = stats.throughput == 0 ? measured : 0.7 * stats.throughput + 0.3 * measured;
+
+  range.requested = false;
+  range.delivered = true;
+  range.blocks = std::move(blocks);
+  return true;
+}
+
+bool SyncScheduler::popReady(std::vector<block_complete_entry_t>& blocks, peer_id_t& deliveredBy) {
+  if (m_ranges.empty() || !m_ranges.begin()->second.delivered) {
+    return false;
+  }
+
+  range_t& range = m_ranges.begin()->second;
+  blocks = std::move(range.blocks);
+  deliveredBy = range.peer;
+  m_popped.insert(m_popped.end(), range.ids.begin(), range.ids.end());
+  m_ranges.erase(m_ranges.begin());
+  return true;
+}
+
+void SyncScheduler::committed() {
+  for (const auto& id : m_popped) {
+    m_scheduled.erase(id);
+  }
+
+  m_popped.clear();
+}
+
+void SyncScheduler::release(const peer_id_t& peer) {
+  auto statsIt = m_peers.find(peer);
+  if (statsIt != m_peers.end()) {
+    if (statsIt->second.busy) {
+      auto it = m_ranges.find(statsIt->second.assignedHeight);
+      if (it != m_ranges.end() && it->second.requested && it->second.peer == peer) {
+        it->second.requested = false;
+      }
+    }
+
+    m_peers.erase(statsIt);
+  }
+
+  for (auto it = m_ranges.begin(); it != m_ranges.end(); ++it) {
+    range_t& range = it->second;
+    range.announcedBy.erase(peer);
+    if (!range.delivered && range.announcedBy.empty()) {
+      // no peer is known to have these blocks, the ranges above build on them
+      dropFrom(it);
+      break;
+    }
+  }
+}
+
+std::vector<SyncScheduler::peer_id_t> SyncScheduler::releaseStalled(clock::time_point now) {
+  std::vector<peer_id_t> stalled;
+  for (const auto& peer : m_peers) {
+    if (!peer.second.busy) {
+      continue;
+    }
+
+    auto it = m_ranges.find(peer.second.assignedHeight);
+    if (it != m_ranges.end() && now - it->second.requestedAt > timeout(peer.second, it->second)) {
+      stalled.push_back(peer.first);
+    }
+  }
+
+  for (const auto& peer : stalled) {
+    release(peer);
+  }
+
+  return stalled;
+}
+
+void SyncScheduler::clear() {
+  m_ranges.clear();
+  m_scheduled.clear();
+  m_popped.clear();
+  m_peers.clear();
+}
+
+bool SyncScheduler::isAssigned(const peer_id_t& peer) const {
+  auto it = m_peers.find(peer);
+  return it != m_peers.end() && it->second.busy;
+}
+
+double SyncScheduler::throughput(const peer_id_t& peer) const {
+  auto it = m_peers.find(peer);
+  return it != m_peers.end() ? it->second.throughput : 0;
+}
+
+SyncScheduler::clock::duration SyncScheduler::timeout(const peer_stats_t& stats, const range_t& range) const {
+  std::chrono::duration<double> minimum = std::chrono::seconds(BLOCKS_SYNCHRONIZING_MIN_TIMEOUT);
+  if (stats.throughput <= 0) {
+    return std::chrono::duration_cast<clock::duration>(minimum);
+  }
+
+  std::chrono::duration<double> expected(BLOCKS_SYNCHRONIZING_TIMEOUT_FACTOR * range.ids.size() / stats.throughput);
+  return std::chrono::duration_cast<clock::duration>(std::max(minimum, expected));
+}
+
+void SyncScheduler::announce(uint32_t startHeight, const std::vector<crypto::hash_t>& ids, const peer_id_t& peer, uint32_t height) {
+  // the peer can serve a pending range starting at 'height' if its ids cover all of the range
+  auto it = m_ranges.find(height);
+  if (it == m_ranges.end() || it->second.delivered) {
+    return;
+  }
+
+  const std::vector<crypto::hash_t>& rangeIds = it->second.ids;
+  size_t offset = height - startHeight;
+  if (ids.size() - offset >= rangeIds.size() && std::equal(rangeIds.begin(), rangeIds.end(), ids.begin() + offset)) {
+    it->second.announcedBy.insert(peer);
+  }
+}
+
+void SyncScheduler::dropFrom(std::map<uint32_t, range_t>::iterator first) {
+  for (auto it = first; it != m_ranges.end(); ++it) {
+    for (const auto& id : it->second.ids) {
+      m_scheduled.erase(id);
+    }
+  }
+
+  m_ranges.erase(first, m_ranges.end());
+  if (!m_ranges.empty()) {
+    auto last = std::prev(m_ranges.end());
+    m_topHeight = last->first + static_cast<uint32_t>(last->second.ids.size()) - 1;
+    m_topId = last->second.ids.back();
+  }
+}
+
+}
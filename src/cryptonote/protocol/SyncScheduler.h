@@ -0,0 +1,93 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <chrono>
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <boost/functional/hash.hpp>
+#include <boost/uuid/uuid.hpp>
+
+#include "CryptoNoteConfig.h"
+#include "cryptonote/protocol/definitions.h"
+
+namespace cryptonote
+{
+  // Splits the block ids learned from chain entries into ranges, hands them out to several peers at once
+  // and buffers the delivered ranges until they can be committed in height order. A range is only handed to
+  // the peers that announced all of its ids, other peers may be on another branch and cannot serve it.
+  class SyncScheduler
+  {
+  public:
+    typedef boost::uuids::uuid peer_id_t;
+    typedef std::chrono::steady_clock clock;
+
+    SyncScheduler(size_t rangeSize = BLOCKS_SYNCHRONIZING_DEFAULT_COUNT, size_t maxRangesAhead = BLOCKS_SYNCHRONIZING_MAX_RANGES_AHEAD);
+
+    // ids[0] has height startHeight and follows previousId, 'peer' announced them. Ids that are already scheduled
+    // are skipped, the peer becomes an announcer of the pending ranges its ids cover. Ids that do not continue the
+    // scheduled chain are rejected. Returns the number of newly scheduled ids.
+    size_t addBlockIds(uint32_t startHeight, const crypto::hash_t& previousId, const std::vector<crypto::hash_t>& ids,
+      const peer_id_t& peer);
+
+    // Gives the peer the lowest range it announced and can serve, false if there is none or the peer already has one
+    bool assign(const peer_id_t& peer, uint32_t peerHeight, clock::time_point now, std::vector<crypto::hash_t>& blockIds);
+    // Moves the peer's range to the reorder buffer, false if the peer has no range assigned
+    bool deliver(const peer_id_t& peer, std::vector<block_complete_entry_t>&& blocks, clock::time_point now);
+    // Takes the lowest range if it has been delivered. Its ids stay scheduled until committed() is called, so
+    // that chain entries arriving meanwhile do not schedule them again.
+    bool popReady(std::vector<block_complete_entry_t>& blocks, peer_id_t& deliveredBy);
+    // The popped ranges are committed, forgets their ids
+    void committed();
+
+    // Puts the peer's range back to the queue and forgets its statistics and announcements. Pending ranges nobody
+    // else announced are dropped together with the ranges above them.
+    void release(const peer_id_t& peer);
+    // Releases the ranges of peers that take much longer than their throughput suggests and returns those peers
+    std::vector<peer_id_t> releaseStalled(clock::time_point now);
+    void clear();
+
+    bool hasPending() const { return !m_ranges.empty(); }
+    bool isAssigned(const peer_id_t& peer) const;
+    // Blocks per second measured over the peer's previous deliveries, zero if unknown
+    double throughput(const peer_id_t& peer) const;
+
+  private:
+    struct range_t
+    {
+      std::vector<crypto::hash_t> ids;
+      std::vector<block_complete_entry_t> blocks;
+      bool requested = false;
+      bool delivered = false;
+      peer_id_t peer;
+      clock::time_point requestedAt;
+      std::unordered_set<peer_id_t, boost::hash<peer_id_t>> announcedBy;
+    };
+
+    struct peer_stats_t
+    {
+      uint32_t assignedHeight = 0;
+      bool busy = false;
+      double throughput = 0;
+    };
+
+    clock::duration timeout(const peer_stats_t& stats, const range_t& range) const;
+    void announce(uint32_t startHeight, const std::vector<crypto::hash_t>& ids, const peer_id_t& peer, uint32_t height);
+    void dropFrom(std::map<uint32_t, range_t>::iterator first);
+
+    size_t m_rangeSize;
+    size_t m_maxRangesAhead;
+    std::map<uint32_t, range_t> m_ranges;
+    std::unordered_set<crypto::hash_t> m_scheduled;
+    // of the popped ranges that are being committed
+    std::vector<crypto::hash_t> m_popped;
+    std::unordered_map<peer_id_t, peer_stats_t, boost::hash<peer_id_t>> m_peers;
+    uint32_t m_topHeight;
+    crypto::hash_t m_topId;
+  };
+}
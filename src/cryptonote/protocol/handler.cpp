@@ -4,6 +4,7 @@
 
 #include "handler.h"
 
+#include <algorithm>
 #include <future>
 #include <boost/scope_exit.hpp>
 #include <boost/uuid/uuid_io.hpp>
@@ -45,6 +46,10 @@ CryptoNoteProtocolHandler::CryptoNoteProtocolHandler(const Currency& currency, S
   m_stop(false),
   m_observedHeight(0),
   m_peersCount(0),
+  m_committing(false),
+  m_blockPrepared(dispatcher),
+  m_importPipeline(currency, [&rcore](const crypto::hash_t& hash) { return rcore.have_block(hash); },
+    [this] { m_dispatcher.remoteSpawn([this] { m_blockPrepared.set(); }); }),
   logger(log, "protocol") {
   
   if (!m_p2p) {
@@ -82,6 +87,9 @@ void CryptoNoteProtocolHandler::onConnectionClosed(CryptoNoteConnectionContext&
     m_observerManager.notify(&ICryptoNoteProtocolObserver::lastKnownBlockHeightUpdated, m_observedHeight);
   }
 
+  m_syncScheduler.release(context.m_connection_id);
+  m_waitingPeers.erase(context.m_connection_id);
+
   if (context.m_state != CryptoNoteConnectionContext::state_befor_handshake) {
     m_peersCount--;
     m_observerManager.notify(&ICryptoNoteProtocolObserver::peerCountUpdated, m_peersCount.load());
@@ -96,7 +104,6 @@ bool CryptoNoteProtocolHandler::start_sync(CryptoNoteConnectionContext& context)
   logger(Logging::TRACE) << context << "Starting synchronization";
 
   if (context.m_state == CryptoNoteConnectionContext::state_synchronizing) {
-    assert(context.m_needed_objects.empty());
     assert(context.m_requested_objects.empty());
 
     NOTIFY_REQUEST_CHAIN::request r = boost::value_initialized<NOTIFY_REQUEST_CHAIN::request>();
@@ -313,6 +320,12 @@ int CryptoNoteProtocolHandler::handle_request_get_objects(int command, NOTIFY_RE
 int CryptoNoteProtocolHandler::handle_response_get_objects(int command, NOTIFY_RESPONSE_GET_OBJECTS::request& arg, CryptoNoteConnectionContext& context) {
   logger(Logging::TRACE) << context << "NOTIFY_RESPONSE_GET_OBJECTS";
 
+  if (context.m_state != CryptoNoteConnectionContext::state_synchronizing || !m_syncScheduler.isAssigned(context.m_connection_id)) {
+    // the range was taken away from the peer after it stalled or the sync was restarted
+    logger(Logging::DEBUGGING) << context << "NOTIFY_RESPONSE_GET_OBJECTS for a range that is no longer assigned, ignoring";
+    return 1;
+  }
+
   if (context.m_last_response_height > arg.current_blockchain_height) {
     logger(Logging::ERROR) << context << "sent wrong NOTIFY_HAVE_OBJECTS: arg.m_current_blockchain_height=" << arg.current_blockchain_height
       << " < m_last_response_height=" << context.m_last_response_height << ", dropping connection";
@@ -324,9 +337,7 @@ int CryptoNoteProtocolHandler::handle_response_get_objects(int command, NOTIFY_R
 
   context.m_remote_blockchain_height = arg.current_blockchain_height;
 
-  size_t count = 0;
   for (const block_complete_entry_t& block_entry : arg.blocks) {
-    ++count;
     block_t b;
     if (!BinaryArray::from(b, array::fromString(block_entry.block))) {
       logger(Logging::ERROR) << context << "sent wrong block: failed to parse and validate block: \r\n"
@@ -335,17 +346,6 @@ int CryptoNoteProtocolHandler::handle_response_get_objects(int command, NOTIFY_R
       return 1;
     }
 
-    //to avoid concurrency in core between connections, suspend connections which delivered block later then first one
-    if (count == 2) {
-      if (m_core.have_block(Block::getHash(b))) {
-        context.m_state = CryptoNoteConnectionContext::state_idle;
-        context.m_needed_objects.clear();
-        context.m_requested_objects.clear();
-        logger(Logging::DEBUGGING) << context << "Connection set to idle state.";
-        return 1;
-      }
-    }
-
     auto blockHash = Block::getHash(b);
     auto req_it = context.m_requested_objects.find(blockHash);
     if (req_it == context.m_requested_objects.end()) {
@@ -372,43 +372,179 @@ int CryptoNoteProtocolHandler::handle_response_get_objects(int command, NOTIFY_R
     return 1;
   }
 
-  {
-    m_core.pause_mining();
+  m_syncScheduler.deliver(context.m_connection_id, std::move(arg.blocks), SyncScheduler::clock::now());
+  logger(Logging::TRACE) << context << "range delivered, throughput " << m_syncScheduler.throughput(context.m_connection_id) << " blocks/s";
 
-    BOOST_SCOPE_EXIT_ALL(this) { m_core.update_block_template_and_resume_mining(); };
+  if (!m_stop && context.m_state == CryptoNoteConnectionContext::state_synchronizing) {
+    request_missing_objects(context);
+  }
+
+  commitSyncedBlocks();
+  return 1;
+}
+
+void CryptoNoteProtocolHandler::commitSyncedBlocks() {
+  // ranges delivered while another connection commits are picked up by its loop
+  if (m_committing) {
+    return;
+  }
+
+  m_committing = true;
+  BOOST_SCOPE_EXIT_ALL(this) { m_committing = false; };
+
+  std::vector<block_complete_entry_t> blocks;
+  SyncScheduler::peer_id_t deliveredBy;
+  while (!m_stop && m_syncScheduler.popReady(blocks, deliveredBy)) {
+    CryptoNoteConnectionContext peer;
+    m_p2p->for_each_connection([&](CryptoNoteConnectionContext& ctx, peer_id_type_t) {
+      if (ctx.m_connection_id == deliveredBy) {
+        peer = ctx;
+      }
+    });
+
+    CryptoNoteConnectionContext::state state = peer.m_state;
+    int result;
+    {
+      m_core.pause_mining();
+
+      BOOST_SCOPE_EXIT_ALL(this) { m_core.update_block_template_and_resume_mining(); };
+
+      result = processObjects(peer, blocks);
+    }
+
+    m_syncScheduler.committed();
+
+    if (peer.m_state != state) {
+      m_p2p->for_each_connection([&](CryptoNoteConnectionContext& ctx, peer_id_type_t) {
+        if (ctx.m_connection_id == deliveredBy) {
+          ctx.m_state = peer.m_state;
+          ctx.m_requested_objects.clear();
+        }
+      });
+    }
 
-    int result = processObjects(context, arg.blocks);
     if (result != 0) {
-      return result;
+      // the buffered ranges build on the failed one
+      restartSync();
+      return;
     }
+
+    uint32_t height;
+    crypto::hash_t top;
+    m_core.get_blockchain_top(height, top);
+    logger(DEBUGGING, BRIGHT_GREEN) << "Local blockchain updated, new height = " << height;
   }
 
-  uint32_t height;
-  crypto::hash_t top;
-  m_core.get_blockchain_top(height, top);
-  logger(DEBUGGING, BRIGHT_GREEN) << "Local blockchain updated, new height = " << height;
+  wakeWaitingPeers();
+}
 
-  if (!m_stop && context.m_state == CryptoNoteConnectionContext::state_synchronizing) {
-    request_missing_objects(context, true);
+void CryptoNoteProtocolHandler::restartSync() {
+  m_syncScheduler.clear();
+  m_waitingPeers.clear();
+
+  m_p2p->for_each_connection([&](CryptoNoteConnectionContext& ctx, peer_id_type_t) {
+    if (ctx.m_state == CryptoNoteConnectionContext::state_synchronizing) {
+      ctx.m_requested_objects.clear();
+      start_sync(ctx);
+    }
+  });
+}
+
+void CryptoNoteProtocolHandler::releaseStalledPeers() {
+  std::vector<SyncScheduler::peer_id_t> stalled = m_syncScheduler.releaseStalled(SyncScheduler::clock::now());
+  if (stalled.empty()) {
+    return;
   }
 
-  return 1;
+  m_p2p->for_each_connection([&](CryptoNoteConnectionContext& ctx, peer_id_type_t) {
+    if (std::find(stalled.begin(), stalled.end(), ctx.m_connection_id) != stalled.end()) {
+      logger(Logging::INFO) << ctx << "Peer stalled while downloading blocks, switching to idle state";
+      ctx.m_state = CryptoNoteConnectionContext::state_idle;
+      ctx.m_requested_objects.clear();
+      m_waitingPeers.erase(ctx.m_connection_id);
+    }
+  });
+
+  wakeWaitingPeers();
+}
+
+void CryptoNoteProtocolHandler::wakeWaitingPeers() {
+  if (m_waitingPeers.empty()) {
+    return;
+  }
+
+  auto waiting = m_waitingPeers;
+  m_p2p->for_each_connection([&](CryptoNoteConnectionContext& ctx, peer_id_type_t) {
+    if (waiting.count(ctx.m_connection_id) == 0) {
+      return;
+    }
+
+    if (ctx.m_state != CryptoNoteConnectionContext::state_synchronizing) {
+      m_waitingPeers.erase(ctx.m_connection_id);
+    } else if (!requestBlockRange(ctx) && !m_syncScheduler.hasPending()) {
+      // everything scheduled is committed, let the peer continue with its chain
+      m_waitingPeers.erase(ctx.m_connection_id);
+      request_missing_objects(ctx);
+    }
+  });
+}
+
+bool CryptoNoteProtocolHandler::requestBlockRange(CryptoNoteConnectionContext& context) {
+  std::vector<crypto::hash_t> blockIds;
+  if (!m_syncScheduler.assign(context.m_connection_id, context.m_remote_blockchain_height, SyncScheduler::clock::now(), blockIds)) {
+    return false;
+  }
+
+  m_waitingPeers.erase(context.m_connection_id);
+
+  NOTIFY_REQUEST_GET_OBJECTS::request req;
+  for (const auto& id : blockIds) {
+    req.blocks.push_back(id);
+    context.m_requested_objects.insert(id);
+  }
+
+  logger(Logging::TRACE) << context << "-->>NOTIFY_REQUEST_GET_OBJECTS: blocks.size()=" << req.blocks.size() << ", txs.size()=" << req.txs.size();
+  post_notify<NOTIFY_REQUEST_GET_OBJECTS>(*m_p2p, req, context);
+  return true;
 }
 
 int CryptoNoteProtocolHandler::processObjects(CryptoNoteConnectionContext& context, const std::vector<block_complete_entry_t>& blocks) {
 
-  for (const block_complete_entry_t& block_entry : blocks) {
+  // decoding, hashing and proof of work run on the pipeline workers, blocks are committed here in order
+  BlockImportPipeline& pipeline = m_importPipeline;
+  pipeline.start(blocks);
+  BOOST_SCOPE_EXIT_ALL(this) { m_importPipeline.finish(); };
+  for (size_t i = 0; i < pipeline.size(); ++i) {
     if (m_stop) {
       break;
     }
 
+    // let other connections run while the block is being prepared
+    m_blockPrepared.clear();
+    while (!pipeline.isReady(i)) {
+      m_blockPrepared.wait();
+      m_blockPrepared.clear();
+    }
+
+    prepared_block_t& prepared = pipeline.get(i);
+    if (!prepared.error.empty()) {
+      logger(Logging::ERROR) << context << "sent wrong block on NOTIFY_RESPONSE_GET_OBJECTS: " << prepared.error << ", dropping connection";
+      context.m_state = CryptoNoteConnectionContext::state_shutdown;
+      return 1;
+    }
+
+    if (prepared.known) {
+      logger(Logging::DEBUGGING) << context << "Block " << prepared.hash << " already exists, skipping";
+      continue;
+    }
+
     //process transactions
-    for (auto& tx_blob : block_entry.txs) {
+    for (size_t t = 0; t < prepared.transactions.size(); ++t) {
       tx_verification_context_t tvc = boost::value_initialized<decltype(tvc)>();
-      m_core.handle_incoming_tx(array::fromString(tx_blob), tvc, true);
+      m_core.handleIncomingTransaction(prepared.transactions[t], prepared.transactionHashes[t], prepared.transactionSizes[t], tvc, true);
       if (tvc.m_verifivation_failed) {
         logger(Logging::ERROR) << context << "transaction verification failed on NOTIFY_RESPONSE_GET_OBJECTS, \r\ntx_id = "
-          << hex::podToString(BinaryArray::getHash(array::fromString(tx_blob))) << ", dropping connection";
+          << hex::podToString(prepared.transactionHashes[t]) << ", dropping connection";
         context.m_state = CryptoNoteConnectionContext::state_shutdown;
         return 1;
       }
@@ -416,7 +552,7 @@ int CryptoNoteProtocolHandler::processObjects(CryptoNoteConnectionContext& conte
 
     // process block
     block_verification_context_t bvc = boost::value_initialized<block_verification_context_t>();
-    m_core.handle_incoming_block_blob(array::fromString(block_entry.block), bvc, false, false);
+    m_core.handleIncomingBlock(prepared.block, prepared.proofOfWork, bvc, false, false);
 
     if (bvc.m_verifivation_failed) {
       logger(Logging::DEBUGGING) << context << "Block verification failed, dropping connection";
@@ -427,11 +563,8 @@ int CryptoNoteProtocolHandler::processObjects(CryptoNoteConnectionContext& conte
       context.m_state = CryptoNoteConnectionContext::state_shutdown;
       return 1;
     } else if (bvc.m_already_exists) {
-      logger(Logging::DEBUGGING) << context << "Block already exists, switching to idle state";
-      context.m_state = CryptoNoteConnectionContext::state_idle;
-      context.m_needed_objects.clear();
-      context.m_requested_objects.clear();
-      return 1;
+      // added meanwhile, the following blocks of the range still build on it
+      logger(Logging::DEBUGGING) << context << "Block " << prepared.hash << " already exists, skipping";
     }
 
     m_dispatcher.yield();
@@ -443,6 +576,7 @@ int CryptoNoteProtocolHandler::processObjects(CryptoNoteConnectionContext& conte
 
 
 bool CryptoNoteProtocolHandler::on_idle() {
+  releaseStalledPeers();
   return m_core.on_idle();
 }
 
@@ -469,23 +603,12 @@ int CryptoNoteProtocolHandler::handle_request_chain(int command, NOTIFY_REQUEST_
   return 1;
 }
 
-bool CryptoNoteProtocolHandler::request_missing_objects(CryptoNoteConnectionContext& context, bool check_having_blocks) {
-  if (context.m_needed_objects.size()) {
-    //we know objects that we need, request this objects
-    NOTIFY_REQUEST_GET_OBJECTS::request req;
-    size_t count = 0;
-    auto it = context.m_needed_objects.begin();
-
-    while (it != context.m_needed_objects.end() && count < BLOCKS_SYNCHRONIZING_DEFAULT_COUNT) {
-      if (!(check_having_blocks && m_core.have_block(*it))) {
-        req.blocks.push_back(*it);
-        ++count;
-        context.m_requested_objects.insert(*it);
-      }
-      it = context.m_needed_objects.erase(it);
-    }
-    logger(Logging::TRACE) << context << "-->>NOTIFY_REQUEST_GET_OBJECTS: blocks.size()=" << req.blocks.size() << ", txs.size()=" << req.txs.size();
-    post_notify<NOTIFY_REQUEST_GET_OBJECTS>(*m_p2p, req, context);
+bool CryptoNoteProtocolHandler::request_missing_objects(CryptoNoteConnectionContext& context) {
+  if (requestBlockRange(context)) {
+    //we know objects that we need, requested a range of them
+  } else if (m_syncScheduler.hasPending()) {
+    //other peers are downloading the remaining ranges, wait until they are committed
+    m_waitingPeers.insert(context.m_connection_id);
   } else if (context.m_last_response_height < context.m_remote_blockchain_height - 1) {//we have to fetch more objects ids, request blockchain entry
 
     NOTIFY_REQUEST_CHAIN::request r = boost::value_initialized<NOTIFY_REQUEST_CHAIN::request>();
@@ -495,13 +618,11 @@ bool CryptoNoteProtocolHandler::request_missing_objects(CryptoNoteConnectionCont
   } else {
     if (!(context.m_last_response_height ==
       context.m_remote_blockchain_height - 1 &&
-      !context.m_needed_objects.size() &&
       !context.m_requested_objects.size())) {
       logger(Logging::ERROR, Logging::BRIGHT_RED)
         << "request_missing_blocks final condition failed!"
         << "\r\nm_last_response_height=" << context.m_last_response_height
         << "\r\nm_remote_blockchain_height=" << context.m_remote_blockchain_height
-        << "\r\nm_needed_objects.size()=" << context.m_needed_objects.size()
         << "\r\nm_requested_objects.size()=" << context.m_requested_objects.size() 
         << "\r\non connection [" << context << "]";
       return false;
@@ -566,14 +687,24 @@ int CryptoNoteProtocolHandler::handle_response_chain_entry(int command, NOTIFY_R
       << arg.total_height << "\r\nm_start_height=" << arg.start_height
       << "\r\nm_block_ids.size()=" << arg.m_block_ids.size();
     context.m_state = CryptoNoteConnectionContext::state_shutdown;
+    return 1;
+  }
+
+  // the first id is known, schedule the ones after it that we don't have yet
+  size_t first = 1;
+  while (first < arg.m_block_ids.size() && m_core.have_block(arg.m_block_ids[first])) {
+    ++first;
   }
 
-  for (auto& bl_id : arg.m_block_ids) {
-    if (!m_core.have_block(bl_id))
-      context.m_needed_objects.push_back(bl_id);
+  if (first < arg.m_block_ids.size()) {
+    std::vector<crypto::hash_t> ids(arg.m_block_ids.begin() + first, arg.m_block_ids.end());
+    size_t scheduled = m_syncScheduler.addBlockIds(arg.start_height + static_cast<uint32_t>(first), arg.m_block_ids[first - 1], ids,
+      context.m_connection_id);
+    logger(Logging::TRACE) << context << "scheduled " << scheduled << " of " << ids.size() << " block ids for download";
   }
 
-  request_missing_objects(context, false);
+  request_missing_objects(context);
+  wakeWaitingPeers();
   return 1;
 }
 
@@ -5,15 +5,19 @@
 #pragma once
 
 #include <atomic>
+#include <unordered_set>
 
 #include <common/ObserverManager.h>
+#include <system/Event.h>
 
 #include "cryptonote/core/ICore.h"
 
+#include "cryptonote/protocol/BlockImportPipeline.h"
 #include "cryptonote/protocol/definitions.h"
 #include "cryptonote/protocol/handler_common.h"
 #include "cryptonote/protocol/i_observer.h"
 #include "cryptonote/protocol/i_query.h"
+#include "cryptonote/protocol/SyncScheduler.h"
 
 #include "p2p/P2pProtocolDefinitions.h"
 #include "p2p/NetNodeCommon.h"
@@ -77,7 +81,12 @@ namespace cryptonote
 
     //----------------------------------------------------------------------------------
     uint32_t get_current_blockchain_height();
-    bool request_missing_objects(CryptoNoteConnectionContext& context, bool check_having_blocks);
+    bool request_missing_objects(CryptoNoteConnectionContext& context);
+    bool requestBlockRange(CryptoNoteConnectionContext& context);
+    void wakeWaitingPeers();
+    void releaseStalledPeers();
+    void commitSyncedBlocks();
+    void restartSync();
     bool on_connection_synchronized();
     void updateObservedHeight(uint32_t peerHeight, const CryptoNoteConnectionContext& context);
     void recalculateMaxObservedHeight(const CryptoNoteConnectionContext& context);
@@ -97,6 +106,15 @@ namespace cryptonote
     uint32_t m_observedHeight;
 
     std::atomic<size_t> m_peersCount;
+
+    SyncScheduler m_syncScheduler;
+    // Synchronizing peers that found no range to download and wait for the others
+    std::unordered_set<boost::uuids::uuid, boost::hash<boost::uuids::uuid>> m_waitingPeers;
+    bool m_committing;
+    // Set on the dispatcher each time the pipeline prepared a block
+    System::Event m_blockPrepared;
+    // Prepares the blocks of processObjects(), its workers are kept between the batches
+    BlockImportPipeline m_importPipeline;
     Tools::ObserverManager<ICryptoNoteProtocolObserver> m_observerManager;
   };
 }
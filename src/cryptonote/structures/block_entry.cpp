@@ -55,6 +55,32 @@ bool Block::getLongHash(const block_t& b, crypto::hash_t& res) {
   return true;
 }
 
+bool Block::getLongHashes(const block_t& b, const uint32_t* nonces, size_t count, crypto::hash_t* res) {
+  assert(count > 0 && count <= crypto::CN_SLOW_HASH_MAX_WAYS);
+  binary_array_t header;
+  if (!BinaryArray::to(static_cast<const block_header_t&>(b), header)) {
+    return false;
+  }
+
+  binary_array_t bd;
+  if (!Block::getBlob(b, bd)) {
+    return false;
+  }
+
+  // the nonce closes the header
+  const size_t nonceOffset = header.size() - sizeof(uint32_t);
+  std::vector<binary_array_t> blobs(count, bd);
+  const void* data[crypto::CN_SLOW_HASH_MAX_WAYS];
+  for (size_t i = 0; i < count; ++i) {
+    memcpy(blobs[i].data() + nonceOffset, &nonces[i], sizeof(uint32_t));
+    data[i] = blobs[i].data();
+  }
+
+  const HardFork hf = HardFork(config::get().hardforks);
+  cn_slow_hash_multi(data, bd.size(), res, count, hf.getCNVariant(b));
+  return true;
+}
+
 bool Block::getHash(const block_t& block, crypto::hash_t& hash) {
   binary_array_t ba;
   if (!Block::getBlob(block, ba)) {
@@ -59,6 +59,8 @@ class Block
     static crypto::hash_t getHash(const block_t &block);
 
     static bool getLongHash(const block_t &b, crypto::hash_t &res);
+    // Proof of work hashes of 'b' with each of 'nonces', computed together by cn_slow_hash_multi
+    static bool getLongHashes(const block_t &b, const uint32_t *nonces, size_t count, crypto::hash_t *res);
     static bool checkProofOfWork(const block_t &block, difficulty_t currentDiffic, crypto::hash_t &proofOfWork);
 
     static block_t genesis(config::config_t &conf);
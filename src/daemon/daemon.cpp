@@ -6,6 +6,7 @@
 
 #include <boost/filesystem.hpp>
 #include <boost/program_options.hpp>
+#include <thread>
 
 #include "DaemonCommandsHandler.h"
 
@@ -43,6 +44,7 @@ JsonValue buildLoggerConfiguration(Level level, const std::string &logfile)
 {
   JsonValue loggerConfiguration(JsonValue::OBJECT);
   loggerConfiguration.insert("globalLevel", static_cast<int64_t>(level));
+  loggerConfiguration.insert("async", JsonValue(true));
 
   JsonValue &cfgLoggers = loggerConfiguration.insert("loggers", JsonValue::ARRAY);
 
@@ -139,6 +141,12 @@ int main(int argc, char *argv[])
 
     //create objects and link them
     cryptonote::CurrencyBuilder currencyBuilder(coreConfig.getDir(), config::get(), logManager);
+    currencyBuilder.blocksMemoryMapped(get_arg(vm, arg_db_mmap));
+    currencyBuilder.blockIndexFlushInterval(get_arg(vm, arg_db_index_flush_interval));
+    currencyBuilder.indexCacheSize(static_cast<size_t>(get_arg(vm, arg_db_index_cache_size)) * 1024 * 1024);
+    currencyBuilder.blockEntryCacheSize(static_cast<size_t>(get_arg(vm, arg_block_cache_size)) * 1024 * 1024);
+    uint32_t rebuildThreads = get_arg(vm, arg_db_rebuild_threads);
+    currencyBuilder.indexRebuildThreads(rebuildThreads != 0 ? rebuildThreads : std::max(1u, std::thread::hardware_concurrency()));
 
     try
     {
@@ -166,6 +174,8 @@ int main(int argc, char *argv[])
 
     cryptonote::CryptoNoteProtocolHandler cprotocol(currency, dispatcher, ccore, nullptr, logManager);
     cryptonote::NodeServer p2psrv(dispatcher, cprotocol, logManager);
+    // outlives the rpc server, whose connections may wait for a worker
+    std::unique_ptr<System::DispatcherPool> rpcWorkers;
     cryptonote::RpcServer rpcServer(dispatcher, logManager, ccore, p2psrv, cprotocol);
 
     cprotocol.set_p2p_endpoint(&p2psrv);
@@ -203,8 +213,12 @@ int main(int argc, char *argv[])
       dch.start_handling();
     }
 
+    if (rpcConfig.threads > 0) {
+      rpcWorkers.reset(new System::DispatcherPool(rpcConfig.threads));
+    }
+
     logger(INFO) << "Starting core rpc server on address " << rpcConfig.getBindAddress();
-    rpcServer.start(rpcConfig.bindIp, rpcConfig.bindPort);
+    rpcServer.start(rpcConfig.bindIp, rpcConfig.bindPort, rpcWorkers.get());
     logger(INFO) << "Core rpc server started ok";
 
     Tools::SignalHandler::install([&dch, &p2psrv] {
@@ -221,6 +235,7 @@ int main(int argc, char *argv[])
     //stop components
     logger(INFO) << "Stopping core rpc server...";
     rpcServer.stop();
+    rpcWorkers.reset();
 
     //deinitialize components
     logger(INFO) << "Deinitializing core...";
@@ -61,6 +61,10 @@ void CommonLogger::operator()(const std::string& category, Level level, boost::p
   }
 }
 
+bool CommonLogger::isEnabled(const std::string& category, Level level) {
+  return level <= logLevel && disabledCategories.count(category) == 0;
+}
+
 void CommonLogger::setPattern(const std::string& pattern) {
   this->pattern = pattern;
 }
@@ -44,6 +44,8 @@ public:
   const static std::array<std::string, 6> LEVEL_NAMES;
 
   virtual void operator()(const std::string& category, Level level, boost::posix_time::ptime time, const std::string& body) = 0;
+  // Checked before a message is formatted, a message nobody would write is not built at all
+  virtual bool isEnabled(const std::string& category, Level level) { return true; }
 };
 
 #ifndef ENDL
@@ -26,4 +26,12 @@ void LoggerGroup::operator()(const std::string& category, Level level, boost::po
   }
 }
 
+bool LoggerGroup::isEnabled(const std::string& category, Level level) {
+  if (!CommonLogger::isEnabled(category, level)) {
+    return false;
+  }
+
+  return std::any_of(loggers.begin(), loggers.end(), [&](ILogger* logger) { return logger->isEnabled(category, level); });
+}
+
 }
@@ -11,15 +11,81 @@ namespace Logging {
 
 using Common::JsonValue;
 
-LoggerManager::LoggerManager() {
+namespace {
+
+const size_t ASYNC_QUEUE_SIZE = 4096;
+
+}
+
+LoggerManager::LoggerManager() : maxLevel(logLevel), async(false), messages(ASYNC_QUEUE_SIZE) {
+}
+
+LoggerManager::~LoggerManager() {
+  if (sink.joinable()) {
+    messages.close();
+    sink.join();
+  }
 }
 
 void LoggerManager::operator()(const std::string& category, Level level, boost::posix_time::ptime time, const std::string& body) {
+  if (async.load(std::memory_order_acquire)) {
+    if (level <= maxLevel.load(std::memory_order_relaxed)) {
+      messages.push(Message{category, level, time, body});
+    }
+
+    return;
+  }
+
   std::unique_lock<std::mutex> lock(reconfigureLock);
   LoggerGroup::operator()(category, level, time, body);
 }
 
+bool LoggerManager::isEnabled(const std::string& category, Level level) {
+  if (level > maxLevel.load(std::memory_order_relaxed)) {
+    return false;
+  }
+
+  // Categories and the levels of the loggers are checked when the message is written, the sink thread holds the lock
+  // while it writes and waiting for it here would bring the writes back to the caller
+  if (async.load(std::memory_order_acquire)) {
+    return true;
+  }
+
+  std::unique_lock<std::mutex> lock(reconfigureLock);
+  return LoggerGroup::isEnabled(category, level);
+}
+
+void LoggerManager::setMaxLevel(Level level) {
+  LoggerGroup::setMaxLevel(level);
+  maxLevel.store(level, std::memory_order_relaxed);
+}
+
+void LoggerManager::startSink() {
+  if (!sink.joinable()) {
+    sink = std::thread(&LoggerManager::sinkProcedure, this);
+    async.store(true, std::memory_order_release);
+  }
+}
+
+void LoggerManager::sinkProcedure() {
+  Message message;
+  while (messages.pop(message)) {
+    std::unique_lock<std::mutex> lock(reconfigureLock);
+    LoggerGroup::operator()(message.category, message.level, message.time, message.body);
+  }
+}
+
 void LoggerManager::configure(const JsonValue& val) {
+  bool startAsync = false;
+  if (val.contains("async")) {
+    auto asyncVal = val("async");
+    if (asyncVal.isBool()) {
+      startAsync = asyncVal.getBool();
+    } else {
+      throw std::runtime_error("parameter async has wrong type");
+    }
+  }
+
   std::unique_lock<std::mutex> lock(reconfigureLock);
   loggers.clear();
   LoggerGroup::loggers.clear();
@@ -109,6 +175,11 @@ void LoggerManager::configure(const JsonValue& val) {
   for (const auto& category : globalDisabledCategories) {
     disableCategory(category);
   }
+
+  lock.unlock();
+  if (startAsync) {
+    startSink();
+  }
 }
 
 }
@@ -4,23 +4,47 @@
 
 #pragma once
 
+#include <atomic>
 #include <list>
 #include <memory>
 #include <mutex>
+#include <thread>
+#include "../common/BlockingQueue.h"
 #include "../common/JsonValue.h"
 #include "LoggerGroup.h"
 
 namespace Logging {
 
+// With "async": true in the configuration, messages are queued and written to the loggers by a sink thread, so
+// callers do not wait for the console or the log file. Once started the sink runs until the manager is destroyed,
+// which writes out everything still queued.
 class LoggerManager : public LoggerGroup {
 public:
   LoggerManager();
+  ~LoggerManager();
   void configure(const Common::JsonValue& val);
   virtual void operator()(const std::string& category, Level level, boost::posix_time::ptime time, const std::string& body) override;
+  virtual bool isEnabled(const std::string& category, Level level) override;
+  virtual void setMaxLevel(Level level) override;
 
 private:
+  struct Message {
+    std::string category;
+    Level level;
+    boost::posix_time::ptime time;
+    std::string body;
+  };
+
+  void startSink();
+  void sinkProcedure();
+
   std::vector<std::unique_ptr<CommonLogger>> loggers;
   std::mutex reconfigureLock;
+  // read without the lock, so that a disabled message costs one load
+  std::atomic<int> maxLevel;
+  std::atomic<bool> async;
+  BlockingQueue<Message> messages;
+  std::thread sink;
 };
 
 }
@@ -6,46 +6,73 @@
 
 namespace Logging {
 
+namespace {
+
+// a long message does not keep its memory on the thread
+const size_t MAX_KEPT_CAPACITY = 64 * 1024;
+
+struct ThreadBuffer {
+  std::string text;
+  bool inUse = false;
+};
+
+thread_local ThreadBuffer threadBuffer;
+
+}
+
 LoggerMessage::LoggerMessage(ILogger& logger, const std::string& category, Level level, const std::string& color)
   : std::ostream(this)
   , std::streambuf()
-  , logger(logger)
+  , message(nullptr)
   , category(category)
   , logLevel(level)
-  , message(color)
-  , timestamp(boost::posix_time::microsec_clock::local_time())
+  , logger(logger)
+  , enabled(logger.isEnabled(category, level))
   , gotText(false) {
+  if (enabled) {
+    timestamp = boost::posix_time::microsec_clock::local_time();
+    acquireBuffer(color);
+  } else {
+    setstate(std::ios_base::badbit);
+  }
 }
 
 LoggerMessage::~LoggerMessage() {
   if (gotText) {
     (*this) << std::endl;
   }
+
+  releaseBuffer();
 }
 
 #ifndef __linux__
 LoggerMessage::LoggerMessage(LoggerMessage&& other)
   : std::ostream(std::move(other))
   , std::streambuf(std::move(other))
+  , message(nullptr)
   , category(other.category)
   , logLevel(other.logLevel)
   , logger(other.logger)
-  , message(other.message)
-  , timestamp(boost::posix_time::microsec_clock::local_time())
-  , gotText(false) {
+  , timestamp(other.timestamp)
+  , enabled(other.enabled)
+  , gotText(other.gotText) {
   this->set_rdbuf(this);
+  takeBuffer(other);
 }
 #else
 LoggerMessage::LoggerMessage(LoggerMessage&& other)
   : std::ostream(nullptr)
   , std::streambuf()
+  , message(nullptr)
   , category(other.category)
   , logLevel(other.logLevel)
   , logger(other.logger)
-  , message(other.message)
-  , timestamp(boost::posix_time::microsec_clock::local_time())
-  , gotText(false) {
+  , timestamp(other.timestamp)
+  , enabled(other.enabled)
+  , gotText(other.gotText) {
   if (this != &other) {
+    takeBuffer(other);
+
     _M_tie = nullptr;
     _M_streambuf = nullptr;
 
@@ -85,16 +112,69 @@ LoggerMessage::LoggerMessage(LoggerMessage&& other)
 #endif
 
 int LoggerMessage::sync() {
-  logger(category, logLevel, timestamp, message);
+  if (!enabled) {
+    return 0;
+  }
+
+  logger(category, logLevel, timestamp, *message);
   gotText = false;
-  message = DEFAULT;
+  message->assign(DEFAULT);
   return 0;
 }
 
 int LoggerMessage::overflow(int c) {
-  gotText = true;
-  message += static_cast<char>(c);
+  if (enabled && c != std::streambuf::traits_type::eof()) {
+    gotText = true;
+    message->push_back(static_cast<char>(c));
+  }
+
   return 0;
 }
 
+std::streamsize LoggerMessage::xsputn(const char* s, std::streamsize n) {
+  if (enabled) {
+    gotText = true;
+    message->append(s, static_cast<size_t>(n));
+  }
+
+  return n;
+}
+
+void LoggerMessage::acquireBuffer(const std::string& color) {
+  if (threadBuffer.inUse) {
+    message = &ownMessage;
+  } else {
+    threadBuffer.inUse = true;
+    message = &threadBuffer.text;
+  }
+
+  message->assign(color);
+}
+
+void LoggerMessage::releaseBuffer() {
+  if (message == &threadBuffer.text) {
+    if (threadBuffer.text.capacity() > MAX_KEPT_CAPACITY) {
+      std::string().swap(threadBuffer.text);
+    }
+
+    threadBuffer.inUse = false;
+  }
+
+  message = nullptr;
+}
+
+void LoggerMessage::takeBuffer(LoggerMessage& other) {
+  if (other.message == &other.ownMessage) {
+    ownMessage = std::move(other.ownMessage);
+    message = &ownMessage;
+  } else {
+    message = other.message;
+  }
+
+  // the moved from message writes nothing and does not release the buffer
+  other.message = nullptr;
+  other.enabled = false;
+  other.gotText = false;
+}
+
 }
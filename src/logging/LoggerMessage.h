@@ -9,6 +9,8 @@
 
 namespace Logging {
 
+// A message is only built if the logger would write it. Otherwise the stream is left bad, so '<<' formats nothing.
+// The text is built in a buffer kept by the thread, 'category' must outlive the message.
 class LoggerMessage : public std::ostream, std::streambuf {
 public:
   LoggerMessage(ILogger& logger, const std::string& category, Level level, const std::string& color);
@@ -20,12 +22,20 @@ public:
 private:
   int sync() override;
   int overflow(int c) override;
+  std::streamsize xsputn(const char* s, std::streamsize n) override;
 
-  std::string message;
-  const std::string category;
+  void acquireBuffer(const std::string& color);
+  void releaseBuffer();
+  void takeBuffer(LoggerMessage& other);
+
+  // the thread's buffer, or ownMessage when a message is built while another one is
+  std::string* message;
+  std::string ownMessage;
+  const std::string& category;
   Level logLevel;
   ILogger& logger;
   boost::posix_time::ptime timestamp;
+  bool enabled;
   bool gotText;
 };
 
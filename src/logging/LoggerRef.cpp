@@ -13,6 +13,10 @@ LoggerMessage LoggerRef::operator()(Level level, const std::string& color) const
   return LoggerMessage(*logger, category, level, color);
 }
 
+bool LoggerRef::isEnabled(Level level) const {
+  return logger->isEnabled(category, level);
+}
+
 ILogger& LoggerRef::getLogger() const {
   return *logger;
 }
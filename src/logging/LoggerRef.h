@@ -13,6 +13,8 @@ class LoggerRef {
 public:
   LoggerRef(ILogger& logger, const std::string& category);
   LoggerMessage operator()(Level level = INFO, const std::string& color = DEFAULT) const;
+  // For messages whose arguments are costly to compute, as they are evaluated even if the message is not written
+  bool isEnabled(Level level) const;
   ILogger& getLogger() const;
 
 private:
@@ -24,11 +24,15 @@ Miner::~Miner() {
   assert(m_state != MiningState::MINING_IN_PROGRESS);
 }
 
-block_t Miner::mine(const BlockMiningParameters& blockMiningParameters, size_t threadCount) {
+block_t Miner::mine(const BlockMiningParameters& blockMiningParameters, size_t threadCount, size_t hashWays) {
   if (threadCount == 0) {
     throw std::runtime_error("Miner requires at least one thread");
   }
 
+  if (hashWays == 0 || hashWays > crypto::CN_SLOW_HASH_MAX_WAYS) {
+    throw std::runtime_error("Miner hash ways must be 1.." + std::to_string(crypto::CN_SLOW_HASH_MAX_WAYS));
+  }
+
   if (m_state == MiningState::MINING_IN_PROGRESS) {
     throw std::runtime_error("Mining is already in progress");
   }
@@ -36,7 +40,7 @@ block_t Miner::mine(const BlockMiningParameters& blockMiningParameters, size_t t
   m_state = MiningState::MINING_IN_PROGRESS;
   m_miningStopped.clear();
 
-  runWorkers(blockMiningParameters, threadCount);
+  runWorkers(blockMiningParameters, threadCount, hashWays);
 
   assert(m_state != MiningState::MINING_IN_PROGRESS);
   if (m_state == MiningState::MINING_STOPPED) {
@@ -57,7 +61,7 @@ void Miner::stop() {
   }
 }
 
-void Miner::runWorkers(BlockMiningParameters blockMiningParameters, size_t threadCount) {
+void Miner::runWorkers(BlockMiningParameters blockMiningParameters, size_t threadCount, size_t hashWays) {
   assert(threadCount > 0);
 
   m_logger(Logging::INFO) << "Starting mining for difficulty " << blockMiningParameters.difficulty;
@@ -67,7 +71,7 @@ void Miner::runWorkers(BlockMiningParameters blockMiningParameters, size_t threa
 
     for (size_t i = 0; i < threadCount; ++i) {
       m_workers.emplace_back(std::unique_ptr<System::RemoteContext<void>> (
-        new System::RemoteContext<void>(m_dispatcher, std::bind(&Miner::workerFunc, this, blockMiningParameters.blockTemplate, blockMiningParameters.difficulty, threadCount)))
+        new System::RemoteContext<void>(m_dispatcher, std::bind(&Miner::workerFunc, this, blockMiningParameters.blockTemplate, blockMiningParameters.difficulty, threadCount, hashWays)))
       );
 
       blockMiningParameters.blockTemplate.nonce++;
@@ -83,20 +87,33 @@ void Miner::runWorkers(BlockMiningParameters blockMiningParameters, size_t threa
   m_miningStopped.set();
 }
 
-void Miner::workerFunc(const block_t& blockTemplate, difficulty_t difficulty, uint32_t nonceStep) {
+void Miner::workerFunc(const block_t& blockTemplate, difficulty_t difficulty, uint32_t nonceStep, size_t hashWays) {
   try {
+    crypto::slow_hash_allocate_state();
+    m_logger(Logging::DEBUGGING) << "Mining thread scratchpad on " << crypto::slow_hash_pages_name(crypto::slow_hash_state_pages());
+
     block_t block = blockTemplate;
+    uint32_t nonces[crypto::CN_SLOW_HASH_MAX_WAYS];
+    crypto::hash_t hashes[crypto::CN_SLOW_HASH_MAX_WAYS];
 
     while (m_state == MiningState::MINING_IN_PROGRESS) {
-      crypto::hash_t hash;
-      if (!Block::getLongHash(block, hash)) {
+      for (size_t i = 0; i < hashWays; ++i) {
+        nonces[i] = block.nonce;
+        block.nonce += nonceStep;
+      }
+
+      if (!Block::getLongHashes(block, nonces, hashWays, hashes)) {
         //error occured
         m_logger(Logging::DEBUGGING) << "calculating long hash error occured";
         m_state = MiningState::MINING_STOPPED;
         return;
       }
 
-      if (check_hash(hash, difficulty)) {
+      for (size_t i = 0; i < hashWays; ++i) {
+        if (!check_hash(hashes[i], difficulty)) {
+          continue;
+        }
+
         m_logger(Logging::INFO) << "Found block for difficulty " << difficulty;
 
         if (!setStateBlockFound()) {
@@ -104,11 +121,10 @@ void Miner::workerFunc(const block_t& blockTemplate, difficulty_t difficulty, ui
           return;
         }
 
+        block.nonce = nonces[i];
         m_block = block;
         return;
       }
-
-      block.nonce += nonceStep;
     }
   } catch (std::exception& e) {
     m_logger(Logging::ERROR) << "Miner got error: " << e.what();
@@ -28,7 +28,8 @@ public:
   Miner(System::Dispatcher& dispatcher, Logging::ILogger& logger);
   ~Miner();
 
-  block_t mine(const BlockMiningParameters& blockMiningParameters, size_t threadCount);
+  // Each thread hashes 'hashWays' nonces together, see cn_slow_hash_multi
+  block_t mine(const BlockMiningParameters& blockMiningParameters, size_t threadCount, size_t hashWays = 1);
 
   //NOTE! this is blocking method
   void stop();
@@ -46,8 +47,8 @@ private:
 
   Logging::LoggerRef m_logger;
 
-  void runWorkers(BlockMiningParameters blockMiningParameters, size_t threadCount);
-  void workerFunc(const block_t& blockTemplate, difficulty_t difficulty, uint32_t nonceStep);
+  void runWorkers(BlockMiningParameters blockMiningParameters, size_t threadCount, size_t hashWays);
+  void workerFunc(const block_t& blockTemplate, difficulty_t difficulty, uint32_t nonceStep, size_t hashWays);
   bool setStateBlockFound();
 };
 
@@ -13,6 +13,7 @@
 #include <boost/program_options.hpp>
 
 #include "CryptoNoteConfig.h"
+#include "crypto/hash.h"
 #include "logging/ILogger.h"
 
 namespace po = boost::program_options;
@@ -58,6 +59,7 @@ MiningConfig::MiningConfig(): help(false) {
       ("daemon-rpc-port", po::value<uint16_t>()->default_value(static_cast<uint16_t>(config::get().net.rpc_port)), "Daemon's RPC port")
       ("daemon-address", po::value<std::string>(), "Daemon host:port. If you use this option you must not use --daemon-host and --daemon-port options")
       ("threads", po::value<size_t>()->default_value(CONCURRENCY_LEVEL), "Mining threads count. Must not be greater than you concurrency level. Default value is your hardware concurrency level")
+      ("hash-ways", po::value<size_t>()->default_value(1), "Nonces each thread hashes together, 1..4. Interleaving hides memory latency on CPUs with AES-NI")
       ("scan-time", po::value<size_t>()->default_value(DEFAULT_SCANT_PERIOD), "Blockchain polling interval (seconds). How often miner will check blockchain for updates")
       ("log-level", po::value<int>()->default_value(1), "Log level. Must be 0..5")
       ("limit", po::value<size_t>()->default_value(0), "Mine exact quantity of blocks. 0 means no limit")
@@ -98,6 +100,11 @@ void MiningConfig::parse(int argc, char** argv) {
     throw std::runtime_error("--threads option must be 1.." + std::to_string(CONCURRENCY_LEVEL));
   }
 
+  hashWays = options["hash-ways"].as<size_t>();
+  if (hashWays == 0 || hashWays > crypto::CN_SLOW_HASH_MAX_WAYS) {
+    throw std::runtime_error("--hash-ways option must be 1.." + std::to_string(crypto::CN_SLOW_HASH_MAX_WAYS));
+  }
+
   scanPeriod = options["scan-time"].as<size_t>();
   if (scanPeriod == 0) {
     throw std::runtime_error("--scan-time must not be zero");
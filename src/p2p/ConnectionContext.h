@@ -33,7 +33,6 @@ struct CryptoNoteConnectionContext {
   };
 
   state m_state = state_befor_handshake;
-  std::list<crypto::hash_t> m_needed_objects;
   std::unordered_set<crypto::hash_t> m_requested_objects;
   uint32_t m_remote_blockchain_height = 0;
   uint32_t m_last_response_height = 0;
@@ -64,6 +63,11 @@ inline std::string get_protocol_state_string(CryptoNoteConnectionContext::state
 
 namespace std {
 inline std::ostream& operator << (std::ostream& s, const cryptonote::CryptoNoteConnectionContext& context) {
+  // a disabled log message, do not build the address string
+  if (!s) {
+    return s;
+  }
+
   return s << "[" << Common::ipAddressToString(context.m_remote_ip) << ":" << 
     context.m_remote_port << (context.m_is_income ? " INC" : " OUT") << "] ";
 }
@@ -47,15 +47,8 @@ void LevinProtocol::sendMessage(uint32_t command, const binary_array_t& out, boo
   head.m_protocol_version = LEVIN_PROTOCOL_VER_1;
   head.m_flags = LEVIN_PACKET_REQUEST;
 
-  // write header and body in one operation
-  binary_array_t writeBuffer;
-  writeBuffer.reserve(sizeof(head) + out.size());
-
-  Common::VectorOutputStream stream(writeBuffer);
-  stream.writeSome(&head, sizeof(head));
-  stream.writeSome(out.data(), out.size());
-
-  writeStrict(writeBuffer.data(), writeBuffer.size());
+  // write header and body in one operation, gathered from where they are instead of joined into a new buffer
+  writeStrict(reinterpret_cast<const uint8_t*>(&head), sizeof(head), out.data(), out.size());
 }
 
 bool LevinProtocol::readCommand(Command& cmd) {
@@ -100,18 +93,22 @@ void LevinProtocol::sendReply(uint32_t command, const binary_array_t& out, int32
   head.m_flags = LEVIN_PACKET_RESPONSE;
   head.m_return_code = returnCode;
 
-  binary_array_t writeBuffer;
-  writeBuffer.reserve(sizeof(head) + out.size());
-
-  Common::VectorOutputStream stream(writeBuffer);
-  stream.writeSome(&head, sizeof(head));
-  stream.writeSome(out.data(), out.size());
-
-  writeStrict(writeBuffer.data(), writeBuffer.size());
+  writeStrict(reinterpret_cast<const uint8_t*>(&head), sizeof(head), out.data(), out.size());
 }
 
-void LevinProtocol::writeStrict(const uint8_t* ptr, size_t size) {
+void LevinProtocol::writeStrict(const uint8_t* head, size_t headSize, const uint8_t* ptr, size_t size) {
+  size_t headOffset = 0;
   size_t offset = 0;
+  while (headOffset < headSize) {
+    size_t written = m_conn.write(head + headOffset, headSize - headOffset, ptr, size);
+    if (written > headSize - headOffset) {
+      offset = written - (headSize - headOffset);
+      headOffset = headSize;
+    } else {
+      headOffset += written;
+    }
+  }
+
   while (offset < size) {
     offset += m_conn.write(ptr + offset, size - offset);
   }
@@ -93,7 +93,8 @@ public:
 private:
 
   bool readStrict(uint8_t* ptr, size_t size);
-  void writeStrict(const uint8_t* ptr, size_t size);
+  // Writes the header and then the payload, resuming either after a partial write
+  void writeStrict(const uint8_t* head, size_t headSize, const uint8_t* ptr, size_t size);
   System::TcpConnection& m_conn;
 };
 
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <functional>
+#include <memory>
 #include <unordered_map>
 
 #include <boost/functional/hash.hpp>
@@ -46,21 +47,29 @@ namespace cryptonote
       NOTIFY
     };
 
+    // The payload is immutable once queued, so a relayed message shares one encoding across every connection
+    // it is pushed to
+    using Buffer = std::shared_ptr<const binary_array_t>;
+
     P2pMessage(Type type, uint32_t command, const binary_array_t& buffer, int32_t returnCode = 0) :
-      type(type), command(command), buffer(buffer), returnCode(returnCode) {
+      type(type), command(command), buffer(std::make_shared<const binary_array_t>(buffer)), returnCode(returnCode) {
     }
 
-    P2pMessage(P2pMessage&& msg) :
-      type(msg.type), command(msg.command), buffer(std::move(msg.buffer)), returnCode(msg.returnCode) {
+    P2pMessage(Type type, uint32_t command, binary_array_t&& buffer, int32_t returnCode = 0) :
+      type(type), command(command), buffer(std::make_shared<const binary_array_t>(std::move(buffer))), returnCode(returnCode) {
+    }
+
+    P2pMessage(Type type, uint32_t command, const Buffer& buffer, int32_t returnCode = 0) :
+      type(type), command(command), buffer(buffer), returnCode(returnCode) {
     }
 
     size_t size() {
-      return buffer.size();
+      return buffer->size();
     }
 
     Type type;
     uint32_t command;
-    const binary_array_t buffer;
+    Buffer buffer;
     int32_t returnCode;
   };
 
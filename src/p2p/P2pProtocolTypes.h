@@ -48,6 +48,10 @@ namespace cryptonote
   }
 
   inline std::ostream& operator << (std::ostream& s, const network_address_t& na) {
+    if (!s) {
+      return s;
+    }
+
     return s << Common::ipAddressToString(na.ip) << ":" << std::to_string(na.port);   
   }
 
@@ -35,6 +35,10 @@ public:
     callback(std::error_code());
   }
   virtual void getTransactionOutsGlobalIndices(const crypto::hash_t& transactionHash, std::vector<uint32_t>& outsGlobalIndices, const Callback& callback) override { }
+  virtual void getTransactionsOutsGlobalIndices(const std::vector<crypto::hash_t>& transactionHashes, std::vector<std::vector<uint32_t>>& outsGlobalIndices,
+    const Callback& callback) override {
+    callback(std::error_code());
+  }
 
   virtual void queryBlocks(std::vector<crypto::hash_t>&& knownBlockIds, uint64_t timestamp, std::vector<cryptonote::BlockShortEntry>& newBlocks,
     uint32_t& startHeight, const Callback& callback) override {
@@ -48,6 +52,13 @@ public:
     callback(std::error_code());
   }
 
+  virtual void getPoolChangesSince(uint64_t& sequence, crypto::hash_t knownBlockId, bool& isBcActual, bool& isFullResync,
+          std::vector<std::unique_ptr<cryptonote::ITransactionReader>>& newTxs, std::vector<crypto::hash_t>& deletedTxIds, const Callback& callback) override {
+    isBcActual = true;
+    isFullResync = false;
+    callback(std::error_code());
+  }
+
   virtual void getBlocks(const std::vector<uint32_t>& blockHeights, std::vector<std::vector<cryptonote::BlockDetails>>& blocks,
     const Callback& callback) override { }
 
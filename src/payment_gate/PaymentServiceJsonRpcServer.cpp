@@ -9,8 +9,9 @@
 #include "PaymentServiceJsonRpcMessages.h"
 #include "WalletService.h"
 
-#include "serialization/JsonInputValueSerializer.h"
-#include "serialization/JsonOutputStreamSerializer.h"
+#include "serialization/JsonInputStringSerializer.h"
+#include "serialization/JsonOutputStringSerializer.h"
+#include "serialization/JsonTokens.h"
 
 namespace PaymentService {
 
@@ -39,23 +40,24 @@ PaymentServiceJsonRpcServer::PaymentServiceJsonRpcServer(System::Dispatcher& sys
   handlers.emplace("getAddresses", jsonHandler<GetAddresses::Request, GetAddresses::Response>(std::bind(&PaymentServiceJsonRpcServer::handleGetAddresses, this, std::placeholders::_1, std::placeholders::_2)));
 }
 
-void PaymentServiceJsonRpcServer::processJsonRpcRequest(const Common::JsonValue& req, Common::JsonValue& resp) {
+void PaymentServiceJsonRpcServer::processJsonRpcRequest(const cryptonote::JsonTokens& req, cryptonote::JsonOutputStringSerializer& resp) {
   try {
     prepareJsonResponse(req, resp);
 
-    if (!req.contains("method")) {
-      logger(Logging::WARNING) << "Field \"method\" is not found in json request: " << req;
+    size_t methodValue = req.find(0, "method");
+    if (methodValue == cryptonote::JsonTokens::npos) {
+      logger(Logging::WARNING) << "Field \"method\" is not found in json request: " << req.getText();
       makeGenericErrorReponse(resp, "Invalid Request", -3600);
       return;
     }
 
-    if (!req("method").isString()) {
-      logger(Logging::WARNING) << "Field \"method\" is not a string type: " << req;
+    if (req.getType(methodValue) != cryptonote::JsonTokens::STRING) {
+      logger(Logging::WARNING) << "Field \"method\" is not a string type: " << req.getText();
       makeGenericErrorReponse(resp, "Invalid Request", -3600);
       return;
     }
 
-    std::string method = req("method").getString();
+    std::string method = req.getString(methodValue);
 
     auto it = handlers.find(method);
     if (it == handlers.end()) {
@@ -66,12 +68,13 @@ void PaymentServiceJsonRpcServer::processJsonRpcRequest(const Common::JsonValue&
 
     logger(Logging::DEBUGGING) << method << " request came";
 
-    Common::JsonValue params(Common::JsonValue::OBJECT);
-    if (req.contains("params")) {
-      params = req("params");
+    size_t params = req.find(0, "params");
+    if (params != cryptonote::JsonTokens::npos) {
+      it->second(req, params, resp);
+    } else {
+      cryptonote::JsonTokens noParams("{}");
+      it->second(noParams, 0, resp);
     }
-
-    it->second(params, resp);
   } catch (std::exception& e) {
     logger(Logging::WARNING) << "Error occurred while processing JsonRpc request: " << e.what();
     makeGenericErrorReponse(resp, e.what());
@@ -6,11 +6,10 @@
 
 #include <unordered_map>
 
-#include "common/JsonValue.h"
 #include "JsonRpcServer/JsonRpcServer.h"
 #include "PaymentServiceJsonRpcMessages.h"
-#include "serialization/JsonInputValueSerializer.h"
-#include "serialization/JsonOutputStreamSerializer.h"
+#include "serialization/JsonInputStringSerializer.h"
+#include "serialization/JsonOutputStringSerializer.h"
 
 namespace PaymentService {
 
@@ -22,22 +21,22 @@ public:
   PaymentServiceJsonRpcServer(const PaymentServiceJsonRpcServer&) = delete;
 
 protected:
-  virtual void processJsonRpcRequest(const Common::JsonValue& req, Common::JsonValue& resp) override;
+  virtual void processJsonRpcRequest(const cryptonote::JsonTokens& req, cryptonote::JsonOutputStringSerializer& resp) override;
 
 private:
   WalletService& service;
   Logging::LoggerRef logger;
 
-  typedef std::function<void (const Common::JsonValue& jsonRpcParams, Common::JsonValue& jsonResponse)> HandlerFunction;
+  typedef std::function<void (const cryptonote::JsonTokens& jsonRpcRequest, size_t jsonRpcParams, cryptonote::JsonOutputStringSerializer& jsonResponse)> HandlerFunction;
 
   template <typename RequestType, typename ResponseType, typename RequestHandler>
   HandlerFunction jsonHandler(RequestHandler handler) {
-    return [handler] (const Common::JsonValue& jsonRpcParams, Common::JsonValue& jsonResponse) mutable {
+    return [handler] (const cryptonote::JsonTokens& jsonRpcRequest, size_t jsonRpcParams, cryptonote::JsonOutputStringSerializer& jsonResponse) mutable {
       RequestType request;
       ResponseType response;
 
       try {
-        cryptonote::JsonInputValueSerializer inputSerializer(const_cast<Common::JsonValue&>(jsonRpcParams));
+        cryptonote::JsonInputStringSerializer inputSerializer(jsonRpcRequest, jsonRpcParams);
         serialize(request, inputSerializer);
       } catch (std::exception&) {
         makeGenericErrorReponse(jsonResponse, "Invalid Request", -32600);
@@ -50,9 +49,10 @@ private:
         return;
       }
 
-      cryptonote::JsonOutputStreamSerializer outputSerializer;
+      // serialized aside, a throwing serialize must not leave half a result in the response
+      cryptonote::JsonOutputStringSerializer outputSerializer;
       serialize(response, outputSerializer);
-      fillJsonResponse(outputSerializer.getValue(), jsonResponse);
+      fillJsonResponse(outputSerializer.getString(), jsonResponse);
     };
   }
 
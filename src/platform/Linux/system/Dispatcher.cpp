@@ -84,6 +84,7 @@ Dispatcher::Dispatcher() {
           firstResumingContext = nullptr;
           firstReusableContext = nullptr;
           runningContextCount = 0;
+          epollControlCount = 0;
           return;
         }
 
@@ -159,38 +160,14 @@ void Dispatcher::dispatch() {
       break;
     }
 
-    epoll_event event;
-    int count = epoll_wait(epoll, &event, 1, -1);
-    if (count == 1) {
-      ContextPair *contextPair = static_cast<ContextPair*>(event.data.ptr);
-      if(((event.events & (EPOLLIN | EPOLLOUT)) != 0) && contextPair->readContext == nullptr && contextPair->writeContext == nullptr) {
-        uint64_t buf;
-        auto transferred = read(remoteSpawnEvent, &buf, sizeof buf);
-        if(transferred == -1) {
-            throw std::runtime_error("Dispatcher::dispatch, read(remoteSpawnEvent) failed, " + lastErrorMessage());
-        }
-
-        MutextGuard guard(*reinterpret_cast<pthread_mutex_t*>(this->mutex));
-        while (!remoteSpawningProcedures.empty()) {
-          spawn(std::move(remoteSpawningProcedures.front()));
-          remoteSpawningProcedures.pop();
-        }
-
-        continue;
-      }
-
-      if ((event.events & EPOLLOUT) != 0) {
-        context = contextPair->writeContext->context;
-        contextPair->writeContext->events = event.events;
-      } else if ((event.events & EPOLLIN) != 0) {
-        context = contextPair->readContext->context;
-        contextPair->readContext->events = event.events;
-      } else {
-        continue;
+    epoll_event events[16];
+    int count = epoll_wait(epoll, events, 16, -1);
+    if (count > 0) {
+      for (int i = 0; i < count; ++i) {
+        resumeWaiters(events[i]);
       }
 
-      assert(context != nullptr);
-      break;
+      continue;
     }
 
     if (errno != EINTR) {
@@ -291,34 +268,7 @@ void Dispatcher::yield() {
 
     if(count > 0) {
       for(int i = 0; i < count; ++i) {
-        ContextPair *contextPair = static_cast<ContextPair*>(events[i].data.ptr);
-        if(((events[i].events & (EPOLLIN | EPOLLOUT)) != 0) && contextPair->readContext == nullptr && contextPair->writeContext == nullptr) {
-          uint64_t buf;
-          auto transferred = read(remoteSpawnEvent, &buf, sizeof buf);
-          if(transferred == -1) {
-            throw std::runtime_error("Dispatcher::dispatch, read(remoteSpawnEvent) failed, " + lastErrorMessage());
-          }
-
-          MutextGuard guard(*reinterpret_cast<pthread_mutex_t*>(this->mutex));
-          while (!remoteSpawningProcedures.empty()) {
-            spawn(std::move(remoteSpawningProcedures.front()));
-            remoteSpawningProcedures.pop();
-          }
-
-          continue;
-        }
-
-        if ((events[i].events & EPOLLOUT) != 0) {
-          contextPair->writeContext->context->interruptProcedure = nullptr;
-          pushContext(contextPair->writeContext->context);
-          contextPair->writeContext->events = events[i].events;
-        } else if ((events[i].events & EPOLLIN) != 0) {
-          contextPair->readContext->context->interruptProcedure = nullptr;
-          pushContext(contextPair->readContext->context);
-          contextPair->readContext->events = events[i].events;
-        } else {
-          continue;
-        }
+        resumeWaiters(events[i]);
       }
     } else {
       if (errno != EINTR) {
@@ -333,10 +283,59 @@ void Dispatcher::yield() {
   }
 }
 
+// Sockets stay registered edge-triggered and get events while no operation waits on them, such an event
+// resumes nobody. A resumed operation is taken off its ContextPair here, so a later edge cannot resume it twice.
+void Dispatcher::resumeWaiters(const epoll_event& event) {
+  ContextPair* contextPair = static_cast<ContextPair*>(event.data.ptr);
+  if (contextPair == &remoteSpawnEventContext) {
+    uint64_t buf;
+    auto transferred = read(remoteSpawnEvent, &buf, sizeof buf);
+    if(transferred == -1) {
+      throw std::runtime_error("Dispatcher::dispatch, read(remoteSpawnEvent) failed, " + lastErrorMessage());
+    }
+
+    MutextGuard guard(*reinterpret_cast<pthread_mutex_t*>(this->mutex));
+    while (!remoteSpawningProcedures.empty()) {
+      spawn(std::move(remoteSpawningProcedures.front()));
+      remoteSpawningProcedures.pop();
+    }
+
+    return;
+  }
+
+  if (contextPair == nullptr) {
+    return;
+  }
+
+  if ((event.events & (EPOLLOUT | EPOLLERR | EPOLLHUP)) != 0 && contextPair->writeContext != nullptr) {
+    resumeWaiter(contextPair->writeContext, event.events);
+  }
+
+  if ((event.events & (EPOLLIN | EPOLLERR | EPOLLHUP)) != 0 && contextPair->readContext != nullptr) {
+    resumeWaiter(contextPair->readContext, event.events);
+  }
+}
+
+void Dispatcher::resumeWaiter(OperationContext*& waiter, uint32_t events) {
+  waiter->events = events;
+  waiter->context->interruptProcedure = nullptr;
+  pushContext(waiter->context);
+  waiter = nullptr;
+}
+
 int Dispatcher::getEpoll() const {
   return epoll;
 }
 
+int Dispatcher::controlEpoll(int operation, int fd, epoll_event* event) {
+  ++epollControlCount;
+  return epoll_ctl(epoll, operation, fd, event);
+}
+
+size_t Dispatcher::getEpollControlCount() const {
+  return epollControlCount;
+}
+
 NativeContext& Dispatcher::getReusableContext() {
   if(firstReusableContext == nullptr) {
     ucontext_t* newlyCreatedContext = new ucontext_t;
@@ -380,7 +379,7 @@ int Dispatcher::getTimer() {
     timerEvent.events = 0;
     timerEvent.data.ptr = nullptr;
 
-    if (epoll_ctl(getEpoll(), EPOLL_CTL_ADD, timer, &timerEvent) == -1) {
+    if (controlEpoll(EPOLL_CTL_ADD, timer, &timerEvent) == -1) {
       throw std::runtime_error("Dispatcher::getTimer, epoll_ctl failed, "  + lastErrorMessage());
     }
   } else {
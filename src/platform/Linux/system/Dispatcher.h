@@ -9,6 +9,8 @@
 #include <queue>
 #include <stack>
 
+struct epoll_event;
+
 namespace System {
 
 struct NativeContextGroup;
@@ -61,6 +63,9 @@ public:
 
   // system-dependent
   int getEpoll() const;
+  // epoll_ctl on getEpoll(), counted so tests can check how often sockets are registered
+  int controlEpoll(int operation, int fd, epoll_event* event);
+  size_t getEpollControlCount() const;
   NativeContext& getReusableContext();
   void pushReusableContext(NativeContext&);
   int getTimer();
@@ -92,7 +97,10 @@ private:
   NativeContext* lastResumingContext;
   NativeContext* firstReusableContext;
   size_t runningContextCount;
+  size_t epollControlCount;
 
+  void resumeWaiters(const epoll_event& event);
+  void resumeWaiter(OperationContext*& waiter, uint32_t events);
   void contextProcedure(void* ucontext);
   static void contextProcedureStatic(void* context);
 };
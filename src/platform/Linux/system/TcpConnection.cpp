@@ -7,6 +7,7 @@
 #include <arpa/inet.h>
 #include <cassert>
 #include <sys/epoll.h>
+#include <sys/socket.h>
 #include <unistd.h>
 
 #include <system/ErrorMessage.h>
@@ -20,8 +21,8 @@ TcpConnection::TcpConnection() : dispatcher(nullptr) {
 
 TcpConnection::TcpConnection(TcpConnection&& other) : dispatcher(other.dispatcher) {
   if (other.dispatcher != nullptr) {
-    assert(other.contextPair.writeContext == nullptr);
-    assert(other.contextPair.readContext == nullptr);
+    assert(other.contextPair->writeContext == nullptr);
+    assert(other.contextPair->readContext == nullptr);
     connection = other.connection;
     contextPair = other.contextPair;
     other.dispatcher = nullptr;
@@ -30,26 +31,29 @@ TcpConnection::TcpConnection(TcpConnection&& other) : dispatcher(other.dispatche
 
 TcpConnection::~TcpConnection() {
   if (dispatcher != nullptr) {
-    assert(contextPair.readContext == nullptr);
-    assert(contextPair.writeContext == nullptr);
+    assert(contextPair->readContext == nullptr);
+    assert(contextPair->writeContext == nullptr);
     int result = close(connection);
     assert(result != -1);
+    delete contextPair;
   }
 }
 
 TcpConnection& TcpConnection::operator=(TcpConnection&& other) {
   if (dispatcher != nullptr) {
-    assert(contextPair.readContext == nullptr);
-    assert(contextPair.writeContext == nullptr);
+    assert(contextPair->readContext == nullptr);
+    assert(contextPair->writeContext == nullptr);
+    delete contextPair;
     if (close(connection) == -1) {
+      dispatcher = nullptr;
       throw std::runtime_error("TcpConnection::operator=, close failed, " + lastErrorMessage());
     }
   }
 
   dispatcher = other.dispatcher;
   if (other.dispatcher != nullptr) {
-    assert(other.contextPair.readContext == nullptr);
-    assert(other.contextPair.writeContext == nullptr);
+    assert(other.contextPair->readContext == nullptr);
+    assert(other.contextPair->writeContext == nullptr);
     connection = other.connection;
     contextPair = other.contextPair;
     other.dispatcher = nullptr;
@@ -60,102 +64,35 @@ TcpConnection& TcpConnection::operator=(TcpConnection&& other) {
 
 size_t TcpConnection::read(uint8_t* data, size_t size) {
   assert(dispatcher != nullptr);
-  assert(contextPair.readContext == nullptr);
+  assert(contextPair->readContext == nullptr);
   if (dispatcher->interrupted()) {
     throw InterruptedException();
   }
 
-  std::string message;
-  ssize_t transferred = ::recv(connection, (void *)data, size, 0);
-  if (transferred == -1) {
-    bool noError = errno != EAGAIN ? errno != EWOULDBLOCK : false;
-    if (noError) {
-      message = "recv failed, " + lastErrorMessage();
-    } else {
-      epoll_event connectionEvent;
-      OperationContext operationContext;
-      operationContext.interrupted = false;
-      operationContext.context = dispatcher->getCurrentContext();
-      contextPair.readContext = &operationContext;
-      connectionEvent.data.ptr = &contextPair;
-
-      if(contextPair.writeContext != nullptr) {
-        connectionEvent.events = EPOLLIN | EPOLLOUT | EPOLLONESHOT;
-      } else {
-        connectionEvent.events = EPOLLIN | EPOLLONESHOT;
-      }
-
-      if (epoll_ctl(dispatcher->getEpoll(), EPOLL_CTL_MOD, connection, &connectionEvent) == -1) {
-        message = "epoll_ctl failed, " + lastErrorMessage();
-      } else {
-        dispatcher->getCurrentContext()->interruptProcedure = [&]() {
-            assert(dispatcher != nullptr);
-            assert(contextPair.readContext != nullptr);
-            epoll_event connectionEvent;
-            connectionEvent.events = 0;
-            connectionEvent.data.ptr = nullptr;
-
-            if (epoll_ctl(dispatcher->getEpoll(), EPOLL_CTL_MOD, connection, &connectionEvent) == -1) {
-              throw std::runtime_error("TcpConnection::stop, epoll_ctl failed, " + lastErrorMessage());
-            }
-
-            contextPair.readContext->interrupted = true;
-            dispatcher->pushContext(contextPair.readContext->context);
-        };
-
-        dispatcher->dispatch();
-        dispatcher->getCurrentContext()->interruptProcedure = nullptr;
-        assert(dispatcher != nullptr);
-        assert(operationContext.context == dispatcher->getCurrentContext());
-        assert(contextPair.readContext == &operationContext);
-
-        if (operationContext.interrupted) {
-          contextPair.readContext = nullptr;
-          throw InterruptedException();
-        }
-
-        contextPair.readContext = nullptr;
-        if(contextPair.writeContext != nullptr) { //write is presented, rearm
-          epoll_event connectionEvent;
-          connectionEvent.events = EPOLLOUT | EPOLLONESHOT;
-          connectionEvent.data.ptr = &contextPair;
-
-          if (epoll_ctl(dispatcher->getEpoll(), EPOLL_CTL_MOD, connection, &connectionEvent) == -1) {
-            message = "epoll_ctl failed, " + lastErrorMessage();
-            throw std::runtime_error("TcpConnection::read: " + message);
-          }
-        }
-
-        if((operationContext.events & (EPOLLERR | EPOLLHUP)) != 0) {
-          message = "Event failed, " + lastErrorMessage();
-          throw std::runtime_error("TcpConnection::read event error : " + message);
-        }
-
-        ssize_t transferred = ::recv(connection, (void *)data, size, 0);
-        if (transferred == -1) {
-          message = "recv failed, " + lastErrorMessage();
-        } else {
-          assert(transferred <= static_cast<ssize_t>(size));
-          return transferred;
-        }
-      }
+  for (;;) {
+    ssize_t transferred = ::recv(connection, (void *)data, size, 0);
+    if (transferred != -1) {
+      assert(transferred <= static_cast<ssize_t>(size));
+      return transferred;
     }
 
-    throw std::runtime_error("TcpConnection::read: "+ message);
-  }
+    if (errno != EAGAIN && errno != EWOULDBLOCK) {
+      throw std::runtime_error("TcpConnection::read: recv failed, " + lastErrorMessage());
+    }
 
-  assert(transferred <= static_cast<ssize_t>(size));
-  return transferred;
+    if ((wait(contextPair->readContext) & (EPOLLERR | EPOLLHUP)) != 0) {
+      throw std::runtime_error("TcpConnection::read event error : Event failed, " + lastErrorMessage());
+    }
+  }
 }
 
 std::size_t TcpConnection::write(const uint8_t* data, size_t size) {
   assert(dispatcher != nullptr);
-  assert(contextPair.writeContext == nullptr);
+  assert(contextPair->writeContext == nullptr);
   if (dispatcher->interrupted()) {
     throw InterruptedException();
   }
 
-  std::string message;
   if(size == 0) {
     if(shutdown(connection, SHUT_WR) == -1) {
       throw std::runtime_error("TcpConnection::write, shutdown failed, " + lastErrorMessage());
@@ -164,85 +101,71 @@ std::size_t TcpConnection::write(const uint8_t* data, size_t size) {
     return 0;
   }
 
-  ssize_t transferred = ::send(connection, (void *)data, size, MSG_NOSIGNAL);
-  if (transferred == -1) {
-        bool noError = errno != EAGAIN ? errno != EWOULDBLOCK : false;
-    if (noError) {
-      message = "send failed, " + lastErrorMessage();
-    } else {
-      epoll_event connectionEvent;
-      OperationContext operationContext;
-      operationContext.interrupted = false;
-      operationContext.context = dispatcher->getCurrentContext();
-      contextPair.writeContext = &operationContext;
-      connectionEvent.data.ptr = &contextPair;
-
-      if(contextPair.readContext != nullptr) {
-        connectionEvent.events = EPOLLIN | EPOLLOUT | EPOLLONESHOT;
-      } else {
-        connectionEvent.events = EPOLLOUT | EPOLLONESHOT;
-      }
-
-      if (epoll_ctl(dispatcher->getEpoll(), EPOLL_CTL_MOD, connection, &connectionEvent) == -1) {
-        message = "epoll_ctl failed, " + lastErrorMessage();
-      } else {
-        dispatcher->getCurrentContext()->interruptProcedure = [&]() {
-            assert(dispatcher != nullptr);
-            assert(contextPair.writeContext != nullptr);
-            epoll_event connectionEvent;
-            connectionEvent.events = 0;
-            connectionEvent.data.ptr = nullptr;
-
-            if (epoll_ctl(dispatcher->getEpoll(), EPOLL_CTL_MOD, connection, &connectionEvent) == -1) {
-              throw std::runtime_error("TcpConnection::stop, epoll_ctl failed, " + lastErrorMessage());
-            }
-
-            contextPair.writeContext->interrupted = true;
-            dispatcher->pushContext(contextPair.writeContext->context);
-        };
-
-        dispatcher->dispatch();
-        dispatcher->getCurrentContext()->interruptProcedure = nullptr;
-        assert(dispatcher != nullptr);
-        assert(operationContext.context == dispatcher->getCurrentContext());
-        assert(contextPair.writeContext == &operationContext);
-
-        if (operationContext.interrupted) {
-          contextPair.writeContext = nullptr;
-          throw InterruptedException();
-        }
-
-        contextPair.writeContext = nullptr;
-        if(contextPair.readContext != nullptr) { //read is presented, rearm
-          epoll_event connectionEvent;
-          connectionEvent.events = EPOLLIN | EPOLLONESHOT;
-          connectionEvent.data.ptr = &contextPair;
-
-          if (epoll_ctl(dispatcher->getEpoll(), EPOLL_CTL_MOD, connection, &connectionEvent) == -1) {
-            message = "epoll_ctl failed, " + lastErrorMessage();
-            throw std::runtime_error("TcpConnection::write, " + message);
-          }
-        }
-
-        if((operationContext.events & (EPOLLERR | EPOLLHUP)) != 0) {
-          throw std::runtime_error("TcpConnection::write, events & (EPOLLERR | EPOLLHUP) != 0");
-        }
-
-        ssize_t transferred = ::send(connection, (void *)data, size, 0);
-        if (transferred == -1) {
-          message = "send failed, "  + lastErrorMessage();
-        } else {
-          assert(transferred <= static_cast<ssize_t>(size));
-          return transferred;
-        }
-      }
+  iovec buffer = {const_cast<uint8_t*>(data), size};
+  return send(&buffer, 1, size);
+}
+
+std::size_t TcpConnection::write(const uint8_t* head, std::size_t headSize, const uint8_t* data, std::size_t size) {
+  assert(dispatcher != nullptr);
+  assert(contextPair->writeContext == nullptr);
+  assert(headSize + size > 0);
+  if (dispatcher->interrupted()) {
+    throw InterruptedException();
+  }
+
+  iovec buffers[] = {{const_cast<uint8_t*>(head), headSize}, {const_cast<uint8_t*>(data), size}};
+  return send(buffers, 2, headSize + size);
+}
+
+std::size_t TcpConnection::send(iovec* buffers, std::size_t count, std::size_t size) {
+  msghdr header = {};
+  header.msg_iov = buffers;
+  header.msg_iovlen = count;
+
+  for (;;) {
+    ssize_t transferred = ::sendmsg(connection, &header, MSG_NOSIGNAL);
+    if (transferred != -1) {
+      assert(transferred <= static_cast<ssize_t>(size));
+      return transferred;
     }
 
-    throw std::runtime_error("TcpConnection::write, " + message);
+    if (errno != EAGAIN && errno != EWOULDBLOCK) {
+      throw std::runtime_error("TcpConnection::write, send failed, " + lastErrorMessage());
+    }
+
+    if ((wait(contextPair->writeContext) & (EPOLLERR | EPOLLHUP)) != 0) {
+      throw std::runtime_error("TcpConnection::write, events & (EPOLLERR | EPOLLHUP) != 0");
+    }
+  }
+}
+
+// The socket stays registered, so waiting costs no syscall: the dispatcher resumes the context on the next edge
+// and clears 'waiter'. An edge reported while nobody waits is dropped, read and write always try the socket
+// before waiting.
+uint32_t TcpConnection::wait(OperationContext*& waiter) {
+  OperationContext operationContext;
+  operationContext.interrupted = false;
+  operationContext.context = dispatcher->getCurrentContext();
+  operationContext.events = 0;
+  waiter = &operationContext;
+
+  dispatcher->getCurrentContext()->interruptProcedure = [&]() {
+    assert(waiter == &operationContext);
+    waiter = nullptr;
+    operationContext.interrupted = true;
+    dispatcher->pushContext(operationContext.context);
+  };
+
+  dispatcher->dispatch();
+  dispatcher->getCurrentContext()->interruptProcedure = nullptr;
+  assert(dispatcher != nullptr);
+  assert(operationContext.context == dispatcher->getCurrentContext());
+  assert(waiter == nullptr);
+  if (operationContext.interrupted) {
+    throw InterruptedException();
   }
 
-  assert(transferred <= static_cast<ssize_t>(size));
-  return transferred;
+  return operationContext.events;
 }
 
 std::pair<Ipv4Address, uint16_t> TcpConnection::getPeerAddressAndPort() const {
@@ -257,13 +180,15 @@ std::pair<Ipv4Address, uint16_t> TcpConnection::getPeerAddressAndPort() const {
 }
 
 TcpConnection::TcpConnection(Dispatcher& dispatcher, int socket) : dispatcher(&dispatcher), connection(socket) {
-  contextPair.readContext = nullptr;
-  contextPair.writeContext = nullptr;
+  contextPair = new ContextPair;
+  contextPair->readContext = nullptr;
+  contextPair->writeContext = nullptr;
   epoll_event connectionEvent;
-  connectionEvent.events = EPOLLONESHOT;
-  connectionEvent.data.ptr = nullptr;
+  connectionEvent.events = EPOLLIN | EPOLLOUT | EPOLLET;
+  connectionEvent.data.ptr = contextPair;
 
-  if (epoll_ctl(dispatcher.getEpoll(), EPOLL_CTL_ADD, socket, &connectionEvent) == -1) {
+  if (dispatcher.controlEpoll(EPOLL_CTL_ADD, socket, &connectionEvent) == -1) {
+    delete contextPair;
     throw std::runtime_error("TcpConnection::TcpConnection, epoll_ctl failed, " + lastErrorMessage());
   }
 }
@@ -98,7 +98,7 @@ TcpConnection TcpConnector::connect(const Ipv4Address& address, uint16_t port) {
             epoll_event connectEvent;
             connectEvent.events = EPOLLOUT | EPOLLRDHUP | EPOLLERR | EPOLLONESHOT;
             connectEvent.data.ptr = &contextPair;
-            if (epoll_ctl(dispatcher->getEpoll(), EPOLL_CTL_ADD, connection, &connectEvent) == -1) {
+            if (dispatcher->controlEpoll(EPOLL_CTL_ADD, connection, &connectEvent) == -1) {
               message = "epoll_ctl failed, " + lastErrorMessage();
             } else {
               context = &connectorContext;
@@ -126,7 +126,7 @@ TcpConnection TcpConnector::connect(const Ipv4Address& address, uint16_t port) {
                 throw InterruptedException();
               }
 
-              if (epoll_ctl(dispatcher->getEpoll(), EPOLL_CTL_DEL, connection, NULL) == -1) {
+              if (dispatcher->controlEpoll(EPOLL_CTL_DEL, connection, NULL) == -1) {
                 message = "epoll_ctl failed, " + lastErrorMessage();
               } else {
                 if((connectorContext.events & (EPOLLERR | EPOLLHUP)) != 0) {
@@ -50,7 +50,7 @@ TcpListener::TcpListener(Dispatcher& dispatcher, const Ipv4Address& addr, uint16
           listenEvent.events = 0;
           listenEvent.data.ptr = nullptr;
 
-          if (epoll_ctl(dispatcher.getEpoll(), EPOLL_CTL_ADD, listener, &listenEvent) == -1) {
+          if (dispatcher.controlEpoll(EPOLL_CTL_ADD, listener, &listenEvent) == -1) {
             message = "epoll_ctl failed, " + lastErrorMessage();
           } else {
             context = nullptr;
@@ -122,7 +122,7 @@ TcpConnection TcpListener::accept() {
   listenEvent.events = EPOLLIN | EPOLLONESHOT;
   listenEvent.data.ptr = &contextPair;
   std::string message;
-  if (epoll_ctl(dispatcher->getEpoll(), EPOLL_CTL_MOD, listener, &listenEvent) == -1) {
+  if (dispatcher->controlEpoll(EPOLL_CTL_MOD, listener, &listenEvent) == -1) {
     message = "epoll_ctl failed, " + lastErrorMessage();
   } else {
     context = &listenerContext;
@@ -135,7 +135,7 @@ TcpConnection TcpListener::accept() {
           listenEvent.events = 0;
           listenEvent.data.ptr = nullptr;
 
-          if (epoll_ctl(dispatcher->getEpoll(), EPOLL_CTL_MOD, listener, &listenEvent) == -1) {
+          if (dispatcher->controlEpoll(EPOLL_CTL_MOD, listener, &listenEvent) == -1) {
             throw std::runtime_error("TcpListener::stop, epoll_ctl failed, " + lastErrorMessage() );
           }
 
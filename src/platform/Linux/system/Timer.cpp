@@ -79,7 +79,7 @@ void Timer::sleep(std::chrono::nanoseconds duration) {
     timerEvent.events = EPOLLIN | EPOLLONESHOT;
     timerEvent.data.ptr = &contextPair;
 
-    if (epoll_ctl(dispatcher->getEpoll(), EPOLL_CTL_MOD, timer, &timerEvent) == -1) {
+    if (dispatcher->controlEpoll(EPOLL_CTL_MOD, timer, &timerEvent) == -1) {
       throw std::runtime_error("Timer::sleep, epoll_ctl failed, " + lastErrorMessage());
     }
     dispatcher->getCurrentContext()->interruptProcedure = [&]() {
@@ -105,7 +105,7 @@ void Timer::sleep(std::chrono::nanoseconds duration) {
           timerEvent.events = 0;
           timerEvent.data.ptr = nullptr;
 
-          if (epoll_ctl(dispatcher->getEpoll(), EPOLL_CTL_MOD, timer, &timerEvent) == -1) {
+          if (dispatcher->controlEpoll(EPOLL_CTL_MOD, timer, &timerEvent) == -1) {
             throw std::runtime_error("Timer::interrupt, epoll_ctl failed, " + lastErrorMessage());
           }
         }
@@ -8,6 +8,8 @@
 #include <cstdint>
 #include <utility>
 
+struct iovec;
+
 namespace System {
 
 class Dispatcher;
@@ -23,6 +25,9 @@ public:
   TcpConnection& operator=(TcpConnection&& other);
   std::size_t read(uint8_t* data, std::size_t size);
   std::size_t write(const uint8_t* data, std::size_t size);
+  // Gathers 'head' and 'data' into one send without copying them together. Returns the number of bytes
+  // written from both, head first.
+  std::size_t write(const uint8_t* head, std::size_t headSize, const uint8_t* data, std::size_t size);
   std::pair<Ipv4Address, uint16_t> getPeerAddressAndPort() const;
 
 private:
@@ -35,6 +40,7 @@ private:
   void* writeContext;
 
   TcpConnection(Dispatcher& dispatcher, int socket);
+  std::size_t send(iovec* buffers, std::size_t count, std::size_t size);
 };
 
 }
@@ -148,9 +148,29 @@ size_t TcpConnection::write(const uint8_t* data, size_t size) {
   }
 
   WSABUF buf{static_cast<ULONG>(size), reinterpret_cast<char*>(const_cast<uint8_t*>(data))};
+  return send(&buf, 1, size);
+}
+
+size_t TcpConnection::write(const uint8_t* head, size_t headSize, const uint8_t* data, size_t size) {
+  assert(dispatcher != nullptr);
+  assert(writeContext == nullptr);
+  assert(headSize + size > 0);
+  if (dispatcher->interrupted()) {
+    throw InterruptedException();
+  }
+
+  WSABUF buffers[] = {
+    {static_cast<ULONG>(headSize), reinterpret_cast<char*>(const_cast<uint8_t*>(head))},
+    {static_cast<ULONG>(size), reinterpret_cast<char*>(const_cast<uint8_t*>(data))}
+  };
+
+  return send(buffers, 2, headSize + size);
+}
+
+size_t TcpConnection::send(WSABUF* buffers, unsigned long count, size_t size) {
   TcpConnectionContext context;
   context.hEvent = NULL;
-  if (WSASend(connection, &buf, 1, NULL, 0, &context, NULL) != 0) {
+  if (WSASend(connection, buffers, count, NULL, 0, &context, NULL) != 0) {
     int lastError = WSAGetLastError();
     if (lastError != WSA_IO_PENDING) {
       throw std::runtime_error("TcpConnection::write, WSASend failed, " + errorMessage(lastError));
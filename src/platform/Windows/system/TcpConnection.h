@@ -7,6 +7,8 @@
 #include <cstdint>
 #include <string>
 
+struct _WSABUF;
+
 namespace System {
 
 class Dispatcher;
@@ -22,6 +24,9 @@ public:
   TcpConnection& operator=(TcpConnection&& other);
   size_t read(uint8_t* data, size_t size);
   size_t write(const uint8_t* data, size_t size);
+  // Gathers 'head' and 'data' into one send without copying them together. Returns the number of bytes
+  // written from both, head first.
+  size_t write(const uint8_t* head, size_t headSize, const uint8_t* data, size_t size);
   std::pair<Ipv4Address, uint16_t> getPeerAddressAndPort() const;
 
 private:
@@ -34,6 +39,7 @@ private:
   void* writeContext;
 
   TcpConnection(Dispatcher& dispatcher, size_t connection);
+  size_t send(_WSABUF* buffers, unsigned long count, size_t size);
 };
 
 }
@@ -141,6 +141,36 @@ struct COMMAND_RPC_GET_POOL_CHANGES_LITE {
   };
 };
 
+struct COMMAND_RPC_GET_POOL_CHANGES_SINCE {
+  struct request {
+    crypto::hash_t tailBlockId;
+    uint64_t sequence;  // from the previous response, 0 for the whole pool
+
+    void serialize(ISerializer &s) {
+      KV_MEMBER(tailBlockId)
+      KV_MEMBER(sequence)
+    }
+  };
+
+  struct response {
+    bool isTailBlockActual;
+    bool isFullResync;  // the changes are no longer known, addedTxs is the whole pool
+    uint64_t sequence;
+    std::vector<transaction_prefix_info_t> addedTxs;
+    std::vector<crypto::hash_t> deletedTxsIds;
+    std::string status;
+
+    void serialize(ISerializer &s) {
+      KV_MEMBER(isTailBlockActual)
+      KV_MEMBER(isFullResync)
+      KV_MEMBER(sequence)
+      KV_MEMBER(addedTxs)
+      serializeAsBinary(deletedTxsIds, "deletedTxsIds", s);
+      KV_MEMBER(status)
+    }
+  };
+};
+
 //-----------------------------------------------
 struct COMMAND_RPC_GET_TX_GLOBAL_OUTPUTS_INDEXES {
   
@@ -163,6 +193,35 @@ struct COMMAND_RPC_GET_TX_GLOBAL_OUTPUTS_INDEXES {
   };
 };
 //-----------------------------------------------
+struct COMMAND_RPC_GET_TXS_GLOBAL_OUTPUTS_INDEXES {
+
+  struct request {
+    std::vector<crypto::hash_t> txids;
+
+    void serialize(ISerializer &s) {
+      serializeAsBinary(txids, "txids", s);
+    }
+  };
+
+  struct tx_indexes {
+    std::vector<uint32_t> o_indexes;
+
+    void serialize(ISerializer &s) {
+      serializeAsBinary(o_indexes, "o_indexes", s);
+    }
+  };
+
+  struct response {
+    std::vector<tx_indexes> txs;  // in the order of request::txids
+    std::string status;
+
+    void serialize(ISerializer &s) {
+      KV_MEMBER(txs)
+      KV_MEMBER(status)
+    }
+  };
+};
+//-----------------------------------------------
 struct COMMAND_RPC_GET_RANDOM_OUTPUTS_FOR_AMOUNTS_request {
   std::vector<uint64_t> amounts;
   uint64_t outs_count;
@@ -265,6 +324,8 @@ struct COMMAND_RPC_GET_INFO {
     uint64_t white_peerlist_size;
     uint64_t grey_peerlist_size;
     uint32_t last_known_block_index;
+    uint64_t block_cache_hits;
+    uint64_t block_cache_misses;
 
     void serialize(ISerializer &s) {
       KV_MEMBER(status)
@@ -278,6 +339,8 @@ struct COMMAND_RPC_GET_INFO {
       KV_MEMBER(white_peerlist_size)
       KV_MEMBER(grey_peerlist_size)
       KV_MEMBER(last_known_block_index)
+      KV_MEMBER(block_cache_hits)
+      KV_MEMBER(block_cache_misses)
     }
   };
 };
@@ -20,6 +20,12 @@ public:
   ConnectException(const std::string& whatArg);
 };
 
+// The server answered 404, it does not know the requested method
+class MethodNotFoundException : public std::runtime_error {
+public:
+  MethodNotFoundException(const std::string& whatArg);
+};
+
 class HttpClient {
 public:
 
@@ -51,6 +57,10 @@ void invokeJsonCommand(HttpClient& client, const std::string& url, const Request
   hreq.setBody(storeToJson(req));
   client.request(hreq, hres);
 
+  if (hres.getStatus() == HttpResponse::STATUS_404) {
+    throw MethodNotFoundException(url);
+  }
+
   if (hres.getStatus() != HttpResponse::STATUS_200) {
     throw std::runtime_error("HTTP status: " + std::to_string(hres.getStatus()));
   }
@@ -69,6 +79,10 @@ void invokeBinaryCommand(HttpClient& client, const std::string& url, const Reque
   hreq.setBody(storeToBinaryKeyValue(req));
   client.request(hreq, hres);
 
+  if (hres.getStatus() == HttpResponse::STATUS_404) {
+    throw MethodNotFoundException(url);
+  }
+
   if (!loadFromBinaryKeyValue(res, hres.getBody())) {
     throw std::runtime_error("Failed to parse binary response");
   }
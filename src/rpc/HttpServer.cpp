@@ -7,6 +7,7 @@
 
 #include <http/HttpParser.h>
 #include <system/InterruptedException.h>
+#include <system/RemoteCall.h>
 #include <system/TcpStream.h>
 #include <system/Ipv4Address.h>
 
@@ -15,11 +16,12 @@ using namespace Logging;
 namespace cryptonote {
 
 HttpServer::HttpServer(System::Dispatcher& dispatcher, Logging::ILogger& log)
-  : m_dispatcher(dispatcher), workingContextGroup(dispatcher), logger(log, "HttpServer") {
+  : m_dispatcher(dispatcher), workingContextGroup(dispatcher), logger(log, "HttpServer"), m_workers(nullptr) {
 
 }
 
-void HttpServer::start(const std::string& address, uint16_t port) {
+void HttpServer::start(const std::string& address, uint16_t port, System::DispatcherPool* workers) {
+  m_workers = workers;
   m_listener = System::TcpListener(m_dispatcher, System::Ipv4Address(address), port);
   workingContextGroup.spawn(std::bind(&HttpServer::acceptLoop, this));
 }
@@ -64,7 +66,11 @@ void HttpServer::acceptLoop() {
       HttpResponse resp;
 
       parser.receiveRequest(stream, req);
-      processRequest(req, resp);
+      if (m_workers != nullptr) {
+        System::remoteCall<void>(m_dispatcher, m_workers->nextDispatcher(), [&] { processRequest(req, resp); });
+      } else {
+        processRequest(req, resp);
+      }
 
       stream << resp;
       stream.flush();
@@ -14,6 +14,7 @@
 #include <system/TcpListener.h>
 #include <system/TcpConnection.h>
 #include <system/Event.h>
+#include <system/DispatcherPool.h>
 
 #include <logging/LoggerRef.h>
 
@@ -25,7 +26,9 @@ public:
 
   HttpServer(System::Dispatcher& dispatcher, Logging::ILogger& log);
 
-  void start(const std::string& address, uint16_t port);
+  // Connections are served on 'dispatcher'; with 'workers' given, requests are processed on the pool's dispatchers so
+  // handlers run in parallel and never stall the connections' dispatcher
+  void start(const std::string& address, uint16_t port, System::DispatcherPool* workers = nullptr);
   void stop();
 
   virtual void processRequest(const HttpRequest& request, HttpResponse& response) = 0;
@@ -42,6 +45,7 @@ private:
   System::ContextGroup workingContextGroup;
   Logging::LoggerRef logger;
   System::TcpListener m_listener;
+  System::DispatcherPool* m_workers;
   std::unordered_set<System::TcpConnection*> m_connections;
 };
 
@@ -7,6 +7,7 @@
 #include <boost/optional.hpp>
 #include <boost/foreach.hpp>
 #include <functional>
+#include <memory>
 
 #include "CoreRpcServerCommandsDefinitions.h"
 #include <common/JsonValue.h>
@@ -53,23 +54,25 @@ typedef boost::optional<Common::JsonValue> OptionalId;
 class JsonRpcRequest {
 public:
   
-  JsonRpcRequest() : psReq(Common::JsonValue::OBJECT) {}
+  JsonRpcRequest() {}
 
   bool parseRequest(const std::string& requestBody) {
     try {
-      psReq = Common::JsonValue::fromString(requestBody);
+      psReq.reset(new JsonTokens(requestBody));
     } catch (std::exception&) {
       throw JsonRpcError(errParseError);
     }
 
-    if (!psReq.contains("method")) {
+    size_t methodValue = psReq->find(0, "method");
+    if (methodValue == JsonTokens::npos) {
       throw JsonRpcError(errInvalidRequest);
     }
 
-    method = psReq("method").getString();
+    method = psReq->getString(methodValue);
 
-    if (psReq.contains("id")) {
-      id = psReq("id");
+    size_t idValue = psReq->find(0, "id");
+    if (idValue != JsonTokens::npos) {
+      id = Common::JsonValue::fromString(std::string(psReq->getRaw(idValue)));
     }
 
     return true;
@@ -77,14 +80,18 @@ public:
 
   template <typename T>
   bool loadParams(T& v) const {
-    loadFromJsonValue(v, psReq.contains("params") ? 
-      psReq("params") : Common::JsonValue(Common::JsonValue::NIL));
+    size_t paramsValue = psReq ? psReq->find(0, "params") : JsonTokens::npos;
+    if (paramsValue == JsonTokens::npos) {
+      throw JsonRpcError(errInvalidParams);
+    }
+
+    loadFromJsonTokens(v, *psReq, paramsValue);
     return true;
   }
 
   template <typename T>
   bool setParams(const T& v) {
-    psReq.set("params", storeToJsonValue(v));
+    params = storeToJson(v);
     return true;
   }
 
@@ -101,74 +108,102 @@ public:
   }
 
   std::string getBody() {
-    psReq.set("jsonrpc", std::string("2.0"));
-    psReq.set("method", method);
-    return psReq.toString();
+    JsonOutputStringSerializer s;
+    std::string version = "2.0";
+    s(version, "jsonrpc");
+    s(method, "method");
+    if (!params.empty()) {
+      s.raw(params, "params");
+    }
+
+    return std::move(s.getString());
   }
 
 private:
 
-  Common::JsonValue psReq;
+  std::unique_ptr<JsonTokens> psReq;
   OptionalId id;
   std::string method;
+  std::string params;
 };
 
 
 class JsonRpcResponse {
 public:
 
-  JsonRpcResponse() : psResp(Common::JsonValue::OBJECT) {}
+  JsonRpcResponse() {}
 
   void parse(const std::string& responseBody) {
     try {
-      psResp = Common::JsonValue::fromString(responseBody);
+      psResp.reset(new JsonTokens(responseBody));
     } catch (std::exception&) {
       throw JsonRpcError(errParseError);
     }
   }
 
   void setId(const OptionalId& id) {
-    if (id.is_initialized()) {
-      psResp.insert("id", id.get());
-    }
+    this->id = id;
   }
 
   void setError(const JsonRpcError& err) {
-    psResp.set("error", storeToJsonValue(err));
+    error = storeToJson(err);
   }
 
   bool getError(JsonRpcError& err) const {
-    if (!psResp.contains("error")) {
+    size_t errorValue = findMember("error");
+    if (errorValue == JsonTokens::npos) {
       return false;
     }
 
-    loadFromJsonValue(err, psResp("error"));
+    loadFromJsonTokens(err, *psResp, errorValue);
     return true;
   }
 
   std::string getBody() {
-    psResp.set("jsonrpc", std::string("2.0"));
-    return psResp.toString();
+    JsonOutputStringSerializer s;
+    if (id.is_initialized()) {
+      s.raw(id->toString(), "id");
+    }
+
+    std::string version = "2.0";
+    s(version, "jsonrpc");
+    if (!error.empty()) {
+      s.raw(error, "error");
+    } else if (!result.empty()) {
+      s.raw(result, "result");
+    }
+
+    return std::move(s.getString());
   }
 
   template <typename T>
   bool setResult(const T& v) {
-    psResp.set("result", storeToJsonValue(v));
+    result = storeToJson(v);
     return true;
   }
 
   template <typename T>
   bool getResult(T& v) const {
-    if (!psResp.contains("result")) {
+    size_t resultValue = findMember("result");
+    if (resultValue == JsonTokens::npos) {
       return false;
     }
 
-    loadFromJsonValue(v, psResp("result"));
+    loadFromJsonTokens(v, *psResp, resultValue);
     return true;
   }
 
 private:
-  Common::JsonValue psResp;
+  // npos for a null member too
+  size_t findMember(Common::StringView name) const {
+    size_t value = psResp ? psResp->find(0, name) : JsonTokens::npos;
+    return value != JsonTokens::npos && psResp->getType(value) == JsonTokens::NIL ? JsonTokens::npos : value;
+  }
+
+  std::unique_ptr<JsonTokens> psResp;
+  OptionalId id;
+  std::string error;
+  std::string result;
 };
 
 
@@ -0,0 +1,169 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "JsonInputStringSerializer.h"
+
+#include <cassert>
+#include <stdexcept>
+
+#include "common/StringTools.h"
+
+using namespace cryptonote;
+
+JsonInputStringSerializer::JsonInputStringSerializer(const JsonTokens& tokens, size_t object) : tokens(tokens) {
+  if (tokens.getType(object) != JsonTokens::OBJECT) {
+    throw std::runtime_error("Serializer doesn't support this type of serialization: Object expected.");
+  }
+
+  chain.push_back({object, JsonTokens::npos, 0});
+}
+
+JsonInputStringSerializer::~JsonInputStringSerializer() {
+}
+
+ISerializer::SerializerType JsonInputStringSerializer::type() const {
+  return ISerializer::INPUT;
+}
+
+bool JsonInputStringSerializer::beginObject(Common::StringView name) {
+  size_t value = getValue(name);
+  if (value == JsonTokens::npos) {
+    return false;
+  }
+
+  if (tokens.getType(value) != JsonTokens::OBJECT) {
+    throw std::runtime_error("JSON value type is not OBJECT");
+  }
+
+  chain.push_back({value, JsonTokens::npos, 0});
+  return true;
+}
+
+void JsonInputStringSerializer::endObject() {
+  assert(!chain.empty());
+  chain.pop_back();
+}
+
+bool JsonInputStringSerializer::beginArray(size_t& size, Common::StringView name) {
+  size_t value = getValue(name);
+  if (value == JsonTokens::npos) {
+    size = 0;
+    return false;
+  }
+
+  if (tokens.getType(value) != JsonTokens::ARRAY) {
+    throw std::runtime_error("JSON value type is not ARRAY");
+  }
+
+  size = tokens.getSize(value);
+  chain.push_back({value, tokens.getFirst(value), size});
+  return true;
+}
+
+void JsonInputStringSerializer::endArray() {
+  assert(!chain.empty());
+  chain.pop_back();
+}
+
+bool JsonInputStringSerializer::operator()(uint16_t& value, Common::StringView name) {
+  return getNumber(name, value);
+}
+
+bool JsonInputStringSerializer::operator()(int16_t& value, Common::StringView name) {
+  return getNumber(name, value);
+}
+
+bool JsonInputStringSerializer::operator()(uint32_t& value, Common::StringView name) {
+  return getNumber(name, value);
+}
+
+bool JsonInputStringSerializer::operator()(int32_t& value, Common::StringView name) {
+  return getNumber(name, value);
+}
+
+bool JsonInputStringSerializer::operator()(int64_t& value, Common::StringView name) {
+  return getNumber(name, value);
+}
+
+bool JsonInputStringSerializer::operator()(uint64_t& value, Common::StringView name) {
+  size_t v = getValue(name);
+  if (v == JsonTokens::npos) {
+    return false;
+  }
+
+  value = tokens.getUnsigned(v);
+  return true;
+}
+
+bool JsonInputStringSerializer::operator()(double& value, Common::StringView name) {
+  size_t v = getValue(name);
+  if (v == JsonTokens::npos) {
+    return false;
+  }
+
+  value = tokens.getReal(v);
+  return true;
+}
+
+bool JsonInputStringSerializer::operator()(uint8_t& value, Common::StringView name) {
+  return getNumber(name, value);
+}
+
+bool JsonInputStringSerializer::operator()(std::string& value, Common::StringView name) {
+  size_t v = getValue(name);
+  if (v == JsonTokens::npos) {
+    return false;
+  }
+
+  value = tokens.getString(v);
+  return true;
+}
+
+bool JsonInputStringSerializer::operator()(bool& value, Common::StringView name) {
+  size_t v = getValue(name);
+  if (v == JsonTokens::npos) {
+    return false;
+  }
+
+  value = tokens.getBool(v);
+  return true;
+}
+
+bool JsonInputStringSerializer::binary(void* value, size_t size, Common::StringView name) {
+  size_t v = getValue(name);
+  if (v == JsonTokens::npos) {
+    return false;
+  }
+
+  hex::fromString(tokens.getString(v), value, size);
+  return true;
+}
+
+bool JsonInputStringSerializer::binary(std::string& value, Common::StringView name) {
+  size_t v = getValue(name);
+  if (v == JsonTokens::npos) {
+    return false;
+  }
+
+  value = array::toString(hex::fromString(tokens.getString(v)));
+  return true;
+}
+
+size_t JsonInputStringSerializer::getValue(Common::StringView name) {
+  Level& level = chain.back();
+  size_t value;
+  if (tokens.getType(level.value) == JsonTokens::ARRAY) {
+    if (level.left == 0) {
+      throw std::out_of_range("JSON array has no more elements");
+    }
+
+    value = level.element;
+    level.element = tokens.getNext(value);
+    --level.left;
+  } else {
+    value = tokens.find(level.value, name);
+  }
+
+  return value == JsonTokens::npos || tokens.getType(value) == JsonTokens::NIL ? JsonTokens::npos : value;
+}
@@ -0,0 +1,72 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <vector>
+#include "ISerializer.h"
+#include "JsonTokens.h"
+
+namespace cryptonote {
+
+//deserialization straight from the JSON text, without building a Common::JsonValue
+class JsonInputStringSerializer : public ISerializer {
+public:
+  // 'object' is the value of 'tokens' to read, the tokens must outlive the serializer
+  JsonInputStringSerializer(const JsonTokens& tokens, size_t object = 0);
+  virtual ~JsonInputStringSerializer();
+
+  SerializerType type() const override;
+
+  virtual bool beginObject(Common::StringView name) override;
+  virtual void endObject() override;
+
+  virtual bool beginArray(size_t& size, Common::StringView name) override;
+  virtual void endArray() override;
+
+  virtual bool operator()(uint8_t& value, Common::StringView name) override;
+  virtual bool operator()(int16_t& value, Common::StringView name) override;
+  virtual bool operator()(uint16_t& value, Common::StringView name) override;
+  virtual bool operator()(int32_t& value, Common::StringView name) override;
+  virtual bool operator()(uint32_t& value, Common::StringView name) override;
+  virtual bool operator()(int64_t& value, Common::StringView name) override;
+  virtual bool operator()(uint64_t& value, Common::StringView name) override;
+  virtual bool operator()(double& value, Common::StringView name) override;
+  virtual bool operator()(bool& value, Common::StringView name) override;
+  virtual bool operator()(std::string& value, Common::StringView name) override;
+  virtual bool binary(void* value, size_t size, Common::StringView name) override;
+  virtual bool binary(std::string& value, Common::StringView name) override;
+
+  template<typename T>
+  bool operator()(T& value, Common::StringView name) {
+    return ISerializer::operator()(value, name);
+  }
+
+private:
+  struct Level {
+    size_t value;
+    // next element and elements left of an array
+    size_t element;
+    size_t left;
+  };
+
+  const JsonTokens& tokens;
+  std::vector<Level> chain;
+
+  // The member 'name' or the next array element, npos if it is missing or null
+  size_t getValue(Common::StringView name);
+
+  template <typename T>
+  bool getNumber(Common::StringView name, T& v) {
+    size_t value = getValue(name);
+    if (value == JsonTokens::npos) {
+      return false;
+    }
+
+    v = static_cast<T>(tokens.getInteger(value));
+    return true;
+  }
+};
+
+}
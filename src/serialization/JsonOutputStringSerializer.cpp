@@ -0,0 +1,223 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "JsonOutputStringSerializer.h"
+
+#include <cassert>
+#include <iomanip>
+#include <sstream>
+
+using namespace cryptonote;
+
+namespace {
+
+const char HEX_DIGITS[] = "0123456789abcdef";
+
+}
+
+JsonOutputStringSerializer::JsonOutputStringSerializer() : output("{") {
+  chain.push_back({false, true});
+}
+
+JsonOutputStringSerializer::~JsonOutputStringSerializer() {
+}
+
+ISerializer::SerializerType JsonOutputStringSerializer::type() const {
+  return ISerializer::OUTPUT;
+}
+
+bool JsonOutputStringSerializer::beginObject(Common::StringView name) {
+  writeName(name);
+  output += '{';
+  chain.push_back({false, true});
+  return true;
+}
+
+void JsonOutputStringSerializer::endObject() {
+  assert(chain.size() > 1 && !chain.back().isArray);
+  chain.pop_back();
+  output += '}';
+}
+
+bool JsonOutputStringSerializer::beginArray(size_t& size, Common::StringView name) {
+  writeName(name);
+  output += '[';
+  chain.push_back({true, true});
+  return true;
+}
+
+void JsonOutputStringSerializer::endArray() {
+  assert(chain.size() > 1 && chain.back().isArray);
+  chain.pop_back();
+  output += ']';
+}
+
+bool JsonOutputStringSerializer::operator()(uint64_t& value, Common::StringView name) {
+  writeName(name);
+  writeUnsigned(value);
+  return true;
+}
+
+bool JsonOutputStringSerializer::operator()(uint16_t& value, Common::StringView name) {
+  writeName(name);
+  writeUnsigned(value);
+  return true;
+}
+
+bool JsonOutputStringSerializer::operator()(int16_t& value, Common::StringView name) {
+  writeName(name);
+  writeInteger(value);
+  return true;
+}
+
+bool JsonOutputStringSerializer::operator()(uint32_t& value, Common::StringView name) {
+  writeName(name);
+  writeUnsigned(value);
+  return true;
+}
+
+bool JsonOutputStringSerializer::operator()(int32_t& value, Common::StringView name) {
+  writeName(name);
+  writeInteger(value);
+  return true;
+}
+
+bool JsonOutputStringSerializer::operator()(int64_t& value, Common::StringView name) {
+  writeName(name);
+  writeInteger(value);
+  return true;
+}
+
+bool JsonOutputStringSerializer::operator()(double& value, Common::StringView name) {
+  // same text as Common::JsonValue gives
+  std::ostringstream stream;
+  stream << std::fixed << std::setprecision(11) << value;
+  std::string text = stream.str();
+  while (text.size() > 1 && text[text.size() - 2] != '.' && text[text.size() - 1] == '0') {
+    text.resize(text.size() - 1);
+  }
+
+  writeName(name);
+  output += text;
+  return true;
+}
+
+bool JsonOutputStringSerializer::operator()(std::string& value, Common::StringView name) {
+  writeName(name);
+  writeString(value);
+  return true;
+}
+
+bool JsonOutputStringSerializer::operator()(uint8_t& value, Common::StringView name) {
+  writeName(name);
+  writeUnsigned(value);
+  return true;
+}
+
+bool JsonOutputStringSerializer::operator()(bool& value, Common::StringView name) {
+  writeName(name);
+  output += value ? "true" : "false";
+  return true;
+}
+
+bool JsonOutputStringSerializer::binary(void* value, size_t size, Common::StringView name) {
+  writeName(name);
+  output += '"';
+  const uint8_t* data = static_cast<const uint8_t*>(value);
+  for (size_t i = 0; i < size; ++i) {
+    output += HEX_DIGITS[data[i] >> 4];
+    output += HEX_DIGITS[data[i] & 15];
+  }
+
+  output += '"';
+  return true;
+}
+
+bool JsonOutputStringSerializer::binary(std::string& value, Common::StringView name) {
+  return binary(const_cast<char*>(value.data()), value.size(), name);
+}
+
+void JsonOutputStringSerializer::raw(Common::StringView json, Common::StringView name) {
+  writeName(name);
+  output.append(json.getData(), json.getSize());
+}
+
+std::string& JsonOutputStringSerializer::getString() {
+  if (!chain.empty()) {
+    assert(chain.size() == 1);
+    chain.clear();
+    output += '}';
+  }
+
+  return output;
+}
+
+void JsonOutputStringSerializer::writeName(Common::StringView name) {
+  assert(!chain.empty());
+  Level& level = chain.back();
+  if (!level.isEmpty) {
+    output += ',';
+  }
+
+  level.isEmpty = false;
+  if (!level.isArray) {
+    writeString(name);
+    output += ':';
+  }
+}
+
+void JsonOutputStringSerializer::writeString(Common::StringView value) {
+  output += '"';
+  const char* data = value.getData();
+  size_t size = value.getSize();
+  size_t plain = 0;
+  for (size_t i = 0; i < size; ++i) {
+    unsigned char c = static_cast<unsigned char>(data[i]);
+    if (c >= 0x20 && c != '"' && c != '\\') {
+      continue;
+    }
+
+    output.append(data + plain, i - plain);
+    plain = i + 1;
+    output += '\\';
+    switch (c) {
+    case '"': output += '"'; break;
+    case '\\': output += '\\'; break;
+    case '\b': output += 'b'; break;
+    case '\f': output += 'f'; break;
+    case '\n': output += 'n'; break;
+    case '\r': output += 'r'; break;
+    case '\t': output += 't'; break;
+    default:
+      output += "u00";
+      output += HEX_DIGITS[c >> 4];
+      output += HEX_DIGITS[c & 15];
+      break;
+    }
+  }
+
+  output.append(data + plain, size - plain);
+  output += '"';
+}
+
+void JsonOutputStringSerializer::writeUnsigned(uint64_t value) {
+  char buffer[20];
+  char* end = buffer + sizeof(buffer);
+  char* begin = end;
+  do {
+    *--begin = static_cast<char>('0' + value % 10);
+    value /= 10;
+  } while (value != 0);
+
+  output.append(begin, end);
+}
+
+void JsonOutputStringSerializer::writeInteger(int64_t value) {
+  if (value < 0) {
+    output += '-';
+    writeUnsigned(0 - static_cast<uint64_t>(value));
+  } else {
+    writeUnsigned(static_cast<uint64_t>(value));
+  }
+}
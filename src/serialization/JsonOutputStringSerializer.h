@@ -0,0 +1,66 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include "ISerializer.h"
+
+namespace cryptonote {
+
+// Writes JSON text as the values come, without building a Common::JsonValue. Members are written in the order they
+// are serialized.
+class JsonOutputStringSerializer : public ISerializer {
+public:
+  JsonOutputStringSerializer();
+  virtual ~JsonOutputStringSerializer();
+
+  SerializerType type() const override;
+
+  virtual bool beginObject(Common::StringView name) override;
+  virtual void endObject() override;
+
+  virtual bool beginArray(size_t& size, Common::StringView name) override;
+  virtual void endArray() override;
+
+  virtual bool operator()(uint8_t& value, Common::StringView name) override;
+  virtual bool operator()(int16_t& value, Common::StringView name) override;
+  virtual bool operator()(uint16_t& value, Common::StringView name) override;
+  virtual bool operator()(int32_t& value, Common::StringView name) override;
+  virtual bool operator()(uint32_t& value, Common::StringView name) override;
+  virtual bool operator()(int64_t& value, Common::StringView name) override;
+  virtual bool operator()(uint64_t& value, Common::StringView name) override;
+  virtual bool operator()(double& value, Common::StringView name) override;
+  virtual bool operator()(bool& value, Common::StringView name) override;
+  virtual bool operator()(std::string& value, Common::StringView name) override;
+  virtual bool binary(void* value, size_t size, Common::StringView name) override;
+  virtual bool binary(std::string& value, Common::StringView name) override;
+
+  template<typename T>
+  bool operator()(T& value, Common::StringView name) {
+    return ISerializer::operator()(value, name);
+  }
+
+  // Writes 'json', the text of a complete JSON value, as it is
+  void raw(Common::StringView json, Common::StringView name);
+  // Closes the root object, nothing may be written afterwards
+  std::string& getString();
+
+private:
+  struct Level {
+    bool isArray;
+    bool isEmpty;
+  };
+
+  void writeName(Common::StringView name);
+  void writeString(Common::StringView value);
+  void writeUnsigned(uint64_t value);
+  void writeInteger(int64_t value);
+
+  std::string output;
+  std::vector<Level> chain;
+};
+
+}
@@ -0,0 +1,422 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "JsonTokens.h"
+
+#include <cassert>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+namespace cryptonote {
+
+namespace {
+
+const size_t MAX_DEPTH = 256;
+
+bool isDigit(char c) {
+  return c >= '0' && c <= '9';
+}
+
+uint32_t readHex4(const std::string& text, size_t position) {
+  if (position + 4 > text.size()) {
+    throw std::runtime_error("Unable to parse: bad escape sequence");
+  }
+
+  uint32_t value = 0;
+  for (size_t i = position; i < position + 4; ++i) {
+    char c = text[i];
+    value <<= 4;
+    if (c >= '0' && c <= '9') {
+      value |= c - '0';
+    } else if (c >= 'a' && c <= 'f') {
+      value |= c - 'a' + 10;
+    } else if (c >= 'A' && c <= 'F') {
+      value |= c - 'A' + 10;
+    } else {
+      throw std::runtime_error("Unable to parse: bad escape sequence");
+    }
+  }
+
+  return value;
+}
+
+void appendUtf8(uint32_t codePoint, std::string& out) {
+  if (codePoint < 0x80) {
+    out += static_cast<char>(codePoint);
+  } else if (codePoint < 0x800) {
+    out += static_cast<char>(0xc0 | (codePoint >> 6));
+    out += static_cast<char>(0x80 | (codePoint & 0x3f));
+  } else if (codePoint < 0x10000) {
+    out += static_cast<char>(0xe0 | (codePoint >> 12));
+    out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3f));
+    out += static_cast<char>(0x80 | (codePoint & 0x3f));
+  } else {
+    out += static_cast<char>(0xf0 | (codePoint >> 18));
+    out += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3f));
+    out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3f));
+    out += static_cast<char>(0x80 | (codePoint & 0x3f));
+  }
+}
+
+}
+
+const size_t JsonTokens::npos;
+
+JsonTokens::JsonTokens(std::string text) : text(std::move(text)) {
+  size_t position = skipSpaces(0);
+  if (position == this->text.size()) {
+    throw std::runtime_error("Unable to parse: unexpected end of stream");
+  }
+
+  position = skipSpaces(parseValue(position, 0));
+  if (position != this->text.size()) {
+    throw std::runtime_error("Unable to parse: unexpected characters after value");
+  }
+}
+
+const std::string& JsonTokens::getText() const {
+  return text;
+}
+
+JsonTokens::Type JsonTokens::getType(size_t value) const {
+  assert(value < tokens.size());
+  return tokens[value].type;
+}
+
+size_t JsonTokens::getSize(size_t value) const {
+  assert(value < tokens.size());
+  return tokens[value].size;
+}
+
+size_t JsonTokens::getFirst(size_t array) const {
+  return getToken(array, ARRAY).size == 0 ? npos : array + 1;
+}
+
+size_t JsonTokens::getNext(size_t value) const {
+  assert(value < tokens.size());
+  return tokens[value].next;
+}
+
+size_t JsonTokens::find(size_t object, Common::StringView name) const {
+  assert(object < tokens.size());
+  const Token& token = tokens[object];
+  if (token.type != OBJECT) {
+    return npos;
+  }
+
+  size_t member = object + 1;
+  for (size_t i = 0; i < token.size; ++i) {
+    size_t value = member + 1;
+    if (nameEquals(tokens[member], name)) {
+      return value;
+    }
+
+    member = tokens[value].next;
+  }
+
+  return npos;
+}
+
+Common::StringView JsonTokens::getRaw(size_t value) const {
+  assert(value < tokens.size());
+  const Token& token = tokens[value];
+  if (token.type == STRING) {
+    return Common::StringView(text.data() + token.begin - 1, token.end - token.begin + 2);
+  }
+
+  return Common::StringView(text.data() + token.begin, token.end - token.begin);
+}
+
+bool JsonTokens::getBool(size_t value) const {
+  const Token& token = getToken(value, BOOL);
+  return text[token.begin] == 't';
+}
+
+int64_t JsonTokens::getInteger(size_t value) const {
+  const Token& token = getToken(value, NUMBER);
+  char* end;
+  errno = 0;
+  long long result = std::strtoll(text.c_str() + token.begin, &end, 10);
+  if (end != text.c_str() + token.end || errno == ERANGE) {
+    throw std::runtime_error("JSON value is not an integer");
+  }
+
+  return result;
+}
+
+uint64_t JsonTokens::getUnsigned(size_t value) const {
+  const Token& token = getToken(value, NUMBER);
+  if (text[token.begin] == '-') {
+    return static_cast<uint64_t>(getInteger(value));
+  }
+
+  char* end;
+  errno = 0;
+  unsigned long long result = std::strtoull(text.c_str() + token.begin, &end, 10);
+  if (end != text.c_str() + token.end || errno == ERANGE) {
+    throw std::runtime_error("JSON value is not an integer");
+  }
+
+  return result;
+}
+
+double JsonTokens::getReal(size_t value) const {
+  const Token& token = getToken(value, NUMBER);
+  return std::strtod(text.c_str() + token.begin, nullptr);
+}
+
+std::string JsonTokens::getString(size_t value) const {
+  const Token& token = getToken(value, STRING);
+  if (!token.escaped) {
+    return text.substr(token.begin, token.end - token.begin);
+  }
+
+  std::string result;
+  result.reserve(token.end - token.begin);
+  for (size_t i = token.begin; i < token.end; ++i) {
+    char c = text[i];
+    if (c != '\\') {
+      result += c;
+      continue;
+    }
+
+    c = text[++i];
+    switch (c) {
+    case 'b': result += '\b'; break;
+    case 'f': result += '\f'; break;
+    case 'n': result += '\n'; break;
+    case 'r': result += '\r'; break;
+    case 't': result += '\t'; break;
+    case 'u': {
+      uint32_t codePoint = readHex4(text, i + 1);
+      i += 4;
+      if (codePoint >= 0xd800 && codePoint < 0xdc00 && i + 6 < token.end && text[i + 1] == '\\' && text[i + 2] == 'u') {
+        uint32_t low = readHex4(text, i + 3);
+        if (low >= 0xdc00 && low < 0xe000) {
+          codePoint = 0x10000 + ((codePoint - 0xd800) << 10) + (low - 0xdc00);
+          i += 6;
+        }
+      }
+
+      appendUtf8(codePoint, result);
+      break;
+    }
+    default:
+      result += c;
+      break;
+    }
+  }
+
+  return result;
+}
+
+size_t JsonTokens::parseValue(size_t position, size_t depth) {
+  if (depth > MAX_DEPTH) {
+    throw std::runtime_error("Unable to parse: nesting is too deep");
+  }
+
+  switch (text[position]) {
+  case '{': return parseObject(position, depth);
+  case '[': return parseArray(position, depth);
+  case '"': return parseString(position);
+  case 't': return parseLiteral(position, "true", BOOL);
+  case 'f': return parseLiteral(position, "false", BOOL);
+  case 'n': return parseLiteral(position, "null", NIL);
+  default:
+    if (text[position] == '-' || isDigit(text[position])) {
+      return parseNumber(position);
+    }
+
+    throw std::runtime_error("Unable to parse");
+  }
+}
+
+size_t JsonTokens::parseArray(size_t position, size_t depth) {
+  size_t index = tokens.size();
+  tokens.push_back({ARRAY, position, 0, 0, 0, false});
+  position = skipSpaces(position + 1);
+  if (position < text.size() && text[position] == ']') {
+    ++position;
+  } else {
+    for (;;) {
+      if (position == text.size()) {
+        throw std::runtime_error("Unable to parse: unexpected end of stream");
+      }
+
+      position = skipSpaces(parseValue(position, depth + 1));
+      ++tokens[index].size;
+      if (position == text.size()) {
+        throw std::runtime_error("Unable to parse: unexpected end of stream");
+      }
+
+      if (text[position] == ']') {
+        ++position;
+        break;
+      }
+
+      if (text[position] != ',') {
+        throw std::runtime_error("Unable to parse");
+      }
+
+      position = skipSpaces(position + 1);
+    }
+  }
+
+  tokens[index].end = position;
+  tokens[index].next = tokens.size();
+  return position;
+}
+
+size_t JsonTokens::parseObject(size_t position, size_t depth) {
+  size_t index = tokens.size();
+  tokens.push_back({OBJECT, position, 0, 0, 0, false});
+  position = skipSpaces(position + 1);
+  if (position < text.size() && text[position] == '}') {
+    ++position;
+  } else {
+    for (;;) {
+      if (position == text.size() || text[position] != '"') {
+        throw std::runtime_error("Unable to parse");
+      }
+
+      position = skipSpaces(parseString(position));
+      if (position == text.size() || text[position] != ':') {
+        throw std::runtime_error("Unable to parse");
+      }
+
+      position = skipSpaces(position + 1);
+      if (position == text.size()) {
+        throw std::runtime_error("Unable to parse: unexpected end of stream");
+      }
+
+      position = skipSpaces(parseValue(position, depth + 1));
+      ++tokens[index].size;
+      if (position == text.size()) {
+        throw std::runtime_error("Unable to parse: unexpected end of stream");
+      }
+
+      if (text[position] == '}') {
+        ++position;
+        break;
+      }
+
+      if (text[position] != ',') {
+        throw std::runtime_error("Unable to parse");
+      }
+
+      position = skipSpaces(position + 1);
+    }
+  }
+
+  tokens[index].end = position;
+  tokens[index].next = tokens.size();
+  return position;
+}
+
+size_t JsonTokens::parseString(size_t position) {
+  size_t begin = position + 1;
+  bool escaped = false;
+  for (++position; position < text.size(); ++position) {
+    char c = text[position];
+    if (c == '"') {
+      tokens.push_back({STRING, begin, position, tokens.size() + 1, 0, escaped});
+      return position + 1;
+    }
+
+    if (c == '\\') {
+      escaped = true;
+      ++position;
+    }
+  }
+
+  throw std::runtime_error("Unable to parse: unexpected end of stream");
+}
+
+size_t JsonTokens::parseNumber(size_t position) {
+  size_t begin = position;
+  if (text[position] == '-') {
+    ++position;
+  }
+
+  if (position == text.size() || !isDigit(text[position])) {
+    throw std::runtime_error("Unable to parse");
+  }
+
+  if (text[position] == '0') {
+    ++position;
+  } else {
+    while (position < text.size() && isDigit(text[position])) {
+      ++position;
+    }
+  }
+
+  if (position < text.size() && text[position] == '.') {
+    ++position;
+    if (position == text.size() || !isDigit(text[position])) {
+      throw std::runtime_error("Unable to parse");
+    }
+
+    while (position < text.size() && isDigit(text[position])) {
+      ++position;
+    }
+  }
+
+  if (position < text.size() && (text[position] == 'e' || text[position] == 'E')) {
+    ++position;
+    if (position < text.size() && (text[position] == '+' || text[position] == '-')) {
+      ++position;
+    }
+
+    if (position == text.size() || !isDigit(text[position])) {
+      throw std::runtime_error("Unable to parse");
+    }
+
+    while (position < text.size() && isDigit(text[position])) {
+      ++position;
+    }
+  }
+
+  tokens.push_back({NUMBER, begin, position, tokens.size() + 1, 0, false});
+  return position;
+}
+
+size_t JsonTokens::parseLiteral(size_t position, Common::StringView literal, Type type) {
+  if (text.compare(position, literal.getSize(), literal.getData(), literal.getSize()) != 0) {
+    throw std::runtime_error("Unable to parse");
+  }
+
+  tokens.push_back({type, position, position + literal.getSize(), tokens.size() + 1, 0, false});
+  return position + literal.getSize();
+}
+
+size_t JsonTokens::skipSpaces(size_t position) const {
+  while (position < text.size() && (text[position] == ' ' || text[position] == '\t' || text[position] == '\n' || text[position] == '\r')) {
+    ++position;
+  }
+
+  return position;
+}
+
+const JsonTokens::Token& JsonTokens::getToken(size_t value, Type type) const {
+  assert(value < tokens.size());
+  const Token& token = tokens[value];
+  if (token.type != type) {
+    static const char* const NAMES[] = { "NIL", "BOOL", "NUMBER", "STRING", "ARRAY", "OBJECT" };
+    throw std::runtime_error(std::string("JSON value type is not ") + NAMES[type]);
+  }
+
+  return token;
+}
+
+bool JsonTokens::nameEquals(const Token& token, Common::StringView name) const {
+  if (token.escaped) {
+    return getString(static_cast<size_t>(&token - tokens.data())) == std::string(name);
+  }
+
+  return token.end - token.begin == name.getSize() && std::memcmp(text.data() + token.begin, name.getData(), name.getSize()) == 0;
+}
+
+}
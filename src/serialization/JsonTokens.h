@@ -0,0 +1,80 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <common/StringView.h>
+
+namespace cryptonote {
+
+// The values of a JSON text, found in a single pass and kept as positions in the text. A value is addressed by its
+// index, the root value being 0. Array elements and object members follow their container; an object member is its
+// name followed by its value. Nothing is decoded until a value is read, and no node is allocated per value.
+class JsonTokens {
+public:
+  enum Type {
+    NIL,
+    BOOL,
+    NUMBER,
+    STRING,
+    ARRAY,
+    OBJECT
+  };
+
+  static const size_t npos = std::numeric_limits<size_t>::max();
+
+  // Throws std::runtime_error if 'text' is not a single JSON value
+  explicit JsonTokens(std::string text);
+
+  const std::string& getText() const;
+  Type getType(size_t value) const;
+  // Number of elements of an array or members of an object
+  size_t getSize(size_t value) const;
+  // First element of an array, npos if it is empty
+  size_t getFirst(size_t array) const;
+  // Value following 'value' and the values nested in it
+  size_t getNext(size_t value) const;
+  // Value of the member 'name', npos if 'object' is not an object or has no such member
+  size_t find(size_t object, Common::StringView name) const;
+  // JSON text of 'value'
+  Common::StringView getRaw(size_t value) const;
+
+  // Read a value, throw std::runtime_error if it has another type
+  bool getBool(size_t value) const;
+  int64_t getInteger(size_t value) const;
+  uint64_t getUnsigned(size_t value) const;
+  double getReal(size_t value) const;
+  std::string getString(size_t value) const;
+
+private:
+  struct Token {
+    Type type;
+    // the quotes of a string are not included
+    size_t begin;
+    size_t end;
+    size_t next;
+    size_t size;
+    bool escaped;
+  };
+
+  size_t parseValue(size_t position, size_t depth);
+  size_t parseArray(size_t position, size_t depth);
+  size_t parseObject(size_t position, size_t depth);
+  size_t parseString(size_t position);
+  size_t parseNumber(size_t position);
+  size_t parseLiteral(size_t position, Common::StringView literal, Type type);
+  size_t skipSpaces(size_t position) const;
+  const Token& getToken(size_t value, Type type) const;
+  bool nameEquals(const Token& token, Common::StringView name) const;
+
+  std::string text;
+  std::vector<Token> tokens;
+};
+
+}
@@ -9,7 +9,9 @@
 #include <stream/MemoryInputStream.h>
 #include <stream/StringOutputStream.h>
 #include "JsonInputStreamSerializer.h"
+#include "JsonInputStringSerializer.h"
 #include "JsonOutputStreamSerializer.h"
+#include "JsonOutputStringSerializer.h"
 #include "KVBinaryInputStreamSerializer.h"
 #include "KVBinaryOutputStreamSerializer.h"
 
@@ -27,6 +29,15 @@ inline std::string getValueAs<std::string>(const JsonValue& js) { return js.getS
 template <>
 inline uint64_t getValueAs<uint64_t>(const JsonValue& js) { return static_cast<uint64_t>(js.getInteger()); }
 
+template <typename T>
+T getValueAs(const cryptonote::JsonTokens& tokens, size_t value);
+
+template <>
+inline std::string getValueAs<std::string>(const cryptonote::JsonTokens& tokens, size_t value) { return tokens.getString(value); }
+
+template <>
+inline uint64_t getValueAs<uint64_t>(const cryptonote::JsonTokens& tokens, size_t value) { return tokens.getUnsigned(value); }
+
 }
 
 namespace cryptonote {
@@ -76,19 +87,53 @@ void loadFromJsonValue(std::list<T>& v, const Common::JsonValue& js) {
   }
 }
 
+template <typename T>
+void loadFromJsonTokens(T& v, const JsonTokens& tokens, size_t value) {
+  JsonInputStringSerializer s(tokens, value);
+  serialize(v, s);
+}
+
+template <typename T>
+void loadFromJsonTokens(std::vector<T>& v, const JsonTokens& tokens, size_t value) {
+  size_t size = tokens.getSize(value);
+  size_t element = tokens.getFirst(value);
+  for (size_t i = 0; i < size; ++i, element = tokens.getNext(element)) {
+    v.push_back(Common::getValueAs<T>(tokens, element));
+  }
+}
+
+template <typename T>
+void loadFromJsonTokens(std::list<T>& v, const JsonTokens& tokens, size_t value) {
+  size_t size = tokens.getSize(value);
+  size_t element = tokens.getFirst(value);
+  for (size_t i = 0; i < size; ++i, element = tokens.getNext(element)) {
+    v.push_back(Common::getValueAs<T>(tokens, element));
+  }
+}
+
 template <typename T>
 std::string storeToJson(const T& v) {
-  return storeToJsonValue(v).toString();
+  JsonOutputStringSerializer s;
+  serialize(const_cast<T&>(v), s);
+  return std::move(s.getString());
 }
 
+template <typename T>
+std::string storeToJson(const std::vector<T>& v) { return storeToJsonValue(v).toString(); }
+
+template <typename T>
+std::string storeToJson(const std::list<T>& v) { return storeToJsonValue(v).toString(); }
+
+inline std::string storeToJson(const std::string& v) { return storeToJsonValue(v).toString(); }
+
 template <typename T>
 bool loadFromJson(T& v, const std::string& buf) {
   try {
     if (buf.empty()) {
       return true;
     }
-    auto js = Common::JsonValue::fromString(buf);
-    loadFromJsonValue(v, js);
+    JsonTokens tokens(buf);
+    loadFromJsonTokens(v, tokens, 0);
   } catch (std::exception&) {
     return false;
   }
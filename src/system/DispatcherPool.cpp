@@ -0,0 +1,87 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "DispatcherPool.h"
+#include <algorithm>
+#include <cassert>
+#include <memory>
+#include <system/Dispatcher.h>
+#include <system/Event.h>
+
+namespace System {
+
+namespace {
+
+thread_local Dispatcher* currentPoolDispatcher = nullptr;
+
+}
+
+DispatcherPool::DispatcherPool(size_t threadCount) : m_workers(std::max<size_t>(1, threadCount)), m_next(0) {
+  for (size_t i = 0; i < m_workers.size(); ++i) {
+    std::promise<void> started;
+    m_workers[i].thread = std::thread(&DispatcherPool::workerThread, this, std::ref(m_workers[i]), std::ref(started));
+    try {
+      started.get_future().get();
+    } catch (...) {
+      m_workers[i].thread.join();
+      m_workers.resize(i);
+      stop();
+      throw;
+    }
+  }
+}
+
+DispatcherPool::~DispatcherPool() {
+  stop();
+}
+
+size_t DispatcherPool::size() const {
+  return m_workers.size();
+}
+
+Dispatcher& DispatcherPool::nextDispatcher() {
+  assert(!m_workers.empty());
+  Dispatcher& dispatcher = *m_workers[m_next].dispatcher;
+  m_next = (m_next + 1) % m_workers.size();
+  return dispatcher;
+}
+
+void DispatcherPool::stop() {
+  for (auto& worker : m_workers) {
+    Event* stopEvent = worker.stopEvent;
+    worker.dispatcher->remoteSpawn([stopEvent] { stopEvent->set(); });
+  }
+
+  for (auto& worker : m_workers) {
+    worker.thread.join();
+  }
+
+  m_workers.clear();
+}
+
+Dispatcher* DispatcherPool::currentDispatcher() {
+  return currentPoolDispatcher;
+}
+
+void DispatcherPool::workerThread(Worker& worker, std::promise<void>& started) {
+  std::unique_ptr<Dispatcher> dispatcherPtr;
+  try {
+    dispatcherPtr.reset(new Dispatcher);
+  } catch (...) {
+    started.set_exception(std::current_exception());
+    return;
+  }
+
+  Dispatcher& dispatcher = *dispatcherPtr;
+  Event stopEvent(dispatcher);
+  worker.dispatcher = &dispatcher;
+  worker.stopEvent = &stopEvent;
+  currentPoolDispatcher = &dispatcher;
+  started.set_value();
+
+  stopEvent.wait();
+  currentPoolDispatcher = nullptr;
+}
+
+}
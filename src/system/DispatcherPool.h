@@ -0,0 +1,48 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <cstddef>
+#include <future>
+#include <thread>
+#include <vector>
+
+namespace System {
+
+class Dispatcher;
+class Event;
+
+// Dispatchers each running on a thread of their own. Work reaches them through Dispatcher::remoteSpawn or
+// remoteCall; a context running on a pool thread finds its dispatcher with currentDispatcher.
+class DispatcherPool {
+public:
+  explicit DispatcherPool(size_t threadCount);
+  DispatcherPool(const DispatcherPool&) = delete;
+  ~DispatcherPool();
+  DispatcherPool& operator=(const DispatcherPool&) = delete;
+
+  size_t size() const;
+  // Round robin over the pool, for the thread that owns the pool only
+  Dispatcher& nextDispatcher();
+  // Stops the dispatchers and joins the threads, whatever was spawned on the pool must have finished
+  void stop();
+
+  // The dispatcher of the pool thread calling it, nullptr outside of a pool
+  static Dispatcher* currentDispatcher();
+
+private:
+  struct Worker {
+    std::thread thread;
+    Dispatcher* dispatcher;
+    Event* stopEvent;
+  };
+
+  void workerThread(Worker& worker, std::promise<void>& started);
+
+  std::vector<Worker> m_workers;
+  size_t m_next;
+};
+
+}
@@ -0,0 +1,49 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <functional>
+#include <future>
+#include <system/Dispatcher.h>
+#include <system/Event.h>
+#include <system/InterruptedException.h>
+
+namespace System {
+
+// Run operation in a new context of 'target', which may run on another thread, and let 'current' run other tasks until
+// it returns. Returns the operation's result or rethrows its exception. An interrupt arriving meanwhile is delivered to
+// the calling context after the operation finished, since the operation refers to the caller's stack.
+template<class T> T remoteCall(Dispatcher& current, Dispatcher& target, std::function<T()>&& operation) {
+  if (&current == &target) {
+    return operation();
+  }
+
+  std::packaged_task<T()> task(std::move(operation));
+  std::future<T> result = task.get_future();
+  Event completed(current);
+  target.remoteSpawn([&] {
+    task();
+    // make a local copy; the captured references are dead once the event is set
+    Event* localCompleted = &completed;
+    current.remoteSpawn([=] { localCompleted->set(); });
+  });
+
+  bool interrupted = false;
+  while (!completed.get()) {
+    try {
+      completed.wait();
+    } catch (InterruptedException&) {
+      interrupted = true;
+    }
+  }
+
+  if (interrupted) {
+    current.interrupt();
+  }
+
+  return result.get();
+}
+
+}
@@ -7,13 +7,14 @@
 #include <numeric>
 
 #include "CommonTypes.h"
-#include "common/BlockingQueue.h"
+#include "TransfersWorkerPool.h"
 #include "cryptonote/core/CryptoNoteFormatUtils.h"
 #include "cryptonote/core/TransactionApi.h"
 
 #include "IWallet.h"
 #include "INode.h"
 #include <future>
+#include <system_error>
 
 using namespace crypto;
 
@@ -79,6 +80,25 @@ void findMyOutputs(
   }
 }
 
+// Transactions a worker takes at once, enough to make the claim cheap next to the key derivations
+const size_t TRANSACTIONS_PER_CHUNK = 4;
+
+// Transfers of confirmed transactions are created by the workers before the global indices are fetched
+std::error_code setGlobalIndices(const std::vector<uint32_t>& globalIdxs,
+  std::unordered_map<public_key_t, std::vector<TransactionOutputInformationIn>>& outputs) {
+  for (auto& kv : outputs) {
+    for (auto& transfer : kv.second) {
+      if (transfer.outputInTransaction >= globalIdxs.size()) {
+        return std::make_error_code(std::errc::bad_message);
+      }
+
+      transfer.globalOutputIndex = globalIdxs[transfer.outputInTransaction];
+    }
+  }
+
+  return std::error_code();
+}
+
 std::vector<crypto::hash_t> getBlockHashes(const cryptonote::CompleteBlock* blocks, size_t count) {
   std::vector<crypto::hash_t> result;
   result.reserve(count);
@@ -94,8 +114,9 @@ std::vector<crypto::hash_t> getBlockHashes(const cryptonote::CompleteBlock* bloc
 
 namespace cryptonote {
 
-TransfersConsumer::TransfersConsumer(const cryptonote::Currency& currency, INode& node, const secret_key_t& viewSecret) :
-  m_node(node), m_viewSecret(viewSecret), m_currency(currency) {
+TransfersConsumer::TransfersConsumer(const cryptonote::Currency& currency, INode& node, TransfersWorkerPool& workers,
+  const secret_key_t& viewSecret) :
+  m_node(node), m_workers(workers), m_viewSecret(viewSecret), m_currency(currency) {
   updateSyncStart();
 }
 
@@ -177,94 +198,86 @@ bool TransfersConsumer::onNewBlocks(const CompleteBlock* blocks, uint32_t startH
   assert(blocks);
   assert(count > 0);
 
-  struct Tx {
+  struct PreprocessedTx : PreprocessInfo {
     TransactionBlockInfo blockInfo;
     const ITransactionReader* tx;
+    std::unordered_map<public_key_t, std::vector<uint32_t>> myOutputs;
   };
 
-  struct PreprocessedTx : Tx, PreprocessInfo {};
-
+  // one slot per transaction in block order, each filled by whichever worker takes it
   std::vector<PreprocessedTx> preprocessedTransactions;
-  std::mutex preprocessedTransactionsMutex;
-
-  size_t workers = std::thread::hardware_concurrency();
-  if (workers == 0) {
-    workers = 2;
-  }
-
-  BlockingQueue<Tx> inputQueue(workers * 2);
-
-  std::atomic<bool> stopProcessing(false);
+  for (uint32_t i = 0; i < count; ++i) {
+    const auto& block = blocks[i].block;
 
-  auto pushingThread = std::async(std::launch::async, [&] {
-    for( uint32_t i = 0; i < count && !stopProcessing; ++i) {
-      const auto& block = blocks[i].block;
+    if (!block.is_initialized()) {
+      continue;
+    }
 
-      if (!block.is_initialized()) {
-        continue;
-      }
+    // filter by syncStartTimestamp
+    if (m_syncStart.timestamp && block->timestamp < m_syncStart.timestamp) {
+      continue;
+    }
 
-      // filter by syncStartTimestamp
-      if (m_syncStart.timestamp && block->timestamp < m_syncStart.timestamp) {
-        continue;
+    TransactionBlockInfo blockInfo;
+    blockInfo.height = startHeight + i;
+    blockInfo.timestamp = block->timestamp;
+    blockInfo.transactionIndex = 0; // position in block
+
+    for (const auto& tx : blocks[i].transactions) {
+      auto pubKey = tx->getTransactionPublicKey();
+      if (pubKey != NULL_PUBLIC_KEY) {
+        preprocessedTransactions.emplace_back();
+        preprocessedTransactions.back().blockInfo = blockInfo;
+        preprocessedTransactions.back().tx = tx.get();
       }
 
-      TransactionBlockInfo blockInfo;
-      blockInfo.height = startHeight + i;
-      blockInfo.timestamp = block->timestamp;
-      blockInfo.transactionIndex = 0; // position in block
-
-      for (const auto& tx : blocks[i].transactions) {
-        auto pubKey = tx->getTransactionPublicKey();
-        if (pubKey == NULL_PUBLIC_KEY) {
-          ++blockInfo.transactionIndex;
-          continue;
-        }
-
-        Tx item = { blockInfo, tx.get() };
-        inputQueue.push(item);
-        ++blockInfo.transactionIndex;
-      }
+      ++blockInfo.transactionIndex;
     }
+  }
 
-    inputQueue.close();
-  });
-
-  auto processingFunction = [&] {
-    Tx item;
-    std::error_code ec;
-    while (!stopProcessing && inputQueue.pop(item)) {
-      PreprocessedTx output;
-      static_cast<Tx&>(output) = item;
-
-      ec = preprocessOutputs(item.blockInfo, *item.tx, output);
-      if (ec) {
-        stopProcessing = true;
-        break;
+  std::error_code processingError;
+  try {
+    m_workers.forEach(preprocessedTransactions.size(), TRANSACTIONS_PER_CHUNK, [&](size_t index) {
+      PreprocessedTx& item = preprocessedTransactions[index];
+      findMyOutputs(*item.tx, m_viewSecret, m_spendKeys, item.myOutputs);
+      if (!item.myOutputs.empty()) {
+        std::error_code ec = preprocessOutputs(item.blockInfo, *item.tx, item.myOutputs, item);
+        if (ec) {
+          throw std::system_error(ec);
+        }
       }
+    });
+  } catch (const std::system_error& e) {
+    processingError = e.code();
+  } catch (const std::exception&) {
+    processingError = std::make_error_code(std::errc::operation_canceled);
+  }
 
-      std::lock_guard<std::mutex> lk(preprocessedTransactionsMutex);
-      preprocessedTransactions.push_back(std::move(output));
+  // the global indices of all the transactions with our outputs are fetched in a single request
+  std::vector<crypto::hash_t> ownTransactionHashes;
+  for (const auto& tx : preprocessedTransactions) {
+    if (!tx.myOutputs.empty()) {
+      ownTransactionHashes.push_back(tx.tx->getTransactionHash());
     }
-    return ec;
-  };
+  }
 
-  std::vector<std::future<std::error_code>> processingThreads;
-  for (size_t i = 0; i < workers; ++i) {
-    processingThreads.push_back(std::async(std::launch::async, processingFunction));
+  std::vector<std::vector<uint32_t>> globalIndices;
+  if (!processingError && !ownTransactionHashes.empty()) {
+    processingError = getGlobalIndices(ownTransactionHashes, globalIndices);
+    if (!processingError && globalIndices.size() != ownTransactionHashes.size()) {
+      processingError = std::make_error_code(std::errc::bad_message);
+    }
   }
 
-  std::error_code processingError;
-  for (auto& f : processingThreads) {
-    try {
-      std::error_code ec = f.get();
-      if (!processingError && ec) {
-        processingError = ec;
-      }
-    } catch (const std::system_error& e) {
-      processingError = e.code();
-    } catch (const std::exception&) {
-      processingError = std::make_error_code(std::errc::operation_canceled);
+  size_t ownTransactionIndex = 0;
+  for (auto& tx : preprocessedTransactions) {
+    if (processingError) {
+      break;
+    }
+
+    if (!tx.myOutputs.empty()) {
+      tx.globalIdxs = std::move(globalIndices[ownTransactionIndex++]);
+      processingError = setGlobalIndices(tx.globalIdxs, tx.outputs);
     }
   }
 
@@ -272,11 +285,6 @@ bool TransfersConsumer::onNewBlocks(const CompleteBlock* blocks, uint32_t startH
   if (!processingError) {
     m_observerManager.notify(&IBlockchainConsumerObserver::onBlocksAdded, this, blockHashes);
 
-    // sort by block height and transaction index in block
-    std::sort(preprocessedTransactions.begin(), preprocessedTransactions.end(), [](const PreprocessedTx& a, const PreprocessedTx& b) {
-      return std::tie(a.blockInfo.height, a.blockInfo.transactionIndex) < std::tie(b.blockInfo.height, b.blockInfo.transactionIndex);
-    });
-
     for (const auto& tx : preprocessedTransactions) {
       processTransaction(tx.blockInfo, *tx.tx, tx);
     }
@@ -354,7 +362,6 @@ std::error_code createTransfers(
   const TransactionBlockInfo& blockInfo,
   const ITransactionReader& tx,
   const std::vector<uint32_t>& outputs,
-  const std::vector<uint32_t>& globalIdxs,
   std::vector<TransactionOutputInformationIn>& transfers) {
 
   auto txPubKey = tx.getTransactionPublicKey();
@@ -378,8 +385,8 @@ std::error_code createTransfers(
     info.type = outType;
     info.transactionPublicKey = txPubKey;
     info.outputInTransaction = idx;
-    info.globalOutputIndex = (blockInfo.height == WALLET_UNCONFIRMED_TRANSACTION_HEIGHT) ?
-      UNCONFIRMED_TRANSACTION_GLOBAL_OUTPUT_INDEX : globalIdxs[idx];
+    // set by onNewBlocks for confirmed transactions
+    info.globalOutputIndex = UNCONFIRMED_TRANSACTION_GLOBAL_OUTPUT_INDEX;
 
     if (outType == TransactionTypes::output_type_t::Key) {
       uint64_t amount;
@@ -414,28 +421,14 @@ std::error_code createTransfers(
   return std::error_code();
 }
 
-std::error_code TransfersConsumer::preprocessOutputs(const TransactionBlockInfo& blockInfo, const ITransactionReader& tx, PreprocessInfo& info) {
-  std::unordered_map<public_key_t, std::vector<uint32_t>> outputs;
-  findMyOutputs(tx, m_viewSecret, m_spendKeys, outputs);
-
-  if (outputs.empty()) {
-    return std::error_code();
-  }
-
+std::error_code TransfersConsumer::preprocessOutputs(const TransactionBlockInfo& blockInfo, const ITransactionReader& tx,
+  const std::unordered_map<public_key_t, std::vector<uint32_t>>& outputs, PreprocessInfo& info) {
   std::error_code errorCode;
-  auto txHash = tx.getTransactionHash();
-  if (blockInfo.height != WALLET_UNCONFIRMED_TRANSACTION_HEIGHT) {
-    errorCode = getGlobalIndices(reinterpret_cast<const hash_t&>(txHash), info.globalIdxs);
-    if (errorCode) {
-      return errorCode;
-    }
-  }
-
   for (const auto& kv : outputs) {
     auto it = m_subscriptions.find(kv.first);
     if (it != m_subscriptions.end()) {
       auto& transfers = info.outputs[kv.first];
-      errorCode = createTransfers(it->second->getKeys(), blockInfo, tx, kv.second, info.globalIdxs, transfers);
+      errorCode = createTransfers(it->second->getKeys(), blockInfo, tx, kv.second, transfers);
       if (errorCode) {
         return errorCode;
       }
@@ -446,8 +439,13 @@ std::error_code TransfersConsumer::preprocessOutputs(const TransactionBlockInfo&
 }
 
 std::error_code TransfersConsumer::processTransaction(const TransactionBlockInfo& blockInfo, const ITransactionReader& tx) {
+  assert(blockInfo.height == WALLET_UNCONFIRMED_TRANSACTION_HEIGHT);
+
+  std::unordered_map<public_key_t, std::vector<uint32_t>> outputs;
+  findMyOutputs(tx, m_viewSecret, m_spendKeys, outputs);
+
   PreprocessInfo info;
-  auto ec = preprocessOutputs(blockInfo, tx, info);
+  auto ec = preprocessOutputs(blockInfo, tx, outputs, info);
   if (ec) {
     return ec;
   }
@@ -499,7 +497,8 @@ void TransfersConsumer::processOutputs(const TransactionBlockInfo& blockInfo, Tr
   }
 }
 
-std::error_code TransfersConsumer::getGlobalIndices(const hash_t& transactionHash, std::vector<uint32_t>& outsGlobalIndices) {  
+std::error_code TransfersConsumer::getGlobalIndices(const std::vector<hash_t>& transactionHashes,
+  std::vector<std::vector<uint32_t>>& outsGlobalIndices) {
   std::promise<std::error_code> prom;
   std::future<std::error_code> f = prom.get_future();
 
@@ -509,7 +508,7 @@ std::error_code TransfersConsumer::getGlobalIndices(const hash_t& transactionHas
   };
 
   outsGlobalIndices.clear();
-  m_node.getTransactionOutsGlobalIndices(transactionHash, outsGlobalIndices, cb);
+  m_node.getTransactionsOutsGlobalIndices(transactionHashes, outsGlobalIndices, cb);
 
   return f.get();
 }
@@ -18,11 +18,12 @@
 namespace cryptonote {
 
 class INode;
+class TransfersWorkerPool;
 
 class TransfersConsumer: public IObservableImpl<IBlockchainConsumerObserver, IBlockchainConsumer> {
 public:
 
-  TransfersConsumer(const cryptonote::Currency& currency, INode& node, const crypto::secret_key_t& viewSecret);
+  TransfersConsumer(const cryptonote::Currency& currency, INode& node, TransfersWorkerPool& workers, const crypto::secret_key_t& viewSecret);
 
   ITransfersSubscription& addSubscription(const AccountSubscription& subscription);
   // returns true if no subscribers left
@@ -56,13 +57,15 @@ private:
     std::vector<uint32_t> globalIdxs;
   };
 
-  std::error_code preprocessOutputs(const TransactionBlockInfo& blockInfo, const ITransactionReader& tx, PreprocessInfo& info);
+  // 'info.globalIdxs' must already hold the global indices of a transaction in a block
+  std::error_code preprocessOutputs(const TransactionBlockInfo& blockInfo, const ITransactionReader& tx,
+    const std::unordered_map<crypto::public_key_t, std::vector<uint32_t>>& outputs, PreprocessInfo& info);
   std::error_code processTransaction(const TransactionBlockInfo& blockInfo, const ITransactionReader& tx);
   void processTransaction(const TransactionBlockInfo& blockInfo, const ITransactionReader& tx, const PreprocessInfo& info);
   void processOutputs(const TransactionBlockInfo& blockInfo, TransfersSubscription& sub, const ITransactionReader& tx,
     const std::vector<TransactionOutputInformationIn>& outputs, const std::vector<uint32_t>& globalIdxs, bool& contains, bool& updated);
 
-  std::error_code getGlobalIndices(const crypto::hash_t& transactionHash, std::vector<uint32_t>& outsGlobalIndices);
+  std::error_code getGlobalIndices(const std::vector<crypto::hash_t>& transactionHashes, std::vector<std::vector<uint32_t>>& outsGlobalIndices);
 
   void updateSyncStart();
 
@@ -74,6 +77,7 @@ private:
   std::unordered_set<crypto::hash_t> m_poolTxs;
 
   INode& m_node;
+  TransfersWorkerPool& m_workers;
   const cryptonote::Currency& m_currency;
 };
 
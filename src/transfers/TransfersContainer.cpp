@@ -153,10 +153,32 @@ size_t SpentOutputDescriptor::hash() const {
 }
 
 
+namespace {
+  bool getBalanceTypeIndex(TransactionTypes::output_type_t type, size_t& index) {
+    switch (type) {
+    case TransactionTypes::output_type_t::Key:
+      index = 0;
+      return true;
+    case TransactionTypes::output_type_t::Multisignature:
+      index = 1;
+      return true;
+    default:
+      return false;
+    }
+  }
+
+  size_t getBalanceIndex(size_t typeIndex, uint32_t state) {
+    size_t stateIndex = state == ITransfersContainer::IncludeStateUnlocked ? 0 : state == ITransfersContainer::IncludeStateLocked ? 1 : 2;
+    return typeIndex * 3 + stateIndex;
+  }
+}
+
 TransfersContainer::TransfersContainer(const Currency& currency, size_t transactionSpendableAge) :
   m_currentHeight(0),
   m_currency(currency),
   m_transactionSpendableAge(transactionSpendableAge) {
+  m_availableBalance.fill(0);
+  m_unconfirmedBalance.fill(0);
 }
 
 bool TransfersContainer::addTransaction(const TransactionBlockInfo& block, const ITransactionReader& tx,
@@ -241,6 +263,7 @@ bool TransfersContainer::addTransactionOutputs(const TransactionBlockInfo& block
       auto result = m_unconfirmedTransfers.emplace(std::move(info));
       (void)result; // Disable unused warning
       assert(result.second);
+      updateUnconfirmedBalance(*result.first, true);
     } else {
       if (info.type == TransactionTypes::output_type_t::Multisignature) {
         SpentOutputDescriptor descriptor(transfer);
@@ -253,6 +276,7 @@ bool TransfersContainer::addTransactionOutputs(const TransactionBlockInfo& block
       auto result = m_availableTransfers.emplace(std::move(info));
       (void)result; // Disable unused warning
       assert(result.second);
+      addToBalance(*result.first);
     }
 
     if (info.type == TransactionTypes::output_type_t::Key) {
@@ -312,6 +336,7 @@ bool TransfersContainer::addTransactionInputs(const TransactionBlockInfo& block,
       assert(spendingTransferIt->keyImage == input.keyImage);
       copyToSpent(block, tx, i, *spendingTransferIt);
       // erase from available outputs
+      removeFromBalance(*spendingTransferIt);
       outputDescriptorIndex.erase(spendingTransferIt);
       updateTransfersVisibility(input.keyImage);
 
@@ -325,6 +350,7 @@ bool TransfersContainer::addTransactionInputs(const TransactionBlockInfo& block,
       if (availableOutputIt != outputDescriptorIndex.end()) {
         copyToSpent(block, tx, i, *availableOutputIt);
         // erase from available outputs
+        removeFromBalance(*availableOutputIt);
         outputDescriptorIndex.erase(availableOutputIt);
 
         inputsAdded = true;
@@ -399,6 +425,11 @@ bool TransfersContainer::markTransactionConfirmed(const TransactionBlockInfo& bl
     auto result = m_availableTransfers.emplace(std::move(transfer));
     (void)result; // Disable unused warning
     assert(result.second);
+    addToBalance(*result.first);
+
+    if (transferIt->visible) {
+      updateUnconfirmedBalance(*transferIt, false);
+    }
 
     transferIt = m_unconfirmedTransfers.get<ContainingTransactionIndex>().erase(transferIt);
 
@@ -432,6 +463,7 @@ void TransfersContainer::deleteTransactionTransfers(const hash_t& transactionHas
 
     auto result = m_availableTransfers.emplace(static_cast<const TransactionOutputInformationEx&>(*it));
     assert(result.second);
+    addToBalance(*result.first);
     it = spendingTransactionIndex.erase(it);
 
     if (result.first->type == TransactionTypes::output_type_t::Key) {
@@ -441,6 +473,10 @@ void TransfersContainer::deleteTransactionTransfers(const hash_t& transactionHas
 
   auto unconfirmedTransfersRange = m_unconfirmedTransfers.get<ContainingTransactionIndex>().equal_range(transactionHash);
   for (auto it = unconfirmedTransfersRange.first; it != unconfirmedTransfersRange.second;) {
+    if (it->visible) {
+      updateUnconfirmedBalance(*it, false);
+    }
+
     if (it->type == TransactionTypes::output_type_t::Key) {
       key_image_t keyImage = it->keyImage;
       it = m_unconfirmedTransfers.get<ContainingTransactionIndex>().erase(it);
@@ -453,6 +489,7 @@ void TransfersContainer::deleteTransactionTransfers(const hash_t& transactionHas
   auto& transactionTransfersIndex = m_availableTransfers.get<ContainingTransactionIndex>();
   auto transactionTransfersRange = transactionTransfersIndex.equal_range(transactionHash);
   for (auto it = transactionTransfersRange.first; it != transactionTransfersRange.second;) {
+    removeFromBalance(*it);
     if (it->type == TransactionTypes::output_type_t::Key) {
       key_image_t keyImage = it->keyImage;
     it = transactionTransfersIndex.erase(it);
@@ -518,17 +555,24 @@ std::vector<hash_t> TransfersContainer::detach(uint32_t height) {
 
   // TODO: notification on detach
   m_currentHeight = height == 0 ? 0 : height - 1;
+  // transfers can be locked again at the lower height
+  rebuildBalance();
 
   return deletedTransactions;
 }
 
 namespace {
-  template<typename C, typename T>
-  void updateVisibility(C& collection, const T& range, bool visible) {
+  template<typename C, typename T, typename F>
+  void updateVisibility(C& collection, const T& range, bool visible, F visibilityChanged) {
     for (auto it = range.first; it != range.second; ++it) {
+      if (it->visible == visible) {
+        continue;
+      }
+
       auto updated = *it;
       updated.visible = visible;
       collection.replace(it, updated);
+      visibilityChanged(*it);
     }
   }
 }
@@ -551,13 +595,25 @@ void TransfersContainer::updateTransfersVisibility(const key_image_t& keyImage)
   size_t spentCount = std::distance(spentRange.first, spentRange.second);
   assert(spentCount == 0 || spentCount == 1);
 
+  auto unconfirmedChanged = [this](const TransactionOutputInformationEx& transfer) {
+    updateUnconfirmedBalance(transfer, transfer.visible);
+  };
+
+  auto availableChanged = [this](const TransactionOutputInformationEx& transfer) {
+    if (transfer.visible) {
+      addToBalance(transfer);
+    } else {
+      removeFromBalance(transfer);
+    }
+  };
+
   if (spentCount > 0) {
-    updateVisibility(unconfirmedIndex, unconfirmedRange, false);
-    updateVisibility(availableIndex, availableRange, false);
-    updateVisibility(spentIndex, spentRange, true);
+    updateVisibility(unconfirmedIndex, unconfirmedRange, false, unconfirmedChanged);
+    updateVisibility(availableIndex, availableRange, false, availableChanged);
+    updateVisibility(spentIndex, spentRange, true, [](const SpentTransactionOutput&) {});
   } else if (availableCount > 0) {
-    updateVisibility(unconfirmedIndex, unconfirmedRange, false);
-    updateVisibility(availableIndex, availableRange, false);
+    updateVisibility(unconfirmedIndex, unconfirmedRange, false, unconfirmedChanged);
+    updateVisibility(availableIndex, availableRange, false, availableChanged);
 
     auto iteratorList = createTransferIteratorList(availableRange);
     auto earliestTransferIt = iteratorList.minElement();
@@ -566,8 +622,9 @@ void TransfersContainer::updateTransfersVisibility(const key_image_t& keyImage)
     auto earliestTransfer = *earliestTransferIt;
     earliestTransfer.visible = true;
     availableIndex.replace(earliestTransferIt, earliestTransfer);
+    addToBalance(*earliestTransferIt);
   } else {
-    updateVisibility(unconfirmedIndex, unconfirmedRange, unconfirmedCount == 1);
+    updateVisibility(unconfirmedIndex, unconfirmedRange, unconfirmedCount == 1, unconfirmedChanged);
   }
 }
 
@@ -594,19 +651,22 @@ size_t TransfersContainer::transactionsCount() const {
 
 uint64_t TransfersContainer::balance(uint32_t flags) const {
   std::lock_guard<std::mutex> lk(m_mutex);
-  uint64_t amount = 0;
+  updatePendingTransfers();
 
-  for (const auto& t : m_availableTransfers) {
-    if (t.visible && isIncluded(t, flags)) {
-      amount += t.amount;
+  uint64_t amount = 0;
+  const TransactionTypes::output_type_t types[] = { TransactionTypes::output_type_t::Key, TransactionTypes::output_type_t::Multisignature };
+  const uint32_t states[] = { IncludeStateUnlocked, IncludeStateLocked, IncludeStateSoftLocked };
+  for (auto type : types) {
+    size_t typeIndex;
+    getBalanceTypeIndex(type, typeIndex);
+    for (auto state : states) {
+      if (isIncluded(type, state, flags)) {
+        amount += m_availableBalance[getBalanceIndex(typeIndex, state)];
+      }
     }
-  }
 
-  if ((flags & IncludeStateLocked) != 0) {
-    for (const auto& t : m_unconfirmedTransfers) {
-      if (t.visible && isIncluded(t.type, IncludeStateLocked, flags)) {
-        amount += t.amount;
-      }
+    if (isIncluded(type, IncludeStateLocked, flags)) {
+      amount += m_unconfirmedBalance[typeIndex];
     }
   }
 
@@ -800,6 +860,114 @@ void TransfersContainer::load(std::istream& in) {
   m_unconfirmedTransfers = std::move(unconfirmedTransfers);
   m_availableTransfers = std::move(availableTransfers);
   m_spentTransfers = std::move(spentTransfers);
+  rebuildBalance();
+}
+
+/**
+ * \pre m_mutex is locked.
+ */
+void TransfersContainer::addToBalance(const TransactionOutputInformationEx& transfer) const {
+  size_t typeIndex;
+  if (!transfer.visible || !getBalanceTypeIndex(transfer.type, typeIndex)) {
+    return;
+  }
+
+  TransferBalanceState balanceState;
+  balanceState.state = getTransferState(transfer);
+  balanceState.pending = nullptr;
+  m_availableBalance[getBalanceIndex(typeIndex, balanceState.state)] += transfer.amount;
+
+  // the first height or time at which getTransferState() gives another state
+  if (balanceState.state == IncludeStateLocked) {
+    if (transfer.unlockTime < m_currency.maxBlockHeight()) {
+      balanceState.pending = &m_pendingByHeight;
+      balanceState.position = m_pendingByHeight.emplace(transfer.unlockTime - m_currency.lockedTxAllowedDeltaBlocks(), &transfer);
+    } else {
+      balanceState.pending = &m_pendingByTime;
+      balanceState.position = m_pendingByTime.emplace(transfer.unlockTime - m_currency.lockedTxAllowedDeltaSeconds(), &transfer);
+    }
+  } else if (balanceState.state == IncludeStateSoftLocked) {
+    balanceState.pending = &m_pendingByHeight;
+    balanceState.position = m_pendingByHeight.emplace(static_cast<uint64_t>(transfer.blockHeight) + m_transactionSpendableAge, &transfer);
+  }
+
+  auto result = m_balanceStates.emplace(&transfer, balanceState);
+  (void)result; // Disable unused warning
+  assert(result.second);
+}
+
+/**
+ * \pre m_mutex is locked.
+ */
+void TransfersContainer::removeFromBalance(const TransactionOutputInformationEx& transfer) const {
+  auto it = m_balanceStates.find(&transfer);
+  if (it == m_balanceStates.end()) {
+    return;
+  }
+
+  size_t typeIndex;
+  getBalanceTypeIndex(transfer.type, typeIndex);
+  m_availableBalance[getBalanceIndex(typeIndex, it->second.state)] -= transfer.amount;
+  if (it->second.pending != nullptr) {
+    it->second.pending->erase(it->second.position);
+  }
+
+  m_balanceStates.erase(it);
+}
+
+/**
+ * \pre m_mutex is locked.
+ */
+void TransfersContainer::updateUnconfirmedBalance(const TransactionOutputInformationEx& transfer, bool add) {
+  size_t typeIndex;
+  if (!getBalanceTypeIndex(transfer.type, typeIndex)) {
+    return;
+  }
+
+  if (add) {
+    m_unconfirmedBalance[typeIndex] += transfer.amount;
+  } else {
+    m_unconfirmedBalance[typeIndex] -= transfer.amount;
+  }
+}
+
+/**
+ * \pre m_mutex is locked.
+ */
+void TransfersContainer::updatePendingTransfers() const {
+  while (!m_pendingByHeight.empty() && m_pendingByHeight.begin()->first <= m_currentHeight) {
+    const TransactionOutputInformationEx& transfer = *m_pendingByHeight.begin()->second;
+    removeFromBalance(transfer);
+    addToBalance(transfer);
+  }
+
+  uint64_t now = static_cast<uint64_t>(time(NULL));
+  while (!m_pendingByTime.empty() && m_pendingByTime.begin()->first <= now) {
+    const TransactionOutputInformationEx& transfer = *m_pendingByTime.begin()->second;
+    removeFromBalance(transfer);
+    addToBalance(transfer);
+  }
+}
+
+/**
+ * \pre m_mutex is locked.
+ */
+void TransfersContainer::rebuildBalance() {
+  m_availableBalance.fill(0);
+  m_unconfirmedBalance.fill(0);
+  m_balanceStates.clear();
+  m_pendingByHeight.clear();
+  m_pendingByTime.clear();
+
+  for (const auto& transfer : m_availableTransfers) {
+    addToBalance(transfer);
+  }
+
+  for (const auto& transfer : m_unconfirmedTransfers) {
+    if (transfer.visible) {
+      updateUnconfirmedBalance(transfer, true);
+    }
+  }
 }
 
 bool TransfersContainer::isSpendTimeUnlocked(uint64_t unlockTime) const {
@@ -815,17 +983,18 @@ bool TransfersContainer::isSpendTimeUnlocked(uint64_t unlockTime) const {
   return false;
 }
 
-bool TransfersContainer::isIncluded(const TransactionOutputInformationEx& info, uint32_t flags) const {
-  uint32_t state;
+uint32_t TransfersContainer::getTransferState(const TransactionOutputInformationEx& info) const {
   if (info.blockHeight == WALLET_LEGACY_UNCONFIRMED_TRANSACTION_HEIGHT || !isSpendTimeUnlocked(info.unlockTime)) {
-    state = IncludeStateLocked;
+    return IncludeStateLocked;
   } else if (m_currentHeight < info.blockHeight + m_transactionSpendableAge) {
-    state = IncludeStateSoftLocked;
+    return IncludeStateSoftLocked;
   } else {
-    state = IncludeStateUnlocked;
+    return IncludeStateUnlocked;
   }
+}
 
-  return isIncluded(info.type, state, flags);
+bool TransfersContainer::isIncluded(const TransactionOutputInformationEx& info, uint32_t flags) const {
+  return isIncluded(info.type, getTransferState(info), flags);
 }
 
 bool TransfersContainer::isIncluded(TransactionTypes::output_type_t type, uint32_t state, uint32_t flags) {
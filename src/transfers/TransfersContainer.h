@@ -4,7 +4,9 @@
 
 #pragma once
 
+#include <array>
 #include <cstdint>
+#include <map>
 #include <unordered_map>
 #include <mutex>
 
@@ -254,12 +256,19 @@ private:
   bool addTransactionInputs(const TransactionBlockInfo& block, const ITransactionReader& tx);
   void deleteTransactionTransfers(const crypto::hash_t& transactionHash);
   bool isSpendTimeUnlocked(uint64_t unlockTime) const;
+  uint32_t getTransferState(const TransactionOutputInformationEx& info) const;
   bool isIncluded(const TransactionOutputInformationEx& info, uint32_t flags) const;
   static bool isIncluded(TransactionTypes::output_type_t type, uint32_t state, uint32_t flags);
   void updateTransfersVisibility(const crypto::key_image_t& keyImage);
 
   void copyToSpent(const TransactionBlockInfo& block, const ITransactionReader& tx, size_t inputIndex, const TransactionOutputInformationEx& output);
 
+  void addToBalance(const TransactionOutputInformationEx& transfer) const;
+  void removeFromBalance(const TransactionOutputInformationEx& transfer) const;
+  void updateUnconfirmedBalance(const TransactionOutputInformationEx& transfer, bool add);
+  void updatePendingTransfers() const;
+  void rebuildBalance();
+
 private:
   TransactionMultiIndex m_transactions;
   UnconfirmedTransfersMultiIndex m_unconfirmedTransfers;
@@ -267,6 +276,24 @@ private:
   SpentTransfersMultiIndex m_spentTransfers;
   //std::unordered_map<key_image_t, KeyOutputInfo, boost::hash<key_image_t>> m_keyImages;
 
+  // Running totals of the visible transfers by output type and state, so that balance() does not go through the
+  // transfers. A locked or soft locked transfer waits, ordered by the height or time at which its state changes, and
+  // is moved to its new total when balance() finds it due. The nodes of m_availableTransfers do not move, their
+  // addresses identify the transfers.
+  typedef std::multimap<uint64_t, const TransactionOutputInformationEx*> PendingTransfers;
+
+  struct TransferBalanceState {
+    uint32_t state;
+    PendingTransfers* pending;
+    PendingTransfers::iterator position;
+  };
+
+  mutable std::array<uint64_t, 6> m_availableBalance;  // by type and state
+  std::array<uint64_t, 2> m_unconfirmedBalance;  // by type, unconfirmed transfers are locked
+  mutable std::unordered_map<const TransactionOutputInformationEx*, TransferBalanceState> m_balanceStates;
+  mutable PendingTransfers m_pendingByHeight;
+  mutable PendingTransfers m_pendingByTime;
+
   uint32_t m_currentHeight; // current height is needed to check if a transfer is unlocked
   size_t m_transactionSpendableAge;
   const cryptonote::Currency& m_currency;
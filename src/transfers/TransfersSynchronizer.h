@@ -7,6 +7,7 @@
 #include "common/ObserverManager.h"
 #include "ITransfersSynchronizer.h"
 #include "IBlockchainSynchronizer.h"
+#include "TransfersWorkerPool.h"
 #include "TypeHelpers.h"
 
 #include <unordered_map>
@@ -44,6 +45,9 @@ public:
   virtual void load(std::istream& in) override;
 
 private:
+  // scans the blocks of every consumer, declared first to outlive them
+  TransfersWorkerPool m_workers;
+
   // map { view public key -> consumer }
   typedef std::unordered_map<crypto::public_key_t, std::unique_ptr<TransfersConsumer>> ConsumersContainer;
   ConsumersContainer m_consumers;
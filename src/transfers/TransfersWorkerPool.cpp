@@ -0,0 +1,111 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "TransfersWorkerPool.h"
+
+#include <algorithm>
+
+namespace cryptonote {
+
+TransfersWorkerPool::TransfersWorkerPool(size_t threadCount) :
+  m_job(nullptr), m_count(0), m_chunkSize(1), m_jobId(0), m_activeWorkers(0), m_stop(false), m_next(0), m_failed(false) {
+  for (size_t i = 1; i < threadCount; ++i) {
+    m_threads.emplace_back(&TransfersWorkerPool::workerThread, this);
+  }
+}
+
+TransfersWorkerPool::~TransfersWorkerPool() {
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+
+  m_jobReady.notify_all();
+  for (auto& thread : m_threads) {
+    thread.join();
+  }
+}
+
+void TransfersWorkerPool::forEach(size_t count, size_t chunkSize, const std::function<void(size_t)>& job) {
+  chunkSize = std::max<size_t>(chunkSize, 1);
+  if (m_threads.empty() || count <= chunkSize) {
+    for (size_t i = 0; i < count; ++i) {
+      job(i);
+    }
+
+    return;
+  }
+
+  std::lock_guard<std::mutex> jobLock(m_jobMutex);
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_job = &job;
+    m_count = count;
+    m_chunkSize = chunkSize;
+    m_next = 0;
+    m_failed = false;
+    m_error = nullptr;
+    m_activeWorkers = m_threads.size();
+    ++m_jobId;
+  }
+
+  m_jobReady.notify_all();
+  processJob();
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_jobDone.wait(lock, [this] { return m_activeWorkers == 0; });
+  m_job = nullptr;
+
+  if (m_error) {
+    std::exception_ptr error = m_error;
+    m_error = nullptr;
+    std::rethrow_exception(error);
+  }
+}
+
+void TransfersWorkerPool::workerThread() {
+  uint64_t processedJob = 0;
+  std::unique_lock<std::mutex> lock(m_mutex);
+  for (;;) {
+    m_jobReady.wait(lock, [&] { return m_stop || m_jobId != processedJob; });
+    if (m_stop) {
+      return;
+    }
+
+    processedJob = m_jobId;
+    lock.unlock();
+    processJob();
+    lock.lock();
+
+    if (--m_activeWorkers == 0) {
+      m_jobDone.notify_one();
+    }
+  }
+}
+
+void TransfersWorkerPool::processJob() {
+  const std::function<void(size_t)>& job = *m_job;
+  while (!m_failed) {
+    size_t begin = m_next.fetch_add(m_chunkSize);
+    if (begin >= m_count) {
+      break;
+    }
+
+    size_t end = std::min(begin + m_chunkSize, m_count);
+    try {
+      for (size_t i = begin; i < end; ++i) {
+        job(i);
+      }
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (!m_error) {
+        m_error = std::current_exception();
+      }
+
+      m_failed = true;
+    }
+  }
+}
+
+}
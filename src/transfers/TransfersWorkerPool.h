@@ -0,0 +1,56 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cryptonote {
+
+// Worker threads kept for the lifetime of a TransfersSyncronizer and shared by all its consumers. A job is a range of
+// indices; the workers and the calling thread claim chunks of it from a shared counter until none are left, so a
+// thread that finishes early keeps taking work from the others.
+class TransfersWorkerPool {
+public:
+  explicit TransfersWorkerPool(size_t threadCount = std::thread::hardware_concurrency());
+  ~TransfersWorkerPool();
+
+  TransfersWorkerPool(const TransfersWorkerPool&) = delete;
+  TransfersWorkerPool& operator=(const TransfersWorkerPool&) = delete;
+
+  // Calls 'job' for each index below 'count', returns when all calls are done. Once a call throws no further chunk is
+  // claimed and the first exception is rethrown. Concurrent calls run one after another.
+  void forEach(size_t count, size_t chunkSize, const std::function<void(size_t)>& job);
+
+private:
+  void workerThread();
+  void processJob();
+
+  std::vector<std::thread> m_threads;
+
+  // Serializes concurrent forEach() calls, the workers serve one job at a time
+  std::mutex m_jobMutex;
+
+  std::mutex m_mutex;
+  std::condition_variable m_jobReady;
+  std::condition_variable m_jobDone;
+  const std::function<void(size_t)>* m_job;
+  size_t m_count;
+  size_t m_chunkSize;
+  uint64_t m_jobId;
+  size_t m_activeWorkers;
+  bool m_stop;
+  std::exception_ptr m_error;
+
+  std::atomic<size_t> m_next;
+  std::atomic<bool> m_failed;
+};
+
+}
@@ -169,3 +169,22 @@ TEST_F(BlockTest, create)
   // ASSERT_TRUE(boost::filesystem::exists(c.blocksFileName()));
 
 } // namespace
+
+TEST_F(BlockTest, longHashesMatchLongHashOfEachNonce)
+{
+  LoggerManager logManager;
+  cryptonote::CurrencyBuilder currencyBuilder("./data", config::testnet::data, logManager);
+  block_t b = currencyBuilder.currency().genesisBlock();
+
+  const uint32_t nonces[] = {7, 0xffffffff, 12345, 0};
+  hash_t hashes[4];
+  ASSERT_TRUE(Block::getLongHashes(b, nonces, 4, hashes));
+
+  for (size_t i = 0; i < 4; ++i)
+  {
+    b.nonce = nonces[i];
+    hash_t h;
+    ASSERT_TRUE(Block::getLongHash(b, h));
+    ASSERT_EQ(h, hashes[i]);
+  }
+}
@@ -0,0 +1,200 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "gtest/gtest.h"
+
+#include <boost/filesystem.hpp>
+#include <logging/LoggerManager.h>
+#include "cryptonote/core/blockchain/serializer/basics.h"
+#include "cryptonote/core/blockchain/block.hpp"
+#include "cryptonote/structures/block_entry.h"
+#include "config/common.h"
+
+using namespace cryptonote;
+using namespace Logging;
+
+namespace
+{
+
+const std::string DATA_DIR = "./block_accessor_data";
+
+block_entry_t makeEntry(const Currency &currency, uint32_t height)
+{
+  block_entry_t entry = boost::value_initialized<block_entry_t>();
+  entry.bl = currency.genesisBlock();
+  entry.bl.timestamp = height;
+  entry.height = height;
+  entry.already_generated_coins = height * 1000;
+  return entry;
+}
+
+TEST(BlockAccessorTest, mappedReadsMatchStreamReads)
+{
+  LoggerManager logManager;
+  boost::filesystem::remove_all(DATA_DIR);
+
+  CurrencyBuilder mappedBuilder(DATA_DIR, config::testnet::data, logManager);
+  Currency mappedCurrency = mappedBuilder.blocksMemoryMapped(true).currency();
+  CurrencyBuilder streamBuilder(DATA_DIR, config::testnet::data, logManager);
+  Currency streamCurrency = streamBuilder.currency();
+
+  {
+    BlockAccessor<block_entry_t> writer(mappedCurrency);
+    ASSERT_TRUE(writer.init());
+    for (uint32_t i = 0; i < 10; ++i) {
+      writer.push_back(makeEntry(mappedCurrency, i));
+    }
+    writer.pop_back();
+    writer.push_back(makeEntry(mappedCurrency, 100));
+  }
+
+  BlockAccessor<block_entry_t> mapped(mappedCurrency);
+  BlockAccessor<block_entry_t> stream(streamCurrency);
+  ASSERT_TRUE(mapped.init());
+  ASSERT_TRUE(stream.init());
+  ASSERT_EQ(10, mapped.size());
+  ASSERT_EQ(10, stream.size());
+
+  for (uint64_t i = 0; i < mapped.size(); ++i) {
+    ASSERT_EQ(Block::getHash(stream[i].bl), Block::getHash(mapped[i].bl));
+    ASSERT_EQ(stream[i].already_generated_coins, mapped[i].already_generated_coins);
+  }
+  ASSERT_EQ(100, mapped.back().height);
+
+  // Items appended after mapping must be visible through a remapped view, load() bypasses the cache
+  mapped.push_back(makeEntry(mappedCurrency, 200));
+  block_entry_t appended;
+  mapped.load(10, appended);
+  ASSERT_EQ(200, appended.height);
+
+  BlockAccessor<block_entry_t> reopened(mappedCurrency);
+  ASSERT_TRUE(reopened.init());
+  ASSERT_EQ(11, reopened.size());
+  ASSERT_EQ(200, reopened.back().height);
+
+  boost::filesystem::remove_all(DATA_DIR);
+}
+
+TEST(BlockAccessorTest, indexIsCommittedInGroups)
+{
+  LoggerManager logManager;
+  boost::filesystem::remove_all(DATA_DIR);
+
+  CurrencyBuilder builder(DATA_DIR, config::testnet::data, logManager);
+  Currency currency = builder.blockIndexFlushInterval(4).currency();
+
+  uint64_t committed = 0;
+  {
+    BlockAccessor<block_entry_t> writer(currency);
+    ASSERT_TRUE(writer.init());
+    for (uint32_t i = 0; i < 3; ++i) {
+      writer.push_back(makeEntry(currency, i));
+    }
+    ASSERT_EQ(3, writer.size());
+    ASSERT_TRUE(std::file::read(currency.blockIndexesFileName(), reinterpret_cast<char*>(&committed), sizeof committed));
+    ASSERT_EQ(0, committed);
+
+    writer.push_back(makeEntry(currency, 3));
+    ASSERT_TRUE(std::file::read(currency.blockIndexesFileName(), reinterpret_cast<char*>(&committed), sizeof committed));
+    ASSERT_EQ(4, committed);
+
+    writer.push_back(makeEntry(currency, 4));
+  }
+
+  ASSERT_TRUE(std::file::read(currency.blockIndexesFileName(), reinterpret_cast<char*>(&committed), sizeof committed));
+  ASSERT_EQ(5, committed);
+
+  boost::filesystem::remove_all(DATA_DIR);
+}
+
+TEST(BlockAccessorTest, itemsFromGetOutliveTheCache)
+{
+  LoggerManager logManager;
+  boost::filesystem::remove_all(DATA_DIR);
+
+  CurrencyBuilder builder(DATA_DIR, config::testnet::data, logManager);
+  Currency currency = builder.currency();
+
+  {
+    BlockAccessor<block_entry_t> accessor(currency);
+    ASSERT_TRUE(accessor.init());
+    for (uint32_t i = 0; i < 5; ++i) {
+      accessor.push_back(makeEntry(currency, i));
+    }
+
+    std::shared_ptr<const block_entry_t> last = accessor.get(4);
+    accessor.pop_back();
+    accessor.push_back(makeEntry(currency, 100));
+
+    ASSERT_EQ(4, last->height);
+    ASSERT_EQ(100, accessor.get(4)->height);
+  }
+
+  boost::filesystem::remove_all(DATA_DIR);
+}
+
+TEST(BlockAccessorTest, recoveryDropsPartiallyWrittenItems)
+{
+  LoggerManager logManager;
+  boost::filesystem::remove_all(DATA_DIR);
+
+  CurrencyBuilder builder(DATA_DIR, config::testnet::data, logManager);
+  Currency currency = builder.currency();
+
+  {
+    BlockAccessor<block_entry_t> writer(currency);
+    ASSERT_TRUE(writer.init());
+    for (uint32_t i = 0; i < 5; ++i) {
+      writer.push_back(makeEntry(currency, i));
+    }
+  }
+
+  // Simulate a crash in the middle of writing the last block
+  uintmax_t blocksFileSize = boost::filesystem::file_size(currency.blocksFileName());
+  boost::filesystem::resize_file(currency.blocksFileName(), blocksFileSize - 1);
+
+  {
+    BlockAccessor<block_entry_t> reader(currency);
+    ASSERT_TRUE(reader.init());
+    ASSERT_EQ(4, reader.size());
+    ASSERT_EQ(3, reader.back().height);
+  }
+
+  uint64_t committed = 0;
+  ASSERT_TRUE(std::file::read(currency.blockIndexesFileName(), reinterpret_cast<char*>(&committed), sizeof committed));
+  ASSERT_EQ(4, committed);
+
+  boost::filesystem::remove_all(DATA_DIR);
+}
+
+TEST(BlockAccessorTest, mappedIndexRejectsOverflowingCount)
+{
+  LoggerManager logManager;
+  boost::filesystem::remove_all(DATA_DIR);
+
+  CurrencyBuilder builder(DATA_DIR, config::testnet::data, logManager);
+  Currency currency = builder.blocksMemoryMapped(true).currency();
+
+  {
+    BlockAccessor<block_entry_t> writer(currency);
+    ASSERT_TRUE(writer.init());
+    writer.push_back(makeEntry(currency, 0));
+  }
+
+  // count * sizeof(uint32_t) wraps around to a size the file has
+  uint64_t count = (uint64_t(1) << 62) + 1;
+  {
+    std::fstream index(currency.blockIndexesFileName(), std::ios::in | std::ios::out | std::ios::binary);
+    ASSERT_TRUE(static_cast<bool>(index.write(reinterpret_cast<char*>(&count), sizeof count)));
+  }
+
+  {
+    BlockAccessor<block_entry_t> reader(currency);
+    ASSERT_FALSE(reader.init());
+  }
+
+  boost::filesystem::remove_all(DATA_DIR);
+}
+
+} // namespace
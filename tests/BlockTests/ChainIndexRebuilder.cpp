@@ -0,0 +1,167 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "gtest/gtest.h"
+
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+#include <boost/filesystem.hpp>
+#include "cryptonote/core/blockchain/serializer/basics.h"
+#include "cryptonote/core/blockchain/indexing/chain_rebuild.h"
+#include "cryptonote/structures/array.hpp"
+
+using namespace cryptonote;
+
+namespace
+{
+
+const std::string SEQUENTIAL_DIR = "./chain_rebuild_sequential";
+const std::string PARALLEL_DIR = "./chain_rebuild_parallel";
+const char* STORE_FILES[] = {"blocks.dat", "keyimages.dat", "transactions.dat", "outputs.dat", "outputcounts.dat",
+  "msigoutputs.dat", "msigoutputcounts.dat"};
+
+// Blocks spending key images and multisignature outputs created earlier, often within the same shard
+std::vector<block_entry_t> makeChain(uint32_t height)
+{
+  std::mt19937 random(7);
+  std::vector<block_entry_t> blocks(height);
+  std::vector<uint32_t> multisignatureOutputs(4, 0);
+  for (uint32_t b = 0; b < height; ++b) {
+    block_entry_t &block = blocks[b];
+    block.bl = boost::value_initialized<block_t>();
+    block.bl.timestamp = b;
+    block.height = b;
+
+    block.transactions.resize(1 + random() % 3);
+    for (auto &entry : block.transactions) {
+      transaction_t &tx = entry.tx;
+      tx.version = 1;
+      tx.unlockTime = random();
+
+      for (uint32_t i = random() % 3; i > 0; --i) {
+        key_input_t input = boost::value_initialized<key_input_t>();
+        input.amount = 10 * (1 + random() % 5);
+        for (auto &byte : input.keyImage.data) {
+          byte = static_cast<uint8_t>(random());
+        }
+        tx.inputs.push_back(input);
+      }
+
+      uint64_t amount = random() % multisignatureOutputs.size();
+      if (multisignatureOutputs[amount] > 0 && random() % 4 == 0) {
+        multi_signature_input_t input = {amount, 1, static_cast<uint32_t>(random() % multisignatureOutputs[amount])};
+        tx.inputs.push_back(input);
+      }
+
+      for (uint32_t o = 1 + random() % 4; o > 0; --o) {
+        transaction_output_t output;
+        if (random() % 5 == 0) {
+          output.amount = random() % multisignatureOutputs.size();
+          output.target = multi_signature_output_t{{crypto::public_key_t()}, 1};
+          ++multisignatureOutputs[output.amount];
+        } else {
+          output.amount = 10 * (1 + random() % 5);
+          output.target = key_output_t{crypto::public_key_t()};
+        }
+        tx.outputs.push_back(output);
+      }
+    }
+  }
+
+  return blocks;
+}
+
+void rebuild(const std::vector<block_entry_t> &blocks, size_t threadCount, const std::string &directory)
+{
+  boost::filesystem::remove_all(directory);
+  ChainIndexStore store(1024 * 1024);
+  uint32_t height;
+  crypto::hash_t tailId;
+  ASSERT_TRUE(store.open(directory, height, tailId));
+
+  uint32_t expectedHeight = 0;
+  ChainIndexRebuilder rebuilder(threadCount);
+  rebuilder.run(0, static_cast<uint32_t>(blocks.size()), [&](uint32_t height, block_entry_t &block) {
+    block = blocks[height];
+  }, [&](const indexed_block_t &block) {
+    ASSERT_EQ(expectedHeight++, block.height);
+    ChainIndexRebuilder::apply(store, block);
+  });
+
+  ASSERT_EQ(blocks.size(), expectedHeight);
+  ASSERT_TRUE(store.commit(expectedHeight, Block::getHash(blocks.back().bl)));
+}
+
+std::string readFile(const std::string &filename)
+{
+  std::ifstream file(filename, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+TEST(ChainIndexRebuilderTest, parallelRebuildMatchesSequentialBitForBit)
+{
+  std::vector<block_entry_t> blocks = makeChain(3000);
+  rebuild(blocks, 1, SEQUENTIAL_DIR);
+  rebuild(blocks, 4, PARALLEL_DIR);
+
+  for (const char *name : STORE_FILES) {
+    std::string sequential = readFile((boost::filesystem::path(SEQUENTIAL_DIR) / name).string());
+    ASSERT_FALSE(sequential.empty());
+    ASSERT_TRUE(sequential == readFile((boost::filesystem::path(PARALLEL_DIR) / name).string())) << name;
+  }
+
+  ChainIndexStore store(1024 * 1024);
+  uint32_t height;
+  crypto::hash_t tailId;
+  ASSERT_TRUE(store.open(PARALLEL_DIR, height, tailId));
+  ASSERT_EQ(blocks.size(), height);
+
+  transaction_index_t transactionIndex;
+  ASSERT_TRUE(store.findTransaction(BinaryArray::objectHash(blocks[2999].transactions[0].tx), transactionIndex));
+  ASSERT_EQ(2999, transactionIndex.block);
+
+  store.close();
+  boost::filesystem::remove_all(SEQUENTIAL_DIR);
+  boost::filesystem::remove_all(PARALLEL_DIR);
+}
+
+TEST(ChainIndexRebuilderTest, loaderErrorStopsRebuild)
+{
+  std::vector<block_entry_t> blocks = makeChain(1000);
+  uint32_t merged = 0;
+  ChainIndexRebuilder rebuilder(4);
+  ASSERT_THROW(rebuilder.run(0, static_cast<uint32_t>(blocks.size()), [&](uint32_t height, block_entry_t &block) {
+    if (height == 700) {
+      throw std::runtime_error("unreadable block");
+    }
+    block = blocks[height];
+  }, [&](const indexed_block_t &block) {
+    ASSERT_EQ(merged++, block.height);
+  }), std::runtime_error);
+
+  // shards below the failing one are merged, nothing after it
+  ASSERT_GE(700, merged);
+}
+
+TEST(ChainIndexRebuilderTest, mergeErrorStopsRebuild)
+{
+  std::vector<block_entry_t> blocks = makeChain(1000);
+  uint32_t merged = 0;
+  ChainIndexRebuilder rebuilder(4);
+  ASSERT_THROW(rebuilder.run(0, static_cast<uint32_t>(blocks.size()), [&](uint32_t height, block_entry_t &block) {
+    block = blocks[height];
+  }, [&](const indexed_block_t &block) {
+    if (block.height == 300) {
+      throw std::runtime_error("store write failed");
+    }
+    ASSERT_EQ(merged++, block.height);
+  }), std::runtime_error);
+
+  // nothing is merged after the failing block
+  ASSERT_EQ(300, merged);
+}
+
+}
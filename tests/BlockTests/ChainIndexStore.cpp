@@ -0,0 +1,149 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "gtest/gtest.h"
+
+#include <boost/filesystem.hpp>
+#include "cryptonote/core/blockchain/indexing/chain_store.h"
+
+using namespace cryptonote;
+
+namespace
+{
+
+const std::string DATA_DIR = "./chain_index_store_data";
+
+crypto::hash_t makeHash(uint8_t seed)
+{
+  crypto::hash_t hash = NULL_HASH;
+  hash.data[0] = seed;
+  hash.data[31] = seed + 1;
+  return hash;
+}
+
+TEST(ChainIndexStoreTest, pushesAndPopsOutputs)
+{
+  boost::filesystem::remove_all(DATA_DIR);
+  ChainIndexStore store(1024 * 1024);
+  uint32_t height;
+  crypto::hash_t tailId;
+  ASSERT_TRUE(store.open(DATA_DIR, height, tailId));
+  ASSERT_EQ(0, height);
+
+  for (uint32_t i = 0; i < 1000; ++i) {
+    transaction_index_t transactionIndex = { i, 1 };
+    ASSERT_EQ(i, store.pushOutput(10, std::make_pair(transactionIndex, static_cast<uint16_t>(i % 7))));
+  }
+  transaction_index_t transactionIndex = { 5, 0 };
+  ASSERT_EQ(0, store.pushOutput(20, std::make_pair(transactionIndex, static_cast<uint16_t>(0))));
+
+  ASSERT_EQ(1000, store.outputCount(10));
+  ChainIndexStore::output_t output;
+  ASSERT_TRUE(store.getOutput(10, 999, output));
+  ASSERT_EQ(999, output.first.block);
+  ASSERT_EQ(999 % 7, output.second);
+  ASSERT_FALSE(store.getOutput(10, 1000, output));
+
+  ASSERT_TRUE(store.popOutput(20));
+  ASSERT_EQ(0, store.outputCount(20));
+  ASSERT_FALSE(store.popOutput(20));
+  ASSERT_EQ(std::vector<uint64_t>{10}, store.outputAmounts());
+
+  multisignature_output_usage_t usage = { transactionIndex, 3, false };
+  ASSERT_EQ(0, store.pushMultisignatureOutput(30, usage));
+  ASSERT_TRUE(store.setMultisignatureOutputUsed(30, 0, true));
+  ASSERT_FALSE(store.setMultisignatureOutputUsed(30, 1, true));
+  ASSERT_TRUE(store.getMultisignatureOutput(30, 0, usage));
+  ASSERT_TRUE(usage.isUsed);
+  ASSERT_EQ(3, usage.outputIndex);
+
+  store.close();
+  boost::filesystem::remove_all(DATA_DIR);
+}
+
+TEST(ChainIndexStoreTest, reopensAtCommittedHeight)
+{
+  boost::filesystem::remove_all(DATA_DIR);
+  {
+    ChainIndexStore store(1024 * 1024);
+    uint32_t height;
+    crypto::hash_t tailId;
+    ASSERT_TRUE(store.open(DATA_DIR, height, tailId));
+
+    for (uint8_t i = 0; i < 3; ++i) {
+      store.pushBlock(i, makeHash(i));
+      transaction_index_t transactionIndex = { i, 0 };
+      ASSERT_TRUE(store.addTransaction(makeHash(100 + i), transactionIndex));
+    }
+    ASSERT_FALSE(store.addTransaction(makeHash(100), { 7, 0 }));
+
+    crypto::key_image_t keyImage = boost::value_initialized<crypto::key_image_t>();
+    keyImage.data[0] = 1;
+    ASSERT_TRUE(store.addKeyImage(keyImage));
+    ASSERT_FALSE(store.addKeyImage(keyImage));
+    ASSERT_TRUE(store.commit(3, makeHash(2)));
+
+    // not committed, dropped on close
+    store.pushBlock(3, makeHash(3));
+    store.close();
+  }
+
+  ChainIndexStore store(1024 * 1024);
+  uint32_t height;
+  crypto::hash_t tailId;
+  ASSERT_TRUE(store.open(DATA_DIR, height, tailId));
+  ASSERT_EQ(3, height);
+  ASSERT_EQ(makeHash(2), tailId);
+
+  std::vector<crypto::hash_t> blockIds;
+  ASSERT_TRUE(store.getBlockIds(height, blockIds));
+  ASSERT_EQ(3, blockIds.size());
+  ASSERT_EQ(makeHash(1), blockIds[1]);
+  ASSERT_FALSE(store.getBlockIds(4, blockIds));
+
+  transaction_index_t transactionIndex;
+  ASSERT_TRUE(store.findTransaction(makeHash(101), transactionIndex));
+  ASSERT_EQ(1, transactionIndex.block);
+  ASSERT_EQ(3, store.transactionCount());
+
+  crypto::key_image_t keyImage = boost::value_initialized<crypto::key_image_t>();
+  keyImage.data[0] = 1;
+  ASSERT_TRUE(store.hasKeyImage(keyImage));
+
+  store.close();
+  boost::filesystem::remove_all(DATA_DIR);
+}
+
+TEST(ChainIndexStoreTest, refusesFilesCommittedAtDifferentHeights)
+{
+  boost::filesystem::remove_all(DATA_DIR);
+  {
+    ChainIndexStore store(1024 * 1024);
+    uint32_t height;
+    crypto::hash_t tailId;
+    ASSERT_TRUE(store.open(DATA_DIR, height, tailId));
+    store.pushBlock(0, makeHash(0));
+    ASSERT_TRUE(store.commit(1, makeHash(0)));
+    store.close();
+  }
+
+  // a crash between the commits of two files leaves them at different heights
+  boost::filesystem::remove(boost::filesystem::path(DATA_DIR) / "keyimages.dat");
+
+  ChainIndexStore store(1024 * 1024);
+  uint32_t height;
+  crypto::hash_t tailId;
+  ASSERT_FALSE(store.open(DATA_DIR, height, tailId));
+
+  store.clear();
+  ASSERT_TRUE(store.commit(0, NULL_HASH));
+  store.close();
+  ASSERT_TRUE(store.open(DATA_DIR, height, tailId));
+  ASSERT_EQ(0, height);
+
+  store.close();
+  boost::filesystem::remove_all(DATA_DIR);
+}
+
+}
@@ -0,0 +1,83 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "gtest/gtest.h"
+
+#include <boost/filesystem.hpp>
+#include "cryptonote/core/blockchain/serializer/indices_delta.h"
+#include "cryptonote/core/key.h"
+
+using namespace cryptonote;
+
+namespace
+{
+
+const std::string SNAPSHOT = "./indices_delta_test.dat";
+
+indices_delta_t makeDelta(uint32_t height, bool pushed)
+{
+  indices_delta_t delta;
+  delta.pushed = pushed;
+  delta.height = height;
+  delta.blockHash = NULL_HASH;
+  delta.blockHash.data[0] = static_cast<uint8_t>(height);
+  delta.previousBlockHash = NULL_HASH;
+  delta.timestamp = 1000 + height;
+  delta.transactionCount = height % 3 + 1;
+  for (uint32_t i = 0; i < height % 2; ++i) {
+    crypto::hash_t paymentId = NULL_HASH;
+    paymentId.data[1] = static_cast<uint8_t>(i);
+    delta.paymentIds.emplace_back(paymentId, delta.blockHash);
+  }
+  return delta;
+}
+
+TEST(IndicesDeltaLogTest, readsAppendedDeltasAndIgnoresTornTail)
+{
+  std::string filename = IndicesDeltaLog::filename(SNAPSHOT, 3);
+  ASSERT_EQ(SNAPSHOT + ".3.log", filename);
+
+  crypto::hash_t tailId = NULL_HASH;
+  tailId.data[5] = 1;
+  IndicesDeltaLog log;
+  ASSERT_TRUE(log.create(filename, 10, tailId));
+  for (uint32_t height = 10; height < 20; ++height) {
+    ASSERT_TRUE(log.append(makeDelta(height, true)));
+  }
+  ASSERT_TRUE(log.append(makeDelta(19, false)));
+  ASSERT_EQ(11, log.size());
+  log.close();
+
+  // a crash in the middle of the last record
+  boost::filesystem::resize_file(filename, boost::filesystem::file_size(filename) - 3);
+
+  uint32_t height;
+  crypto::hash_t logTailId;
+  std::vector<indices_delta_t> deltas;
+  ASSERT_TRUE(IndicesDeltaLog::read(filename, height, logTailId, deltas));
+  ASSERT_EQ(10, height);
+  ASSERT_EQ(tailId, logTailId);
+  ASSERT_EQ(10, deltas.size());
+  for (uint32_t i = 0; i < deltas.size(); ++i) {
+    indices_delta_t expected = makeDelta(10 + i, true);
+    ASSERT_TRUE(deltas[i].pushed);
+    ASSERT_EQ(expected.height, deltas[i].height);
+    ASSERT_EQ(expected.blockHash, deltas[i].blockHash);
+    ASSERT_EQ(expected.timestamp, deltas[i].timestamp);
+    ASSERT_EQ(expected.transactionCount, deltas[i].transactionCount);
+    ASSERT_EQ(expected.paymentIds, deltas[i].paymentIds);
+  }
+
+  // create starts over
+  ASSERT_TRUE(log.create(filename, 0, NULL_HASH));
+  log.close();
+  ASSERT_TRUE(IndicesDeltaLog::read(filename, height, logTailId, deltas));
+  ASSERT_EQ(0, height);
+  ASSERT_TRUE(deltas.empty());
+
+  boost::filesystem::remove(filename);
+  ASSERT_FALSE(IndicesDeltaLog::read(filename, height, logTailId, deltas));
+}
+
+}
@@ -0,0 +1,98 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "common/RecursiveSharedMutex.h"
+#include "crypto/hash.h"
+
+#include "PerformanceUtils.h"
+
+// Models wallet-sync queries running next to block import: a_readers threads each run a series of
+// read-only queries that hash a range of "blocks" under the read lock, while one thread keeps
+// appending blocks under the exclusive lock.
+template<typename Mutex, typename ReadLock, size_t a_readers>
+class lock_contention_test_base
+{
+public:
+  static const size_t loop_count = 10;
+  static const size_t readers = a_readers;
+  static const size_t queries_per_reader = 100;
+  static const size_t blocks_per_query = 200;
+  static const size_t pushed_blocks = 50;
+
+  bool init()
+  {
+    m_chain.resize(1000);
+    for (size_t i = 0; i < m_chain.size(); ++i)
+    {
+      crypto::cn_fast_hash(&i, sizeof i, m_chain[i]);
+    }
+
+    return true;
+  }
+
+  bool test()
+  {
+    std::vector<std::thread> threads;
+    for (size_t r = 0; r < readers; ++r)
+    {
+      threads.emplace_back([this] { read(); });
+    }
+
+    threads.emplace_back([this] { write(); });
+
+    for (auto& thread : threads)
+    {
+      thread.join();
+    }
+
+    return true;
+  }
+
+private:
+  void read()
+  {
+    reset_thread_affinity();
+    for (size_t q = 0; q < queries_per_reader; ++q)
+    {
+      ReadLock lock(m_mutex);
+      crypto::hash_t acc = m_chain.front();
+      size_t start = m_chain.size() - blocks_per_query;
+      for (size_t i = start; i < m_chain.size(); ++i)
+      {
+        crypto::cn_fast_hash(&m_chain[i], sizeof(acc), acc);
+      }
+    }
+  }
+
+  void write()
+  {
+    reset_thread_affinity();
+    for (size_t b = 0; b < pushed_blocks; ++b)
+    {
+      std::lock_guard<Mutex> lock(m_mutex);
+      crypto::hash_t h;
+      crypto::cn_fast_hash(&m_chain.back(), sizeof(h), h);
+      m_chain.push_back(h);
+    }
+  }
+
+  Mutex m_mutex;
+  std::vector<crypto::hash_t> m_chain;
+};
+
+template<size_t a_readers>
+class test_blockchain_exclusive_lock : public lock_contention_test_base<std::recursive_mutex, std::lock_guard<std::recursive_mutex>, a_readers>
+{
+};
+
+template<size_t a_readers>
+class test_blockchain_shared_lock : public lock_contention_test_base<Tools::RecursiveSharedMutex, Tools::SharedLockGuard<Tools::RecursiveSharedMutex>, a_readers>
+{
+};
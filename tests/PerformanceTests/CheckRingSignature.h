@@ -48,7 +48,9 @@ public:
   bool test()
   {
     const cryptonote::key_input_t& txin = boost::get<cryptonote::key_input_t>(m_tx.inputs[0]);
-    return crypto::check_ring_signature(m_tx_prefix_hash, txin.keyImage, this->m_public_key_ptrs, ring_size, m_tx.signatures[0].data());
+    crypto::ring_signature_batch_item_t item = { &m_tx_prefix_hash, &txin.keyImage, this->m_public_keys, ring_size, m_tx.signatures[0].data() };
+    size_t failed_index;
+    return crypto::check_ring_signatures(&item, 1, failed_index);
   }
 
 private:
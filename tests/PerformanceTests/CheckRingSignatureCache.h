@@ -0,0 +1,111 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "crypto/crypto.h"
+
+// Verifies rings whose decoys are drawn from a pool of outputs with a bias towards recent ones, as wallets pick them,
+// so that the same outputs turn up in many rings. Run with and without the public key cache, which is emptied before
+// each pass so that only the reuse within a pass counts.
+template<size_t a_ring_size, bool a_cached>
+class test_check_ring_signature_cache
+{
+public:
+  static const size_t loop_count = 5;
+  static const size_t ring_size = a_ring_size;
+  static const size_t ring_count = 500;
+  static const size_t output_count = 5000;
+
+  ~test_check_ring_signature_cache()
+  {
+    uint64_t hits;
+    uint64_t misses;
+    crypto::get_public_key_cache_stats(hits, misses);
+    hits -= m_hits;
+    misses -= m_misses;
+    if (hits + misses != 0)
+    {
+      std::cout << "  key cache hit rate: " << (100 * hits / (hits + misses)) << "% of " << hits + misses << " lookups\n";
+    }
+
+    crypto::set_public_key_cache_size(crypto::DEFAULT_PUBLIC_KEY_CACHE_SIZE);
+  }
+
+  bool init()
+  {
+    std::mt19937 generator(1);
+    std::uniform_real_distribution<double> uniform(0, 1);
+
+    std::vector<crypto::public_key_t> public_keys(output_count);
+    std::vector<crypto::secret_key_t> secret_keys(output_count);
+    for (size_t i = 0; i < output_count; ++i)
+    {
+      crypto::generate_keys(public_keys[i], secret_keys[i]);
+    }
+
+    m_rings.resize(ring_count);
+    for (ring& r : m_rings)
+    {
+      std::vector<size_t> members;
+      while (members.size() < ring_size)
+      {
+        // most decoys are among the latest outputs, at the end of the pool
+        size_t index = output_count - 1 - static_cast<size_t>(std::pow(uniform(generator), 4) * (output_count - 1));
+        if (std::find(members.begin(), members.end(), index) == members.end())
+        {
+          members.push_back(index);
+        }
+      }
+
+      std::sort(members.begin(), members.end());
+      size_t real = std::uniform_int_distribution<size_t>(0, ring_size - 1)(generator);
+      for (size_t i = 0; i < ring_size; ++i)
+      {
+        r.keys[i] = public_keys[members[i]];
+        r.key_ptrs[i] = &r.keys[i];
+      }
+
+      r.prefix_hash = crypto::rand<crypto::hash_t>();
+      crypto::generate_key_image(r.keys[real], secret_keys[members[real]], r.image);
+      crypto::generate_ring_signature(r.prefix_hash, r.image, r.key_ptrs, ring_size, secret_keys[members[real]], real, r.signatures);
+    }
+
+    crypto::get_public_key_cache_stats(m_hits, m_misses);
+    return true;
+  }
+
+  bool test()
+  {
+    crypto::set_public_key_cache_size(0);
+    crypto::set_public_key_cache_size(a_cached ? crypto::DEFAULT_PUBLIC_KEY_CACHE_SIZE : 0);
+    for (const ring& r : m_rings)
+    {
+      if (!crypto::check_ring_signature(r.prefix_hash, r.image, r.key_ptrs, ring_size, r.signatures))
+        return false;
+    }
+
+    return true;
+  }
+
+private:
+  struct ring
+  {
+    crypto::hash_t prefix_hash;
+    crypto::key_image_t image;
+    crypto::public_key_t keys[ring_size];
+    const crypto::public_key_t* key_ptrs[ring_size];
+    crypto::signature_t signatures[ring_size];
+  };
+
+  std::vector<ring> m_rings;
+  uint64_t m_hits = 0;
+  uint64_t m_misses = 0;
+};
@@ -4,6 +4,10 @@
 
 #pragma once
 
+#include <iostream>
+
+#include <boost/chrono.hpp>
+
 #include "common/StringTools.h"
 #include "crypto/crypto.h"
 #include "cryptonote/core/key.h"
@@ -43,3 +47,57 @@ private:
   data_t m_data;
   crypto::hash_t m_expected_hash;
 };
+
+// Hashes 'ways' nonces of the same input per call with cn_slow_hash_multi, the way a mining thread does, and
+// reports the hash rate of the width since the time per call alone hides it.
+template<size_t ways>
+class test_cn_slow_hash_multi {
+public:
+  static const size_t loop_count = 10;
+
+  test_cn_slow_hash_multi() : m_hashes(0), m_elapsed(0) {
+  }
+
+  ~test_cn_slow_hash_multi() {
+    if (m_elapsed.count() != 0) {
+      std::cout << "  " << ways << "-way: " << m_hashes * 1000000.0 / m_elapsed.count() << " hashes per second\n";
+    }
+  }
+
+  bool init() {
+    for (size_t i = 0; i < ways; ++i) {
+      for (size_t j = 0; j < sizeof(m_data[i]); ++j) {
+        m_data[i][j] = static_cast<uint8_t>(i * 31 + j);
+      }
+
+      m_inputs[i] = m_data[i];
+      crypto::cn_slow_hash(m_data[i], sizeof(m_data[i]), m_expected_hashes[i]);
+    }
+
+    return true;
+  }
+
+  bool test() {
+    crypto::hash_t hashes[ways];
+    boost::chrono::high_resolution_clock::time_point start = boost::chrono::high_resolution_clock::now();
+    crypto::cn_slow_hash_multi(m_inputs, sizeof(m_data[0]), hashes, ways);
+    m_elapsed += boost::chrono::duration_cast<boost::chrono::microseconds>(boost::chrono::high_resolution_clock::now() - start);
+    m_hashes += ways;
+
+    for (size_t i = 0; i < ways; ++i) {
+      if (hashes[i] != m_expected_hashes[i]) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+private:
+  // the size of a block hashing blob
+  uint8_t m_data[ways][76];
+  const void* m_inputs[ways];
+  crypto::hash_t m_expected_hashes[ways];
+  uint64_t m_hashes;
+  boost::chrono::microseconds m_elapsed;
+};
@@ -0,0 +1,187 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "common/JsonValue.h"
+#include "serialization/SerializationOverloads.h"
+#include "serialization/SerializationTools.h"
+
+// Shaped like a large payment gate getTransactions response: blocks of transactions with their transfers. The
+// '_value' tests go through a Common::JsonValue tree as loadFromJsonValue and storeToJsonValue do, the '_string'
+// tests read and write the text directly as loadFromJson and storeToJson do.
+namespace json_serialization_test
+{
+  struct transfer
+  {
+    std::string address;
+    int64_t amount;
+
+    void serialize(cryptonote::ISerializer& s)
+    {
+      s(address, "address");
+      s(amount, "amount");
+    }
+  };
+
+  struct transaction
+  {
+    std::string transactionHash;
+    uint32_t blockIndex;
+    uint64_t timestamp;
+    bool isBase;
+    uint64_t fee;
+    std::string extra;
+    std::vector<transfer> transfers;
+
+    void serialize(cryptonote::ISerializer& s)
+    {
+      s(transactionHash, "transactionHash");
+      s(blockIndex, "blockIndex");
+      s(timestamp, "timestamp");
+      s(isBase, "isBase");
+      s(fee, "fee");
+      s(extra, "extra");
+      s(transfers, "transfers");
+    }
+  };
+
+  struct block
+  {
+    std::string blockHash;
+    std::vector<transaction> transactions;
+
+    void serialize(cryptonote::ISerializer& s)
+    {
+      s(blockHash, "blockHash");
+      s(transactions, "transactions");
+    }
+  };
+
+  struct response
+  {
+    std::vector<block> items;
+
+    void serialize(cryptonote::ISerializer& s)
+    {
+      s(items, "items");
+    }
+  };
+
+  inline response make_response()
+  {
+    response r;
+    r.items.resize(100);
+    for (size_t b = 0; b < r.items.size(); ++b)
+    {
+      block& bl = r.items[b];
+      bl.blockHash = std::string(64, 'a' + b % 6);
+      bl.transactions.resize(20);
+      for (size_t t = 0; t < bl.transactions.size(); ++t)
+      {
+        transaction& tx = bl.transactions[t];
+        tx.transactionHash = std::string(64, 'b');
+        tx.blockIndex = static_cast<uint32_t>(b);
+        tx.timestamp = 1450000000 + b * 120;
+        tx.isBase = t == 0;
+        tx.fee = 1000000;
+        tx.extra = std::string(66, 'c');
+        tx.transfers.resize(4);
+        for (size_t i = 0; i < tx.transfers.size(); ++i)
+        {
+          tx.transfers[i].address = std::string(95, 'd');
+          tx.transfers[i].amount = static_cast<int64_t>(i * 123456789);
+        }
+      }
+    }
+
+    return r;
+  }
+}
+
+class test_json_store_value
+{
+public:
+  static const size_t loop_count = 20;
+
+  bool init()
+  {
+    m_response = json_serialization_test::make_response();
+    return true;
+  }
+
+  bool test()
+  {
+    return !cryptonote::storeToJsonValue(m_response).toString().empty();
+  }
+
+private:
+  json_serialization_test::response m_response;
+};
+
+class test_json_store_string
+{
+public:
+  static const size_t loop_count = 20;
+
+  bool init()
+  {
+    m_response = json_serialization_test::make_response();
+    return true;
+  }
+
+  bool test()
+  {
+    return !cryptonote::storeToJson(m_response).empty();
+  }
+
+private:
+  json_serialization_test::response m_response;
+};
+
+class test_json_load_value
+{
+public:
+  static const size_t loop_count = 20;
+
+  bool init()
+  {
+    m_json = cryptonote::storeToJson(json_serialization_test::make_response());
+    return true;
+  }
+
+  bool test()
+  {
+    json_serialization_test::response r;
+    cryptonote::loadFromJsonValue(r, Common::JsonValue::fromString(m_json));
+    return r.items.size() == 100;
+  }
+
+private:
+  std::string m_json;
+};
+
+class test_json_load_string
+{
+public:
+  static const size_t loop_count = 20;
+
+  bool init()
+  {
+    m_json = cryptonote::storeToJson(json_serialization_test::make_response());
+    return true;
+  }
+
+  bool test()
+  {
+    json_serialization_test::response r;
+    return cryptonote::loadFromJson(r, m_json) && r.items.size() == 100;
+  }
+
+private:
+  std::string m_json;
+};
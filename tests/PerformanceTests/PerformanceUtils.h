@@ -5,6 +5,7 @@
 #pragma once
 
 #include <iostream>
+#include <thread>
 
 #include <boost/config.hpp>
 
@@ -34,6 +35,23 @@ void set_process_affinity(int core)
 #endif
 }
 
+// Lets a worker thread of a multi-threaded test leave the core main() is pinned to
+void reset_thread_affinity()
+{
+#if defined(BOOST_HAS_PTHREADS) && !defined(__APPLE__)
+  cpu_set_t cpuset;
+  CPU_ZERO(&cpuset);
+  for (unsigned int core = 0; core < std::thread::hardware_concurrency(); ++core)
+  {
+    CPU_SET(core, &cpuset);
+  }
+  if (0 != ::pthread_setaffinity_np(::pthread_self(), sizeof(cpuset), &cpuset))
+  {
+    std::cout << "pthread_setaffinity_np - ERROR" << std::endl;
+  }
+#endif
+}
+
 void set_thread_high_priority()
 {
 #if defined(__APPLE__)
@@ -6,8 +6,10 @@
 #include "PerformanceUtils.h"
 
 // tests
+#include "BlockchainLockContention.h"
 #include "ConstructTransaction.h"
 #include "CheckRingSignature.h"
+#include "CheckRingSignatureCache.h"
 #include "CryptoNoteSlowHash.h"
 #include "DerivePublicKey.h"
 #include "DeriveSecretKey.h"
@@ -15,6 +17,7 @@
 #include "GenerateKeyImage.h"
 #include "GenerateKeyImageHelper.h"
 #include "IsOutToAccount.h"
+#include "JsonSerialization.h"
 
 int main(int argc, char** argv)
 {
@@ -49,6 +52,8 @@ int main(int argc, char** argv)
   TEST_PERFORMANCE1(test_check_ring_signature, 2);
   TEST_PERFORMANCE1(test_check_ring_signature, 10);
   TEST_PERFORMANCE1(test_check_ring_signature, 100);
+  TEST_PERFORMANCE2(test_check_ring_signature_cache, 10, false);
+  TEST_PERFORMANCE2(test_check_ring_signature_cache, 10, true);
 
   TEST_PERFORMANCE0(test_is_out_to_acc);
   TEST_PERFORMANCE0(test_generate_key_image_helper);
@@ -58,6 +63,22 @@ int main(int argc, char** argv)
   TEST_PERFORMANCE0(test_derive_secret_key);
 
   TEST_PERFORMANCE0(test_cn_slow_hash);
+  TEST_PERFORMANCE1(test_cn_slow_hash_multi, 1);
+  TEST_PERFORMANCE1(test_cn_slow_hash_multi, 2);
+  TEST_PERFORMANCE1(test_cn_slow_hash_multi, 3);
+  TEST_PERFORMANCE1(test_cn_slow_hash_multi, 4);
+
+  TEST_PERFORMANCE1(test_blockchain_exclusive_lock, 1);
+  TEST_PERFORMANCE1(test_blockchain_shared_lock, 1);
+  TEST_PERFORMANCE1(test_blockchain_exclusive_lock, 4);
+  TEST_PERFORMANCE1(test_blockchain_shared_lock, 4);
+  TEST_PERFORMANCE1(test_blockchain_exclusive_lock, 8);
+  TEST_PERFORMANCE1(test_blockchain_shared_lock, 8);
+
+  TEST_PERFORMANCE0(test_json_store_value);
+  TEST_PERFORMANCE0(test_json_store_string);
+  TEST_PERFORMANCE0(test_json_load_value);
+  TEST_PERFORMANCE0(test_json_load_string);
 
   std::cout << "Tests finished. Elapsed time: " << timer.elapsed_ms() / 1000 << " sec" << std::endl;
 
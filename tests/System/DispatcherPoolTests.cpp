@@ -0,0 +1,93 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <stdexcept>
+#include <thread>
+#include <system/ContextGroup.h>
+#include <system/Dispatcher.h>
+#include <system/DispatcherPool.h>
+#include <system/RemoteCall.h>
+#include <system/Timer.h>
+#include <gtest/gtest.h>
+
+using namespace System;
+
+TEST(DispatcherPoolTests, dispatchersRunOnTheirOwnThreads) {
+  Dispatcher dispatcher;
+  DispatcherPool pool(2);
+  ASSERT_EQ(2, pool.size());
+  ASSERT_EQ(nullptr, DispatcherPool::currentDispatcher());
+
+  Dispatcher& first = pool.nextDispatcher();
+  Dispatcher& second = pool.nextDispatcher();
+  ASSERT_NE(&first, &second);
+  ASSERT_EQ(&first, &pool.nextDispatcher());
+
+  std::thread::id firstThread = remoteCall<std::thread::id>(dispatcher, first, [&] {
+    EXPECT_EQ(&first, DispatcherPool::currentDispatcher());
+    return std::this_thread::get_id();
+  });
+
+  std::thread::id secondThread = remoteCall<std::thread::id>(dispatcher, second, [] { return std::this_thread::get_id(); });
+  ASSERT_NE(std::this_thread::get_id(), firstThread);
+  ASSERT_NE(firstThread, secondThread);
+}
+
+TEST(DispatcherPoolTests, remoteCallRethrows) {
+  Dispatcher dispatcher;
+  DispatcherPool pool(1);
+  ASSERT_THROW(remoteCall<void>(dispatcher, pool.nextDispatcher(), [] { throw std::runtime_error("failed"); }), std::runtime_error);
+}
+
+TEST(DispatcherPoolTests, callerDispatcherKeepsRunningAndServesCallsBack) {
+  Dispatcher dispatcher;
+  DispatcherPool pool(1);
+  Dispatcher& worker = pool.nextDispatcher();
+  ContextGroup contextGroup(dispatcher);
+  int ticks = 0;
+  bool finished = false;
+
+  contextGroup.spawn([&] {
+    while (!finished) {
+      ++ticks;
+      Timer(dispatcher).sleep(std::chrono::milliseconds(1));
+    }
+  });
+
+  contextGroup.spawn([&] {
+    int result = remoteCall<int>(dispatcher, worker, [&] {
+      Timer(worker).sleep(std::chrono::milliseconds(20));
+      // back on the caller's dispatcher, which is not blocked by the waiting context
+      return remoteCall<int>(worker, dispatcher, [&] { return ticks; });
+    });
+
+    finished = true;
+    ASSERT_LT(0, result);
+  });
+
+  contextGroup.wait();
+}
+
+TEST(DispatcherPoolTests, interruptIsDeliveredAfterTheCall) {
+  Dispatcher dispatcher;
+  DispatcherPool pool(1);
+  Dispatcher& worker = pool.nextDispatcher();
+  ContextGroup contextGroup(dispatcher);
+  bool called = false;
+  bool interrupted = false;
+
+  contextGroup.spawn([&] {
+    remoteCall<void>(dispatcher, worker, [&] {
+      Timer(worker).sleep(std::chrono::milliseconds(20));
+      called = true;
+    });
+
+    interrupted = dispatcher.interrupted();
+  });
+
+  contextGroup.interrupt();
+  contextGroup.wait();
+  ASSERT_TRUE(called);
+  ASSERT_TRUE(interrupted);
+}
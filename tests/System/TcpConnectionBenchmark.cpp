@@ -0,0 +1,92 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <vector>
+#include <system/ContextGroup.h>
+#include <system/Dispatcher.h>
+#include <system/Ipv4Address.h>
+#include <system/TcpConnection.h>
+#include <system/TcpConnector.h>
+#include <system/TcpListener.h>
+#include <gtest/gtest.h>
+
+using namespace System;
+
+namespace {
+
+const Ipv4Address LISTEN_ADDRESS("127.0.0.1");
+const uint16_t LISTEN_PORT = 6668;
+const size_t CONNECTION_COUNT = 32;
+const size_t ROUND_TRIP_COUNT = 2000;
+const size_t MESSAGE_SIZE = 64;
+
+void readStrict(TcpConnection& connection, uint8_t* data, size_t size) {
+  while (size > 0) {
+    size_t transferred = connection.read(data, size);
+    ASSERT_NE(0, transferred);
+    data += transferred;
+    size -= transferred;
+  }
+}
+
+void writeStrict(TcpConnection& connection, const uint8_t* data, size_t size) {
+  while (size > 0) {
+    size_t transferred = connection.write(data, size);
+    data += transferred;
+    size -= transferred;
+  }
+}
+
+}
+
+// Ping-pong over many connections on one dispatcher: every read waits for the peer, so the rate is bound by the
+// cost of a wait. Disabled by default, run it with --gtest_also_run_disabled_tests.
+TEST(TcpConnectionBenchmark, DISABLED_pingPongRoundTrips) {
+  Dispatcher dispatcher;
+  TcpListener listener(dispatcher, LISTEN_ADDRESS, LISTEN_PORT);
+  std::vector<TcpConnection> clients;
+  std::vector<TcpConnection> servers;
+  for (size_t i = 0; i < CONNECTION_COUNT; ++i) {
+    clients.emplace_back(TcpConnector(dispatcher).connect(LISTEN_ADDRESS, LISTEN_PORT));
+    servers.emplace_back(listener.accept());
+  }
+
+#ifdef __linux__
+  size_t controlCount = dispatcher.getEpollControlCount();
+#endif
+  auto start = std::chrono::steady_clock::now();
+  ContextGroup contextGroup(dispatcher);
+  for (size_t i = 0; i < CONNECTION_COUNT; ++i) {
+    contextGroup.spawn([&, i] {
+      uint8_t message[MESSAGE_SIZE];
+      for (size_t r = 0; r < ROUND_TRIP_COUNT; ++r) {
+        readStrict(servers[i], message, sizeof(message));
+        writeStrict(servers[i], message, sizeof(message));
+      }
+    });
+
+    contextGroup.spawn([&, i] {
+      uint8_t message[MESSAGE_SIZE];
+      for (size_t r = 0; r < ROUND_TRIP_COUNT; ++r) {
+        message[0] = static_cast<uint8_t>(r);
+        writeStrict(clients[i], message, sizeof(message));
+        readStrict(clients[i], message, sizeof(message));
+        ASSERT_EQ(static_cast<uint8_t>(r), message[0]);
+      }
+    });
+  }
+
+  contextGroup.wait();
+  auto duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+  size_t roundTrips = CONNECTION_COUNT * ROUND_TRIP_COUNT;
+  std::cout << roundTrips << " round trips over " << CONNECTION_COUNT << " connections in " <<
+    duration.count() / 1000 << " ms, " << roundTrips * 1000000 / std::max<int64_t>(1, duration.count()) <<
+    " round trips/s" << std::endl;
+#ifdef __linux__
+  std::cout << dispatcher.getEpollControlCount() - controlCount << " epoll_ctl calls" << std::endl;
+#endif
+}
@@ -262,6 +262,49 @@ TEST_F(TcpConnectionTests, sendBigChunk) {
   ASSERT_EQ(buf, incoming);
 }
 
+TEST_F(TcpConnectionTests, sendGatheredHeadAndBigChunk) {
+  connect();
+
+  std::vector<uint8_t> head(33);
+  fillRandomBuf(head);
+  const size_t bufsize = 15 * 1024 * 1024; // 15MB
+  std::vector<uint8_t> buf(bufsize);
+  fillRandomBuf(buf);
+
+  std::vector<uint8_t> incoming;
+  Event readComplete(dispatcher);
+
+  contextGroup.spawn([&]{
+    uint8_t readBuf[1024];
+    size_t readSize;
+    while ((readSize = connection2.read(readBuf, sizeof(readBuf))) > 0) {
+      incoming.insert(incoming.end(), readBuf, readBuf + readSize);
+    }
+
+    readComplete.set();
+  });
+
+  contextGroup.spawn([&]{
+    size_t written = 0;
+    while (written < head.size()) {
+      written += connection1.write(&head[written], head.size() - written, &buf[0], bufsize);
+    }
+
+    written -= head.size();
+    while (written < bufsize) {
+      written += connection1.write(&buf[written], bufsize - written);
+    }
+
+    connection1 = TcpConnection(); // close connection
+  });
+
+  readComplete.wait();
+
+  ASSERT_EQ(head.size() + bufsize, incoming.size());
+  ASSERT_TRUE(std::equal(head.begin(), head.end(), incoming.begin()));
+  ASSERT_TRUE(std::equal(buf.begin(), buf.end(), incoming.begin() + head.size()));
+}
+
 TEST_F(TcpConnectionTests, writeWhenReadWaiting) {
   connect();
 
@@ -311,6 +354,31 @@ TEST_F(TcpConnectionTests, writeWhenReadWaiting) {
   writeCompleted.wait();
 }
 
+#ifdef __linux__
+// Connections are registered with epoll once, waiting for data must not touch the registration
+TEST_F(TcpConnectionTests, waitingReadsDoNotCallEpollControl) {
+  connect();
+
+  size_t controlCount = dispatcher.getEpollControlCount();
+  contextGroup.spawn([&] {
+    uint8_t message = 0;
+    for (size_t i = 0; i < 100; ++i) {
+      ASSERT_EQ(1, connection2.read(&message, 1));
+      ASSERT_EQ(1, connection2.write(&message, 1));
+    }
+  });
+
+  uint8_t message = 0;
+  for (size_t i = 0; i < 100; ++i) {
+    ASSERT_EQ(1, connection1.write(&message, 1));
+    ASSERT_EQ(1, connection1.read(&message, 1));
+  }
+
+  contextGroup.wait();
+  ASSERT_EQ(controlCount, dispatcher.getEpollControlCount());
+}
+#endif
+
 TEST_F(TcpConnectionTests, sendBigChunkThruTcpStream) {
   connect();
   const size_t bufsize = 15 * 1024 * 1024; // 15MB
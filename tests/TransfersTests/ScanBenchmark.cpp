@@ -0,0 +1,99 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "Globals.h"
+#include "cryptonote/core/account.h"
+#include "cryptonote/core/TransactionApi.h"
+
+#include "NodeRpcProxy/NodeRpcProxy.h"
+#include "transfers/CommonTypes.h"
+#include "transfers/TransfersConsumer.h"
+#include "transfers/TransfersWorkerPool.h"
+
+#include <chrono>
+#include <iostream>
+
+using namespace cryptonote;
+
+namespace {
+
+const uint32_t BLOCK_COUNT = 200;
+const size_t TRANSACTIONS_PER_BLOCK = 20;
+const size_t OUTPUTS_PER_TRANSACTION = 2;
+const uint32_t ROUNDS = 3;
+
+account_keys_t generateAccountKeys() {
+  Account account;
+  account.generate();
+  return account.getAccountKeys();
+}
+
+// Blocks full of transactions paying someone else, which is what a wallet scans most of the time
+std::vector<CompleteBlock> makeBlocks() {
+  std::vector<CompleteBlock> blocks(BLOCK_COUNT);
+  for (auto& block : blocks) {
+    block.block = block_t();
+    block.block->timestamp = 1;
+
+    for (size_t i = 0; i < TRANSACTIONS_PER_BLOCK; ++i) {
+      std::shared_ptr<ITransaction> tx(createTransaction());
+      key_input_t input;
+      input.amount = 1000000;
+      input.keyImage = crypto::rand<crypto::key_image_t>();
+      input.outputIndexes.push_back(1);
+      tx->addInput(input);
+
+      for (size_t j = 0; j < OUTPUTS_PER_TRANSACTION; ++j) {
+        tx->addOutput(1000, generateAccountKeys().address);
+      }
+
+      block.transactions.push_back(tx);
+    }
+  }
+
+  return blocks;
+}
+
+// Blocks per second scanned by 'consumerCount' consumers sharing one worker pool, as in TransfersSyncronizer
+double measureBlocksPerSecond(const std::vector<CompleteBlock>& blocks, size_t consumerCount) {
+  // never initialized: the blocks hold none of our outputs, so the node is not asked for anything
+  NodeRpcProxy node("127.0.0.1", 0);
+  TransfersWorkerPool workers;
+
+  std::vector<std::unique_ptr<TransfersConsumer>> consumers;
+  for (size_t i = 0; i < consumerCount; ++i) {
+    AccountSubscription subscription;
+    subscription.keys = generateAccountKeys();
+    subscription.syncStart.height = 0;
+    subscription.syncStart.timestamp = 0;
+    subscription.transactionSpendableAge = 1;
+
+    consumers.emplace_back(new TransfersConsumer(currency, node, workers, subscription.keys.viewSecretKey));
+    consumers.back()->addSubscription(subscription);
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  for (uint32_t round = 0; round < ROUNDS; ++round) {
+    for (auto& consumer : consumers) {
+      EXPECT_TRUE(consumer->onNewBlocks(blocks.data(), round * BLOCK_COUNT, BLOCK_COUNT));
+    }
+  }
+
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  return ROUNDS * BLOCK_COUNT / elapsed.count();
+}
+
+}
+
+// Disabled by default, run it with --gtest_also_run_disabled_tests
+TEST(TransfersScanBenchmark, DISABLED_blocksPerSecond) {
+  std::vector<CompleteBlock> blocks = makeBlocks();
+
+  for (size_t consumerCount : { 1, 4 }) {
+    double blocksPerSecond = measureBlocksPerSecond(blocks, consumerCount);
+    std::cout << consumerCount << " consumer(s), " << TRANSACTIONS_PER_BLOCK << " transactions per block: " <<
+      static_cast<uint64_t>(blocksPerSecond) << " blocks/s" << std::endl;
+    ASSERT_LT(0, blocksPerSecond);
+  }
+}
@@ -0,0 +1,77 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "gtest/gtest.h"
+
+#include "cryptonote/core/BlockEntryCache.h"
+
+using namespace cryptonote;
+
+namespace {
+
+crypto::hash_t makeHash(uint8_t n) {
+  crypto::hash_t hash = {};
+  hash.data[0] = n;
+  return hash;
+}
+
+block_complete_entry_t makeEntry(size_t blockSize, size_t txSize) {
+  block_complete_entry_t entry;
+  entry.block.assign(blockSize, 'b');
+  entry.txs.push_back(std::string(txSize, 't'));
+  return entry;
+}
+
+}
+
+TEST(BlockEntryCache, getReturnsPutEntryAndCounts) {
+  BlockEntryCache cache(1000);
+  block_complete_entry_t entry;
+  ASSERT_FALSE(cache.get(makeHash(1), entry));
+
+  cache.put(makeHash(1), makeEntry(10, 20));
+  ASSERT_TRUE(cache.get(makeHash(1), entry));
+  ASSERT_EQ(10, entry.block.size());
+  ASSERT_EQ(1, entry.txs.size());
+  ASSERT_EQ(20, entry.txs[0].size());
+
+  ASSERT_EQ(1, cache.hits());
+  ASSERT_EQ(1, cache.misses());
+  ASSERT_EQ(30, cache.size());
+}
+
+TEST(BlockEntryCache, evictsLeastRecentlyUsed) {
+  BlockEntryCache cache(100);
+  cache.put(makeHash(1), makeEntry(20, 20));
+  cache.put(makeHash(2), makeEntry(20, 20));
+
+  block_complete_entry_t entry;
+  ASSERT_TRUE(cache.get(makeHash(1), entry));
+  cache.put(makeHash(3), makeEntry(20, 20));
+
+  ASSERT_EQ(80, cache.size());
+  ASSERT_TRUE(cache.get(makeHash(1), entry));
+  ASSERT_FALSE(cache.get(makeHash(2), entry));
+  ASSERT_TRUE(cache.get(makeHash(3), entry));
+}
+
+TEST(BlockEntryCache, skipsEntryLargerThanLimit) {
+  BlockEntryCache cache(100);
+  cache.put(makeHash(1), makeEntry(20, 20));
+  cache.put(makeHash(2), makeEntry(100, 1));
+
+  block_complete_entry_t entry;
+  ASSERT_TRUE(cache.get(makeHash(1), entry));
+  ASSERT_FALSE(cache.get(makeHash(2), entry));
+}
+
+TEST(BlockEntryCache, removeDropsEntry) {
+  BlockEntryCache cache(100);
+  cache.put(makeHash(1), makeEntry(20, 20));
+  cache.remove(makeHash(1));
+
+  block_complete_entry_t entry;
+  ASSERT_FALSE(cache.get(makeHash(1), entry));
+  ASSERT_EQ(0, cache.size());
+}
@@ -0,0 +1,130 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "gtest/gtest.h"
+
+#include <atomic>
+
+#include "cryptonote/protocol/BlockImportPipeline.h"
+#include "cryptonote/structures/array.hpp"
+#include "cryptonote/structures/block_entry.h"
+#include <logging/LoggerGroup.h>
+#include <common/os.h>
+
+using namespace cryptonote;
+
+namespace {
+
+block_complete_entry_t makeEntry(const block_t& block) {
+  block_complete_entry_t entry;
+  entry.block = BinaryArray::toString(BinaryArray::to(block));
+  return entry;
+}
+
+}
+
+TEST(BlockImportPipeline, preparesBlocksInOrder) {
+  Logging::LoggerGroup logger;
+  Currency currency = CurrencyBuilder(os::appdata::path(), config::testnet::data, logger).currency();
+
+  std::vector<block_complete_entry_t> entries;
+  std::vector<block_t> blocks;
+  for (uint32_t i = 0; i < 10; ++i) {
+    block_t block = currency.genesisBlock();
+    block.nonce = i;
+    blocks.push_back(block);
+    entries.push_back(makeEntry(block));
+  }
+
+  BlockImportPipeline pipeline(currency, BlockImportPipeline::KnownBlockPredicate(), BlockImportPipeline::PreparedCallback(), 4);
+  pipeline.start(entries);
+  ASSERT_EQ(entries.size(), pipeline.size());
+  for (size_t i = 0; i < pipeline.size(); ++i) {
+    prepared_block_t& prepared = pipeline.get(i);
+    ASSERT_TRUE(prepared.error.empty());
+    ASSERT_FALSE(prepared.known);
+    ASSERT_EQ(Block::getHash(blocks[i]), prepared.hash);
+
+    crypto::hash_t longHash;
+    ASSERT_TRUE(Block::getLongHash(blocks[i], longHash));
+    ASSERT_EQ(longHash, prepared.proofOfWork);
+  }
+}
+
+TEST(BlockImportPipeline, reportsUndecodableEntries) {
+  Logging::LoggerGroup logger;
+  Currency currency = CurrencyBuilder(os::appdata::path(), config::testnet::data, logger).currency();
+
+  std::vector<block_complete_entry_t> entries(2, makeEntry(currency.genesisBlock()));
+  entries[0].block.resize(entries[0].block.size() / 2);
+  entries[1].txs.push_back("garbage");
+
+  BlockImportPipeline pipeline(currency);
+  pipeline.start(entries);
+  ASSERT_FALSE(pipeline.get(0).error.empty());
+  ASSERT_FALSE(pipeline.get(1).error.empty());
+}
+
+TEST(BlockImportPipeline, stopsOnDestruction) {
+  Logging::LoggerGroup logger;
+  Currency currency = CurrencyBuilder(os::appdata::path(), config::testnet::data, logger).currency();
+
+  std::vector<block_complete_entry_t> entries(100, makeEntry(currency.genesisBlock()));
+  {
+    BlockImportPipeline pipeline(currency, BlockImportPipeline::KnownBlockPredicate(), BlockImportPipeline::PreparedCallback(), 2);
+    pipeline.start(entries);
+    ASSERT_TRUE(pipeline.get(0).error.empty());
+  }
+}
+
+TEST(BlockImportPipeline, preparesSeveralBatches) {
+  Logging::LoggerGroup logger;
+  Currency currency = CurrencyBuilder(os::appdata::path(), config::testnet::data, logger).currency();
+
+  std::atomic<size_t> prepared(0);
+  BlockImportPipeline pipeline(currency, BlockImportPipeline::KnownBlockPredicate(), [&prepared] { ++prepared; }, 2);
+  for (uint32_t batch = 0; batch < 3; ++batch) {
+    block_t block = currency.genesisBlock();
+    block.nonce = batch;
+    std::vector<block_complete_entry_t> entries(5, makeEntry(block));
+
+    pipeline.start(entries);
+    ASSERT_EQ(entries.size(), pipeline.size());
+    for (size_t i = 0; i < pipeline.size(); ++i) {
+      ASSERT_TRUE(pipeline.get(i).error.empty());
+      ASSERT_EQ(Block::getHash(block), pipeline.get(i).hash);
+    }
+
+    pipeline.finish();
+  }
+
+  ASSERT_EQ(15, prepared);
+}
+
+TEST(BlockImportPipeline, skipsProofOfWorkOfKnownBlocks) {
+  Logging::LoggerGroup logger;
+  Currency currency = CurrencyBuilder(os::appdata::path(), config::testnet::data, logger).currency();
+
+  block_t knownBlock = currency.genesisBlock();
+  block_t newBlock = currency.genesisBlock();
+  newBlock.nonce = 1;
+  crypto::hash_t knownHash = Block::getHash(knownBlock);
+
+  std::vector<block_complete_entry_t> entries { makeEntry(knownBlock), makeEntry(newBlock) };
+  BlockImportPipeline pipeline(currency, [&knownHash](const crypto::hash_t& hash) { return hash == knownHash; });
+  pipeline.start(entries);
+
+  const prepared_block_t& known = pipeline.get(0);
+  ASSERT_TRUE(known.error.empty());
+  ASSERT_TRUE(known.known);
+  ASSERT_EQ(knownHash, known.hash);
+  ASSERT_EQ(crypto::hash_t(), known.proofOfWork);
+
+  const prepared_block_t& prepared = pipeline.get(1);
+  ASSERT_TRUE(prepared.error.empty());
+  ASSERT_FALSE(prepared.known);
+  crypto::hash_t longHash;
+  ASSERT_TRUE(Block::getLongHash(newBlock, longHash));
+  ASSERT_EQ(longHash, prepared.proofOfWork);
+}
@@ -0,0 +1,95 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "gtest/gtest.h"
+
+#include "cryptonote/core/BlockTemplateCache.h"
+#include "cryptonote/core/TransactionExtra.h"
+
+using namespace cryptonote;
+
+namespace {
+
+const uint64_t MAX_POOL_CHANGES = 4;
+const uint64_t MAX_AGE = 10;
+
+crypto::hash_t makeHash(uint8_t n) {
+  crypto::hash_t hash = {};
+  hash.data[0] = n;
+  return hash;
+}
+
+account_public_address_t makeAddress(uint8_t n) {
+  account_public_address_t address = {};
+  address.spendPublicKey.data[0] = n;
+  return address;
+}
+
+block_t makeTemplate(const crypto::hash_t& previousBlockHash, const binary_array_t& extraNonce) {
+  block_t block = block_t();
+  block.previousBlockHash = previousBlockHash;
+  crypto::public_key_t txKey = {};
+  txKey.data[0] = 9;
+  addTransactionPublicKeyToExtra(block.baseTransaction.extra, txKey);
+  addExtraNonceToTransactionExtra(block.baseTransaction.extra, extraNonce);
+  // padding added to reach the expected coinbase size
+  block.baseTransaction.extra.insert(block.baseTransaction.extra.end(), 3, 0);
+  block.transactionHashes.push_back(makeHash(7));
+  return block;
+}
+
+}
+
+TEST(BlockTemplateCache, hitPatchesExtraNonce) {
+  BlockTemplateCache cache(MAX_POOL_CHANGES, MAX_AGE);
+  binary_array_t reserved(8, 0);
+  block_t block;
+  difficulty_t difficulty;
+  uint32_t height;
+  ASSERT_FALSE(cache.get(makeHash(1), 0, 100, makeAddress(1), reserved, block, difficulty, height));
+
+  block_t built = makeTemplate(makeHash(1), reserved);
+  cache.put(0, 100, makeAddress(1), reserved, built, 1000, 12);
+
+  binary_array_t extraNonce = {1, 2, 3, 4, 5, 6, 7, 8};
+  ASSERT_TRUE(cache.get(makeHash(1), 0, 101, makeAddress(1), extraNonce, block, difficulty, height));
+  ASSERT_EQ(1000, difficulty);
+  ASSERT_EQ(12, height);
+  ASSERT_EQ(built.transactionHashes, block.transactionHashes);
+  ASSERT_EQ(makeTemplate(makeHash(1), extraNonce).baseTransaction.extra, block.baseTransaction.extra);
+
+  ASSERT_EQ(1, cache.hits());
+  ASSERT_EQ(1, cache.misses());
+}
+
+TEST(BlockTemplateCache, newTipOrOtherRequestMisses) {
+  BlockTemplateCache cache(MAX_POOL_CHANGES, MAX_AGE);
+  binary_array_t reserved(8, 0);
+  cache.put(0, 100, makeAddress(1), reserved, makeTemplate(makeHash(1), reserved), 1000, 12);
+
+  block_t block;
+  difficulty_t difficulty;
+  uint32_t height;
+  ASSERT_FALSE(cache.get(makeHash(2), 0, 100, makeAddress(1), reserved, block, difficulty, height));
+  ASSERT_FALSE(cache.get(makeHash(1), 0, 100, makeAddress(2), reserved, block, difficulty, height));
+  ASSERT_FALSE(cache.get(makeHash(1), 0, 100, makeAddress(1), binary_array_t(4, 0), block, difficulty, height));
+  ASSERT_TRUE(cache.get(makeHash(1), 0, 100, makeAddress(1), reserved, block, difficulty, height));
+
+  cache.clear();
+  ASSERT_FALSE(cache.get(makeHash(1), 0, 100, makeAddress(1), reserved, block, difficulty, height));
+}
+
+TEST(BlockTemplateCache, poolChangesInvalidatePastThresholdOrAge) {
+  BlockTemplateCache cache(MAX_POOL_CHANGES, MAX_AGE);
+  binary_array_t extraNonce;
+  cache.put(10, 100, makeAddress(1), extraNonce, makeTemplate(makeHash(1), extraNonce), 1000, 12);
+
+  block_t block;
+  difficulty_t difficulty;
+  uint32_t height;
+  ASSERT_TRUE(cache.get(makeHash(1), 10, 100 + MAX_AGE, makeAddress(1), extraNonce, block, difficulty, height));
+  ASSERT_TRUE(cache.get(makeHash(1), 10 + MAX_POOL_CHANGES - 1, 100, makeAddress(1), extraNonce, block, difficulty, height));
+  ASSERT_FALSE(cache.get(makeHash(1), 10 + MAX_POOL_CHANGES, 100, makeAddress(1), extraNonce, block, difficulty, height));
+  ASSERT_FALSE(cache.get(makeHash(1), 11, 100 + MAX_AGE, makeAddress(1), extraNonce, block, difficulty, height));
+}
@@ -131,6 +131,14 @@ bool ICoreStub::getPoolChangesLite(const crypto::hash_t& tailBlockId, const std:
   return returnStatus;
 }
 
+bool ICoreStub::getPoolChangesSince(const crypto::hash_t& tailBlockId, uint64_t& sequence, bool& isFullResync,
+        std::vector<cryptonote::transaction_prefix_info_t>& addedTxs, std::vector<crypto::hash_t>& deletedTxsIds) {
+  // the stub keeps no change log, every call returns the whole pool
+  sequence = 1;
+  isFullResync = true;
+  return getPoolChangesLite(tailBlockId, std::vector<crypto::hash_t>(), addedTxs, deletedTxsIds);
+}
+
 void ICoreStub::getPoolChanges(const std::vector<crypto::hash_t>& knownTxsIds, std::vector<cryptonote::transaction_t>& addedTxs,
                                std::vector<crypto::hash_t>& deletedTxsIds) {
 }
@@ -33,6 +33,8 @@ public:
                               std::vector<cryptonote::transaction_t>& addedTxs, std::vector<crypto::hash_t>& deletedTxsIds) override;
   virtual bool getPoolChangesLite(const crypto::hash_t& tailBlockId, const std::vector<crypto::hash_t>& knownTxsIds,
           std::vector<cryptonote::transaction_prefix_info_t>& addedTxs, std::vector<crypto::hash_t>& deletedTxsIds) override;
+  virtual bool getPoolChangesSince(const crypto::hash_t& tailBlockId, uint64_t& sequence, bool& isFullResync,
+          std::vector<cryptonote::transaction_prefix_info_t>& addedTxs, std::vector<crypto::hash_t>& deletedTxsIds) override;
   virtual void getPoolChanges(const std::vector<crypto::hash_t>& knownTxsIds, std::vector<cryptonote::transaction_t>& addedTxs,
                               std::vector<crypto::hash_t>& deletedTxsIds) override;
   virtual bool queryBlocks(const std::vector<crypto::hash_t>& block_ids, uint64_t timestamp,
@@ -73,6 +75,7 @@ public:
   virtual bool getTransactionsByPaymentId(const crypto::hash_t& paymentId, std::vector<cryptonote::transaction_t>& transactions) override;
   virtual std::unique_ptr<cryptonote::IBlock> getBlock(const crypto::hash_t& blockId) override;
   virtual bool handleIncomingTransaction(const cryptonote::transaction_t& tx, const crypto::hash_t& txHash, size_t blobSize, cryptonote::tx_verification_context_t& tvc, bool keptByBlock) override;
+  virtual bool handleIncomingBlock(const cryptonote::block_t& block, const crypto::hash_t& proofOfWork, cryptonote::block_verification_context_t& bvc, bool controlMiner, bool relayBlock) override { return false; }
   virtual std::error_code executeLocked(const std::function<std::error_code()>& func) override;
 
   virtual bool addMessageQueue(cryptonote::MessageQueue<cryptonote::BlockchainMessage>& messageQueuePtr) override;
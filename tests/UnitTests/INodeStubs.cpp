@@ -51,6 +51,30 @@ bool INodeDummyStub::removeObserver(INodeObserver* observer) {
   return observerManager.remove(observer);
 }
 
+void INodeDummyStub::getTransactionsOutsGlobalIndices(const std::vector<crypto::hash_t>& transactionHashes,
+  std::vector<std::vector<uint32_t>>& outsGlobalIndices, const Callback& callback) {
+  outsGlobalIndices.clear();
+  outsGlobalIndices.resize(transactionHashes.size());
+  getTransactionsOutsGlobalIndicesFrom(0, transactionHashes, outsGlobalIndices, callback);
+}
+
+void INodeDummyStub::getTransactionsOutsGlobalIndicesFrom(size_t index, const std::vector<crypto::hash_t>& transactionHashes,
+  std::vector<std::vector<uint32_t>>& outsGlobalIndices, const Callback& callback) {
+  if (index == transactionHashes.size()) {
+    callback(std::error_code());
+    return;
+  }
+
+  getTransactionOutsGlobalIndices(transactionHashes[index], outsGlobalIndices[index],
+    [this, index, &transactionHashes, &outsGlobalIndices, callback](std::error_code ec) {
+    if (ec) {
+      callback(ec);
+    } else {
+      getTransactionsOutsGlobalIndicesFrom(index + 1, transactionHashes, outsGlobalIndices, callback);
+    }
+  });
+}
+
 void INodeTrivialRefreshStub::getNewBlocks(std::vector<crypto::hash_t>&& knownBlockIds, std::vector<block_complete_entry_t>& newBlocks, uint32_t& startHeight, const Callback& callback)
 {
   m_asyncCounter.addAsyncContext();
@@ -36,10 +36,16 @@ public:
   virtual void relayTransaction(const cryptonote::transaction_t& transaction, const Callback& callback) override { callback(std::error_code()); };
   virtual void getRandomOutsByAmounts(std::vector<uint64_t>&& amounts, uint64_t outsCount, std::vector<cryptonote::COMMAND_RPC_GET_RANDOM_OUTPUTS_FOR_AMOUNTS::outs_for_amount>& result, const Callback& callback) override { callback(std::error_code()); };
   virtual void getTransactionOutsGlobalIndices(const crypto::hash_t& transactionHash, std::vector<uint32_t>& outsGlobalIndices, const Callback& callback) override { callback(std::error_code()); };
+  // Asks getTransactionOutsGlobalIndices for one transaction after another
+  virtual void getTransactionsOutsGlobalIndices(const std::vector<crypto::hash_t>& transactionHashes, std::vector<std::vector<uint32_t>>& outsGlobalIndices, const Callback& callback) override;
   virtual void getPoolSymmetricDifference(std::vector<crypto::hash_t>&& known_pool_tx_ids, crypto::hash_t known_block_id, bool& is_bc_actual,
           std::vector<std::unique_ptr<cryptonote::ITransactionReader>>& new_txs, std::vector<crypto::hash_t>& deleted_tx_ids, const Callback& callback) override {
     is_bc_actual = true; callback(std::error_code());
   };
+  virtual void getPoolChangesSince(uint64_t& sequence, crypto::hash_t known_block_id, bool& is_bc_actual, bool& is_full_resync,
+          std::vector<std::unique_ptr<cryptonote::ITransactionReader>>& new_txs, std::vector<crypto::hash_t>& deleted_tx_ids, const Callback& callback) override {
+    is_bc_actual = true; is_full_resync = false; callback(std::error_code());
+  };
   virtual void queryBlocks(std::vector<crypto::hash_t>&& knownBlockIds, uint64_t timestamp, std::vector<cryptonote::BlockShortEntry>& newBlocks,
           uint32_t& startHeight, const Callback& callback) override { callback(std::error_code()); };
 
@@ -56,6 +62,10 @@ public:
 
   Tools::ObserverManager<cryptonote::INodeObserver> observerManager;
 
+private:
+  void getTransactionsOutsGlobalIndicesFrom(size_t index, const std::vector<crypto::hash_t>& transactionHashes,
+    std::vector<std::vector<uint32_t>>& outsGlobalIndices, const Callback& callback);
+
 };
 
 class INodeTrivialRefreshStub : public INodeDummyStub {
@@ -0,0 +1,132 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "gtest/gtest.h"
+
+#include <array>
+#include <limits>
+
+#include "serialization/SerializationOverloads.h"
+#include "serialization/SerializationTools.h"
+
+using namespace cryptonote;
+
+namespace {
+
+struct Item {
+  std::string name;
+  int32_t delta;
+  std::array<uint8_t, 4> blob;
+
+  bool operator==(const Item& other) const {
+    return name == other.name && delta == other.delta && blob == other.blob;
+  }
+
+  void serialize(ISerializer& s) {
+    s(name, "name");
+    s(delta, "delta");
+    s.binary(blob.data(), blob.size(), "blob");
+  }
+};
+
+struct Message {
+  uint8_t u8;
+  uint64_t u64;
+  bool flag;
+  double ratio;
+  std::string text;
+  std::vector<Item> items;
+  std::vector<std::vector<uint32_t>> rows;
+
+  bool operator==(const Message& other) const {
+    return u8 == other.u8 && u64 == other.u64 && flag == other.flag && ratio == other.ratio && text == other.text &&
+      items == other.items && rows == other.rows;
+  }
+
+  void serialize(ISerializer& s) {
+    s(u8, "u8");
+    s(u64, "u64");
+    s(flag, "flag");
+    s(ratio, "ratio");
+    s(text, "text");
+    s(items, "items");
+    s(rows, "rows");
+  }
+};
+
+Message makeMessage() {
+  Message message;
+  message.u8 = 200;
+  message.u64 = std::numeric_limits<uint64_t>::max();
+  message.flag = true;
+  message.ratio = 0.5;
+  message.text = "quote \" backslash \\ newline \n tab \t control \x01 utf8 \xc3\xa9";
+  message.items.push_back({"first", -5, {{1, 2, 3, 4}}});
+  message.items.push_back({"", 7, {{0xde, 0xad, 0xbe, 0xef}}});
+  message.rows = {{1, 2}, {}, {3}};
+  return message;
+}
+
+}
+
+TEST(JsonStringSerializer, roundTrip) {
+  Message message = makeMessage();
+  std::string json = storeToJson(message);
+
+  Message loaded;
+  ASSERT_TRUE(loadFromJson(loaded, json));
+  ASSERT_EQ(message, loaded);
+}
+
+TEST(JsonStringSerializer, writesValidJsonInSerializationOrder) {
+  Item item = {"a\"b", -1, {{0, 1, 0xab, 0xff}}};
+  ASSERT_EQ("{\"name\":\"a\\\"b\",\"delta\":-1,\"blob\":\"0001abff\"}", storeToJson(item));
+
+  Common::JsonValue value = Common::JsonValue::fromString(storeToJson(makeMessage()));
+  ASSERT_EQ(2, value("items").size());
+  ASSERT_EQ(3, value("rows").size());
+}
+
+TEST(JsonStringSerializer, readsMembersInAnyOrderAndSkipsUnknownOnes) {
+  std::string json = " { \"unknown\" : {\"name\": [1, {\"x\": null}]}, \"delta\":\t42,\r\n\"name\" : \"\\u00e9\\ud83d\\ude00\\/\", "
+    "\"blob\": \"00ff00ff\" } ";
+
+  Item item = {"old", 0, {}};
+  ASSERT_TRUE(loadFromJson(item, json));
+  ASSERT_EQ("\xc3\xa9\xf0\x9f\x98\x80/", item.name);
+  ASSERT_EQ(42, item.delta);
+  ASSERT_EQ((std::array<uint8_t, 4>{{0, 0xff, 0, 0xff}}), item.blob);
+}
+
+TEST(JsonStringSerializer, missingAndNullMembersKeepTheirValue) {
+  Item item = {"old", 3, {{1, 1, 1, 1}}};
+  ASSERT_TRUE(loadFromJson(item, "{\"name\":null}"));
+  ASSERT_EQ("old", item.name);
+  ASSERT_EQ(3, item.delta);
+}
+
+TEST(JsonStringSerializer, rejectsMalformedText) {
+  Item item;
+  ASSERT_FALSE(loadFromJson(item, "{\"name\":\"x\""));
+  ASSERT_FALSE(loadFromJson(item, "{\"name\" \"x\"}"));
+  ASSERT_FALSE(loadFromJson(item, "{\"delta\":01}"));
+  ASSERT_FALSE(loadFromJson(item, "{\"delta\":1} x"));
+  ASSERT_FALSE(loadFromJson(item, "[1]"));
+  ASSERT_FALSE(loadFromJson(item, "{\"delta\":\"1\"}"));
+  ASSERT_FALSE(loadFromJson(item, std::string(1000, '[')));
+}
+
+TEST(JsonStringSerializer, tokensGiveRawValues) {
+  JsonTokens tokens("{\"id\": \"7\", \"params\": {\"a\": [1, 2]}, \"n\": -12}");
+  size_t id = tokens.find(0, "id");
+  ASSERT_NE(JsonTokens::npos, id);
+  ASSERT_EQ("\"7\"", std::string(tokens.getRaw(id)));
+
+  size_t params = tokens.find(0, "params");
+  ASSERT_EQ(JsonTokens::OBJECT, tokens.getType(params));
+  ASSERT_EQ("{\"a\": [1, 2]}", std::string(tokens.getRaw(params)));
+  ASSERT_EQ(-12, tokens.getInteger(tokens.find(0, "n")));
+  ASSERT_EQ(JsonTokens::npos, tokens.find(0, "a"));
+  ASSERT_EQ(JsonTokens::npos, tokens.find(params + 2, "a"));
+}
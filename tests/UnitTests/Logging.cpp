@@ -0,0 +1,117 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "gtest/gtest.h"
+
+#include <fstream>
+#include <boost/filesystem.hpp>
+
+#include "logging/CommonLogger.h"
+#include "logging/LoggerGroup.h"
+#include "logging/LoggerManager.h"
+#include "logging/LoggerRef.h"
+
+using namespace Logging;
+
+namespace {
+
+class LoggerStub : public CommonLogger {
+public:
+  LoggerStub(Level level) : CommonLogger(level) {
+    setPattern("");
+  }
+
+  std::vector<std::string> messages;
+
+protected:
+  virtual void doLogString(const std::string& message) override {
+    messages.push_back(message);
+  }
+};
+
+}
+
+TEST(Logging, disabledMessageIsNotFormatted) {
+  LoggerStub stub(INFO);
+  stub.disableCategory("off");
+  LoggerRef logger(stub, "test");
+  LoggerRef disabled(stub, "off");
+  ASSERT_FALSE(logger.isEnabled(DEBUGGING));
+  ASSERT_FALSE(disabled.isEnabled(ERROR));
+  ASSERT_TRUE(logger.isEnabled(INFO));
+
+  ASSERT_TRUE((logger(DEBUGGING) << "hidden " << 1).bad());
+  ASSERT_TRUE((disabled(ERROR) << "hidden " << 2 << std::endl).bad());
+  ASSERT_TRUE(stub.messages.empty());
+
+  logger(INFO) << "shown " << 5;
+  ASSERT_EQ(1, stub.messages.size());
+  ASSERT_EQ(DEFAULT + "shown 5\n", stub.messages[0]);
+}
+
+TEST(Logging, groupIsEnabledIfOneOfItsLoggersIs) {
+  LoggerStub quiet(ERROR);
+  LoggerStub verbose(TRACE);
+  LoggerGroup group(DEBUGGING);
+  ASSERT_FALSE(group.isEnabled("test", ERROR));
+
+  group.addLogger(quiet);
+  ASSERT_FALSE(group.isEnabled("test", INFO));
+  group.addLogger(verbose);
+  ASSERT_TRUE(group.isEnabled("test", INFO));
+  ASSERT_FALSE(group.isEnabled("test", TRACE));
+}
+
+TEST(Logging, nestedMessagesKeepTheirText) {
+  LoggerStub stub(TRACE);
+  LoggerRef logger(stub, "test");
+
+  {
+    LoggerMessage outer = logger(INFO);
+    outer << "outer ";
+    logger(INFO) << "inner";
+    outer << "end";
+  }
+
+  ASSERT_EQ(2, stub.messages.size());
+  ASSERT_EQ(DEFAULT + "inner\n", stub.messages[0]);
+  ASSERT_EQ(DEFAULT + "outer end\n", stub.messages[1]);
+}
+
+TEST(Logging, asyncManagerWritesEverythingBeforeDestruction) {
+  boost::filesystem::path path = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+
+  {
+    Common::JsonValue configuration(Common::JsonValue::OBJECT);
+    configuration.insert("globalLevel", static_cast<int64_t>(INFO));
+    configuration.insert("async", Common::JsonValue(true));
+    Common::JsonValue& loggers = configuration.insert("loggers", Common::JsonValue::ARRAY);
+    Common::JsonValue& fileLogger = loggers.pushBack(Common::JsonValue::OBJECT);
+    fileLogger.insert("type", "file");
+    fileLogger.insert("filename", path.string());
+    fileLogger.insert("level", static_cast<int64_t>(TRACE));
+    fileLogger.insert("pattern", "");
+
+    LoggerManager manager;
+    manager.configure(configuration);
+    LoggerRef logger(manager, "test");
+    ASSERT_FALSE(manager.isEnabled("test", DEBUGGING));
+    for (int i = 0; i < 10000; ++i) {
+      logger(INFO) << "line " << i;
+      logger(DEBUGGING) << "hidden " << i;
+    }
+  }
+
+  std::ifstream file(path.string());
+  std::string line;
+  int lines = 0;
+  while (std::getline(file, line)) {
+    ASSERT_EQ("line " + std::to_string(lines), line);
+    ++lines;
+  }
+
+  ASSERT_EQ(10000, lines);
+  file.close();
+  boost::filesystem::remove(path);
+}
@@ -0,0 +1,120 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "gtest/gtest.h"
+
+#include <map>
+#include <random>
+#include <boost/filesystem.hpp>
+
+#include "common/PagedHashFile.h"
+
+using namespace Common;
+
+namespace {
+
+const std::string FILENAME = "./paged_hash_file.dat";
+
+class PagedHashFileTest : public ::testing::Test {
+public:
+  virtual void SetUp() override {
+    boost::filesystem::remove(FILENAME);
+  }
+
+  virtual void TearDown() override {
+    boost::filesystem::remove(FILENAME);
+  }
+};
+
+}
+
+TEST_F(PagedHashFileTest, matchesMapAcrossSplitsAndErases) {
+  PagedHashFile file(sizeof(uint64_t), sizeof(uint32_t), 8);
+  ASSERT_TRUE(file.open(FILENAME));
+
+  std::map<uint64_t, uint32_t> expected;
+  std::mt19937_64 random(1);
+  for (uint32_t i = 0; i < 50000; ++i) {
+    uint64_t key = random() % 30000;
+    if (i % 3 == 2) {
+      ASSERT_EQ(expected.erase(key) == 1, file.erase(&key));
+    } else {
+      ASSERT_EQ(expected.insert(std::make_pair(key, i)).second, file.insert(&key, &i));
+    }
+  }
+
+  ASSERT_EQ(expected.size(), file.size());
+  for (const auto& entry : expected) {
+    uint32_t value;
+    ASSERT_TRUE(file.find(&entry.first, &value));
+    ASSERT_EQ(entry.second, value);
+  }
+
+  size_t visited = 0;
+  file.forEach([&](const uint8_t* key, const uint8_t* value) {
+    uint64_t k;
+    uint32_t v;
+    memcpy(&k, key, sizeof k);
+    memcpy(&v, value, sizeof v);
+    ASSERT_EQ(expected.at(k), v);
+    ++visited;
+  });
+
+  ASSERT_EQ(expected.size(), visited);
+}
+
+TEST_F(PagedHashFileTest, reopensCommittedState) {
+  {
+    PagedHashFile file(sizeof(uint64_t), sizeof(uint64_t), 4);
+    ASSERT_TRUE(file.open(FILENAME));
+    for (uint64_t i = 0; i < 10000; ++i) {
+      uint64_t value = i * 2;
+      file.put(&i, &value);
+    }
+
+    ASSERT_TRUE(file.commit("first"));
+
+    // changes after the last commit are dropped on close
+    for (uint64_t i = 10000; i < 11000; ++i) {
+      file.put(&i, &i);
+    }
+  }
+
+  PagedHashFile file(sizeof(uint64_t), sizeof(uint64_t), 4);
+  ASSERT_TRUE(file.open(FILENAME));
+  ASSERT_EQ("first", file.state());
+  ASSERT_EQ(10000, file.size());
+
+  uint64_t key = 9999;
+  uint64_t value;
+  ASSERT_TRUE(file.find(&key, &value));
+  ASSERT_EQ(19998, value);
+  key = 10000;
+  ASSERT_FALSE(file.find(&key, nullptr));
+}
+
+TEST_F(PagedHashFileTest, refusesOtherLayoutAndHalfWrittenFiles) {
+  {
+    PagedHashFile file(sizeof(uint64_t), sizeof(uint64_t));
+    ASSERT_TRUE(file.open(FILENAME));
+    ASSERT_TRUE(file.commit(""));
+  }
+
+  PagedHashFile otherLayout(sizeof(uint32_t), sizeof(uint64_t));
+  ASSERT_FALSE(otherLayout.open(FILENAME));
+
+  {
+    // a crash between the invalidated header and the final one
+    std::fstream stream(FILENAME, std::ios::binary | std::ios::in | std::ios::out);
+    stream.seekp(sizeof(uint64_t) + 2 * sizeof(uint32_t));
+    uint32_t clean = 0;
+    stream.write(reinterpret_cast<const char*>(&clean), sizeof clean);
+  }
+
+  PagedHashFile file(sizeof(uint64_t), sizeof(uint64_t));
+  ASSERT_FALSE(file.open(FILENAME));
+  file.clear();
+  ASSERT_EQ(0, file.size());
+  ASSERT_TRUE(file.open(FILENAME));
+}
@@ -0,0 +1,100 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <gtest/gtest.h>
+#include "common/RecursiveSharedMutex.h"
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace Tools;
+
+TEST(RecursiveSharedMutex, exclusiveIsRecursive) {
+  RecursiveSharedMutex mutex;
+  mutex.lock();
+  mutex.lock();
+  mutex.unlock();
+
+  std::atomic<bool> acquired(false);
+  std::thread other([&] {
+    std::lock_guard<RecursiveSharedMutex> lock(mutex);
+    acquired = true;
+  });
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  ASSERT_FALSE(acquired);
+  mutex.unlock();
+  other.join();
+  ASSERT_TRUE(acquired);
+}
+
+TEST(RecursiveSharedMutex, ownerCanTakeSharedLock) {
+  RecursiveSharedMutex mutex;
+  std::lock_guard<RecursiveSharedMutex> lock(mutex);
+  SharedLockGuard<RecursiveSharedMutex> shared(mutex);
+  SharedLockGuard<RecursiveSharedMutex> nested(mutex);
+  ASSERT_TRUE(mutex.try_lock());
+  mutex.unlock();
+}
+
+TEST(RecursiveSharedMutex, readerCanNotUpgrade) {
+  RecursiveSharedMutex mutex;
+  {
+    SharedLockGuard<RecursiveSharedMutex> shared(mutex);
+    ASSERT_THROW(mutex.lock(), std::logic_error);
+    ASSERT_FALSE(mutex.try_lock());
+  }
+
+  ASSERT_TRUE(mutex.try_lock());
+  mutex.unlock();
+}
+
+TEST(RecursiveSharedMutex, readersRunConcurrently) {
+  RecursiveSharedMutex mutex;
+  const size_t readerCount = 4;
+  std::atomic<size_t> inside(0);
+  std::atomic<size_t> maxInside(0);
+
+  std::vector<std::thread> readers;
+  for (size_t i = 0; i < readerCount; ++i) {
+    readers.emplace_back([&] {
+      SharedLockGuard<RecursiveSharedMutex> lock(mutex);
+      SharedLockGuard<RecursiveSharedMutex> nested(mutex);
+      size_t now = ++inside;
+      size_t seen = maxInside;
+      while (now > seen && !maxInside.compare_exchange_weak(seen, now)) {
+      }
+
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+      --inside;
+    });
+  }
+
+  for (auto& reader : readers) {
+    reader.join();
+  }
+
+  ASSERT_GT(maxInside.load(), 1u);
+}
+
+TEST(RecursiveSharedMutex, writerExcludesReaders) {
+  RecursiveSharedMutex mutex;
+  mutex.lock_shared();
+  ASSERT_FALSE(mutex.try_lock());
+
+  std::atomic<bool> written(false);
+  std::thread writer([&] {
+    std::lock_guard<RecursiveSharedMutex> lock(mutex);
+    written = true;
+  });
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  ASSERT_FALSE(written);
+  mutex.unlock_shared();
+  writer.join();
+  ASSERT_TRUE(written);
+}
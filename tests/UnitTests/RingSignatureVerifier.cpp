@@ -0,0 +1,97 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <gtest/gtest.h>
+#include "cryptonote/core/RingSignatureVerifier.h"
+
+using namespace cryptonote;
+
+namespace {
+
+ring_signature_check_t makeCheck(size_t ringSize) {
+  ring_signature_check_t check;
+  check.prefixHash = crypto::rand<crypto::hash_t>();
+
+  crypto::secret_key_t realKey;
+  size_t realIndex = ringSize / 2;
+  check.outputKeys.resize(ringSize);
+  for (size_t i = 0; i < ringSize; ++i) {
+    crypto::secret_key_t secretKey;
+    crypto::generate_keys(check.outputKeys[i], secretKey);
+    if (i == realIndex) {
+      realKey = secretKey;
+    }
+  }
+
+  crypto::generate_key_image(check.outputKeys[realIndex], realKey, check.keyImage);
+
+  std::vector<const crypto::public_key_t*> keys;
+  for (const auto& key : check.outputKeys) {
+    keys.push_back(&key);
+  }
+
+  check.signatures.resize(ringSize);
+  crypto::generate_ring_signature(check.prefixHash, check.keyImage, keys, realKey, realIndex, check.signatures.data());
+  return check;
+}
+
+std::vector<ring_signature_check_t> makeChecks(size_t count) {
+  std::vector<ring_signature_check_t> checks;
+  for (size_t i = 0; i < count; ++i) {
+    checks.push_back(makeCheck(1 + i % 4));
+  }
+
+  return checks;
+}
+
+}
+
+TEST(RingSignatureVerifier, acceptsValidSignatures) {
+  RingSignatureVerifier verifier(4);
+  ASSERT_TRUE(verifier.verify(makeChecks(20)));
+  ASSERT_TRUE(verifier.verify(std::vector<ring_signature_check_t>()));
+}
+
+TEST(RingSignatureVerifier, rejectsBatchWithOneInvalidSignature) {
+  RingSignatureVerifier verifier(4);
+  auto checks = makeChecks(20);
+  checks[13].prefixHash = crypto::rand<crypto::hash_t>();
+  ASSERT_FALSE(verifier.verify(checks));
+
+  // The workers must be usable again after an early exit
+  ASSERT_TRUE(verifier.verify(makeChecks(8)));
+}
+
+TEST(RingSignatureVerifier, smallBatchesAreSplitOverThreads) {
+  RingSignatureVerifier verifier(4);
+  auto checks = makeChecks(3);
+  ASSERT_TRUE(verifier.verify(checks));
+  checks[2].keyImage = crypto::rand<crypto::key_image_t>();
+  ASSERT_FALSE(verifier.verify(checks));
+}
+
+TEST(RingSignatureVerifier, worksWithoutWorkerThreads) {
+  RingSignatureVerifier verifier(1);
+  auto checks = makeChecks(5);
+  ASSERT_TRUE(verifier.verify(checks));
+  checks[0].keyImage = crypto::rand<crypto::key_image_t>();
+  ASSERT_FALSE(verifier.verify(checks));
+}
+
+TEST(RingSignatureVerifier, cryptoBatchFindsInvalidRing) {
+  auto checks = makeChecks(40);
+  std::vector<crypto::ring_signature_batch_item_t> items;
+  for (const auto& check : checks) {
+    items.push_back({ &check.prefixHash, &check.keyImage, check.outputKeys.data(), check.outputKeys.size(), check.signatures.data() });
+  }
+
+  size_t failedIndex = 0;
+  ASSERT_TRUE(crypto::check_ring_signatures(items, failedIndex));
+
+  checks[27].signatures[0] = checks[26].signatures[0];
+  ASSERT_FALSE(crypto::check_ring_signatures(items, failedIndex));
+  ASSERT_EQ(27, failedIndex);
+  ASSERT_FALSE(checks[27].verify());
+  ASSERT_TRUE(checks[26].verify());
+}
@@ -0,0 +1,66 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#include "crypto/hash.h"
+
+namespace {
+
+size_t scratchpadCount(size_t* pooled = nullptr) {
+  size_t counts[crypto::SLOW_HASH_PAGES_HUGE + 1];
+  size_t pool;
+  crypto::slow_hash_get_scratchpad_counts(counts, &pool);
+  if (pooled != nullptr) {
+    *pooled = pool;
+  }
+
+  return counts[crypto::SLOW_HASH_PAGES_SMALL] + counts[crypto::SLOW_HASH_PAGES_TRANSPARENT] + counts[crypto::SLOW_HASH_PAGES_HUGE];
+}
+
+int hashOnNewThread(size_t ways) {
+  int pages;
+  std::thread([&] {
+    const char data[] = "scratchpad";
+    const void* inputs[crypto::CN_SLOW_HASH_MAX_WAYS] = {data, data, data, data};
+    crypto::hash_t hashes[crypto::CN_SLOW_HASH_MAX_WAYS];
+    crypto::cn_slow_hash_multi(inputs, sizeof(data), hashes, ways);
+    pages = crypto::slow_hash_state_pages();
+  }).join();
+
+  return pages;
+}
+
+}
+
+TEST(SlowHashScratchpad, exitedThreadsGiveTheirScratchpadsBack) {
+  if (hashOnNewThread(2) == crypto::SLOW_HASH_PAGES_NONE) {
+    return;
+  }
+
+  size_t pooled;
+  size_t count = scratchpadCount(&pooled);
+  ASSERT_LE(2, pooled);
+
+  for (size_t i = 0; i < 3; ++i) {
+    ASSERT_NE(crypto::SLOW_HASH_PAGES_NONE, hashOnNewThread(2));
+  }
+
+  ASSERT_EQ(count, scratchpadCount(&pooled));
+  ASSERT_LE(2, pooled);
+}
+
+TEST(SlowHashScratchpad, freedStateIsTakenAgainOnNextHash) {
+  const char data[] = "scratchpad";
+  crypto::hash_t first;
+  crypto::cn_slow_hash(data, sizeof(data), first);
+  crypto::slow_hash_free_state();
+  ASSERT_EQ(crypto::SLOW_HASH_PAGES_NONE, crypto::slow_hash_state_pages());
+
+  crypto::hash_t second;
+  crypto::cn_slow_hash(data, sizeof(data), second);
+  ASSERT_EQ(first, second);
+}
@@ -0,0 +1,201 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "gtest/gtest.h"
+
+#include <boost/uuid/random_generator.hpp>
+
+#include "crypto/crypto.h"
+#include "cryptonote/protocol/SyncScheduler.h"
+
+using namespace cryptonote;
+
+namespace {
+
+std::vector<crypto::hash_t> makeIds(size_t count) {
+  std::vector<crypto::hash_t> ids;
+  for (size_t i = 0; i < count; ++i) {
+    ids.push_back(crypto::rand<crypto::hash_t>());
+  }
+
+  return ids;
+}
+
+std::vector<block_complete_entry_t> makeBlocks(const std::vector<crypto::hash_t>& ids) {
+  std::vector<block_complete_entry_t> blocks(ids.size());
+  for (size_t i = 0; i < ids.size(); ++i) {
+    blocks[i].block.assign(reinterpret_cast<const char*>(&ids[i]), sizeof(ids[i]));
+  }
+
+  return blocks;
+}
+
+class SyncSchedulerTest : public ::testing::Test {
+public:
+  SyncSchedulerTest() : scheduler(10, 4), previousId(crypto::rand<crypto::hash_t>()), now(SyncScheduler::clock::now()) {
+    boost::uuids::random_generator generator;
+    fastPeer = generator();
+    slowPeer = generator();
+  }
+
+protected:
+  SyncScheduler scheduler;
+  crypto::hash_t previousId;
+  SyncScheduler::clock::time_point now;
+  SyncScheduler::peer_id_t fastPeer;
+  SyncScheduler::peer_id_t slowPeer;
+};
+
+}
+
+TEST_F(SyncSchedulerTest, splitsIdsIntoRangesForSeveralPeers) {
+  auto ids = makeIds(25);
+  ASSERT_EQ(25, scheduler.addBlockIds(1, previousId, ids, fastPeer));
+  ASSERT_EQ(0, scheduler.addBlockIds(1, previousId, ids, slowPeer));
+
+  std::vector<crypto::hash_t> first;
+  std::vector<crypto::hash_t> second;
+  ASSERT_TRUE(scheduler.assign(fastPeer, 100, now, first));
+  ASSERT_TRUE(scheduler.assign(slowPeer, 100, now, second));
+  ASSERT_EQ(std::vector<crypto::hash_t>(ids.begin(), ids.begin() + 10), first);
+  ASSERT_EQ(std::vector<crypto::hash_t>(ids.begin() + 10, ids.begin() + 20), second);
+
+  std::vector<crypto::hash_t> none;
+  ASSERT_FALSE(scheduler.assign(fastPeer, 100, now, none));
+}
+
+TEST_F(SyncSchedulerTest, commitsOutOfOrderDeliveriesInHeightOrder) {
+  auto ids = makeIds(20);
+  scheduler.addBlockIds(1, previousId, ids, fastPeer);
+  scheduler.addBlockIds(1, previousId, ids, slowPeer);
+
+  std::vector<crypto::hash_t> first;
+  std::vector<crypto::hash_t> second;
+  scheduler.assign(slowPeer, 100, now, first);
+  scheduler.assign(fastPeer, 100, now, second);
+
+  std::vector<block_complete_entry_t> blocks;
+  SyncScheduler::peer_id_t deliveredBy;
+  ASSERT_TRUE(scheduler.deliver(fastPeer, makeBlocks(second), now + std::chrono::seconds(1)));
+  ASSERT_FALSE(scheduler.popReady(blocks, deliveredBy));
+
+  ASSERT_TRUE(scheduler.deliver(slowPeer, makeBlocks(first), now + std::chrono::seconds(5)));
+  ASSERT_TRUE(scheduler.popReady(blocks, deliveredBy));
+  ASSERT_EQ(slowPeer, deliveredBy);
+  ASSERT_EQ(makeBlocks(first)[0].block, blocks[0].block);
+
+  ASSERT_TRUE(scheduler.popReady(blocks, deliveredBy));
+  ASSERT_EQ(fastPeer, deliveredBy);
+  ASSERT_FALSE(scheduler.hasPending());
+
+  ASSERT_DOUBLE_EQ(10.0, scheduler.throughput(fastPeer));
+  ASSERT_DOUBLE_EQ(2.0, scheduler.throughput(slowPeer));
+}
+
+TEST_F(SyncSchedulerTest, reassignsRangeOfStalledPeer) {
+  auto ids = makeIds(10);
+  scheduler.addBlockIds(1, previousId, ids, slowPeer);
+  scheduler.addBlockIds(1, previousId, ids, fastPeer);
+
+  std::vector<crypto::hash_t> range;
+  ASSERT_TRUE(scheduler.assign(slowPeer, 100, now, range));
+  ASSERT_TRUE(scheduler.releaseStalled(now + std::chrono::seconds(1)).empty());
+
+  auto stalled = scheduler.releaseStalled(now + std::chrono::seconds(BLOCKS_SYNCHRONIZING_MIN_TIMEOUT + 1));
+  ASSERT_EQ(1, stalled.size());
+  ASSERT_EQ(slowPeer, stalled[0]);
+  ASSERT_FALSE(scheduler.isAssigned(slowPeer));
+
+  std::vector<crypto::hash_t> reassigned;
+  ASSERT_TRUE(scheduler.assign(fastPeer, 100, now, reassigned));
+  ASSERT_EQ(range, reassigned);
+  ASSERT_FALSE(scheduler.deliver(slowPeer, makeBlocks(range), now));
+}
+
+TEST_F(SyncSchedulerTest, skipsRangesAbovePeerHeight) {
+  auto ids = makeIds(20);
+  scheduler.addBlockIds(1, previousId, ids, slowPeer);
+  scheduler.addBlockIds(1, previousId, ids, fastPeer);
+
+  std::vector<crypto::hash_t> range;
+  ASSERT_TRUE(scheduler.assign(slowPeer, 11, now, range));
+  ASSERT_FALSE(scheduler.assign(fastPeer, 11, now, range));
+  ASSERT_TRUE(scheduler.assign(fastPeer, 21, now, range));
+}
+
+TEST_F(SyncSchedulerTest, limitsRangesAheadOfCommit) {
+  auto ids = makeIds(100);
+  std::vector<SyncScheduler::peer_id_t> peers;
+  boost::uuids::random_generator generator;
+  for (size_t i = 0; i < 5; ++i) {
+    peers.push_back(generator());
+    scheduler.addBlockIds(1, previousId, ids, peers.back());
+  }
+
+  std::vector<crypto::hash_t> range;
+  for (size_t i = 0; i < 4; ++i) {
+    ASSERT_TRUE(scheduler.assign(peers[i], 1000, now, range));
+  }
+
+  ASSERT_FALSE(scheduler.assign(peers[4], 1000, now, range));
+}
+
+TEST_F(SyncSchedulerTest, acceptsOnlyIdsContinuingScheduledChain) {
+  auto ids = makeIds(10);
+  ASSERT_EQ(10, scheduler.addBlockIds(1, previousId, ids, fastPeer));
+
+  // overlapping entry from another peer on the same chain
+  auto more = makeIds(5);
+  std::vector<crypto::hash_t> entry(ids.begin() + 5, ids.end());
+  entry.insert(entry.end(), more.begin(), more.end());
+  ASSERT_EQ(5, scheduler.addBlockIds(6, ids[4], entry, slowPeer));
+
+  // entry from a peer on another branch
+  ASSERT_EQ(0, scheduler.addBlockIds(16, crypto::rand<crypto::hash_t>(), makeIds(5), slowPeer));
+}
+
+TEST_F(SyncSchedulerTest, assignsRangesOnlyToPeersThatAnnouncedThem) {
+  auto ids = makeIds(20);
+  scheduler.addBlockIds(1, previousId, ids, fastPeer);
+  // announces only the second range
+  scheduler.addBlockIds(11, ids[9], std::vector<crypto::hash_t>(ids.begin() + 10, ids.end()), slowPeer);
+
+  std::vector<crypto::hash_t> range;
+  ASSERT_TRUE(scheduler.assign(slowPeer, 100, now, range));
+  ASSERT_EQ(std::vector<crypto::hash_t>(ids.begin() + 10, ids.end()), range);
+
+  boost::uuids::random_generator generator;
+  ASSERT_FALSE(scheduler.assign(generator(), 100, now, range));
+}
+
+TEST_F(SyncSchedulerTest, dropsRangesNobodyAnnouncedAnymore) {
+  auto ids = makeIds(20);
+  scheduler.addBlockIds(1, previousId, std::vector<crypto::hash_t>(ids.begin(), ids.begin() + 10), slowPeer);
+  scheduler.addBlockIds(1, previousId, ids, fastPeer);
+
+  scheduler.release(fastPeer);
+  ASSERT_TRUE(scheduler.hasPending());
+
+  scheduler.release(slowPeer);
+  ASSERT_FALSE(scheduler.hasPending());
+  ASSERT_EQ(20, scheduler.addBlockIds(1, previousId, ids, fastPeer));
+}
+
+TEST_F(SyncSchedulerTest, keepsPoppedIdsScheduledUntilCommitted) {
+  auto ids = makeIds(10);
+  scheduler.addBlockIds(1, previousId, ids, fastPeer);
+
+  std::vector<crypto::hash_t> range;
+  ASSERT_TRUE(scheduler.assign(fastPeer, 100, now, range));
+  ASSERT_TRUE(scheduler.deliver(fastPeer, makeBlocks(range), now));
+
+  std::vector<block_complete_entry_t> blocks;
+  SyncScheduler::peer_id_t deliveredBy;
+  ASSERT_TRUE(scheduler.popReady(blocks, deliveredBy));
+  ASSERT_EQ(0, scheduler.addBlockIds(1, previousId, ids, slowPeer));
+  ASSERT_FALSE(scheduler.hasPending());
+
+  scheduler.committed();
+  ASSERT_EQ(10, scheduler.addBlockIds(1, previousId, ids, slowPeer));
+}
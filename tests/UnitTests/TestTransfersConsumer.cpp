@@ -7,6 +7,7 @@
 #include "cryptonote/core/TransactionApi.h"
 #include "logging/ConsoleLogger.h"
 #include "transfers/TransfersConsumer.h"
+#include "transfers/TransfersWorkerPool.h"
 
 #include <algorithm>
 #include <limits>
@@ -75,6 +76,7 @@ protected:
   TestBlockchainGenerator m_generator;
   INodeTrivialRefreshStub m_node;
   account_keys_t m_accountKeys;
+  TransfersWorkerPool m_workers;
   TransfersConsumer m_consumer;
 };
 
@@ -83,7 +85,7 @@ TransfersConsumerTest::TransfersConsumerTest() :
   m_generator(m_currency),
   m_node(m_generator, true),
   m_accountKeys(generateAccountKeys()),
-  m_consumer(m_currency, m_node, m_accountKeys.viewSecretKey)
+  m_consumer(m_currency, m_node, m_workers, m_accountKeys.viewSecretKey)
 {
 }
 
@@ -410,7 +412,7 @@ TEST_F(TransfersConsumerTest, onNewBlocks_getTransactionOutsGlobalIndicesError)
 
   INodeGlobalIndicesStub node;
 
-  TransfersConsumer consumer(m_currency, node, m_accountKeys.viewSecretKey);
+  TransfersConsumer consumer(m_currency, node, m_workers, m_accountKeys.viewSecretKey);
 
   auto subscription = getAccountSubscriptionWithSyncStart(m_accountKeys, 1234, 10);
 
@@ -529,7 +531,7 @@ TEST_F(TransfersConsumerTest, onNewBlocks_getTransactionOutsGlobalIndicesIsPrope
   };
 
   INodeGlobalIndicesStub node;
-  TransfersConsumer consumer(m_currency, node, m_accountKeys.viewSecretKey);
+  TransfersConsumer consumer(m_currency, node, m_workers, m_accountKeys.viewSecretKey);
 
   AccountSubscription subscription = getAccountSubscription(m_accountKeys);
   subscription.syncStart.height = 0;
@@ -567,7 +569,7 @@ TEST_F(TransfersConsumerTest, onNewBlocks_getTransactionOutsGlobalIndicesIsNotCa
   };
 
   INodeGlobalIndicesStub node;
-  TransfersConsumer consumer(m_currency, node, m_accountKeys.viewSecretKey);
+  TransfersConsumer consumer(m_currency, node, m_workers, m_accountKeys.viewSecretKey);
 
   AccountSubscription subscription = getAccountSubscription(m_accountKeys);
   subscription.syncStart.height = 0;
@@ -587,6 +589,65 @@ TEST_F(TransfersConsumerTest, onNewBlocks_getTransactionOutsGlobalIndicesIsNotCa
   ASSERT_FALSE(node.called);
 }
 
+TEST_F(TransfersConsumerTest, onNewBlocks_getTransactionsOutsGlobalIndicesIsCalledOnceForAllTransactions) {
+  class INodeGlobalIndicesStub: public INodeDummyStub {
+  public:
+    INodeGlobalIndicesStub() : calls(0) {};
+
+    virtual void getTransactionsOutsGlobalIndices(const std::vector<crypto::hash_t>& transactionHashes,
+      std::vector<std::vector<uint32_t>>& outsGlobalIndices, const Callback& callback) override {
+      ++calls;
+      hashes = transactionHashes;
+      for (uint32_t i = 0; i < transactionHashes.size(); ++i) {
+        outsGlobalIndices.push_back(std::vector<uint32_t>(1, 10 + i));
+      }
+      callback(std::error_code());
+    };
+
+    size_t calls;
+    std::vector<crypto::hash_t> hashes;
+  };
+
+  INodeGlobalIndicesStub node;
+  TransfersConsumer consumer(m_currency, node, m_workers, m_accountKeys.viewSecretKey);
+
+  AccountSubscription subscription = getAccountSubscription(m_accountKeys);
+  subscription.syncStart.height = 0;
+  subscription.syncStart.timestamp = 0;
+  auto& container = consumer.addSubscription(subscription).getContainer();
+
+  CompleteBlock blocks[2];
+  std::vector<crypto::hash_t> expectedHashes;
+  for (auto& block : blocks) {
+    block.block = cryptonote::block_t();
+    block.block->timestamp = 0;
+    for (size_t i = 0; i < 2; ++i) {
+      TestTransactionBuilder builder;
+      builder.addTestInput(10000);
+      builder.addTestKeyOutput(900, 0, m_accountKeys);
+      std::shared_ptr<ITransactionReader> tx(builder.build().release());
+      block.transactions.push_back(tx);
+      expectedHashes.push_back(tx->getTransactionHash());
+    }
+
+    TestTransactionBuilder foreignBuilder;
+    foreignBuilder.addTestInput(10000);
+    foreignBuilder.addTestKeyOutput(900, 0, generateAccount());
+    block.transactions.push_back(std::shared_ptr<ITransactionReader>(foreignBuilder.build().release()));
+  }
+
+  ASSERT_TRUE(consumer.onNewBlocks(blocks, 1, 2));
+  ASSERT_EQ(1, node.calls);
+  ASSERT_EQ(expectedHashes, node.hashes);
+  ASSERT_EQ(4 * 900, container.balance(ITransfersContainer::IncludeAll));
+
+  for (uint32_t i = 0; i < expectedHashes.size(); ++i) {
+    auto outputs = container.getTransactionOutputs(expectedHashes[i], ITransfersContainer::IncludeAll);
+    ASSERT_EQ(1, outputs.size());
+    ASSERT_EQ(10 + i, outputs[0].globalOutputIndex);
+  }
+}
+
 TEST_F(TransfersConsumerTest, onNewBlocks_markTransactionConfirmed) {
   auto& container = addSubscription().getContainer();
   
@@ -637,7 +698,7 @@ TEST_F(TransfersConsumerTest, onNewBlocks_checkTransactionOutputInformation) {
   const uint64_t index = 2;
 
   INodeGlobalIndexStub node;
-  TransfersConsumer consumer(m_currency, node, m_accountKeys.viewSecretKey);
+  TransfersConsumer consumer(m_currency, node, m_workers, m_accountKeys.viewSecretKey);
 
   node.globalIndex = index;
 
@@ -670,7 +731,7 @@ TEST_F(TransfersConsumerTest, onNewBlocks_checkTransactionOutputInformationMulti
   const uint64_t index = 2;
 
   INodeGlobalIndexStub node;
-  TransfersConsumer consumer(m_currency, node, m_accountKeys.viewSecretKey);
+  TransfersConsumer consumer(m_currency, node, m_workers, m_accountKeys.viewSecretKey);
 
   node.globalIndex = index;
 
@@ -988,6 +988,30 @@ TEST_F(TransfersContainer_balance, filtersByStateAndKeySimultaneously) {
   ASSERT_EQ(AMOUNT_1 + AMOUNT_2, container.balance(ITransfersContainer::IncludeStateUnlocked | ITransfersContainer::IncludeTypeKey));
 }
 
+TEST_F(TransfersContainer_balance, followsTransfersAsHeightChanges) {
+  TestTransactionBuilder tx1;
+  tx1.setUnlockTime(TEST_BLOCK_HEIGHT + 10);
+  tx1.addTestInput(AMOUNT_1 + 1);
+  auto outInfo = tx1.addTestKeyOutput(AMOUNT_1, TEST_TRANSACTION_OUTPUT_GLOBAL_INDEX, account);
+  ASSERT_TRUE(container.addTransaction(blockInfo(TEST_BLOCK_HEIGHT), *tx1.build(), { outInfo }));
+  auto tx2 = addTransaction(TEST_BLOCK_HEIGHT + 1, AMOUNT_2);
+
+  ASSERT_EQ(AMOUNT_1, container.balance(ITransfersContainer::IncludeStateLocked | ITransfersContainer::IncludeTypeAll));
+  ASSERT_EQ(AMOUNT_2, container.balance(ITransfersContainer::IncludeStateSoftLocked | ITransfersContainer::IncludeTypeAll));
+
+  container.advanceHeight(TEST_BLOCK_HEIGHT + 10);
+  ASSERT_EQ(AMOUNT_1 + AMOUNT_2, container.balance(ITransfersContainer::IncludeAllUnlocked));
+  ASSERT_EQ(0, container.balance(ITransfersContainer::IncludeAllLocked));
+
+  auto spendingTx = addSpendingTransaction(tx2->getTransactionHash(), TEST_BLOCK_HEIGHT + 10, 0, AMOUNT_2);
+  ASSERT_EQ(AMOUNT_1, container.balance(ITransfersContainer::IncludeAll));
+
+  container.detach(TEST_BLOCK_HEIGHT + 2);
+  ASSERT_EQ(AMOUNT_1, container.balance(ITransfersContainer::IncludeStateLocked | ITransfersContainer::IncludeTypeAll));
+  ASSERT_EQ(AMOUNT_2, container.balance(ITransfersContainer::IncludeStateSoftLocked | ITransfersContainer::IncludeTypeAll));
+  ASSERT_EQ(0, container.balance(ITransfersContainer::IncludeAllUnlocked));
+}
+
 
 //--------------------------------------------------------------------------- 
 // TransfersContainer_getOutputs
@@ -41,6 +41,27 @@ class TransactionValidator : public cryptonote::ITransactionValidator {
   }
 };
 
+class CountingTransactionValidator : public TransactionValidator {
+public:
+  size_t fullInputChecks = 0;
+  size_t inputChecks = 0;
+  bool spent = false;
+
+  virtual bool checkTransactionInputs(const cryptonote::transaction_t& tx, block_info_t& maxUsedBlock) override {
+    ++fullInputChecks;
+    return true;
+  }
+
+  virtual bool checkTransactionInputs(const cryptonote::transaction_t& tx, block_info_t& maxUsedBlock, block_info_t& lastFailed) override {
+    ++inputChecks;
+    return true;
+  }
+
+  virtual bool haveSpentKeyImages(const cryptonote::transaction_t& tx) override {
+    return spent;
+  }
+};
+
 class FakeTimeProvider : public ITimeProvider {
 public:
   FakeTimeProvider(time_t currentTime = time(nullptr))
@@ -682,6 +703,66 @@ TEST_F(tx_pool, TxPoolDoesNotAcceptInvalidFusionTransaction) {
   ASSERT_FALSE(tvc.m_verifivation_impossible);
 }
 
+TEST_F(tx_pool, getDifferenceChecksTransactionsAgainOnlyAfterChainChanges) {
+  CountingTransactionValidator validator;
+  FakeTimeProvider timeProvider;
+  std::unique_ptr<TxMemoryPool> pool(new TxMemoryPool(currency, validator, timeProvider, logger));
+  ASSERT_TRUE(pool->init());
+
+  FusionTransactionBuilder builder(currency, 10 * currency.defaultDustThreshold());
+  auto tx = builder.buildTx();
+  crypto::hash_t txHash = BinaryArray::objectHash(tx);
+  tx_verification_context_t tvc = boost::value_initialized<tx_verification_context_t>();
+  ASSERT_TRUE(pool->add_tx(tx, tvc, false));
+
+  std::vector<crypto::hash_t> added;
+  std::vector<crypto::hash_t> deleted;
+  pool->get_difference({}, added, deleted);
+  ASSERT_EQ(std::vector<crypto::hash_t>{txHash}, added);
+  ASSERT_TRUE(deleted.empty());
+
+  size_t inputChecks = validator.inputChecks;
+  added.clear();
+  pool->get_difference({txHash}, added, deleted);
+  ASSERT_TRUE(added.empty());
+  ASSERT_TRUE(deleted.empty());
+  ASSERT_EQ(inputChecks, validator.inputChecks);
+
+  validator.spent = true;
+  pool->on_blockchain_inc(1, crypto::hash_t());
+  pool->get_difference({txHash}, added, deleted);
+  ASSERT_TRUE(added.empty());
+  ASSERT_EQ(std::vector<crypto::hash_t>{txHash}, deleted);
+  ASSERT_EQ(inputChecks + 1, validator.inputChecks);
+}
+
+TEST_F(tx_pool, addTxUsesInputsCheckedByTheCaller) {
+  CountingTransactionValidator validator;
+  FakeTimeProvider timeProvider;
+  std::unique_ptr<TxMemoryPool> pool(new TxMemoryPool(currency, validator, timeProvider, logger));
+  ASSERT_TRUE(pool->init());
+
+  FusionTransactionBuilder builder(currency, 10 * currency.defaultDustThreshold());
+  auto tx = builder.buildTx();
+  crypto::hash_t txHash = NULL_HASH;
+  size_t blobSize = 0;
+  BinaryArray::objectHash(tx, txHash, blobSize);
+
+  block_info_t failed;
+  tx_verification_context_t tvc = boost::value_initialized<tx_verification_context_t>();
+  ASSERT_FALSE(pool->add_tx(tx, txHash, blobSize, tvc, false, &failed));
+  ASSERT_TRUE(tvc.m_verifivation_failed);
+
+  block_info_t checked;
+  checked.height = 1;
+  checked.id = crypto::rand<crypto::hash_t>();
+  tvc = boost::value_initialized<tx_verification_context_t>();
+  ASSERT_TRUE(pool->add_tx(tx, txHash, blobSize, tvc, false, &checked));
+  ASSERT_TRUE(tvc.m_added_to_pool);
+  ASSERT_EQ(0, validator.fullInputChecks);
+  ASSERT_EQ(1, validator.inputChecks);
+}
+
 namespace {
 
 const size_t TEST_FUSION_TX_COUNT_PER_BLOCK = 3;
@@ -805,3 +886,51 @@ TEST_F(TxPool_FillBlockTemplate, TxPoolContinuesToAddOrdinaryTransactionsUpTo125
     TEST_MAX_TX_COUNT_PER_BLOCK - fusionTxCount,
     fusionTxCount));
 }
+
+TEST_F(tx_pool, getChangesSinceReturnsTheLoggedChangesOrTheWholePool) {
+  currency = cryptonote::CurrencyBuilder(os::appdata::path(), config::testnet::data, logger).poolChangeLogSize(2).currency();
+  currency.setPath(m_configDir.string());
+  TransactionValidator validator;
+  FakeTimeProvider timeProvider;
+  std::unique_ptr<TxMemoryPool> pool(new TxMemoryPool(currency, validator, timeProvider, logger));
+  ASSERT_TRUE(pool->init());
+
+  std::vector<crypto::hash_t> added;
+  std::vector<crypto::hash_t> deleted;
+  uint64_t start = 0;
+  ASSERT_FALSE(pool->getChangesSince(start, added, deleted));
+  ASSERT_TRUE(added.empty());
+
+  std::vector<crypto::hash_t> txHashes;
+  for (size_t i = 0; i < 3; ++i) {
+    auto tx = createTestOrdinaryTransaction(currency);
+    txHashes.push_back(BinaryArray::objectHash(tx));
+    tx_verification_context_t tvc = boost::value_initialized<tx_verification_context_t>();
+    ASSERT_TRUE(pool->add_tx(tx, tvc, false));
+  }
+
+  uint64_t sequence = start + 1;
+  ASSERT_TRUE(pool->getChangesSince(sequence, added, deleted));
+  ASSERT_EQ(start + 3, sequence);
+  ASSERT_EQ(std::unordered_set<crypto::hash_t>(txHashes.begin() + 1, txHashes.end()),
+    std::unordered_set<crypto::hash_t>(added.begin(), added.end()));
+  ASSERT_TRUE(deleted.empty());
+
+  transaction_t tx;
+  size_t blobSize;
+  uint64_t fee;
+  ASSERT_TRUE(pool->take_tx(txHashes[0], tx, blobSize, fee));
+  added.clear();
+  ASSERT_TRUE(pool->getChangesSince(sequence, added, deleted));
+  ASSERT_EQ(start + 4, sequence);
+  ASSERT_TRUE(added.empty());
+  ASSERT_EQ(std::vector<crypto::hash_t>{txHashes[0]}, deleted);
+
+  // the log keeps two changes, the client has to start over
+  sequence = start + 1;
+  deleted.clear();
+  ASSERT_FALSE(pool->getChangesSince(sequence, added, deleted));
+  ASSERT_EQ(start + 4, sequence);
+  ASSERT_EQ(2, added.size());
+  ASSERT_TRUE(deleted.empty());
+}
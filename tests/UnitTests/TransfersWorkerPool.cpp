@@ -0,0 +1,51 @@
+// Copyright (c) 2011-2016 The Cryptonote developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <gtest/gtest.h>
+#include "transfers/TransfersWorkerPool.h"
+
+#include <atomic>
+#include <stdexcept>
+
+using namespace cryptonote;
+
+TEST(TransfersWorkerPool, callsEveryIndexOncePerJob) {
+  TransfersWorkerPool pool(4);
+  std::vector<std::atomic<int>> calls(1000);
+
+  for (size_t job = 0; job < 3; ++job) {
+    pool.forEach(calls.size(), 3, [&](size_t index) {
+      ++calls[index];
+    });
+  }
+
+  for (const auto& count : calls) {
+    ASSERT_EQ(3, count);
+  }
+}
+
+TEST(TransfersWorkerPool, smallJobsRunOnTheCallingThread) {
+  TransfersWorkerPool pool(4);
+  std::thread::id caller = std::this_thread::get_id();
+  size_t calls = 0;
+  pool.forEach(4, 4, [&](size_t) {
+    ASSERT_EQ(caller, std::this_thread::get_id());
+    ++calls;
+  });
+
+  ASSERT_EQ(4, calls);
+}
+
+TEST(TransfersWorkerPool, rethrowsTheFirstErrorAndStaysUsable) {
+  TransfersWorkerPool pool(4);
+  std::atomic<size_t> calls(0);
+  ASSERT_THROW(pool.forEach(1000, 1, [&](size_t index) {
+    if (index == 10) {
+      throw std::runtime_error("failed");
+    }
+  }), std::runtime_error);
+
+  pool.forEach(100, 1, [&](size_t) { ++calls; });
+  ASSERT_EQ(100, calls);
+}